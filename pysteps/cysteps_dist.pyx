@@ -1206,6 +1206,7 @@ cdef class _py_SSAMethod:
 cdef class _py_SearchMethod:
     DIRECT = 0
     GIBSON_BRUCK = 1
+    DIRECT_SUM_TREE = 2
 
 # ----------------------------------------------------------------------------------------------------------------------
 cdef class _py_DistTetOpSplitP(_py__base):
@@ -1224,7 +1225,9 @@ cdef class _py_DistTetOpSplitP(_py__base):
 
         Create a distributed spatial stochastic solver based on operator splitting, that is that reaction events are
         partitioned and diffusion is approximated. Keyword parameters SSAMethod and searchMethod respectively set the
-        SSA method (SSA or RSSA) and the next event search method (DIRECT or GIBSON_BRUCK).
+        SSA method (SSA or RSSA) and the next event search method (DIRECT, GIBSON_BRUCK or DIRECT_SUM_TREE).
+        DIRECT_SUM_TREE is the direct method with propensities kept in a binary sum tree, which makes
+        propensity updates and event selection logarithmic in the number of kinetic processes.
 
         Arguments:
         steps.model.Model model
@@ -1251,6 +1254,10 @@ cdef class _py_DistTetOpSplitP(_py__base):
                 self._ptr = new TetOpSplit[steps_dist_solver.SSAMethod_SSA, steps_dist_solver.NextEventSearchMethod_GibsonBruck](
                     deref(model.ptr()), deref(mesh.ptrx()), rng.ptr(), indepKProcs
                 )
+            elif searchMethod == _py_SearchMethod.DIRECT_SUM_TREE:
+                self._ptr = new TetOpSplit[steps_dist_solver.SSAMethod_SSA, steps_dist_solver.NextEventSearchMethod_DirectSumTree](
+                    deref(model.ptr()), deref(mesh.ptrx()), rng.ptr(), indepKProcs
+                )
             else:
                 raise ValueError(f'Unknown next event search method: {searchMethod}')
         elif SSAMethod == _py_SSAMethod.RSSA:
@@ -2261,6 +2268,58 @@ cdef class _py_DistTetOpSplitP(_py__base):
             raise ValueError(f'The threshold cannot be negative.')
         self.ptrx().setDiffApplyThreshold(threshold)
 
+    def setCounterBasedRNG(self, unsigned long seed):
+        """
+        Draw the random numbers of diffusion from counter-based generators instead of the
+        random number generator of the solver.
+
+        Each tetrahedron, species and time step gets its own Philox generator, keyed with
+        the seed and counting from the global index of the tetrahedron. Diffusion can then
+        be computed in parallel within a process, and the trajectories do not depend on the
+        number of processes nor on the number of threads.
+
+        With the SSA method and independent kprocs, each group of independent reactions
+        also draws from its own generator, keyed on the global index of the element of its
+        first reaction, and the groups are run in parallel on the OpenMP threads of the
+        process during the operator-split period. The reactions then do not depend on the
+        number of threads.
+
+        The seed must be the same on all processes.
+
+        Syntax::
+
+            setCounterBasedRNG(seed)
+
+        Arguments:
+        unsigned long seed
+
+        Return:
+        None
+        """
+        self.ptrx().setCounterBasedRNG(seed)
+
+    def setDiffHaloExchangeOverlap(self, bool overlap):
+        """
+        Overlap the exchange of diffusing molecules between processes with computations.
+
+        When enabled, the molecules leaving the tetrahedrons at the border of the partition
+        are computed and sent first, and the interior tetrahedrons are updated while the
+        messages are in flight.
+
+        Overlap is enabled by default.
+
+        Syntax::
+
+            setDiffHaloExchangeOverlap(overlap)
+
+        Arguments:
+        bool overlap
+
+        Return:
+        None
+        """
+        self.ptrx().setDiffHaloExchangeOverlap(overlap)
+
     def setTemp(self, double t):
         """
         Set the simulation temperature. Currently, this will only
@@ -1343,6 +1343,27 @@ cdef class _py_Tetmesh(_py_Geom):
         """
         return self.ptrx().findTetByPoint(p).get()
 
+    def findTetsByPointsNP(self, double[:] coords, index_t[:] tets):
+        """
+        For each point given in coords (Cartesian coordinates x,y,z), store
+        the index of the tetrahedron which encompasses it in tets, or
+        UNKNOWN_TET if the point is outside the mesh.
+
+        Syntax::
+
+            findTetsByPointsNP(coords, tets)
+
+        Arguments:
+        numpy.array<double> coords
+        numpy.array<index_t, length = length(coords) / 3> tets
+
+        Return:
+        None
+
+        """
+        if not len(tets): return
+        self.ptrx().findTetsByPointsNP(&coords[0], coords.shape[0], &tets[0], tets.shape[0])
+
     def getBoundMin(self, ):
         """
         Returns the minimal Cartesian coordinate of the rectangular bounding box of the mesh.
@@ -2458,6 +2479,45 @@ cdef class _py_Tetmesh(_py_Geom):
             raise Exception("Wrong memory layout for point_coords, np array should be [pts,3] and row major")
         return self.ptrx().intersect(&point_coords[0][0], point_coords.shape[0], sampling)
 
+    def saveBinary(self, str path):
+        """
+        Save the mesh, its compartments, patches and ROIs to a binary file,
+        together with all the derived connectivity (neighbours, bars, volumes).
+        Membranes and diffusion boundaries are not saved.
+
+        Syntax::
+
+            saveBinary(path)
+
+        Arguments:
+        str path
+
+        Return:
+        None
+
+        """
+        steps_tetmesh.saveBinary(to_std_string(path), self.ptrx())
+
+    @staticmethod
+    def loadBinary(str path):
+        """
+        Load a mesh saved with saveBinary. The file is mapped in memory and
+        the connectivity is not recomputed, which makes loading large meshes
+        much faster than from other formats.
+
+        Syntax::
+
+            mesh = steps.geom.Tetmesh.loadBinary(path)
+
+        Arguments:
+        str path
+
+        Return:
+        steps.geom.Tetmesh
+
+        """
+        return _py_Tetmesh.from_ptr(steps_tetmesh.loadBinary(to_std_string(path)))
+
     @staticmethod
     cdef _py_Tetmesh from_ptr(Tetmesh *ptr):
         if (ptr == NULL):
@@ -2754,6 +2814,8 @@ cdef class _py_Memb(_py__base):
         more than 3 neighbours. Specify optimization method with opt_method (default = 1):
         1 = principal axis ordering (quick to set up but usually results in slower simulation than method 2).
         2 = breadth first search (can be time-consuming to set up, but usually faster simulation.
+        3 = reverse Cuthill-McKee from a few pseudo-peripheral start points (fast to set up, bandwidth
+        similar to method 2, search_percent is ignored).
         If 2:breadth first search is chosen then argument search_percent can specify the number of starting points to search for the
         lowest bandwidth.
         If a filename (with full path) is given in optional argument opt_file_name the membrane optimization will be loaded from file,
@@ -567,6 +567,46 @@ cdef class _py_TetOpSplitP(_py_TetAPI):
         """
         self.ptrx().setBatchTetConcsNP(&index_array[0], index_array.shape[0], to_std_string(s), &concs[0], concs.shape[0])
 
+    def setBatchTetCountsNP(self, index_t[:] index_array, str s, double[:] counts):
+        """
+        Set the counts of a species s in a list of tetrahedrons.
+
+        Each process only sets the tetrahedrons it hosts, without communication.
+
+        Syntax::
+            setBatchTetCountsNP(indices, s, counts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        string s
+        numpy.array<double, length = len(indices)> counts
+
+        Return:
+        None
+
+        """
+        self.ptrx().setBatchTetCountsNP(&index_array[0], index_array.shape[0], to_std_string(s), &counts[0], counts.shape[0])
+
+    def setBatchTriCountsNP(self, index_t[:] index_array, str s, double[:] counts):
+        """
+        Set the counts of a species s in a list of triangles.
+
+        Each process only sets the triangles it hosts, without communication.
+
+        Syntax::
+            setBatchTriCountsNP(indices, s, counts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        string s
+        numpy.array<double, length = len(indices)> counts
+
+        Return:
+        None
+
+        """
+        self.ptrx().setBatchTriCountsNP(&index_array[0], index_array.shape[0], to_std_string(s), &counts[0], counts.shape[0])
+
 
     def getBatchTetConcsNP(self, index_t[:] index_array, str s, double[:] concs):
         """
@@ -850,6 +890,46 @@ cdef class _py_TetOpSplitP(_py_TetAPI):
         """
         self.ptrx().getROITriCountsNP(to_std_string(ROI_id), to_std_string(s), &counts[0], counts.shape[0])
 
+    def setROITetCountsNP(self, str ROI_id, str s, double[:] counts):
+        """
+        Set the counts of a species s in tetrahedrons of a ROI.
+
+        Each process only sets the tetrahedrons it hosts, without communication.
+
+        Syntax::
+            setROITetCountsNP(ROI_id, s, counts)
+
+        Arguments:
+        string ROI_id
+        string s
+        numpy.array<double, length = number of tetrahedrons in the ROI> counts
+
+        Return:
+        None
+
+        """
+        self.ptrx().setROITetCountsNP(to_std_string(ROI_id), to_std_string(s), &counts[0], counts.shape[0])
+
+    def setROITriCountsNP(self, str ROI_id, str s, double[:] counts):
+        """
+        Set the counts of a species s in triangles of a ROI.
+
+        Each process only sets the triangles it hosts, without communication.
+
+        Syntax::
+            setROITriCountsNP(ROI_id, s, counts)
+
+        Arguments:
+        string ROI_id
+        string s
+        numpy.array<double, length = number of triangles in the ROI> counts
+
+        Return:
+        None
+
+        """
+        self.ptrx().setROITriCountsNP(to_std_string(ROI_id), to_std_string(s), &counts[0], counts.shape[0])
+
     def getROIVol(self, str ROI_id):
         """
         Get the volume of a ROI.
@@ -1286,6 +1366,51 @@ cdef class _py_TetOpSplitP(_py_TetAPI):
         """
         self.ptrx().setDiffApplyThreshold(threshold)
 
+    def setMultiRateDiffusion(self, uint max_multiplier):
+        """
+        Enable multi-rate diffusion with period multipliers up to max_multiplier.
+
+        By default every diffusion process is applied after each update period,
+        which is set by the fastest diffusion process of the simulation. In
+        multi-rate mode, slower processes are only applied every 2, 4, 8, ...
+        update periods, up to max_multiplier, as long as the expected number of
+        jumps of a molecule over their own period stays below one. All processes
+        are applied at the end of each run() call.
+
+        The mean population of a slow process is estimated from its last update
+        period only, which is an approximation.
+
+        The default multiplier is 1, which disables multi-rate diffusion. The
+        largest accepted multiplier is 2^30.
+
+        Syntax::
+
+            setMultiRateDiffusion(max_multiplier)
+
+        Arguments:
+        uint max_multiplier
+
+        Return:
+        None
+        """
+        self.ptrx().setMultiRateDiffusion(max_multiplier)
+
+    def getMultiRateDiffusion(self, ):
+        """
+        Return the maximum diffusion period multiplier of the multi-rate mode.
+
+        Syntax::
+
+            getMultiRateDiffusion()
+
+        Arguments:
+        None
+
+        Return:
+        uint
+        """
+        return self.ptrx().getMultiRateDiffusion()
+
     def getReacExtent(self, bool local=False):
         """
         Return the number of reaction events that have happened in the simulation.
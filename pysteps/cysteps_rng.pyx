@@ -215,7 +215,7 @@ cdef class _py_RNG(_py__base):
 
     def getExp(self, double lambda_):
         """
-        Get an exponentially distributed number with mean lambda.
+        Get an exponentially distributed number with rate lambda, i.e. with mean 1/lambda.
         
         Syntax::
         
@@ -232,7 +232,7 @@ cdef class _py_RNG(_py__base):
 
     def getPsn(self, double lambda_):
         """
-        Get a Poisson-distributed number with mean lambda.
+        Get a Poisson-distributed number with mean 1/lambda.
         
         Syntax::
         
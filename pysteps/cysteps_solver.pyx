@@ -4,6 +4,7 @@ from steps_wmrk4 cimport *
 from steps_wmdirect cimport *
 from steps_wmrssa cimport *
 from steps_tetexact cimport *
+cimport steps_tetexact
 from steps_tetode cimport *
 from steps_solver cimport *
 from steps cimport index_t
@@ -214,7 +215,8 @@ cdef class _py_Wmrk4(_py_API):
         simulation with these solvers (currently Wmrk4) since there is no default 
         stepsize. The deterministic solver Wmrk4 implements a fixed stepsize 
         (i.e. not adaptive), although the stepsize can be altered at any point 
-        during the simulation with this method.
+        during the simulation with this method. With the adaptive "rk45"
+        integrator (see setIntegrator), this is only the first trial step.
 
         Syntax::
             
@@ -229,6 +231,227 @@ cdef class _py_Wmrk4(_py_API):
         """
         self.ptrx().setRk4DT(dt)
 
+    def setIntegrator(self, str name):
+        """
+        Select the integrator used by run, advance and step:
+
+        - "rk4" (default): the classic Runge-Kutta method, with the fixed
+          stepsize set with setRk4DT.
+        - "rk45": the embedded Dormand-Prince 5(4) method, with adaptive
+          stepsizes controlled by setTolerances. The stepsize set with
+          setRk4DT is only the first trial step, and is estimated if 0.
+          Counts at the end of run are interpolated with the dense output
+          of the last step, so sampling times do not shorten the steps.
+
+        Syntax::
+
+            setIntegrator(name)
+
+        Arguments:
+        string name
+
+        Return:
+        None
+
+        """
+        self.ptrx().setIntegrator(to_std_string(name))
+
+    def getIntegrator(self, ):
+        """
+        Returns the name of the integrator, "rk4" or "rk45".
+
+        Syntax::
+
+            getIntegrator()
+
+        Arguments:
+        None
+
+        Return:
+        string
+
+        """
+        return from_std_string(self.ptrx().getIntegrator())
+
+    def setTolerances(self, double atol, double rtol):
+        """
+        Set the absolute tolerance (in number of molecules) and the relative
+        tolerance of the "rk45" integrator. Both default to 1e-6.
+
+        Syntax::
+
+            setTolerances(atol, rtol)
+
+        Arguments:
+        float atol
+        float rtol
+
+        Return:
+        None
+
+        """
+        self.ptrx().setTolerances(atol, rtol)
+
+    def setNLanes(self, uint n):
+        """
+        Integrate n instances ("lanes") of the model together.
+
+        Each lane starts as a copy of the current counts and rate constants of
+        the solver and can then be given its own with the setLane* methods.
+        run, advance and step then integrate all lanes, and the solver state
+        follows lane 0. Volumes, areas, clamped and active flags are shared by
+        all lanes; the other solver setters do not affect the lanes.
+        reset copies the solver state to all lanes again. Lanes are not
+        checkpointed. n = 0 goes back to a single instance.
+
+        Syntax::
+
+            setNLanes(n)
+
+        Arguments:
+        uint n
+
+        Return:
+        None
+
+        """
+        self.ptrx().setNLanes(n)
+
+    def getNLanes(self):
+        """
+        Returns the number of lanes, 0 if lanes are not used.
+
+        Syntax::
+
+            getNLanes()
+
+        Arguments:
+        None
+
+        Return:
+        uint
+
+        """
+        return self.ptrx().getNLanes()
+
+    def getLaneCompCount(self, uint lane, str c, str s):
+        """
+        Returns the number of molecules of species s in compartment c in a lane.
+
+        Syntax::
+
+            getLaneCompCount(lane, c, s)
+
+        Arguments:
+        uint lane
+        string c
+        string s
+
+        Return:
+        float
+
+        """
+        return self.ptrx().getLaneCompCount(lane, to_std_string(c), to_std_string(s))
+
+    def setLaneCompCount(self, uint lane, str c, str s, double n):
+        """
+        Sets the number of molecules of species s in compartment c in a lane.
+
+        Syntax::
+
+            setLaneCompCount(lane, c, s, n)
+
+        Arguments:
+        uint lane
+        string c
+        string s
+        float n
+
+        Return:
+        None
+
+        """
+        self.ptrx().setLaneCompCount(lane, to_std_string(c), to_std_string(s), n)
+
+    def getLanePatchCount(self, uint lane, str p, str s):
+        """
+        Returns the number of molecules of species s in patch p in a lane.
+
+        Syntax::
+
+            getLanePatchCount(lane, p, s)
+
+        Arguments:
+        uint lane
+        string p
+        string s
+
+        Return:
+        float
+
+        """
+        return self.ptrx().getLanePatchCount(lane, to_std_string(p), to_std_string(s))
+
+    def setLanePatchCount(self, uint lane, str p, str s, double n):
+        """
+        Sets the number of molecules of species s in patch p in a lane.
+
+        Syntax::
+
+            setLanePatchCount(lane, p, s, n)
+
+        Arguments:
+        uint lane
+        string p
+        string s
+        float n
+
+        Return:
+        None
+
+        """
+        self.ptrx().setLanePatchCount(lane, to_std_string(p), to_std_string(s), n)
+
+    def setLaneCompReacK(self, uint lane, str c, str r, double kf):
+        """
+        Sets the macroscopic reaction constant of reaction r in compartment c in a lane.
+
+        Syntax::
+
+            setLaneCompReacK(lane, c, r, kf)
+
+        Arguments:
+        uint lane
+        string c
+        string r
+        float kf
+
+        Return:
+        None
+
+        """
+        self.ptrx().setLaneCompReacK(lane, to_std_string(c), to_std_string(r), kf)
+
+    def setLanePatchSReacK(self, uint lane, str p, str sr, double kf):
+        """
+        Sets the macroscopic reaction constant of surface reaction sr in patch p in a lane.
+
+        Syntax::
+
+            setLanePatchSReacK(lane, p, sr, kf)
+
+        Arguments:
+        uint lane
+        string p
+        string sr
+        float kf
+
+        Return:
+        None
+
+        """
+        self.ptrx().setLanePatchSReacK(lane, to_std_string(p), to_std_string(sr), kf)
+
     def getTime(self, ):
         """
         Returns the current simulation time in seconds.
@@ -946,20 +1169,27 @@ cdef class _py_Tetexact(_py_TetAPI):
     cdef Tetexact *ptrx(self):
         return <Tetexact*> self._ptr
 
-    def __init__(self, _py_Model m, _py_Geom g, _py_RNG r, int calcMembPot=0):
+    #Constants
+    CR_SCHEDULE_DEFAULT = steps_tetexact.CR_SCHEDULE_DEFAULT
+    CR_SCHEDULE_FLAT    = steps_tetexact.CR_SCHEDULE_FLAT
+
+    def __init__(self, _py_Model m, _py_Geom g, _py_RNG r, int calcMembPot=0, int crSchedule=0):
         """        
         Construction::
         
-            sim = steps.solver.Tetexact(model, geom, rng, calcMembPot = 0)
+            sim = steps.solver.Tetexact(model, geom, rng, calcMembPot = 0, crSchedule = 0)
         
         Create a spatial stochastic solver based on Gillespie's SSA, extended with diffusion across elements in a tetrahedral mesh.
         If voltage is to be simulated, argument calcMemPot=1 will set to the default solver. calcMembPot=0 means voltage will not be simulated. 
+        crSchedule selects the memory layout of the composition-rejection schedule: CR_SCHEDULE_DEFAULT (0) or
+        CR_SCHEDULE_FLAT (1), which stores rates contiguously per group and gives identical results for the same seed.
         
         Arguments:
         steps.model.Model model
         steps.geom.Geom geom
         steps.rng.RNG rng
         int calcMemPot (default=0)
+        int crSchedule (default=0)
         
         """
         if m == None:
@@ -968,7 +1198,7 @@ cdef class _py_Tetexact(_py_TetAPI):
             raise TypeError('The Geom object is empty.')
         if r == None:
             raise TypeError('The RNG object is empty.')
-        self._ptr = new Tetexact(m.ptr(), g.ptr(), r.ptr(), calcMembPot)
+        self._ptr = new Tetexact(m.ptr(), g.ptr(), r.ptr(), calcMembPot, crSchedule)
         _py_API.__init__(self, m, g, r)
 
     def getSolverName(self, ):
@@ -1244,6 +1474,43 @@ cdef class _py_Tetexact(_py_TetAPI):
         """
         self.ptrx().saveMembOpt(to_std_string(opt_file_name))
 
+    def setEfieldVTolerance(self, double tol):
+        """
+        Set the potential change (in volts) of a membrane triangle below which
+        its voltage-dependent rates are not recomputed after an EField step.
+        The default of 0 recomputes them whenever the potential changes.
+
+        Syntax::
+
+            setEfieldVTolerance(tol)
+
+        Arguments:
+        float tol
+
+        Return:
+        None
+
+        """
+        self.ptrx().setEfieldVTolerance(tol)
+
+    def getEfieldVTolerance(self, ):
+        """
+        Returns the potential tolerance for the update of voltage-dependent
+        rates after an EField step (in volts).
+
+        Syntax::
+
+            getEfieldVTolerance()
+
+        Arguments:
+        None
+
+        Return:
+        float
+
+        """
+        return self.ptrx().getEfieldVTolerance()
+
     def getTime(self, ):
         """
         Returns the current simulation time in seconds.
@@ -2191,6 +2458,43 @@ cdef class _py_TetODE(_py_TetAPI):
         """
         self.ptrx().setMaxNumSteps(maxn)
 
+    def setStiff(self, bool stiff):
+        """
+        Choose the CVODE integration method. By default the Adams-Moulton
+        method with functional iteration is used. For stiff systems, the BDF
+        method with Newton iteration is used instead, with a preconditioned
+        Krylov linear solver.
+
+        Syntax::
+
+            setStiff(stiff)
+
+        Arguments:
+        bool stiff
+
+        Return:
+        None
+
+        """
+        self.ptrx().setStiff(stiff)
+
+    def getStiff(self):
+        """
+        Returns True if the BDF method with Newton iteration is used.
+
+        Syntax::
+
+            getStiff()
+
+        Arguments:
+        None
+
+        Return:
+        bool
+
+        """
+        return self.ptrx().getStiff()
+
 
     @staticmethod
     cdef _py_TetODE from_ptr(TetODE *ptr):
@@ -2203,6 +2507,258 @@ cdef class _py_TetODE(_py_TetAPI):
         return _py_TetODE.from_ptr(<TetODE*>&ref)
 
 
+# ======================================================================================================================
+# Python bindings to namespace steps::ensemble
+# ======================================================================================================================
+cimport steps_ensemble
+
+cdef steps_ensemble.WmSolverType _wm_ensemble_solver(str solver) except *:
+    if solver == 'Wmdirect':
+        return steps_ensemble.ENSEMBLE_WMDIRECT
+    if solver == 'Wmrssa':
+        return steps_ensemble.ENSEMBLE_WMRSSA
+    if solver == 'Wmrk4':
+        return steps_ensemble.ENSEMBLE_WMRK4
+    raise ValueError('Unknown ensemble solver: ' + solver)
+
+cdef steps_ensemble.WmOverrideType _wm_ensemble_override(str otype) except *:
+    if otype == 'CompCount':
+        return steps_ensemble.OVERRIDE_COMP_COUNT
+    if otype == 'PatchCount':
+        return steps_ensemble.OVERRIDE_PATCH_COUNT
+    if otype == 'CompReacK':
+        return steps_ensemble.OVERRIDE_COMP_REAC_K
+    if otype == 'PatchSReacK':
+        return steps_ensemble.OVERRIDE_PATCH_SREAC_K
+    raise ValueError('Unknown ensemble override: ' + otype)
+
+# ----------------------------------------------------------------------------------------------------------------------
+cdef class _py_WmEnsemble(_py__base):
+    "Python wrapper class for WmEnsemble"
+# ----------------------------------------------------------------------------------------------------------------------
+    cdef _py_Model model
+    cdef _py_Geom geom
+
+    cdef steps_ensemble.WmEnsemble *ptr(self):
+        return <steps_ensemble.WmEnsemble*> self._ptr
+
+    def __init__(self, _py_Model m, _py_Geom g, str solver, str rng_name = 'mt19937', uint rng_bufsize = 512):
+        """
+        Construction::
+
+            ens = steps.solver.WmEnsemble(model, geom, solver, rng_name = 'mt19937', rng_bufsize = 512)
+
+        Create an ensemble of independent realisations of a well-mixed model, run
+        concurrently on the OpenMP threads.
+
+        Arguments:
+        steps.model.Model model
+        steps.geom.Geom geom
+        string solver ('Wmdirect', 'Wmrssa' or 'Wmrk4')
+        string rng_name
+        uint rng_bufsize
+        """
+        if m == None:
+            raise TypeError('The Model object is empty.')
+        if g == None:
+            raise TypeError('The Geom object is empty.')
+
+        self._ptr = new steps_ensemble.WmEnsemble(m.ptr(), g.ptr(), _wm_ensemble_solver(solver),
+                                                  to_std_string(rng_name), rng_bufsize)
+        self.model = m
+        self.geom = g
+
+    def __dealloc__(self):
+        del self.ptr()
+
+    def addCompCount(self, str c, str s):
+        """
+        Record the count of species s in compartment c.
+
+        Syntax::
+
+            addCompCount(c, s)
+
+        Arguments:
+        string c
+        string s
+
+        Return:
+        None
+
+        """
+        self.ptr().addCompCount(to_std_string(c), to_std_string(s))
+
+    def addPatchCount(self, str p, str s):
+        """
+        Record the count of species s in patch p.
+
+        Syntax::
+
+            addPatchCount(p, s)
+
+        Arguments:
+        string p
+        string s
+
+        Return:
+        None
+
+        """
+        self.ptr().addPatchCount(to_std_string(p), to_std_string(s))
+
+    def countObservables(self):
+        """
+        Returns the number of recorded quantities.
+
+        Syntax::
+
+            countObservables()
+
+        Arguments:
+        None
+
+        Return:
+        uint
+
+        """
+        return self.ptr().countObservables()
+
+    def setCompCount(self, str c, str s, double n):
+        """
+        Set the initial count of species s in compartment c for all instances.
+
+        Syntax::
+
+            setCompCount(c, s, n)
+
+        Arguments:
+        string c
+        string s
+        float n
+
+        Return:
+        None
+
+        """
+        self.ptr().setCompCount(to_std_string(c), to_std_string(s), n)
+
+    def setPatchCount(self, str p, str s, double n):
+        """
+        Set the initial count of species s in patch p for all instances.
+
+        Syntax::
+
+            setPatchCount(p, s, n)
+
+        Arguments:
+        string p
+        string s
+        float n
+
+        Return:
+        None
+
+        """
+        self.ptr().setPatchCount(to_std_string(p), to_std_string(s), n)
+
+    def setCompReacK(self, str c, str r, double kf):
+        """
+        Set the rate constant of reaction r in compartment c for all instances.
+
+        Syntax::
+
+            setCompReacK(c, r, kf)
+
+        Arguments:
+        string c
+        string r
+        float kf
+
+        Return:
+        None
+
+        """
+        self.ptr().setCompReacK(to_std_string(c), to_std_string(r), kf)
+
+    def setPatchSReacK(self, str p, str sr, double kf):
+        """
+        Set the rate constant of surface reaction sr in patch p for all instances.
+
+        Syntax::
+
+            setPatchSReacK(p, sr, kf)
+
+        Arguments:
+        string p
+        string sr
+        float kf
+
+        Return:
+        None
+
+        """
+        self.ptr().setPatchSReacK(to_std_string(p), to_std_string(sr), kf)
+
+    def setRk4DT(self, double dt):
+        """
+        Set the time step of the instances of a Wmrk4 ensemble.
+
+        Syntax::
+
+            setRk4DT(dt)
+
+        Arguments:
+        float dt
+
+        Return:
+        None
+
+        """
+        self.ptr().setRk4DT(dt)
+
+    def run(self, seeds, tpnts, double[:] counts, overrides = None):
+        """
+        Run one instance per seed and record the counts at each time point.
+
+        overrides is either None or a list with, for each instance, a list of
+        (type, loc, id, value) tuples, where type is 'CompCount', 'PatchCount',
+        'CompReacK' or 'PatchSReacK'. They are applied after the parameters
+        common to all instances.
+
+        Syntax::
+
+            run(seeds, tpnts, counts, overrides = None)
+
+        Arguments:
+        list<uint> seeds
+        list<float> tpnts
+        numpy.array<float, length = len(seeds) * len(tpnts) * countObservables()> counts
+        list<list<tuple>> overrides
+
+        Return:
+        None
+
+        """
+        cdef std.vector[uint] _seeds = seeds
+        cdef std.vector[double] _tpnts = tpnts
+        cdef std.vector[std.vector[steps_ensemble.WmOverride]] _overrides
+        cdef steps_ensemble.WmOverride o
+        cdef double *_counts = &counts[0] if counts.shape[0] > 0 else NULL
+        cdef size_t _size = counts.shape[0]
+        if overrides is not None:
+            _overrides.resize(len(overrides))
+            for i, instance in enumerate(overrides):
+                for otype, loc, oid, value in instance:
+                    o.type = _wm_ensemble_override(otype)
+                    o.loc = to_std_string(loc)
+                    o.id = to_std_string(oid)
+                    o.value = value
+                    _overrides[i].push_back(o)
+        with nogil:
+            self.ptr().run(_seeds, _tpnts, _counts, _size, _overrides)
+
+
 # ======================================================================================================================
 # Python bindings to namespace steps::solver
 # ======================================================================================================================
@@ -3351,6 +3907,7 @@ cdef class _py_TetAPI(_py_API):
     EF_DEFAULT   = steps_solver.EF_DEFAULT
     EF_DV_BDSYS  = steps_solver.EF_DV_BDSYS
     EF_DV_PETSC  = steps_solver.EF_DV_PETSC
+    EF_DV_PCG    = steps_solver.EF_DV_PCG
 
     # ---- VIRTUAL - doesnt call original constructor ------
     def __init__(self, _py_Model m, _py_Geom g, _py_RNG r):
@@ -31,6 +31,7 @@ EF_NONE = stepslib._py_TetAPI.EF_NONE
 EF_DEFAULT = stepslib._py_TetAPI.EF_DEFAULT
 EF_DV_BDSYS = stepslib._py_TetAPI.EF_DV_BDSYS
 EF_DV_PETSC  = stepslib._py_TetAPI.EF_DV_PETSC
+EF_DV_PCG = stepslib._py_TetAPI.EF_DV_PCG
 
 
 # --------------------------------------------------------------------
@@ -196,20 +197,52 @@ class Wmrssa(stepslib._py_Wmrssa, _Base_Solver):
         return self._getIndexMapping()
         
         
+class WmEnsemble(stepslib._py_WmEnsemble):
+    """
+    Construction::
+
+        ens = steps.solver.WmEnsemble(model, geom, solver, rng_name = 'mt19937', rng_bufsize = 512)
+
+    Create an ensemble of independent realisations of a well-mixed model,
+    run concurrently on the OpenMP threads. Each instance has its own solver
+    ('Wmdirect', 'Wmrssa' or 'Wmrk4') and its own RNG, initialized with the
+    seed of the instance.
+
+    Arguments:
+    steps.model.Model model
+    steps.geom.Geom geom
+    string solver
+    string rng_name
+    uint rng_bufsize
+    """
+    def runNP(self, seeds, tpnts, overrides = None):
+        """
+        Run one instance per seed and return the recorded counts as a numpy
+        array of shape (len(seeds), len(tpnts), countObservables()).
+        """
+        import numpy
+        counts = numpy.zeros(len(seeds) * len(tpnts) * self.countObservables())
+        self.run(seeds, tpnts, counts, overrides)
+        return counts.reshape((len(seeds), len(tpnts), self.countObservables()))
+
+
 class Tetexact(stepslib._py_Tetexact, _Base_Solver):
     """
     Construction::
     
-        sim = steps.solver.Tetexact(model, geom, rng, calcMembPot = 0)
+        sim = steps.solver.Tetexact(model, geom, rng, calcMembPot = 0, crSchedule = 0)
     
     Create a spatial stochastic solver based on Gillespie's SSA, extended with diffusion across elements in a tetrahedral mesh.
     If voltage is to be simulated, argument calcMemPot=1 will set to the default solver. calcMembPot=0 means voltage will not be simulated. 
+    crSchedule selects the memory layout of the composition-rejection schedule: CR_SCHEDULE_DEFAULT (0) or
+    CR_SCHEDULE_FLAT (1), which stores rates contiguously per group and gives identical results for the same seed.
     
     Arguments:
     steps.model.Model model
     steps.geom.Geom geom
     steps.rng.RNG rng
     int calcMemPot (default=0)
+    int crSchedule (default=0)
     
     """
     def run(self, end_time, cp_interval = 0.0, prefix = ""):
@@ -835,6 +835,8 @@ class Membrane(_PhysicalLocation, nutils.Facade):
     1. principal axis ordering (quick to set up but usually results in slower simulation than
        method 2).
     2. breadth first search (can be time-consuming to set up, but usually faster simulation.
+    3. reverse Cuthill-McKee from a few pseudo-peripheral start points (fast to set up, bandwidth
+       similar to method 2, *search_percent* is ignored).
 
     If breadth first search is chosen then argument *search_percent* can specify the number of
     starting points to search for the lowest bandwidth.
@@ -74,6 +74,7 @@ if stepslib._STEPS_USE_DIST_MESH:
     class NextEventSearchMethod(enum.IntEnum):
         DIRECT = stepslib._py_SearchMethod.DIRECT
         GIBSON_BRUCK = stepslib._py_SearchMethod.GIBSON_BRUCK
+        DIRECT_SUM_TREE = stepslib._py_SearchMethod.DIRECT_SUM_TREE
 
 
     __all__ +=  ['KSPNorm', 'SSAMethod', 'NextEventSearchMethod']
@@ -949,6 +950,9 @@ class MPI:
     EF_DV_PETSC = stepslib._py_TetAPI.EF_DV_PETSC
     """Possible value for the calcMembPot parameter of solvers that implement EField.
     Means that parallel PETSc EField solver should be used."""
+    EF_DV_PCG = stepslib._py_TetAPI.EF_DV_PCG
+    """Possible value for the calcMembPot parameter of solvers that implement EField.
+    Means that the serial sparse preconditioned conjugate gradient EField solver should be used."""
 
     _usingMPI = None
     _shouldWrite = True
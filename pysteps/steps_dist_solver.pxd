@@ -53,6 +53,9 @@ cdef extern from "mpi/dist/tetopsplit/fwd.hpp" namespace "steps::dist":
     cdef cppclass NextEventSearchMethod_GibsonBruck "steps::dist::NextEventSearchMethod::GibsonBruck":
         pass
 
+    cdef cppclass NextEventSearchMethod_DirectSumTree "steps::dist::NextEventSearchMethod::DirectSumTree":
+        pass
+
 
 # ======================================================================================================================
 cdef extern from "mpi/dist/tetopsplit/tetopsplit.hpp" namespace "steps::dist":
@@ -98,6 +101,8 @@ cdef extern from "mpi/dist/tetopsplit/tetopsplit.hpp" namespace "steps::dist":
 
         void setDiffApplyThreshold(int) except +
         int getDiffApplyThreshold() except +
+        void setCounterBasedRNG(unsigned long) except +
+        void setDiffHaloExchangeOverlap(bool) except +
 
         unsigned long long getReacExtent(bool) except +
         unsigned long long getDiffExtent(bool) except +
@@ -0,0 +1,43 @@
+###___license_placeholder___###
+
+from libcpp cimport bool
+cimport std
+cimport steps_model
+cimport steps_wm
+from steps_common cimport *
+
+
+# ======================================================================================================================
+cdef extern from "ensemble/wmensemble.hpp" namespace "steps::ensemble":
+# ----------------------------------------------------------------------------------------------------------------------
+
+    cdef enum WmSolverType:
+        ENSEMBLE_WMDIRECT "steps::ensemble::WmSolverType::Wmdirect",
+        ENSEMBLE_WMRSSA "steps::ensemble::WmSolverType::Wmrssa",
+        ENSEMBLE_WMRK4 "steps::ensemble::WmSolverType::Wmrk4"
+
+    cdef enum WmOverrideType "steps::ensemble::WmOverride::Type":
+        OVERRIDE_COMP_COUNT "steps::ensemble::WmOverride::Type::CompCount",
+        OVERRIDE_PATCH_COUNT "steps::ensemble::WmOverride::Type::PatchCount",
+        OVERRIDE_COMP_REAC_K "steps::ensemble::WmOverride::Type::CompReacK",
+        OVERRIDE_PATCH_SREAC_K "steps::ensemble::WmOverride::Type::PatchSReacK"
+
+    ###### Cybinding for WmOverride ######
+    cdef cppclass WmOverride:
+        WmOverrideType type
+        std.string loc
+        std.string id
+        double value
+
+    ###### Cybinding for WmEnsemble ######
+    cdef cppclass WmEnsemble:
+        WmEnsemble(steps_model.Model*, steps_wm.Geom*, WmSolverType, std.string, uint) except +
+        void addCompCount(std.string, std.string) except +
+        void addPatchCount(std.string, std.string) except +
+        uint countObservables()
+        void setCompCount(std.string, std.string, double) except +
+        void setPatchCount(std.string, std.string, double) except +
+        void setCompReacK(std.string, std.string, double) except +
+        void setPatchSReacK(std.string, std.string, double) except +
+        void setRk4DT(double) except +
+        void run(std.vector[uint], std.vector[double], double*, size_t, std.vector[std.vector[WmOverride]]) nogil except +
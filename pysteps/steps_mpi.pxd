@@ -203,10 +203,14 @@ cdef extern from "mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::tetopspl
         void getBatchTriCountsNP(steps.index_t*, int, std.string, double*, int) except +
         void setBatchTetConcsNP(steps.index_t*, size_t, std.string, double*, size_t) except +
         void getBatchTetConcsNP(steps.index_t*, size_t, std.string, double*, size_t) except +
+        void setBatchTetCountsNP(steps.index_t*, size_t, std.string, double*, size_t) except +
+        void setBatchTriCountsNP(steps.index_t*, size_t, std.string, double*, size_t) except +
         std.vector[double] getROITetCounts(std.string, std.string) except +
         std.vector[double] getROITriCounts(std.string, std.string) except +
         void getROITetCountsNP(std.string, std.string, double*, int) except +
         void getROITriCountsNP(std.string, std.string, double*, int) except +
+        void setROITetCountsNP(std.string, std.string, double*, size_t) except +
+        void setROITriCountsNP(std.string, std.string, double*, size_t) except +
         double getROIVol(std.string) except +
         double getROIArea(std.string) except +
         double getROICount(std.string, std.string) except +
@@ -241,6 +245,8 @@ cdef extern from "mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::tetopspl
         void getBatchTriBatchOhmicIsNP(steps.index_t*, int, std.vector[std.string], double*, int) except +
         void getBatchTriBatchGHKIsNP(steps.index_t*, int, std.vector[std.string], double*, int) except +
         void setDiffApplyThreshold(int) except +
+        void setMultiRateDiffusion(uint) except +
+        uint getMultiRateDiffusion() except +
         unsigned long long getReacExtent(bool) except +
         unsigned long long getDiffExtent(bool) except +
         double getNIteration() except +
@@ -46,10 +46,10 @@ cdef extern from "rng/rng.hpp" namespace "steps::rng":
         double getUnfIE()
         double getUnfEE()
         double getUnfIE53()
-        float getStdExp()
+        double getStdExp()
         double getExp(double)
-        long getPsn(float)
-        float getStdNrm()
+        long getPsn(double)
+        double getStdNrm()
         uint getBinom(uint, double)
 
 
@@ -182,6 +182,7 @@ cdef extern from "solver/api.hpp" namespace "steps::solver::API":
         EF_DEFAULT
         EF_DV_BDSYS
         EF_DV_PETSC
+        EF_DV_PCG
 
 
 # ======================================================================================================================
@@ -18,6 +18,14 @@ from steps_common cimport *
 from steps cimport index_t
 
 
+# ======================================================================================================================
+cdef extern from "tetexact/tetexact.hpp" namespace "steps::tetexact::Tetexact":
+# ----------------------------------------------------------------------------------------------------------------------
+    enum CR_schedule:
+        CR_SCHEDULE_DEFAULT
+        CR_SCHEDULE_FLAT
+
+
 # ======================================================================================================================
 cdef extern from "tetexact/tetexact.hpp" namespace "steps::tetexact":
 # ----------------------------------------------------------------------------------------------------------------------
@@ -32,7 +40,7 @@ cdef extern from "tetexact/tetexact.hpp" namespace "steps::tetexact":
     ###### Cybinding for Tetexact ######
     cdef cppclass Tetexact:
         # Heavily modified by Iain
-        Tetexact(steps_model.Model*, steps_wm.Geom*, shared_ptr[steps_rng.RNG], int) except +
+        Tetexact(steps_model.Model*, steps_wm.Geom*, shared_ptr[steps_rng.RNG], int, int) except +
         std.string getSolverName() except +
         std.string getSolverDesc() except +
         std.string getSolverAuthors() except +
@@ -195,3 +203,5 @@ cdef extern from "tetexact/tetexact.hpp" namespace "steps::tetexact":
         unsigned long long getROIDiffExtent(std.string, std.string) except +
         void resetROIDiffExtent(std.string, std.string) except +
         void saveMembOpt(std.string) except +
+        void setEfieldVTolerance(double) except +
+        double getEfieldVTolerance()
@@ -163,6 +163,7 @@ cdef extern from "geom/tetmesh.hpp" namespace "steps::tetmesh":
         std.vector[steps.index_t] getTetTriNeighb(steps.index_t) except +
         std.vector[steps.index_t] getTetTetNeighb(steps.index_t) except +
         steps.tetrahedron_id_t findTetByPoint(std.vector[double]) except +
+        void findTetsByPointsNP(double*, int, steps.index_t*, int) except +
         std.vector[double] getBoundMin() except +
         std.vector[double] getBoundMax() except +
         double getMeshVolume() except +
@@ -226,3 +227,9 @@ cdef extern from "geom/tetmesh.hpp" namespace "steps::tetmesh":
         void setBarTris(steps.index_t bidx, steps.index_t itriidx, steps.index_t otriidx) except +
         std.vector[std.vector[std.pair[steps.index_t, double]]] intersect(const double*, int) except+
         std.vector[std.vector[std.pair[steps.index_t, double]]] intersect(const double*, int, int) except+
+
+# ======================================================================================================================
+cdef extern from "geom/tetmesh_rw.hpp" namespace "steps::tetmesh":
+# ----------------------------------------------------------------------------------------------------------------------
+    Tetmesh* loadBinary(std.string) except +
+    void saveBinary(std.string, Tetmesh*) except +
@@ -36,6 +36,17 @@ cdef extern from "wmrk4/wmrk4.hpp" namespace "steps::wmrk4":
         void step() except +
         void setDT(double) except +
         void setRk4DT(double) except +
+        void setIntegrator(std.string) except +
+        std.string getIntegrator() except +
+        void setTolerances(double, double) except +
+        void setNLanes(uint) except +
+        uint getNLanes()
+        double getLaneCompCount(uint, std.string, std.string) except +
+        void setLaneCompCount(uint, std.string, std.string, double) except +
+        double getLanePatchCount(uint, std.string, std.string) except +
+        void setLanePatchCount(uint, std.string, std.string, double) except +
+        void setLaneCompReacK(uint, std.string, std.string, double) except +
+        void setLanePatchSReacK(uint, std.string, std.string, double) except +
         double getTime() except +
         void checkpoint(std.string) except +
         void restore(std.string) except +
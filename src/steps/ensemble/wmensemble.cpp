@@ -0,0 +1,340 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+// Standard library & STL headers.
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+// logging
+#include <easylogging++.h>
+
+// STEPS headers.
+#include "wmensemble.hpp"
+#include "rng/create.hpp"
+#include "util/error.hpp"
+#include "wmdirect/wmdirect.hpp"
+#include "wmrk4/wmrk4.hpp"
+#include "wmrssa/wmrssa.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace ensemble {
+
+////////////////////////////////////////////////////////////////////////////////
+
+WmEnsemble::WmEnsemble(steps::model::Model *m, steps::wm::Geom *g, WmSolverType solver,
+                       std::string rng_name, uint rng_bufsize)
+: pModel(m)
+, pGeom(g)
+, pSolverType(solver)
+, pRNGName(std::move(rng_name))
+, pRNGBufsize(rng_bufsize)
+{
+    ArgErrLogIf(pModel == nullptr, "No model provided to ensemble initializer function.");
+    ArgErrLogIf(pGeom == nullptr, "No geometry provided to ensemble initializer function.");
+
+    // also checks the RNG name
+    auto r = rng::create(pRNGName, pRNGBufsize);
+    r->initialize(0);
+    pCheckSolver = _createSolver(r);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<steps::solver::API> WmEnsemble::_createSolver(rng::RNGptr const & r) const
+{
+    switch (pSolverType) {
+    case WmSolverType::Wmdirect:
+        return std::make_unique<steps::wmdirect::Wmdirect>(pModel, pGeom, r);
+    case WmSolverType::Wmrssa:
+        return std::make_unique<steps::wmrssa::Wmrssa>(pModel, pGeom, r);
+    case WmSolverType::Wmrk4: {
+        auto solver = std::make_unique<steps::wmrk4::Wmrk4>(pModel, pGeom, r);
+        if (pRk4DT > 0.0) solver->setRk4DT(pRk4DT);
+        return solver;
+    }
+    }
+    AssertLog(false);
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::addCompCount(std::string const & c, std::string const & s)
+{
+    // throws if c or s are unknown
+    pCheckSolver->getCompCount(c, s);
+    pObservables.push_back({false, c, s});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::addPatchCount(std::string const & p, std::string const & s)
+{
+    // throws if p or s are unknown
+    pCheckSolver->getPatchCount(p, s);
+    pObservables.push_back({true, p, s});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::setCompCount(std::string const & c, std::string const & s, double n)
+{
+    WmOverride o{WmOverride::Type::CompCount, c, s, n};
+    _check(o);
+    pOverrides.push_back(std::move(o));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::setPatchCount(std::string const & p, std::string const & s, double n)
+{
+    WmOverride o{WmOverride::Type::PatchCount, p, s, n};
+    _check(o);
+    pOverrides.push_back(std::move(o));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::setCompReacK(std::string const & c, std::string const & r, double kf)
+{
+    WmOverride o{WmOverride::Type::CompReacK, c, r, kf};
+    _check(o);
+    pOverrides.push_back(std::move(o));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::setPatchSReacK(std::string const & p, std::string const & sr, double kf)
+{
+    WmOverride o{WmOverride::Type::PatchSReacK, p, sr, kf};
+    _check(o);
+    pOverrides.push_back(std::move(o));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::setRk4DT(double dt)
+{
+    ArgErrLogIf(pSolverType != WmSolverType::Wmrk4,
+                "The time step can only be set for Wmrk4 ensembles.");
+    // throws if dt is negative
+    pCheckSolver->setRk4DT(dt);
+    pRk4DT = dt;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::_apply(steps::solver::API & solver, WmOverride const & o)
+{
+    switch (o.type) {
+    case WmOverride::Type::CompCount:
+        solver.setCompCount(o.loc, o.id, o.value);
+        break;
+    case WmOverride::Type::PatchCount:
+        solver.setPatchCount(o.loc, o.id, o.value);
+        break;
+    case WmOverride::Type::CompReacK:
+        solver.setCompReacK(o.loc, o.id, o.value);
+        break;
+    case WmOverride::Type::PatchSReacK:
+        solver.setPatchSReacK(o.loc, o.id, o.value);
+        break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::_check(WmOverride const & o) const
+{
+    // the solver throws on unknown names and invalid values
+    _apply(*pCheckSolver, o);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::run(std::vector<uint> const & seeds, std::vector<double> const & tpnts,
+                     double * counts, std::size_t counts_size,
+                     std::vector<std::vector<WmOverride>> const & overrides)
+{
+    const std::size_t ninstances = seeds.size();
+    const std::size_t ntpnts = tpnts.size();
+    const std::size_t nobs = pObservables.size();
+
+    if (counts_size != ninstances * ntpnts * nobs) {
+        std::ostringstream os;
+        os << "Size of the counts array (" << counts_size << ") does not match the number of "
+           << "instances x time points x recorded quantities (" << ninstances * ntpnts * nobs
+           << ").";
+        ArgErrLog(os.str());
+    }
+    ArgErrLogIf(!overrides.empty() && overrides.size() != ninstances,
+                "Overrides must be given for all instances or none.");
+    ArgErrLogIf(!std::is_sorted(tpnts.begin(), tpnts.end()),
+                "Time points must be in ascending order.");
+    ArgErrLogIf(!tpnts.empty() && tpnts.front() < 0.0, "Time points cannot be negative.");
+    ArgErrLogIf(pSolverType == WmSolverType::Wmrk4 && pRk4DT <= 0.0,
+                "The time step of Wmrk4 ensembles must be set before running them.");
+    for (auto const & instance: overrides) {
+        for (auto const & o: instance) {
+            _check(o);
+        }
+    }
+
+    if (pSolverType == WmSolverType::Wmrk4) {
+        _runLanes(ninstances, tpnts, counts, overrides);
+    } else {
+        _runInstances(seeds, tpnts, counts, overrides);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::_runInstances(std::vector<uint> const & seeds, std::vector<double> const & tpnts,
+                               double * counts,
+                               std::vector<std::vector<WmOverride>> const & overrides) const
+{
+    const std::size_t ntpnts = tpnts.size();
+    const std::size_t nobs = pObservables.size();
+    std::exception_ptr error;
+    const auto ni = static_cast<long>(seeds.size());
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long i = 0; i < ni; ++i)
+    {
+        try {
+            auto r = rng::create(pRNGName, pRNGBufsize);
+            r->initialize(seeds[i]);
+            auto solver = _createSolver(r);
+
+            for (auto const & o: pOverrides) {
+                _apply(*solver, o);
+            }
+            if (!overrides.empty()) {
+                for (auto const & o: overrides[i]) {
+                    _apply(*solver, o);
+                }
+            }
+
+            double * out = counts + static_cast<std::size_t>(i) * ntpnts * nobs;
+            for (auto t: tpnts) {
+                solver->run(t);
+                for (auto const & obs: pObservables) {
+                    *out++ = obs.patch ? solver->getPatchCount(obs.loc, obs.spec)
+                                       : solver->getCompCount(obs.loc, obs.spec);
+                }
+            }
+        }
+        catch (...) {
+            #pragma omp critical(steps_ensemble_wmensemble_run)
+            if (!error) error = std::current_exception();
+        }
+    }
+
+    if (error) std::rethrow_exception(error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::_applyLane(steps::wmrk4::Wmrk4 & solver, uint lane, WmOverride const & o)
+{
+    switch (o.type) {
+    case WmOverride::Type::CompCount:
+        solver.setLaneCompCount(lane, o.loc, o.id, o.value);
+        break;
+    case WmOverride::Type::PatchCount:
+        solver.setLanePatchCount(lane, o.loc, o.id, o.value);
+        break;
+    case WmOverride::Type::CompReacK:
+        solver.setLaneCompReacK(lane, o.loc, o.id, o.value);
+        break;
+    case WmOverride::Type::PatchSReacK:
+        solver.setLanePatchSReacK(lane, o.loc, o.id, o.value);
+        break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WmEnsemble::_runLanes(std::size_t ninstances, std::vector<double> const & tpnts,
+                           double * counts,
+                           std::vector<std::vector<WmOverride>> const & overrides) const
+{
+    // number of instances integrated together by one solver
+    constexpr std::size_t block_size = 256;
+
+    const std::size_t ntpnts = tpnts.size();
+    const std::size_t nobs = pObservables.size();
+    std::exception_ptr error;
+    const auto nb = static_cast<long>((ninstances + block_size - 1) / block_size);
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long b = 0; b < nb; ++b)
+    {
+        try {
+            const std::size_t first = static_cast<std::size_t>(b) * block_size;
+            const auto nlanes = static_cast<uint>(std::min(block_size, ninstances - first));
+
+            steps::wmrk4::Wmrk4 solver(pModel, pGeom, nullptr);
+            solver.setRk4DT(pRk4DT);
+            for (auto const & o: pOverrides) {
+                _apply(solver, o);
+            }
+            solver.setNLanes(nlanes);
+            if (!overrides.empty()) {
+                for (uint l = 0; l < nlanes; ++l) {
+                    for (auto const & o: overrides[first + l]) {
+                        _applyLane(solver, l, o);
+                    }
+                }
+            }
+
+            for (std::size_t ti = 0; ti < ntpnts; ++ti) {
+                solver.run(tpnts[ti]);
+                for (uint l = 0; l < nlanes; ++l) {
+                    double * out = counts + ((first + l) * ntpnts + ti) * nobs;
+                    for (auto const & obs: pObservables) {
+                        *out++ = obs.patch ? solver.getLanePatchCount(l, obs.loc, obs.spec)
+                                           : solver.getLaneCompCount(l, obs.loc, obs.spec);
+                    }
+                }
+            }
+        }
+        catch (...) {
+            #pragma omp critical(steps_ensemble_wmensemble_run)
+            if (!error) error = std::current_exception();
+        }
+    }
+
+    if (error) std::rethrow_exception(error);
+}
+
+}} // namespace steps::ensemble
+
+// END
@@ -0,0 +1,208 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_ENSEMBLE_WMENSEMBLE_HPP
+#define STEPS_ENSEMBLE_WMENSEMBLE_HPP 1
+
+
+// STL headers.
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// STEPS headers.
+#include "util/common.h"
+#include "geom/geom.hpp"
+#include "model/model.hpp"
+#include "rng/rng.hpp"
+#include "solver/api.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace wmrk4 {
+class Wmrk4;
+}
+
+namespace ensemble {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Well-mixed solvers an ensemble can be made of.
+enum class WmSolverType
+{
+    Wmdirect,
+    Wmrssa,
+    Wmrk4
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// A parameter of an ensemble instance, set after the solver of the
+/// instance has been created.
+struct WmOverride
+{
+    enum class Type
+    {
+        CompCount,
+        PatchCount,
+        CompReacK,
+        PatchSReacK
+    };
+
+    Type            type;
+    /// Name of the compartment or patch
+    std::string     loc;
+    /// Name of the species, reaction or surface reaction
+    std::string     id;
+    double          value;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Runs many realisations of a well-mixed model concurrently.
+///
+/// Each instance has its own solver and its own RNG, seeded with the seed of
+/// the instance; model and geometry are shared and only read. Instances are
+/// distributed dynamically over the OpenMP threads, so that ensembles of
+/// small models with uneven run times keep all cores busy. The result of an
+/// instance only depends on its seed and parameters, not on the number of
+/// threads.
+///
+/// Wmrk4 instances are deterministic and ignore their seed: they are
+/// integrated as lanes of a few Wmrk4 solvers (see Wmrk4::setNLanes), one
+/// block of instances per thread.
+class WmEnsemble
+{
+
+public:
+
+    /// Constructor
+    ///
+    /// \param m Model
+    /// \param g Well-mixed geometry
+    /// \param solver Solver of the instances
+    /// \param rng_name Name of the RNG of the instances, see rng::create
+    /// \param rng_bufsize Buffer size of the RNG of the instances
+    WmEnsemble(steps::model::Model *m, steps::wm::Geom *g, WmSolverType solver,
+               std::string rng_name = "mt19937", uint rng_bufsize = 512);
+
+    ////////////////////////////////////////////////////////////////////////
+    // RECORDED QUANTITIES
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Record the count of species s in compartment c.
+    void addCompCount(std::string const & c, std::string const & s);
+
+    /// Record the count of species s in patch p.
+    void addPatchCount(std::string const & p, std::string const & s);
+
+    /// Return the number of recorded quantities.
+    inline uint countObservables() const noexcept
+    { return static_cast<uint>(pObservables.size()); }
+
+    ////////////////////////////////////////////////////////////////////////
+    // PARAMETERS COMMON TO ALL INSTANCES
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Set the initial count of species s in compartment c.
+    void setCompCount(std::string const & c, std::string const & s, double n);
+
+    /// Set the initial count of species s in patch p.
+    void setPatchCount(std::string const & p, std::string const & s, double n);
+
+    /// Set the rate constant of reaction r in compartment c.
+    void setCompReacK(std::string const & c, std::string const & r, double kf);
+
+    /// Set the rate constant of surface reaction sr in patch p.
+    void setPatchSReacK(std::string const & p, std::string const & sr, double kf);
+
+    /// Set the time step of the instances, Wmrk4 only.
+    void setRk4DT(double dt);
+
+    ////////////////////////////////////////////////////////////////////////
+    // RUN
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Run one instance per seed and record the counts at each time point.
+    ///
+    /// \param seeds Seed of the RNG of each instance
+    /// \param tpnts Time points, in ascending order
+    /// \param counts Recorded counts, as a C-ordered array of shape
+    ///        [seeds.size()][tpnts.size()][countObservables()]
+    /// \param counts_size Size of counts
+    /// \param overrides Parameters of each instance, applied after the common
+    ///        ones; either empty or of the same size as seeds
+    void run(std::vector<uint> const & seeds, std::vector<double> const & tpnts,
+             double * counts, std::size_t counts_size,
+             std::vector<std::vector<WmOverride>> const & overrides = {});
+
+private:
+
+    struct Observable
+    {
+        bool            patch;
+        std::string     loc;
+        std::string     spec;
+    };
+
+    std::unique_ptr<steps::solver::API> _createSolver(rng::RNGptr const & r) const;
+
+    static void _apply(steps::solver::API & solver, WmOverride const & o);
+
+    static void _applyLane(steps::wmrk4::Wmrk4 & solver, uint lane, WmOverride const & o);
+
+    void _runInstances(std::vector<uint> const & seeds, std::vector<double> const & tpnts,
+                       double * counts,
+                       std::vector<std::vector<WmOverride>> const & overrides) const;
+
+    void _runLanes(std::size_t ninstances, std::vector<double> const & tpnts, double * counts,
+                   std::vector<std::vector<WmOverride>> const & overrides) const;
+
+    void _check(WmOverride const & o) const;
+
+    steps::model::Model                   * pModel;
+    steps::wm::Geom                       * pGeom;
+    WmSolverType                            pSolverType;
+    std::string                             pRNGName;
+    uint                                    pRNGBufsize;
+    double                                  pRk4DT{0.0};
+
+    std::vector<Observable>                 pObservables;
+    std::vector<WmOverride>                 pOverrides;
+
+    // Solver used to check the names of compartments, species, etc. before
+    // running the instances.
+    std::unique_ptr<steps::solver::API>     pCheckSolver;
+};
+
+}} // namespace steps::ensemble
+
+#endif // STEPS_ENSEMBLE_WMENSEMBLE_HPP
+
+// END
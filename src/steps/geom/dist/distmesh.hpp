@@ -8,6 +8,7 @@
 #include <utility>
 
 #include <Omega_h_array_ops.hpp>
+#include <Omega_h_future.hpp>
 #include <Omega_h_mesh.hpp>
 #include <Omega_h_owners.hpp>
 #include <boost/optional.hpp>
@@ -655,6 +656,12 @@ class DistMesh : public steps::wm::Geom {
         return mesh_.sync_array(ent_dim, a, width);
     }
 
+    /// Start syncing the array, the returned future completes the communication
+    template <typename T>
+    osh::Future<T> isync_array(osh::Int ent_dim, osh::Read<T> a, osh::Int width) {
+        return mesh_.isync_array(ent_dim, a, width);
+    }
+
     /// Mapping a2ab from objects of dimension \p from to objects \p to (\f$ from < to \f$)
     inline osh::LOs bounds2elems_a2ab(osh::Int from, osh::Int to) {
         return mesh_.ask_up(from, to).a2ab;
@@ -57,8 +57,8 @@ Memb::Memb(std::string id, Tetmesh *container,
               "No mesh provided to Membrane initializer function.");
   ArgErrLogIf(patches.empty(),
               "No Patches provided to Membrane initializer function.");
-  ArgErrLogIf(pOpt_method != 1 && pOpt_method != 2,
-              "Unknown optimization method. Choices are 1 or 2.");
+  ArgErrLogIf(pOpt_method < 1 || pOpt_method > 3,
+              "Unknown optimization method. Choices are 1, 2 or 3.");
   ArgErrLogIf(pSearch_percent > 100.0,
               "Search percentage is greater than 100.");
   ArgErrLogIf(pSearch_percent <= 0.0,
@@ -252,7 +252,9 @@ Tetmesh::Tetmesh(std::vector<double> const &verts,
                  std::vector<double> const &tet_vols,
                  std::vector<double> const &tet_barycs,
                  std::vector<triangle_id_t> const &tet_tri_neighbs,
-                 std::vector<tetrahedron_id_t> const &tet_tet_neighbs)
+                 std::vector<tetrahedron_id_t> const &tet_tet_neighbs,
+                 std::vector<vertex_id_t> const &bars,
+                 std::vector<bar_id_t> const &tri_bar_ids)
     : pVertsN(), pBarsN(0), pTrisN(0), pTetsN(0), pMembs(), pDiffBoundaries() {
   // check the vectors are of the expected size
 
@@ -289,6 +291,12 @@ Tetmesh::Tetmesh(std::vector<double> const &verts,
   ArgErrLogIf(tet_tet_neighbs.size() != pTetsN * 4,
               "Inconsistent tet_tet_neighbs size");
 
+  ArgErrLogIf(bars.size() % 2, "Inconsistent bars size");
+
+  ArgErrLogIf(bars.empty() != tri_bar_ids.empty() ||
+                  (!tri_bar_ids.empty() && tri_bar_ids.size() != pTrisN * 3),
+              "Inconsistent tri_bar_ids size");
+
   // see comment in other constructor
   srand(time(nullptr));
 
@@ -322,19 +330,35 @@ Tetmesh::Tetmesh(std::vector<double> const &verts,
   pTri_diffboundaries.assign(pTrisN, nullptr);
   pTri_patches.assign(pTrisN, nullptr);
 
-  // use tri data to make pBars, pTriBars.
-  buildBarData();
+  if (tri_bar_ids.empty()) {
+    // use tri data to make pBars, pTriBars.
+    buildBarData();
+  } else {
+    // copy bar information
+    pBarsN = bars.size() / 2;
+    pBars.resize(pBarsN);
+    for (size_t i = 0, j = 0; i < pBarsN; ++i, j += 2) {
+      pBars[i] = bar_verts{{bars[j], bars[j + 1]}};
+    }
+    pTri_bars.resize(pTrisN);
+    for (size_t i = 0, j = 0; i < pTrisN; ++i, j += 3) {
+      pTri_bars[i] =
+          tri_bars{{tri_bar_ids[j], tri_bar_ids[j + 1], tri_bar_ids[j + 2]}};
+      for (auto bar : pTri_bars[i]) {
+        ArgErrLogIf(bar >= pBarsN, "triangle bar index out of range");
+      }
+    }
+    pBar_sdiffboundaries.assign(pBarsN, nullptr);
+    pBar_tri_neighbours.assign(pBarsN, bar_tris{{boost::none, boost::none}});
+  }
 
-  // copy tet information and compute tet barycenters.
+  // copy tet information and barycenters.
   pTets.resize(pTetsN);
   pTet_barycenters.resize(pTetsN);
-  for (size_t i = 0, j = 0; i < pTetsN; ++i, j += 4) {
-    tet_verts tet = {{tets[j], tets[j + 1], tets[j + 2], tets[j + 3]}};
-
-    pTets[i] = tet;
+  for (size_t i = 0, j = 0, k = 0; i < pTetsN; ++i, j += 4, k += 3) {
+    pTets[i] = tet_verts{{tets[j], tets[j + 1], tets[j + 2], tets[j + 3]}};
     pTet_barycenters[i] =
-        steps::math::tet_barycenter(pVerts[tet[0].get()], pVerts[tet[1].get()],
-                                    pVerts[tet[2].get()], pVerts[tet[3].get()]);
+        point3d{tet_barycs[k], tet_barycs[k + 1], tet_barycs[k + 2]};
   }
   pTet_vols = tet_vols;
   for (auto v : pTet_vols) {
@@ -804,8 +828,21 @@ tetrahedron_id_t Tetmesh::findTetByPoint(point3d const &p) const {
     return boost::none;
   }
 
-  for (auto tidx = 0u; tidx < pTetsN; ++tidx) {
-    const tet_verts &v = pTets[tidx];
+  std::call_once(pTetGridOnce, &Tetmesh::buildTetGrid, this);
+
+  index_t cell = 0;
+  for (int d = 2; d >= 0; --d) {
+    const auto n = pTetGrid->ncells[d];
+    auto c = static_cast<index_t>(std::floor((p[d] - pTetGrid->origin[d]) *
+                                             pTetGrid->inv_cell_size[d]));
+    cell = cell * n + std::min(c, n - 1);
+  }
+
+  const auto begin = pTetGrid->cell_start[cell];
+  const auto end = pTetGrid->cell_start[cell + 1];
+  for (auto i = begin; i < end; ++i) {
+    const auto tidx = pTetGrid->cell_tets[i];
+    const tet_verts &v = pTets[tidx.get()];
     if (steps::math::tet_inside(pVerts[v[0].get()], pVerts[v[1].get()],
                                 pVerts[v[2].get()], pVerts[v[3].get()], p)) {
       return tidx;
@@ -817,6 +854,106 @@ tetrahedron_id_t Tetmesh::findTetByPoint(point3d const &p) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Tetmesh::findTetsByPointsNP(const double *coords, size_t coord_size,
+                                 index_t *tets, size_t tet_size) const {
+  ArgErrLogIf(coord_size != 3 * tet_size,
+              "Length of coords array should be 3 times the length of tets array.");
+
+  for (auto i = 0u; i < tet_size; ++i) {
+    point3d x{coords[3 * i], coords[3 * i + 1], coords[3 * i + 2]};
+    tets[i] = findTetByPoint(x).get();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetmesh::buildTetGrid() const {
+  auto grid = std::unique_ptr<TetGrid>(new TetGrid);
+
+  const point3d &bmin = pBBox.min();
+  const point3d extent = pBBox.max() - bmin;
+
+  // Cells about the size of a tetrahedron, but not more cells than twice the
+  // number of tetrahedra for sparse meshes.
+  double mean_size = 0.0;
+  for (auto tidx = 0u; tidx < pTetsN; ++tidx) {
+    mean_size += std::cbrt(pTet_vols[tidx]);
+  }
+  mean_size /= pTetsN;
+  const double bbox_vol = std::max(extent[0], mean_size) *
+                          std::max(extent[1], mean_size) *
+                          std::max(extent[2], mean_size);
+  const double cell_size =
+      std::max(mean_size, std::cbrt(bbox_vol / (2.0 * pTetsN)));
+
+  index_t ncells = 1;
+  for (int d = 0; d < 3; ++d) {
+    grid->ncells[d] = std::max(
+        index_t{1}, static_cast<index_t>(std::ceil(extent[d] / cell_size)));
+    grid->origin[d] = bmin[d];
+    grid->inv_cell_size[d] =
+        extent[d] > 0.0 ? grid->ncells[d] / extent[d] : 0.0;
+    ncells *= grid->ncells[d];
+  }
+
+  // Bounding boxes are slightly enlarged so that points accepted by
+  // tet_inside through rounding errors are still found.
+  const double pad = 1.0e-9 * std::max({extent[0], extent[1], extent[2]});
+  auto cell_range = [&](tetrahedron_id_t tidx, std::array<index_t, 3> &lo,
+                        std::array<index_t, 3> &hi) {
+    const tet_verts &v = pTets[tidx.get()];
+    for (int d = 0; d < 3; ++d) {
+      double vmin = pVerts[v[0].get()][d];
+      double vmax = vmin;
+      for (int k = 1; k < 4; ++k) {
+        vmin = std::min(vmin, pVerts[v[k].get()][d]);
+        vmax = std::max(vmax, pVerts[v[k].get()][d]);
+      }
+      auto to_cell = [&](double x) {
+        double c = std::floor((x - grid->origin[d]) * grid->inv_cell_size[d]);
+        c = std::min(std::max(c, 0.0), static_cast<double>(grid->ncells[d] - 1));
+        return static_cast<index_t>(c);
+      };
+      lo[d] = to_cell(vmin - pad);
+      hi[d] = to_cell(vmax + pad);
+    }
+  };
+
+  // count then fill, tetrahedra in increasing index order
+  grid->cell_start.assign(ncells + 1, 0);
+  std::array<index_t, 3> lo{}, hi{};
+  for (auto tidx = 0u; tidx < pTetsN; ++tidx) {
+    cell_range(tidx, lo, hi);
+    for (auto k = lo[2]; k <= hi[2]; ++k) {
+      for (auto j = lo[1]; j <= hi[1]; ++j) {
+        for (auto i = lo[0]; i <= hi[0]; ++i) {
+          grid->cell_start[(k * grid->ncells[1] + j) * grid->ncells[0] + i + 1]++;
+        }
+      }
+    }
+  }
+  for (auto c = 0u; c < ncells; ++c) {
+    grid->cell_start[c + 1] += grid->cell_start[c];
+  }
+
+  grid->cell_tets.resize(grid->cell_start[ncells]);
+  std::vector<index_t> next(grid->cell_start.begin(), grid->cell_start.end() - 1);
+  for (auto tidx = 0u; tidx < pTetsN; ++tidx) {
+    cell_range(tidx, lo, hi);
+    for (auto k = lo[2]; k <= hi[2]; ++k) {
+      for (auto j = lo[1]; j <= hi[1]; ++j) {
+        for (auto i = lo[0]; i <= hi[0]; ++i) {
+          grid->cell_tets[next[(k * grid->ncells[1] + j) * grid->ncells[0] + i]++] = tidx;
+        }
+      }
+    }
+  }
+
+  pTetGrid = std::move(grid);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 std::vector<double> Tetmesh::getBoundMin() const {
   return as_vector(pBBox.min());
 }
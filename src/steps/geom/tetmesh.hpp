@@ -26,7 +26,10 @@
 
 #pragma once
 
+#include <array>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -164,9 +167,14 @@ public:
             std::vector<index_t> const & tets,
             std::vector<index_t> const & tris = {});
 
-    /// Constructor
+    /// Constructor from precomputed connectivity, nothing is re-derived
+    /// except the triangle barycenters.
     ///
     /// \param verts
+    /// \param bars Vertices of the bars, 2 per bar. If empty, the bars are
+    ///        built from the triangles.
+    /// \param tri_bar_ids Bars of the triangles, 3 per triangle. Must be given
+    ///        together with \a bars.
     Tetmesh(std::vector<double> const & verts,
             std::vector<vertex_id_t> const & tris,
             std::vector<double> const & tri_areas,
@@ -176,7 +184,9 @@ public:
             std::vector<double> const & tet_vols,
             std::vector<double> const & tet_barycs,
             std::vector<triangle_id_t> const & tet_tri_neighbs,
-            std::vector<tetrahedron_id_t> const & tet_tet_neighbs);
+            std::vector<tetrahedron_id_t> const & tet_tet_neighbs,
+            std::vector<vertex_id_t> const & bars = {},
+            std::vector<bar_id_t> const & tri_bar_ids = {});
 
     /// Destructor
     virtual ~Tetmesh();
@@ -435,6 +445,14 @@ public:
 
     tetrahedron_id_t findTetByPoint(point3d const &p) const;
 
+    /// Find the tetrahedra which encompass a batch of points, as
+    /// findTetByPoint does for a single point.
+    /// \param coords Coordinates x0, y0, z0, x1, ... of the points.
+    /// \param tets Index of the tetrahedron found for each point, or
+    ///        UNKNOWN_TET if the point is outside the mesh.
+    void findTetsByPointsNP(const double *coords, size_t coord_size,
+                            index_t *tets, size_t tet_size) const;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS (EXPOSED TO PYTHON): MESH
     ////////////////////////////////////////////////////////////////////////
@@ -886,6 +904,9 @@ private:
     /// Build pBars, pBarsN, pTri_bars from pTris.
     void buildBarData();
 
+    /// Build pTetGrid from pTets and pVerts.
+    void buildTetGrid() const;
+
     ///////////////////////// DATA: VERTICES ///////////////////////////////
     ///
     /// The total number of vertices in the mesh
@@ -952,6 +973,24 @@ private:
     /// Information about the minimal and maximal boundary values
     steps::math::bounding_box           pBBox;
 
+    /// Uniform grid over pBBox used by the point location queries. Each cell
+    /// lists, in increasing index order, the tetrahedra whose bounding box
+    /// overlaps it, so the first tetrahedron found is the same as with a
+    /// linear scan over all tetrahedra.
+    struct TetGrid {
+        std::array<index_t, 3>          ncells{};
+        point3d                         origin;
+        point3d                         inv_cell_size;
+        /// The tetrahedra of cell c are cell_tets[cell_start[c], cell_start[c + 1])
+        std::vector<index_t>            cell_start;
+        std::vector<tetrahedron_id_t>   cell_tets;
+    };
+
+    /// Built on the first point location query, once even if several
+    /// threads query the mesh concurrently
+    mutable std::unique_ptr<TetGrid>    pTetGrid;
+    mutable std::once_flag              pTetGridOnce;
+
     ////////////////////////////////////////////////////////////////////////
 
     // List of contained membranes. Members of this class because they
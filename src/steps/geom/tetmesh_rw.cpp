@@ -2,7 +2,7 @@
  #################################################################################
 #
 #    STEPS - STochastic Engine for Pathway Simulation
-#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
 #    Copyright (C) 2003-2006 University of Antwerp, Belgium.
 #    
 #    See the file AUTHORS for details.
@@ -24,367 +24,629 @@
 
  */
 
+#include "tetmesh_rw.hpp"
 
-// STL headers.
-#include <cassert>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
-#include <iostream>
 #include <map>
+#include <memory>
 #include <set>
-#include <sstream>
 #include <vector>
 
-// STEPS headers.
-#include "steps/common.h"
-#include "steps/error.hpp"
-#include "steps/geom/comp.hpp"
-#include "steps/geom/patch.hpp"
-#include "steps/geom/tetmesh_rw.hpp"
-#include "steps/geom/tetmesh.hpp"
-#include "steps/geom/tmcomp.hpp"
-#include "steps/geom/tmpatch.hpp"
-
-USING(std, endl);
-USING(std, map);
-USING(std, ifstream);
-USING(std, ofstream);
-USING(std, ostringstream);
-USING(std, set);
-USING(std, string);
-USING(std, vector);
-USING(steps::tetmesh, Tetmesh);
-USING(steps::tetmesh, TmComp);
-USING(steps::tetmesh, TmPatch);
-USING(steps::wm, Comp);
-USING(steps::wm, Patch);
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-////////////////////////////////////////////////////////////////////////////////
+#include <easylogging++.h>
+
+#include "tetmesh.hpp"
+#include "tmcomp.hpp"
+#include "tmpatch.hpp"
+
+#include "util/error.hpp"
+#include "util/strong_id.hpp"
 
-// TODO:
-// * Change to a binary format, this will obviously be much more effective
-//   for larger meshes. Maybe use something like the NetCDF library for
-//   this. It will make loading the mesh from e.g. Matlab easier.
-// * Add a LOT more error checking and throw exceptions (while keeping in
-//   mind to clean up along the call path!! As always!!!!!!!!)
+namespace steps {
+namespace tetmesh {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Tetmesh * steps::tetmesh::loadASCII(string pathname)
-{
-    typedef vector<string> strvec_t;
-    typedef strvec_t::const_iterator strvec_ci;
-    typedef vector<double> doublevec_t;
-    typedef vector<uint> uintvec_t;
-    typedef map<string, TmComp*> compmap_t;
-
-    ifstream mf(pathname.c_str());
-    if (!mf)
-    {
-        ostringstream os;
-        os << "Cannot open file \"" << pathname << "\"";
-        IOErrLog(os.str());
+Tetmesh *loadASCII(std::string const &pathname) {
+  std::ifstream mf(pathname);
+  IOErrLogIf(!mf, "Cannot open file \"" + pathname + "\"");
+
+  // Read vertices.
+  index_t nverts = 0;
+  mf >> nverts;
+  std::vector<double> verts(nverts * 3);
+  for (auto &v : verts) {
+    mf >> v;
+  }
+
+  // Read triangles.
+  index_t ntris = 0;
+  mf >> ntris;
+  std::vector<index_t> tris(ntris * 3);
+  for (auto &v : tris) {
+    mf >> v;
+  }
+
+  // Read tetrahedrons.
+  index_t ntets = 0;
+  mf >> ntets;
+  std::vector<index_t> tets(ntets * 4);
+  for (auto &v : tets) {
+    mf >> v;
+  }
+  IOErrLogIf(!mf, "Cannot read mesh elements from \"" + pathname + "\"");
+
+  auto m = std::make_unique<Tetmesh>(verts, tets, tris);
+
+  // Read compartments.
+  std::map<std::string, TmComp *> compmap;
+  uint ncomps = 0;
+  mf >> ncomps;
+  for (uint c = 0; c < ncomps; ++c) {
+    std::string compid;
+    mf >> compid;
+
+    uint nvolsys = 0;
+    mf >> nvolsys;
+    std::vector<std::string> volsys(nvolsys);
+    for (auto &v : volsys) {
+      mf >> v;
     }
 
-    // Read vertices.
-    uint nverts = 0;
-    mf >> nverts;
-    doublevec_t verts(nverts * 3);
-    for (uint i = 0; i < nverts * 3; ++i)
-    {
-        double v;
-        mf >> v;
-        verts[i] = v;
+    index_t ntets_in_c = 0;
+    mf >> ntets_in_c;
+    std::vector<index_t> comptets(ntets_in_c);
+    for (auto &t : comptets) {
+      mf >> t;
     }
 
-    // Read triangles.
-    uint ntris = 0;
-    mf >> ntris;
-    uintvec_t tris(ntris * 3);
-    for (uint i = 0; i < ntris * 3; ++i)
-    {
-        uint v;
-        mf >> v;
-        tris[i] = v;
+    auto comp = new TmComp(compid, m.get(), comptets);
+    compmap[compid] = comp;
+    for (auto const &v : volsys) {
+      comp->addVolsys(v);
+    }
+  }
+
+  // Read patches.
+  uint npatches = 0;
+  mf >> npatches;
+  for (uint p = 0; p < npatches; ++p) {
+    std::string patchid;
+    mf >> patchid;
+
+    TmComp *patch_comps[2] = {nullptr, nullptr};
+    for (auto &comp : patch_comps) {
+      uint comp_switch = 0;
+      mf >> comp_switch;
+      if (comp_switch != 0) {
+        std::string compid;
+        mf >> compid;
+        comp = compmap[compid];
+      }
     }
 
-    // Read tetrahedrons.
-    uint ntets = 0;
-    mf >> ntets;
-    uintvec_t tets(ntets * 4);
-    for (uint i = 0; i < ntets * 4; ++i)
-    {
-        uint v;
-        mf >> v;
-        tets[i] = v;
+    uint nsurfsys = 0;
+    mf >> nsurfsys;
+    std::vector<std::string> surfsys(nsurfsys);
+    for (auto &s : surfsys) {
+      mf >> s;
     }
 
-    // Build mesh and set stuff using new style constructor).
-    Tetmesh * m = new Tetmesh(verts, tets, tris);
+    index_t ntris_in_p = 0;
+    mf >> ntris_in_p;
+    std::vector<index_t> patchtris(ntris_in_p);
+    for (auto &t : patchtris) {
+      mf >> t;
+    }
 
-    // Read compartments.
-    uint ncomps = 0;
-    mf >> ncomps;
-    compmap_t compmap;
-    for (uint c = 0; c < ncomps; ++c)
-    {
-        string compid;
-        mf >> compid;
+    auto patch = new TmPatch(patchid, m.get(), patchtris, patch_comps[0],
+                             patch_comps[1]);
+    for (auto const &s : surfsys) {
+      patch->addSurfsys(s);
+    }
+  }
+  IOErrLogIf(!mf, "Cannot read compartments and patches from \"" + pathname +
+                      "\"");
+
+  return m.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-        uint nvolsys;
-        mf >> nvolsys;
-        strvec_t volsys;
-        for (uint v = 0; v < nvolsys; ++v)
-        {
-            string volsysid;
-            mf >> volsysid;
-            volsys.push_back(volsysid);
-        }
-
-        uint ntets_in_c;
-        mf >> ntets_in_c;
-        uintvec_t comptets(ntets_in_c);
-        for (uint t = 0; t < ntets_in_c; ++t)
-        {
-            uint v;
-            mf >> v;
-            comptets[t] = v;
-        }
-
-        TmComp * newcomp = new TmComp(compid, m, comptets);
-        compmap[compid] = newcomp;
-        strvec_ci volsys_end = volsys.end();
-        for (strvec_ci vsys = volsys.begin(); vsys != volsys_end; ++vsys)
-            newcomp->addVolsys(*vsys);
+namespace {
+
+/// Write a list of indices, 8 per line.
+template <typename Container>
+void writeIndices(std::ofstream &mf, Container const &indices) {
+  mf << indices.size() << '\n';
+  uint numctr = 0;
+  for (auto const &i : indices) {
+    mf.width(8);
+    mf << i;
+    if (++numctr == 8) {
+      numctr = 0;
+      mf << '\n';
+    } else {
+      mf << "  ";
     }
+  }
+  if (numctr != 0) {
+    mf << '\n';
+  }
+  mf << '\n';
+}
 
-    // Read patches.
-    uint npatches = 0;
-    mf >> npatches;
-    for (uint p = 0; p < npatches; ++p)
-    {
-        // Read patch name.
-        string patchid;
-        mf >> patchid;
-
-        // Read inner comp.
-        uint icomp_switch = 0;
-        TmComp * icomp = 0;
-        mf >> icomp_switch;
-        if (icomp_switch != 0)
-        {
-            string icomp_id;
-            mf >> icomp_id;
-            icomp = compmap[icomp_id];
-        }
-
-        // Read outer comp.
-        uint ocomp_switch = 0;
-        TmComp * ocomp = 0;
-        mf >> ocomp_switch;
-        if (ocomp_switch != 0)
-        {
-            string ocomp_id;
-            mf >> ocomp_id;
-            ocomp = compmap[ocomp_id];
-        }
-
-        // Read surface systems.
-        uint nsurfsys = 0;
-        mf >> nsurfsys;
-        strvec_t surfsys;
-        for (uint s = 0; s < nsurfsys; ++s)
-        {
-            string ssysid;
-            mf >> ssysid;
-            surfsys.push_back(ssysid);
-        }
-
-        // Read triangles.
-        uint ntris_in_p = 0;
-        mf >> ntris_in_p;
-        uintvec_t patchtris(ntris_in_p);
-        for (uint t = 0; t < ntris_in_p; ++t)
-        {
-            uint v;
-            mf >> v;
-            patchtris[t] = v;
-        }
-
-        TmPatch * patch = new TmPatch(patchid, m, patchtris, icomp, ocomp);
-        strvec_ci surfsys_end = surfsys.end();
-        for (strvec_ci ssys = surfsys.begin(); ssys != surfsys_end; ++ssys)
-            patch->addSurfsys(*ssys);
+} // namespace
+
+void saveASCII(std::string const &pathname, Tetmesh *m) {
+  ArgErrLogIf(m == nullptr, "No mesh specified");
+
+  std::ofstream mf(pathname);
+  IOErrLogIf(!mf, "Cannot open file \"" + pathname + "\"");
+
+  // Increase digit precision a bit to accurately store doubles
+  // in ASCII. Otherwise last few binary digits might get rounded
+  // wrongly when reading back in.
+  mf.precision(13);
+
+  // Dump vertices.
+  mf << m->countVertices() << '\n';
+  for (index_t i = 0; i < m->countVertices(); ++i) {
+    auto const &vert = m->_getVertex(i);
+    mf.width(20);
+    mf << vert[0] << "    ";
+    mf.width(20);
+    mf << vert[1] << "    ";
+    mf.width(20);
+    mf << vert[2] << '\n';
+  }
+  mf << '\n';
+
+  // Dump triangles.
+  mf << m->countTris() << '\n';
+  for (index_t i = 0; i < m->countTris(); ++i) {
+    auto tri = m->_getTri(i);
+    mf.width(8);
+    mf << tri[0] << "  ";
+    mf.width(8);
+    mf << tri[1] << "  ";
+    mf.width(8);
+    mf << tri[2] << '\n';
+  }
+  mf << '\n';
+
+  // Dump tetrahedrons.
+  mf << m->countTets() << '\n';
+  for (index_t i = 0; i < m->countTets(); ++i) {
+    auto tet = m->_getTet(i);
+    for (uint j = 0; j < 4; ++j) {
+      mf.width(8);
+      mf << tet[j] << (j == 3 ? "\n" : "  ");
+    }
+  }
+  mf << '\n';
+
+  // Dump compartments.
+  mf << m->_countComps() << '\n';
+  for (uint cidx = 0; cidx < m->_countComps(); ++cidx) {
+    auto comp = dynamic_cast<TmComp *>(m->_getComp(cidx));
+    ProgErrLogIf(comp == nullptr, "Tetmesh compartment is not a TmComp");
+    mf << comp->getID() << '\n';
+
+    mf << comp->getVolsys().size() << '\n';
+    for (auto const &v : comp->getVolsys()) {
+      mf << v << '\n';
     }
+    writeIndices(mf, comp->_getAllTetIndices());
+  }
+
+  // Dump patches.
+  mf << m->_countPatches() << '\n';
+  for (uint pidx = 0; pidx < m->_countPatches(); ++pidx) {
+    auto patch = dynamic_cast<TmPatch *>(m->_getPatch(pidx));
+    ProgErrLogIf(patch == nullptr, "Tetmesh patch is not a TmPatch");
+    mf << patch->getID() << '\n';
+
+    for (auto comp : {patch->getIComp(), patch->getOComp()}) {
+      if (comp == nullptr) {
+        mf << "0" << '\n';
+      } else {
+        mf << "1" << "    " << comp->getID() << '\n';
+      }
+    }
+
+    mf << patch->getSurfsys().size() << '\n';
+    for (auto const &s : patch->getSurfsys()) {
+      mf << s << '\n';
+    }
+    writeIndices(mf, patch->getAllTriIndices());
+  }
 
-    mf.close();
-    return m;
+  IOErrLogIf(!mf, "Cannot write file \"" + pathname + "\"");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void steps::tetmesh::saveASCII(string pathname, Tetmesh * m)
-{
-    typedef set<string> strset;
-    typedef strset::const_iterator strset_ci;
-    typedef vector<uint> uintvec;
-    typedef uintvec::const_iterator uintvec_ci;
-
-    if (m == 0)
-    {
-        ostringstream os;
-        os << "No model specified";
-        ArgErrLog(os.str());
-    }
+namespace {
+
+constexpr char binary_magic[8] = {'S', 'T', 'E', 'P', 'S', 'T', 'M', 'B'};
+constexpr uint32_t binary_byte_order = 0x01020304;
+/// Every array and record of the binary format starts on this boundary.
+constexpr size_t binary_alignment = 8;
+
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t index_size;
+  uint32_t reserved;
+  uint64_t nverts;
+  uint64_t nbars;
+  uint64_t ntris;
+  uint64_t ntets;
+};
+
+static_assert(sizeof(BinaryHeader) % binary_alignment == 0,
+              "binary tetmesh header breaks the alignment of the arrays");
+
+inline size_t aligned(size_t size) {
+  return (size + binary_alignment - 1) / binary_alignment * binary_alignment;
+}
 
-    ofstream mf(pathname.c_str());
-    if (!mf)
-    {
-        ostringstream os;
-        os << "Cannot open file \"" << pathname << "\"";
-        IOErrLog(os.str());
+/// Sequential writer of the binary format.
+class BinaryWriter {
+public:
+  explicit BinaryWriter(std::ofstream &out) : pOut(out) {}
+
+  void raw(const void *data, size_t size) {
+    pOut.write(static_cast<const char *>(data),
+               static_cast<std::streamsize>(size));
+    static constexpr char padding[binary_alignment] = {};
+    pOut.write(padding,
+               static_cast<std::streamsize>(aligned(size) - size));
+  }
+
+  template <typename T> void array(std::vector<T> const &values) {
+    raw(values.data(), values.size() * sizeof(T));
+  }
+
+  void count(uint64_t n) { raw(&n, sizeof n); }
+
+  void string(std::string const &s) {
+    count(s.size());
+    raw(s.data(), s.size());
+  }
+
+  void strings(std::set<std::string> const &strings) {
+    count(strings.size());
+    for (auto const &s : strings) {
+      string(s);
+    }
+  }
+
+  template <typename T> void indices(std::vector<T> const &values) {
+    count(values.size());
+    std::vector<index_t> raw_values;
+    raw_values.reserve(values.size());
+    for (auto const &v : values) {
+      raw_values.push_back(util::deref_strongid(v));
+    }
+    array(raw_values);
+  }
+
+private:
+  std::ofstream &pOut;
+};
+
+/// Sequential reader of the binary format, checking the bounds of the mapped
+/// file.
+class BinaryReader {
+public:
+  BinaryReader(const char *begin, size_t size, std::string const &pathname)
+      : pPos(begin), pEnd(begin + size), pPathname(pathname) {}
+
+  template <typename T> const T *array(uint64_t n) {
+    IOErrLogIf(n > static_cast<size_t>(pEnd - pPos) / sizeof(T),
+               "Truncated binary mesh file \"" + pPathname + "\"");
+    auto data = reinterpret_cast<const T *>(pPos);
+    const auto size = aligned(n * sizeof(T));
+    pPos += std::min(size, static_cast<size_t>(pEnd - pPos));
+    return data;
+  }
+
+  uint64_t count() { return *array<uint64_t>(1); }
+
+  std::string string() {
+    const auto n = count();
+    return std::string(array<char>(n), n);
+  }
+
+  template <typename T> std::vector<T> indices() {
+    const auto n = count();
+    const auto data = array<index_t>(n);
+    return std::vector<T>(data, data + n);
+  }
+
+private:
+  const char *pPos;
+  const char *pEnd;
+  std::string const &pPathname;
+};
+
+/// Read-only memory mapping of a whole file.
+class MappedFile {
+public:
+  explicit MappedFile(std::string const &pathname) {
+    const int fd = open(pathname.c_str(), O_RDONLY);
+    IOErrLogIf(fd < 0, "Cannot open file \"" + pathname + "\"");
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      pSize = static_cast<size_t>(st.st_size);
+      void *addr = mmap(nullptr, pSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        pData = static_cast<const char *>(addr);
+      }
     }
+    close(fd);
+    IOErrLogIf(pData == nullptr, "Cannot map file \"" + pathname + "\"");
+  }
+
+  MappedFile(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+
+  ~MappedFile() {
+    munmap(const_cast<char *>(pData), pSize);
+  }
 
-    // Increase digit precision a bit to accurately store doubles
-    // in ASCII. Otherwise last few binary digits might get rounded
-    // wrongly when reading back in.
-    mf.precision(13);
-
-    // Dump vertices.
-    uint nverts = m->countVertices();
-    mf << nverts << endl;
-    for (uint i = 0; i < nverts; ++i)
-    {
-        double * verts = m->_getVertex(i);
-        mf.width(20);
-        mf << verts[0] << "    ";
-        mf.width(20);
-        mf << verts[1] << "    ";
-        mf.width(20);
-        mf << verts[2] << endl;
+  const char *data() const noexcept { return pData; }
+  size_t size() const noexcept { return pSize; }
+
+private:
+  const char *pData{nullptr};
+  size_t pSize{0};
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+Tetmesh *loadBinary(std::string const &pathname) {
+  MappedFile file(pathname);
+  BinaryReader reader(file.data(), file.size(), pathname);
+
+  const auto &header = *reader.array<BinaryHeader>(1);
+  IOErrLogIf(std::memcmp(header.magic, binary_magic, sizeof binary_magic) != 0,
+             "\"" + pathname + "\" is not a STEPS binary mesh file");
+  IOErrLogIf(header.version != TETMESH_BINARY_VERSION,
+             "Unsupported binary mesh version " +
+                 std::to_string(header.version) + " in \"" + pathname + "\"");
+  IOErrLogIf(header.byte_order != binary_byte_order,
+             "Binary mesh file \"" + pathname +
+                 "\" was written with another byte order");
+  IOErrLogIf(header.index_size != sizeof(index_t),
+             "Binary mesh file \"" + pathname +
+                 "\" was written with another index size");
+
+  const auto nverts = header.nverts;
+  const auto nbars = header.nbars;
+  const auto ntris = header.ntris;
+  const auto ntets = header.ntets;
+
+  const auto verts = reader.array<double>(nverts * 3);
+  const auto bars = reader.array<index_t>(nbars * 2);
+  const auto tris = reader.array<index_t>(ntris * 3);
+  const auto tri_bars = reader.array<index_t>(ntris * 3);
+  const auto tri_tets = reader.array<index_t>(ntris * 2);
+  const auto tri_areas = reader.array<double>(ntris);
+  const auto tri_norms = reader.array<double>(ntris * 3);
+  const auto tets = reader.array<index_t>(ntets * 4);
+  const auto tet_vols = reader.array<double>(ntets);
+  const auto tet_barycs = reader.array<double>(ntets * 3);
+  const auto tet_tris = reader.array<index_t>(ntets * 4);
+  const auto tet_tets = reader.array<index_t>(ntets * 4);
+
+  auto m = std::make_unique<Tetmesh>(
+      std::vector<double>(verts, verts + nverts * 3),
+      std::vector<vertex_id_t>(tris, tris + ntris * 3),
+      std::vector<double>(tri_areas, tri_areas + ntris),
+      std::vector<double>(tri_norms, tri_norms + ntris * 3),
+      std::vector<tetrahedron_id_t>(tri_tets, tri_tets + ntris * 2),
+      std::vector<vertex_id_t>(tets, tets + ntets * 4),
+      std::vector<double>(tet_vols, tet_vols + ntets),
+      std::vector<double>(tet_barycs, tet_barycs + ntets * 3),
+      std::vector<triangle_id_t>(tet_tris, tet_tris + ntets * 4),
+      std::vector<tetrahedron_id_t>(tet_tets, tet_tets + ntets * 4),
+      std::vector<vertex_id_t>(bars, bars + nbars * 2),
+      std::vector<bar_id_t>(tri_bars, tri_bars + ntris * 3));
+
+  // Compartments
+  const auto ncomps = reader.count();
+  for (uint64_t c = 0; c < ncomps; ++c) {
+    const auto id = reader.string();
+    std::vector<std::string> volsys(reader.count());
+    for (auto &v : volsys) {
+      v = reader.string();
+    }
+    auto comp = new TmComp(id, m.get(), reader.indices<index_t>());
+    for (auto const &v : volsys) {
+      comp->addVolsys(v);
     }
-    mf << endl;
-
-    // Dump triangles.
-    uint ntris = m->countTris();
-    mf << ntris << endl;
-    for (uint i = 0; i < ntris; ++i)
-    {
-        uint * tri = m->_getTri(i);
-        mf.width(8);
-        mf << tri[0] << "  ";
-        mf.width(8);
-        mf << tri[1] << "  ";
-        mf.width(8);
-        mf << tri[2] << endl;
+  }
+
+  // Patches
+  const auto npatches = reader.count();
+  for (uint64_t p = 0; p < npatches; ++p) {
+    const auto id = reader.string();
+    steps::wm::Comp *patch_comps[2] = {nullptr, nullptr};
+    for (auto &comp : patch_comps) {
+      const auto compid = reader.string();
+      if (!compid.empty()) {
+        comp = m->getComp(compid);
+      }
     }
-    mf << endl;
-
-    // Dump tetrahedrons.
-    uint ntets = m->countTets();
-    mf << ntets << endl;
-    for (uint i = 0; i < ntets; ++i)
-    {
-        uint * tet = m->_getTet(i);
-        mf.width(8);
-        mf << tet[0] << "  ";
-        mf.width(8);
-        mf << tet[1] << "  ";
-        mf.width(8);
-        mf << tet[2] << "  ";
-        mf.width(8);
-        mf << tet[3] << endl;
+    std::vector<std::string> surfsys(reader.count());
+    for (auto &s : surfsys) {
+      s = reader.string();
     }
-    mf << endl;
-
-    // Dump compartments.
-    uint ncomps = m->_countComps();
-    mf << ncomps << endl;
-    for (uint cidx = 0; cidx < ncomps; ++cidx)
-    {
-        TmComp * comp = m->getTetComp(cidx);
-        mf << comp->getID() << endl;
-
-        strset volsys = comp->getVolsys();
-        mf << volsys.size() << endl;
-        strset_ci v_end = volsys.end();
-        for (strset_ci v = volsys.begin(); v != v_end; ++v)
-        {
-            mf << *v << endl;
-        }
-
-        uintvec tets = comp->_getAllTetIndices();
-        mf << tets.size() << endl;
-        uintvec_ci t_end = tets.end();
-        uint numctr = 0;
-        for (uintvec_ci t = tets.begin(); t != t_end; ++t)
-        {
-            mf.width(8);
-            mf << *t;
-            numctr++;
-            if (numctr == 8)
-            {
-                numctr = 0;
-                mf << endl;
-            }
-            else
-            {
-                mf << "  ";
-            }
-        }
-        if (numctr != 0) mf << endl;
-        mf << endl;
+    auto patch = new TmPatch(id, m.get(), reader.indices<index_t>(),
+                             patch_comps[0], patch_comps[1]);
+    for (auto const &s : surfsys) {
+      patch->addSurfsys(s);
     }
+  }
+
+  // Regions of interest, in their original element order
+  for (auto nrois = reader.count(); nrois > 0; --nrois) {
+    const auto id = reader.string();
+    m->rois.insert<ROI_TET>(id, reader.indices<tetrahedron_id_t>());
+  }
+  for (auto nrois = reader.count(); nrois > 0; --nrois) {
+    const auto id = reader.string();
+    m->rois.insert<ROI_TRI>(id, reader.indices<triangle_id_t>());
+  }
+  for (auto nrois = reader.count(); nrois > 0; --nrois) {
+    const auto id = reader.string();
+    m->rois.insert<ROI_VERTEX>(id, reader.indices<vertex_id_t>());
+  }
+
+  return m.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-    // Dump patches.
-    uint npatches = m->_countPatches();
-    mf << npatches << endl;
-    for (uint pidx = 0; pidx < npatches; ++pidx)
-    {
-        TmPatch * patch = m->getTriPatch(pidx);
-        mf << patch->getID() << endl;
-
-        Comp * icomp = patch->getIComp();
-        if (icomp == 0) mf << "0" << endl;
-        else mf << "1" << "    " << icomp->getID() << endl;
-
-        Comp * ocomp = patch->getOComp();
-        if (ocomp == 0) mf << "0" << endl;
-        else mf << "1" << "    " << ocomp->getID() << endl;
-
-        strset surfsys = patch->getSurfsys();
-        mf << surfsys.size() << endl;
-        strset_ci s_end = surfsys.end();
-        for (strset_ci s = surfsys.begin(); s != s_end; ++s)
-        {
-            mf << *s << endl;
-        }
-
-        uintvec tris = patch->_getAllTriIndices();
-        mf << tris.size() << endl;
-        uintvec_ci t_end = tris.end();
-        uint numctr = 0;
-        for (uintvec_ci t = tris.begin(); t != t_end; ++t)
-        {
-            mf.width(8);
-            mf << *t;
-            numctr++;
-            if (numctr == 8)
-            {
-                numctr = 0;
-                mf << endl;
-            }
-            else
-            {
-                mf << "  ";
-            }
-        }
-        if (numctr != 0) mf << endl;
-        mf << endl;
+void saveBinary(std::string const &pathname, Tetmesh *m) {
+  ArgErrLogIf(m == nullptr, "No mesh specified");
+
+  std::ofstream mf(pathname, std::ios::binary);
+  IOErrLogIf(!mf, "Cannot open file \"" + pathname + "\"");
+  BinaryWriter writer(mf);
+
+  const index_t nverts = m->countVertices();
+  const index_t nbars = m->countBars();
+  const index_t ntris = m->countTris();
+  const index_t ntets = m->countTets();
+
+  BinaryHeader header{};
+  std::memcpy(header.magic, binary_magic, sizeof binary_magic);
+  header.version = TETMESH_BINARY_VERSION;
+  header.byte_order = binary_byte_order;
+  header.index_size = sizeof(index_t);
+  header.nverts = nverts;
+  header.nbars = nbars;
+  header.ntris = ntris;
+  header.ntets = ntets;
+  writer.raw(&header, sizeof header);
+
+  std::vector<double> verts;
+  verts.reserve(nverts * 3);
+  for (index_t v = 0; v < nverts; ++v) {
+    auto const &vert = m->_getVertex(v);
+    verts.insert(verts.end(), vert.begin(), vert.end());
+  }
+  writer.array(verts);
+
+  std::vector<index_t> bars;
+  bars.reserve(nbars * 2);
+  for (index_t b = 0; b < nbars; ++b) {
+    auto bar = m->_getBar(b);
+    bars.insert(bars.end(), {bar[0].get(), bar[1].get()});
+  }
+  writer.array(bars);
+
+  std::vector<index_t> tris, tri_bars, tri_tets;
+  std::vector<double> tri_areas, tri_norms;
+  tris.reserve(ntris * 3);
+  tri_bars.reserve(ntris * 3);
+  tri_tets.reserve(ntris * 2);
+  tri_areas.reserve(ntris);
+  tri_norms.reserve(ntris * 3);
+  for (index_t t = 0; t < ntris; ++t) {
+    auto tri = m->_getTri(t);
+    tris.insert(tris.end(), {tri[0].get(), tri[1].get(), tri[2].get()});
+    for (auto bar : m->_getTriBars(t)) {
+      tri_bars.push_back(bar.get());
+    }
+    auto neighbs = m->_getTriTetNeighb(t);
+    tri_tets.insert(tri_tets.end(), {neighbs[0].get(), neighbs[1].get()});
+    tri_areas.push_back(m->getTriArea(t));
+    auto const &norm = m->_getTriNorm(t);
+    tri_norms.insert(tri_norms.end(), norm.begin(), norm.end());
+  }
+  writer.array(tris);
+  writer.array(tri_bars);
+  writer.array(tri_tets);
+  writer.array(tri_areas);
+  writer.array(tri_norms);
+
+  std::vector<index_t> tets, tet_tris, tet_tets;
+  std::vector<double> tet_vols, tet_barycs;
+  tets.reserve(ntets * 4);
+  tet_tris.reserve(ntets * 4);
+  tet_tets.reserve(ntets * 4);
+  tet_vols.reserve(ntets);
+  tet_barycs.reserve(ntets * 3);
+  for (index_t t = 0; t < ntets; ++t) {
+    auto tet = m->_getTet(t);
+    auto tris_neighbs = m->_getTetTriNeighb(t);
+    auto tets_neighbs = m->_getTetTetNeighb(t);
+    for (uint j = 0; j < 4; ++j) {
+      tets.push_back(tet[j].get());
+      tet_tris.push_back(tris_neighbs[j].get());
+      tet_tets.push_back(tets_neighbs[j].get());
+    }
+    tet_vols.push_back(m->getTetVol(t));
+    auto const &baryc = m->_getTetBarycenter(t);
+    tet_barycs.insert(tet_barycs.end(), baryc.begin(), baryc.end());
+  }
+  writer.array(tets);
+  writer.array(tet_vols);
+  writer.array(tet_barycs);
+  writer.array(tet_tris);
+  writer.array(tet_tets);
+
+  writer.count(m->_countComps());
+  for (uint cidx = 0; cidx < m->_countComps(); ++cidx) {
+    auto comp = dynamic_cast<TmComp *>(m->_getComp(cidx));
+    ProgErrLogIf(comp == nullptr, "Tetmesh compartment is not a TmComp");
+    writer.string(comp->getID());
+    writer.strings(comp->getVolsys());
+    writer.indices(comp->_getAllTetIndices());
+  }
+
+  writer.count(m->_countPatches());
+  for (uint pidx = 0; pidx < m->_countPatches(); ++pidx) {
+    auto patch = dynamic_cast<TmPatch *>(m->_getPatch(pidx));
+    ProgErrLogIf(patch == nullptr, "Tetmesh patch is not a TmPatch");
+    writer.string(patch->getID());
+    for (auto comp : {patch->getIComp(), patch->getOComp()}) {
+      writer.string(comp == nullptr ? std::string() : comp->getID());
+    }
+    writer.strings(patch->getSurfsys());
+    writer.indices(patch->_getAllTriIndices());
+  }
+
+  const auto write_rois = [&writer](auto const &rois) {
+    writer.count(rois.size());
+    for (auto const &roi : rois) {
+      writer.string(roi.first);
+      writer.indices(roi.second);
     }
+  };
+  write_rois(m->rois.tets_roi);
+  write_rois(m->rois.tris_roi);
+  write_rois(m->rois.vertices_roi);
 
-    mf.close();
+  mf.close();
+  IOErrLogIf(!mf, "Cannot write file \"" + pathname + "\"");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-// END
+} // namespace tetmesh
+} // namespace steps
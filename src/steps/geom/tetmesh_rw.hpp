@@ -2,7 +2,7 @@
  #################################################################################
 #
 #    STEPS - STochastic Engine for Pathway Simulation
-#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
 #    Copyright (C) 2003-2006 University of Antwerp, Belgium.
 #    
 #    See the file AUTHORS for details.
@@ -24,19 +24,13 @@
 
  */
 
-#ifndef STEPS_TETMESH_TETMESH_RW_HPP
-#define STEPS_TETMESH_TETMESH_RW_HPP 1
+#pragma once
 
-
-// STEPS headers.
-#include "steps/common.h"
-
-// STL headers
-#include <cassert>
+#include <cstdint>
 #include <string>
 
- namespace steps {
- namespace tetmesh {
+namespace steps {
+namespace tetmesh {
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -96,22 +90,52 @@ class Tetmesh;
 /// STEPS (and C++) internally.
 ///
 /// \todo More care could be taken in handling wrongly specified
-/// ASCII files. A binary format, or better even a format based a
-/// library like NetCDF (or HDF), would be more efficient in terms
-/// occupying disk space and could make it easier to read meshes from
-/// other software such as Matlab. (But first see whether Matlab's
-/// support for these formats is actually as easy as they say it is.)
+/// ASCII files.
 ///
-Tetmesh * loadASCII(std::string pathname);
-void saveASCII(std::string pathname, Tetmesh * m);
+Tetmesh * loadASCII(std::string const & pathname);
+void saveASCII(std::string const & pathname, Tetmesh * m);
 //@}
 
 ////////////////////////////////////////////////////////////////////////////////
 
-}
-}
+/// Version of the binary format written by saveBinary().
+constexpr uint32_t TETMESH_BINARY_VERSION = 1;
 
-#endif
-// STEPS_TETMESH_TETMESH_RW_HPP
+//@{
+/// loadBinary() and saveBinary() read and write a tetmesh together with all
+/// its derived connectivity, so that loading a large mesh does not go through
+/// the triangle and bar indexing of the Tetmesh(verts, tets, tris)
+/// constructor. The file is mapped in memory and its arrays are passed to the
+/// Tetmesh constructor taking precomputed connectivity.
+///
+/// The file starts with a header: the magic string "STEPSTMB", the format
+/// version, a byte order mark, sizeof(index_t), then the number of vertices,
+/// bars, triangles and tetrahedrons as 64-bit integers. It is followed by
+/// the arrays below, in native byte order, each starting on an 8 bytes
+/// boundary:
+///
+/// <OL>
+/// <LI>vertex coordinates (3 doubles per vertex)
+/// <LI>bar vertices (2 indices per bar)
+/// <LI>triangle vertices, bars and tetrahedron neighbours (3, 3 and 2
+///     indices per triangle), then areas and normals (1 and 3 doubles)
+/// <LI>tetrahedron vertices (4 indices), volumes and barycenters (1 and 3
+///     doubles), triangle and tetrahedron neighbours (4 and 4 indices)
+/// </OL>
+///
+/// Compartments (id, volume systems and tetrahedrons), patches (id, inner and
+/// outer compartment ids, surface systems and triangles) and the regions of
+/// interest follow as length-prefixed strings and index lists. Missing
+/// neighbours are stored as the unknown index value. Membranes and diffusion
+/// boundaries are not stored.
+///
+/// Files with another version, byte order or index size are rejected.
+///
+Tetmesh * loadBinary(std::string const & pathname);
+void saveBinary(std::string const & pathname, Tetmesh * m);
+//@}
+
+////////////////////////////////////////////////////////////////////////////////
 
-// END
+} // namespace tetmesh
+} // namespace steps
@@ -354,7 +354,7 @@ void Surfsys::_handleSpecDelete(Spec *spec) {
     for (auto const &oc : pOhmicCurrs) {
       SpecP cstate = oc.second->getChanState();
       if (cstate == spec) {
-        oc_del.emplace_back(cstate->getID());
+        oc_del.emplace_back(oc.second->getID());
       }
     }
     for (auto const &occurr_del : oc_del) {
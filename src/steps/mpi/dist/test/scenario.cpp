@@ -88,6 +88,9 @@ void Scenario<RNG>::apply_statedef(Simulation<RNG> &simulation) {
   this->fill_compartments(simulation);
   this->fill_patches(simulation);
   simulation.setDiffOpBinomialThreshold(input.threshold);
+  if (input.counter_rng_seed) {
+    simulation.setCounterBasedRNG(*input.counter_rng_seed);
+  }
   if (input.log_state_report) {
     simulation.log_once(simulation.createStateReport());
   }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <random>
 
@@ -30,7 +31,8 @@ struct ScenarioInput {
                   const std::string& t_logfile,
                   const std::string& t_depgraphfile,
                   bool t_molecules_pools_force_dist_for_variable_sized,
-                  bool t_sim_indep_k_procs)
+                  bool t_sim_indep_k_procs,
+                  boost::optional<std::uint64_t> t_counter_rng_seed = boost::none)
         : mesh_file(std::move(t_mesh_file))
         , threshold(t_threshold)
         , num_mols_factor(t_num_mols_factor)
@@ -50,7 +52,8 @@ struct ScenarioInput {
         , depgraphfile(t_depgraphfile)
         , molecules_pools_force_dist_for_variable_sized(
               t_molecules_pools_force_dist_for_variable_sized)
-        , sim_indep_k_procs(t_sim_indep_k_procs) {}
+        , sim_indep_k_procs(t_sim_indep_k_procs)
+        , counter_rng_seed(t_counter_rng_seed) {}
 
     ScenarioInput(std::string t_mesh_file, osh::Real t_scale = 1.0e-6)
         : mesh_file(std::move(t_mesh_file))
@@ -111,6 +114,8 @@ struct ScenarioInput {
     bool molecules_pools_force_dist_for_variable_sized{false};
     /// simulate independently groups of independent kinetic processes
     bool sim_indep_k_procs;
+    /// if set, diffusion draws from counter-based generators seeded with this value
+    boost::optional<std::uint64_t> counter_rng_seed;
 };
 
 struct ScenarioResult {
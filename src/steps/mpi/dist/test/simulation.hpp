@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <fstream>
 #include <memory>
 #include <random>
@@ -163,6 +164,17 @@ public:
 
   virtual void setDiffOpBinomialThreshold(osh::Real threshold) = 0;
 
+  /// Draw the random numbers of the diffusion operator from counter-based
+  /// generators keyed with the global element index, so that trajectories do
+  /// not depend on the partitioning. The seed must be the same on all ranks.
+  /// With the SSA method, independent groups of kprocs also get their own
+  /// generators and run on the OpenMP threads.
+  virtual void setCounterBasedRNG(std::uint64_t seed) = 0;
+
+  /// Overlap the halo exchange of the diffusion operator with the
+  /// computations on the interior elements (default)
+  virtual void setDiffOpHaloExchangeOverlap(bool overlap) = 0;
+
   virtual void exportMolStateToVTK(const std::string &filename) = 0;
 
   virtual osh::I64 getDiffOpExtent(bool local = false) const = 0;
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <random>
@@ -158,9 +159,21 @@ static int splitting_operator(osh::Mesh &mesh, Omega_h::CmdLine &cmdline) {
   }
 
   if (cmdline.parsed("--rng-seed-add-process-rank")) {
+    if (cmdline.parsed("--counter-based-rng")) {
+      throw std::logic_error("Can't use counter-based RNG with a seed that depends on the rank");
+    }
     rng_seed += mesh.comm()->rank();
   }
 
+  boost::optional<std::uint64_t> counter_rng_seed;
+  if (cmdline.parsed("--counter-based-rng")) {
+    // the default seed is drawn independently on each process
+    if (!cmdline.parsed("--rng-seed")) {
+      throw std::logic_error("Counter-based RNG requires --rng-seed");
+    }
+    counter_rng_seed = rng_seed;
+  }
+
   osh::Real do_interval{1e-7};
   if (cmdline.parsed("--do-interval")) {
     do_interval = cmdline.get<osh::Real>("--do-interval", "value");
@@ -219,7 +232,8 @@ static int splitting_operator(osh::Mesh &mesh, Omega_h::CmdLine &cmdline) {
                             logfile,
                             depgraphfile,
                             molecules_pools_force_dist_for_variable_sized,
-                            cmdline.parsed("--independent-kprocs"));
+                            cmdline.parsed("--independent-kprocs"),
+                            counter_rng_seed);
 
   const auto run_sim = [&](auto &sim) {
     const auto &result = test_splitting_operator(sim, scenario, input);
@@ -237,6 +251,8 @@ static int splitting_operator(osh::Mesh &mesh, Omega_h::CmdLine &cmdline) {
   if (cmdline.parsed("--use-rssa")) {
     if (cmdline.parsed("--use-gibson-bruck")) {
       throw std::logic_error("Can't use RSSA with Gibson-Bruck");
+    } else if (cmdline.parsed("--use-sum-tree")) {
+      throw std::logic_error("Can't use RSSA with the sum tree search");
     } else {
       if (use_big_int_for_num_mols) {
         OmegaHSimulation<SSAMethod::RSSA, decltype(rng), osh::I64,
@@ -264,6 +280,18 @@ static int splitting_operator(osh::Mesh &mesh, Omega_h::CmdLine &cmdline) {
             simulation(input, mesh_wrapper, rng, outstream);
         return run_sim(simulation);
       }
+    } else if (cmdline.parsed("--use-sum-tree")) {
+      if (use_big_int_for_num_mols) {
+        OmegaHSimulation<SSAMethod::SSA, decltype(rng), osh::I64,
+                         NextEventSearchMethod ::DirectSumTree>
+            simulation(input, mesh_wrapper, rng, outstream);
+        return run_sim(simulation);
+      } else {
+        OmegaHSimulation<SSAMethod::SSA, decltype(rng), osh::I32,
+                         NextEventSearchMethod ::DirectSumTree>
+            simulation(input, mesh_wrapper, rng, outstream);
+        return run_sim(simulation);
+      }
     } else {
       if (use_big_int_for_num_mols) {
         OmegaHSimulation<SSAMethod::SSA, decltype(rng), osh::I64,
@@ -376,6 +404,9 @@ int main(int argc, char **argv) {
   rng_seed_flag.add_arg<int>("value");
   cmdline.add_flag("--rng-seed-add-process-rank",
                    "add process rank to rng seed");
+  cmdline.add_flag("--counter-based-rng",
+                   "diffusion and reactions draw from counter-based generators, results do not "
+                   "depend on the number of processes, independent kprocs run on OpenMP threads");
 
   auto &expected_num_diffusions_flag =
       cmdline.add_flag("--expected-diffusions", "numDiffusions");
@@ -408,6 +439,8 @@ int main(int argc, char **argv) {
   cmdline.add_flag("--use-rssa", "Use RSSA");
   cmdline.add_flag("--use-gibson-bruck",
                    "use Gibson-Bruck method to determine next kinetic event");
+  cmdline.add_flag("--use-sum-tree",
+                   "use direct method with a sum tree to determine next kinetic event");
   cmdline.add_flag("--independent-kprocs",
                    "Simulate unrelated subsets of kprocs independently");
 
@@ -8,7 +8,7 @@ namespace dist {
 
 template <typename RNG, typename NumMolecules> class SimulationInput;
 
-enum class NextEventSearchMethod { Direct, GibsonBruck };
+enum class NextEventSearchMethod { Direct, GibsonBruck, DirectSumTree };
 
 enum class SSAMethod { SSA, RSSA };
 
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <algorithm>
+#include <optional>
 #include <random>
 
 #include <Omega_h_array.hpp>
 #include <Omega_h_array_ops.hpp>
 #include <Omega_h_dist.hpp>
+#include <Omega_h_future.hpp>
 #include <Omega_h_mesh.hpp>
 
 #include "geom/dist/distmesh.hpp"
@@ -146,21 +148,47 @@ class PoolsIncrements: public util::flat_multimap<NumMolecules, DistMesh::dim()
      * check which function we should use
      */
     inline void sync_delta_pools() {
+        start_sync_delta_pools();
+        finish_sync_delta_pools();
+    }
+
+    /** Non-blocking version of \a sync_delta_pools
+     *
+     * The molecule counts are packed when the exchange starts: the increments
+     * of the elements that are ghosts on other processes must be final, while
+     * the others can still be updated until \a finish_sync_delta_pools.
+     */
+    inline void start_sync_delta_pools() {
         if (dist_.comm()) {
             // multiple compartment
-            synced_delta_pools_ = dist_.exch(util::createRead(this->ab2c()), 1 /* unused width */);
+            pending_sync_.emplace(
+                dist_.iexch(util::createRead(this->ab2c()), 1 /* unused width */));
         } else {
             // same number of species per element
             const auto element_num_values = this->a2ab()[1] - this->a2ab()[0];
-            synced_delta_pools_ =
-                mesh_.sync_array(dims(), util::createRead(this->ab2c()), element_num_values);
+            pending_sync_.emplace(
+                mesh_.isync_array(dims(), util::createRead(this->ab2c()), element_num_values));
         }
     }
 
+    /// Wait for the exchange started by \a start_sync_delta_pools
+    inline void finish_sync_delta_pools() {
+        synced_delta_pools_ = pending_sync_->get();
+        pending_sync_.reset();
+    }
+
+    /**
+     * Number of molecules leaving \a element through \a face. Owned elements
+     * are read from the local increments, ghost elements from the last
+     * synchronization.
+     */
     inline NumMolecules ith_delta_pool(mesh::tetrahedron_id_t element,
                                        container::species_id species,
                                        int face) const noexcept {
         const auto index = this->ab(element.get(), species.get());
+        if (mesh_.isOwned(element)) {
+            return this->ab2c()[index + face];
+        }
         return synced_delta_pools_[index + face];
     }
 
@@ -177,6 +205,7 @@ class PoolsIncrements: public util::flat_multimap<NumMolecules, DistMesh::dim()
 
   private:
     osh::Read<NumMolecules> synced_delta_pools_;
+    std::optional<osh::Future<NumMolecules>> pending_sync_;
     DistMesh& mesh_;
     osh::Dist dist_;
 
@@ -204,12 +233,24 @@ public:
   NumMolecules operator()(NumMolecules num_molecules,
                           osh::Real diffusion_propensity_sum,
                           osh::Real time_delta) const {
+      return (*this)(num_molecules, diffusion_propensity_sum, time_delta, rng_);
+  }
+
+  /**
+   * Same as above, drawing from the given generator instead of the
+   * generator of the simulation
+   */
+  template <typename Generator>
+  NumMolecules operator()(NumMolecules num_molecules,
+                          osh::Real diffusion_propensity_sum,
+                          osh::Real time_delta,
+                          Generator& gen) const {
       const auto p = std::clamp(time_delta * diffusion_propensity_sum, 0., 1.);
-      if constexpr (std::is_same_v<RNG, steps::rng::RNG>) {
-          return NumMolecules(rng_.getBinom(static_cast<uint>(num_molecules), p));
+      if constexpr (std::is_same_v<Generator, steps::rng::RNG>) {
+          return NumMolecules(gen.getBinom(static_cast<uint>(num_molecules), p));
       } else {
           std::binomial_distribution<NumMolecules> total_leaving(num_molecules, p);
-          return total_leaving(rng_);
+          return total_leaving(gen);
       }
   }
 
@@ -7,35 +7,111 @@ namespace steps {
 namespace dist {
 namespace kproc {
 
+EventQueue::Entry& EventQueue::entry(const KProcID id) {
+    auto& entries = entries_[static_cast<size_t>(id.type())];
+    const auto idx = static_cast<size_t>(id.id());
+    if (idx >= entries.size()) {
+        entries.resize(idx + 1);
+    }
+    return entries[idx];
+}
+
+const EventQueue::Entry* EventQueue::findEntry(const KProcID id) const noexcept {
+    const auto& entries = entries_[static_cast<size_t>(id.type())];
+    const auto idx = static_cast<size_t>(id.id());
+    if (idx < entries.size() && entries[idx].known) {
+        return &entries[idx];
+    }
+    return nullptr;
+}
+
+void EventQueue::place(const unsigned pos, const Node& node) {
+    heap_[pos] = node;
+    entry(KProcID(node.kproc)).heap_pos = pos;
+}
+
+void EventQueue::siftUp(unsigned pos) {
+    const Node node = heap_[pos];
+    while (pos > 0) {
+        const unsigned parent = (pos - 1) / 2;
+        if (!(node < heap_[parent])) {
+            break;
+        }
+        place(pos, heap_[parent]);
+        pos = parent;
+    }
+    place(pos, node);
+}
+
+void EventQueue::siftDown(unsigned pos) {
+    const Node node = heap_[pos];
+    const auto size = static_cast<unsigned>(heap_.size());
+    while (true) {
+        unsigned child = 2 * pos + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && heap_[child + 1] < heap_[child]) {
+            child++;
+        }
+        if (!(heap_[child] < node)) {
+            break;
+        }
+        place(pos, heap_[child]);
+        pos = child;
+    }
+    place(pos, node);
+}
+
+void EventQueue::erase(const unsigned pos) {
+    entry(KProcID(heap_[pos].kproc)).heap_pos = not_in_heap;
+    const unsigned last = static_cast<unsigned>(heap_.size()) - 1;
+    if (pos != last) {
+        const bool up = heap_[last] < heap_[pos];
+        heap_[pos] = heap_[last];
+        heap_.pop_back();
+        if (up) {
+            siftUp(pos);
+        } else {
+            siftDown(pos);
+        }
+    } else {
+        heap_.pop_back();
+    }
+}
+
 void EventQueue::update(const KProcID id, const osh::Real time) {
-    // Remove previous event if it exists
-    auto timeit = kproc_to_event_time_.find(id.data());
-    if (timeit != kproc_to_event_time_.end() && timeit->second <= max_time_) {
-        auto range = next_event_.equal_range(timeit->second);
-        if (range.first != next_event_.end()) {
-            auto it =
-                std::find_if(range.first, range.second, [&id](const auto &p) {
-                    return p.second == id.data();
-                });
-            if (it != range.second) {
-                next_event_.erase(it);
+    Entry& e = entry(id);
+    if (queued(time)) {
+        // an updated event is ordered after the ones already queued at the same time
+        const Node node{time, sequence_++, id.data()};
+        if (e.heap_pos == not_in_heap) {
+            e.heap_pos = static_cast<unsigned>(heap_.size());
+            heap_.push_back(node);
+            siftUp(e.heap_pos);
+        } else {
+            const unsigned pos = e.heap_pos;
+            const bool up = node < heap_[pos];
+            heap_[pos] = node;
+            if (up) {
+                siftUp(pos);
             } else {
-                throw std::logic_error(
-                    "Can find event time but not the KProcID in the event map");
+                siftDown(pos);
             }
         }
+    } else if (e.heap_pos != not_in_heap) {
+        erase(e.heap_pos);
     }
-    // Only add the event if it will happen before max_time_
-    if (time != std::numeric_limits<osh::Real>::infinity() && time <= max_time_) {
-        next_event_.emplace(time, id.data());
-    }
-    kproc_to_event_time_[id.data()] = time;
+    // the sifts only touch entries of kprocs already in the heap, so no
+    // entries vector is resized and e is still valid
+    e.time = time;
+    e.known = true;
 }
 
 osh::Real EventQueue::getEventTime(const KProcID id) const {
-    auto it = kproc_to_event_time_.find(id.data());
-    if (it != kproc_to_event_time_.end()) {
-        return it->second;
+    const auto* e = findEntry(id);
+    if (e != nullptr) {
+        return e->time;
     } else {
         throw std::logic_error("Cannot find the KProcID in the event map");
     }
@@ -45,48 +121,60 @@ void EventQueue::updateMaxTime(const osh::Real max_time) {
     auto old_max_time = max_time_;
     if (old_max_time < max_time) {
         max_time_ = max_time;
-        if(!next_event_.empty()) {
-            CLOG(WARNING, "general_log") << "remain events: " << next_event_.size();
-            for (auto & e : next_event_) {
-                CLOG(WARNING, "general_log") << e.first << " kproc: " << e.second;
+        if(!heap_.empty()) {
+            CLOG(WARNING, "general_log") << "remain events: " << heap_.size();
+            for (auto & e : heap_) {
+                CLOG(WARNING, "general_log") << e.time << " kproc: " << e.kproc;
             }
             ProgErrLog("Event queue not empty!");
         }
-        for(auto& kp_event : kproc_to_event_time_) {
-            if(kp_event.second == std::numeric_limits<osh::Real>::infinity()) {
-                continue;
-            }
-            if(kp_event.second <= old_max_time) {
-                std::ostringstream os;
-                os << "existing event time: " << kp_event.second; 
-                os << " older than the previous maximum time: " << old_max_time;
-                ProgErrLog(os.str());
-            }
-            if(kp_event.second <= max_time_) {
-                next_event_.emplace(kp_event.second, kp_event.first);
+        for (size_t type = 0; type < entries_.size(); type++) {
+            for (size_t idx = 0; idx < entries_[type].size(); idx++) {
+                auto& e = entries_[type][idx];
+                if (!e.known || e.time == std::numeric_limits<osh::Real>::infinity()) {
+                    continue;
+                }
+                if (e.time <= old_max_time) {
+                    std::ostringstream os;
+                    os << "existing event time: " << e.time;
+                    os << " older than the previous maximum time: " << old_max_time;
+                    ProgErrLog(os.str());
+                }
+                if (e.time <= max_time_) {
+                    const KProcID id(static_cast<KProcType>(type), static_cast<unsigned>(idx));
+                    e.heap_pos = static_cast<unsigned>(heap_.size());
+                    heap_.push_back({e.time, sequence_++, id.data()});
+                }
             }
         }
+        // bottom-up heap construction
+        for (auto pos = static_cast<unsigned>(heap_.size() / 2); pos > 0; pos--) {
+            siftDown(pos - 1);
+        }
     } else if (old_max_time > max_time) {
         ProgErrLog("Previous max time is larger than new max time, missing reset of simulation?");
     }
 }
 
 Event EventQueue::getFirst() const {
-    if (next_event_.empty()) {
+    if (heap_.empty()) {
         return {std::numeric_limits<osh::Real>::infinity(), KProcID(0)};
     } else {
-        auto event = next_event_.begin();
+        const auto& event = heap_.front();
         // Ideally we would want to randomly select an event if several events
         // should happen at the same time. But this is rare enough that the bias
-        // resulting from always selecting .begin() instead should be
-        // acceptable.
-        return {event->first, KProcID(event->second)};
+        // resulting from always selecting the earliest inserted one instead
+        // should be acceptable.
+        return {event.time, KProcID(event.kproc)};
     }
 }
 
 std::ostream &operator<<(std::ostream &ostr, const EventQueue &events) {
-    return ostr << "  next_event_: " << events.next_event_
-                << "\n  kproc_to_event_time_: " << events.kproc_to_event_time_;
+    ostr << "  next_event_: (" << events.heap_.size() << "): [";
+    for (const auto& node: events.heap_) {
+        ostr << node.time << ": " << node.kproc << ", ";
+    }
+    return ostr << ']';
 }
 
 } // namespace kproc
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <iosfwd>
-#include <unordered_map>
+#include <limits>
+#include <vector>
 
 #include "kproc_id.hpp"
 #include "mpi/dist/tetopsplit/fwd.hpp"
@@ -16,14 +18,25 @@ using Event = std::pair<EventTime, kproc::KProcID>;
 /**
  * \brief A small utility struct to keeep track of the times at which
  * future events should happen.
+ *
+ * Events are stored in an indexed binary min-heap laid out in a flat array,
+ * together with a position table indexed by kproc type and id. Updating the
+ * time of a kproc is O(log N) and, once every kproc has been seen, does not
+ * allocate.
+ *
+ * Events with equal times are ordered by insertion, like in a
+ * std::multimap.
  */
 class EventQueue {
   public:
     EventQueue() = default;
 
     void clear() {
-        next_event_.clear();
-        kproc_to_event_time_.clear();
+        for (auto& entries: entries_) {
+            entries.clear();
+        }
+        heap_.clear();
+        sequence_ = 0;
         max_time_ = -std::numeric_limits<osh::Real>::epsilon();
     }
 
@@ -36,10 +49,44 @@ class EventQueue {
     friend std::ostream& operator<<(std::ostream& ostr, const EventQueue& events);
 
   private:
-    std::multimap<osh::Real, unsigned> next_event_ {};
-    std::unordered_map<unsigned, osh::Real> kproc_to_event_time_ {};
+    static constexpr unsigned not_in_heap = std::numeric_limits<unsigned>::max();
 
-    // maximum time that an event is put into the multimap
+    /// per kproc: last event time and position in the heap
+    struct Entry {
+        osh::Real time{std::numeric_limits<osh::Real>::quiet_NaN()};
+        unsigned heap_pos{not_in_heap};
+        bool known{false};
+    };
+
+    struct Node {
+        osh::Real time;
+        /// insertion stamp, breaks ties between equal times
+        unsigned long long sequence;
+        KProcID::data_t kproc;
+
+        inline bool operator<(const Node& rhs) const noexcept {
+            return time < rhs.time || (time == rhs.time && sequence < rhs.sequence);
+        }
+    };
+
+    Entry& entry(const KProcID id);
+    const Entry* findEntry(const KProcID id) const noexcept;
+
+    /// true if an event at time should be kept in the heap
+    inline bool queued(const osh::Real time) const noexcept {
+        return time != std::numeric_limits<osh::Real>::infinity() && time <= max_time_;
+    }
+
+    void place(unsigned pos, const Node& node);
+    void siftUp(unsigned pos);
+    void siftDown(unsigned pos);
+    void erase(unsigned pos);
+
+    std::array<std::vector<Entry>, num_kproc_types()> entries_{};
+    std::vector<Node> heap_{};
+    unsigned long long sequence_{};
+
+    // maximum time that an event is put into the heap
     osh::Real max_time_ {-std::numeric_limits<osh::Real>::epsilon()};
 };
 
@@ -1,6 +1,9 @@
 
 #include "kproc_state.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
 #include <stdexcept>
 
 #include <Omega_h_for.hpp>
@@ -12,6 +15,7 @@
 #include "reactions.hpp"
 #include "mpi/dist/tetopsplit/definition/compdef.hpp"
 #include "mpi/dist/tetopsplit/definition/statedef.hpp"
+#include "geom/dist/distmesh.hpp"
 #include "util/vocabulary.hpp"
 
 namespace steps {
@@ -32,6 +36,7 @@ KProcState::KProcState(const Statedef& statedef,
     setupDependencies(use_rssa, independent_kprocs);
     // extract connected components of the Gibson-Bruck dependency graph
     setupGroups(independent_kprocs);
+    setupGroupGlobalIds(mesh);
 }
 
 //------------------------------------------------------------------
@@ -226,6 +231,53 @@ void KProcState::setupGroups(bool independent_kprocs) {
 
 //------------------------------------------------------------------
 
+void KProcState::setupGroupGlobalIds(const DistMesh& mesh) {
+  using global_id = std::pair<std::uint32_t, std::uint32_t>;
+  // tets and triangles are numbered independently: the kproc type tells them
+  // apart
+  const auto tagged = [](KProcID kid, container::kproc_id kproc) {
+    return static_cast<std::uint32_t>(kid.type()) << 24 |
+           static_cast<std::uint32_t>(kproc.get());
+  };
+  const auto tri_global_id = [&mesh, &tagged](KProcID kid, const auto &processes) {
+    const auto tri = processes.boundaries()[kid.id()];
+    return global_id{static_cast<std::uint32_t>(mesh.getGlobalIndex(tri)),
+                     tagged(kid, processes.getReacDef(kid.id()).getKProcContainerIdx())};
+  };
+  const auto kproc_global_id = [&](KProcID kid) {
+    switch (kid.type()) {
+    case KProcType::Reac:
+      return global_id{
+          static_cast<std::uint32_t>(mesh.getGlobalIndex(reactions_.getOwnerPoint(kid.id()))),
+          tagged(kid, reactions_.getReacDef(kid.id()).getKProcContainerIdx())};
+    case KProcType::SReac:
+      return tri_global_id(kid, surface_reactions_);
+    case KProcType::VDepSReac:
+      return tri_global_id(kid, vdep_surface_reactions_);
+    case KProcType::GHKSReac:
+      return tri_global_id(kid, ghk_surface_reactions_);
+    case KProcType::Diff:
+      break;
+    }
+    std::ostringstream oss;
+    oss << "Unhandled kinetic process " << static_cast<int>(kid.type());
+    throw std::invalid_argument(oss.str());
+  };
+
+  group_global_ids_.clear();
+  group_global_ids_.reserve(static_cast<size_t>(disjoint_kprocs_.size()));
+  for (osh::LO g = 0; g < disjoint_kprocs_.size(); g++) {
+    global_id id{std::numeric_limits<std::uint32_t>::max(),
+                 std::numeric_limits<std::uint32_t>::max()};
+    for (auto kp: disjoint_kprocs_[g]) {
+      id = std::min(id, kproc_global_id(KProcID(static_cast<unsigned>(kp))));
+    }
+    group_global_ids_.push_back(id);
+  }
+}
+
+//------------------------------------------------------------------
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wreturn-type"
 template <typename NumMolecules>
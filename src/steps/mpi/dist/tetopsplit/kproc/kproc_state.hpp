@@ -1,9 +1,11 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <ostream>
 #include <set>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include <boost/graph/undirected_graph.hpp>
@@ -144,6 +146,19 @@ public:
    */
   const kproc_groups_t &groups() const noexcept { return disjoint_kprocs_; }
 
+  /**
+   * \brief Identifier of each group that depends neither on the partition of
+   * the mesh nor on the order of the groups: the smallest pair, over the kprocs
+   * of the group, of the global index of the element owning the kproc and of
+   * the kproc index in its compartment or patch, tagged with the kproc type.
+   *
+   * \return the identifiers, in the order of groups()
+   */
+  const std::vector<std::pair<std::uint32_t, std::uint32_t>> &
+  groupGlobalIds() const noexcept {
+    return group_global_ids_;
+  }
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wreturn-type"
   /**
@@ -171,6 +186,30 @@ public:
       throw std::invalid_argument(oss.str());
     }
   }
+
+  /**
+   * \brief Molecular state elements updated by the occurrence of a kinetic
+   * process.
+   *
+   * \param kid a kinetic process id
+   * \return the updated molecular state elements
+   */
+  const std::vector<MolStateElementID> &molStateElementsUpdates(const KProcID &kid) const {
+    switch (kid.type()) {
+    case KProcType::Reac:
+      return reactions().getMolStateElementsUpdates(kid.id());
+    case KProcType::SReac:
+      return surfaceReactions().getMolStateElementsUpdates(kid.id());
+    case KProcType::VDepSReac:
+      return vDepSurfaceReactions().getMolStateElementsUpdates(kid.id());
+    case KProcType::GHKSReac:
+      return ghkSurfaceReactions().getMolStateElementsUpdates(kid.id());
+    case KProcType::Diff:
+      std::ostringstream oss;
+      oss << "Unhandled kinetic process " << static_cast<int>(kid.type());
+      throw std::invalid_argument(oss.str());
+    }
+  }
 #pragma GCC diagnostic pop
 
   /**
@@ -272,6 +311,12 @@ private:
    */
   void setupGroups(bool independent_kprocs);
 
+  /**
+   * \brief Compute the identifiers returned by groupGlobalIds().
+   * \param mesh distributed mesh
+   */
+  void setupGroupGlobalIds(const DistMesh &mesh);
+
   /**
    * \brief Collate a class of kprocs in respect of their molecular state
    * dependencies.
@@ -306,6 +351,7 @@ private:
   dependencies_t ghk_surface_reactions_dependencies_;
 
   kproc_groups_t disjoint_kprocs_;
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> group_global_ids_;
 
   Reactions reactions_;
   SurfaceReactions surface_reactions_;
@@ -64,6 +64,20 @@ std::ostream& operator<<(
     return ostr << "PropensityGroup (GibsonBruck)" << '\n' << pg.events_;
 }
 
+template <typename NumMoleculesF, unsigned int PolicyF>
+std::ostream& operator<<(
+    std::ostream& ostr,
+    const PropensitiesGroup<NumMoleculesF,
+                            PolicyF,
+                            std::enable_if_t<PropensitiesTraits<PolicyF>::is_direct_sum_tree>>& pg) {
+    ostr << "PropensityGroup (DirectSumTree)\n"
+         << "  idx_: " << pg.idx_ << "\n  sums_: [";
+    for (size_t k = 0; k < pg.sums_.size(); k++) {
+        ostr << (k > 0 ? ", " : "") << pg.sums_[k];
+    }
+    return ostr << "]";
+}
+
 // explicit template instantiation definitions
 template class Propensities<osh::I32, PropensitiesPolicy::direct_without_next_event>;
 template class Propensities<osh::I64, PropensitiesPolicy::direct_without_next_event>;
@@ -73,6 +87,10 @@ template class Propensities<osh::I32, PropensitiesPolicy::direct_with_next_event
 template class Propensities<osh::I64, PropensitiesPolicy::direct_with_next_event>;
 template class Propensities<osh::I32, PropensitiesPolicy::gibson_bruck_with_next_event>;
 template class Propensities<osh::I64, PropensitiesPolicy::gibson_bruck_with_next_event>;
+template class Propensities<osh::I32, PropensitiesPolicy::direct_sum_tree_without_next_event>;
+template class Propensities<osh::I64, PropensitiesPolicy::direct_sum_tree_without_next_event>;
+template class Propensities<osh::I32, PropensitiesPolicy::direct_sum_tree_with_next_event>;
+template class Propensities<osh::I64, PropensitiesPolicy::direct_sum_tree_with_next_event>;
 
 template struct PropensitiesGroup<osh::I32, PropensitiesPolicy::direct_without_next_event>;
 template struct PropensitiesGroup<osh::I64, PropensitiesPolicy::direct_without_next_event>;
@@ -82,6 +100,10 @@ template struct PropensitiesGroup<osh::I32, PropensitiesPolicy::direct_with_next
 template struct PropensitiesGroup<osh::I64, PropensitiesPolicy::direct_with_next_event>;
 template struct PropensitiesGroup<osh::I32, PropensitiesPolicy::gibson_bruck_with_next_event>;
 template struct PropensitiesGroup<osh::I64, PropensitiesPolicy::gibson_bruck_with_next_event>;
+template struct PropensitiesGroup<osh::I32, PropensitiesPolicy::direct_sum_tree_without_next_event>;
+template struct PropensitiesGroup<osh::I64, PropensitiesPolicy::direct_sum_tree_without_next_event>;
+template struct PropensitiesGroup<osh::I32, PropensitiesPolicy::direct_sum_tree_with_next_event>;
+template struct PropensitiesGroup<osh::I64, PropensitiesPolicy::direct_sum_tree_with_next_event>;
 
 } // namespace kproc
 } // namespace dist
@@ -8,6 +8,7 @@
 
 #include "event_queue.hpp"
 #include "kproc_id.hpp"
+#include "sum_tree.hpp"
 #include "mpi/dist/tetopsplit/fwd.hpp"
 #include "rng/rng.hpp"
 #include "util/flat_multimap.hpp"
@@ -28,6 +29,7 @@ struct PropensitiesPolicy {
     static constexpr unsigned int with_next_event = 0b10;
     static constexpr unsigned int direct_event = 0b100;
     static constexpr unsigned int gibson_bruck_event = 0b1000;
+    static constexpr unsigned int direct_sum_tree_event = 0b10000;
 
     static constexpr unsigned int direct_without_next_event = without_next_event | direct_event;
     static constexpr unsigned int direct_with_next_event = with_next_event | direct_event;
@@ -35,10 +37,15 @@ struct PropensitiesPolicy {
                                                                     gibson_bruck_event;
     static constexpr unsigned int gibson_bruck_with_next_event = with_next_event |
                                                                  gibson_bruck_event;
+    static constexpr unsigned int direct_sum_tree_without_next_event = without_next_event |
+                                                                       direct_sum_tree_event;
+    static constexpr unsigned int direct_sum_tree_with_next_event = with_next_event |
+                                                                    direct_sum_tree_event;
 
     static constexpr unsigned int default_policy = direct_with_next_event;
 
-    static constexpr unsigned int search_method_mask = direct_event | gibson_bruck_event;
+    static constexpr unsigned int search_method_mask = direct_event | gibson_bruck_event |
+                                                       direct_sum_tree_event;
     static constexpr unsigned int next_event_mask = with_next_event | without_next_event;
 
     /**
@@ -67,6 +74,8 @@ struct PropensitiesPolicy {
             return direct_event;
         case NextEventSearchMethod::GibsonBruck:
             return gibson_bruck_event;
+        case NextEventSearchMethod::DirectSumTree:
+            return direct_sum_tree_event;
         default:
             static_assert(true, "Unexpected enum value");
         }
@@ -81,8 +90,8 @@ template <unsigned int Policy>
 struct PropensitiesTraits {
     static_assert((Policy & PropensitiesPolicy::search_method_mask) != 0,
                   "a search method must be specified");
-    static_assert((Policy & PropensitiesPolicy::search_method_mask) !=
-                      PropensitiesPolicy::search_method_mask,
+    static_assert(((Policy & PropensitiesPolicy::search_method_mask) &
+                   ((Policy & PropensitiesPolicy::search_method_mask) - 1)) == 0,
                   "only one search method must be specified");
     static_assert((Policy & PropensitiesPolicy::next_event_mask) != 0,
                   "event management must be specified");
@@ -94,6 +103,9 @@ struct PropensitiesTraits {
     static constexpr bool is_gibson_bruck = (Policy & PropensitiesPolicy::gibson_bruck_event) != 0;
     /// true if the direect method is selected, false otherwise
     static constexpr bool is_direct = (Policy & PropensitiesPolicy::direct_event) != 0;
+    /// true if the direct method with a sum tree is selected, false otherwise
+    static constexpr bool is_direct_sum_tree = (Policy &
+                                                PropensitiesPolicy::direct_sum_tree_event) != 0;
     /// true if the propensities should handle the next event, false otherwise
     static constexpr bool handle_next_event = (Policy & PropensitiesPolicy::with_next_event) != 0;
 };
@@ -590,6 +602,153 @@ struct PropensitiesGroup<NumMolecules,
     Propensities<NumMolecules, Policy>& propensities_;
 };
 
+//--------------------------------------------------------
+
+/**
+ * \brief A group of propensities where next event is searched via the Direct
+ * method of Gillespie, with the propensities of the group kept in a binary
+ * sum tree.
+ *
+ * Same draws as the \a Direct group, but updating the propensity of a kproc
+ * and selecting the kproc that fires are both O(log N) in the size of the
+ * group, whereas the \a Direct group recomputes its partial sums from the
+ * lowest updated index onward on every event. This pays off on large owned
+ * partitions where each event only changes a handful of propensities.
+ *
+ */
+template <typename NumMolecules, unsigned int Policy>
+struct PropensitiesGroup<NumMolecules,
+                         Policy,
+                         std::enable_if_t<PropensitiesTraits<Policy>::is_direct_sum_tree>> {
+    /**
+     * \brief Ctor.
+     *
+     * \param propensities all propensities of kprocs
+     * \param ids KProcIds of kprocs handled by the group
+     */
+    PropensitiesGroup(Propensities<NumMolecules, Policy>& propensities, const kproc_group_t& ids)
+        : idx_(static_cast<size_t>(ids.size()))
+        , ids_(ids)
+        , propensities_(propensities) {
+        std::transform(ids.begin(), ids.end(), idx_.begin(), [&propensities](osh::LO id) {
+            return propensities.ab(KProcID(static_cast<unsigned>(id)));
+        });
+        if constexpr (handle_next_event()) {
+            sums_.resize(static_cast<size_t>(ids.size()));
+        }
+        idx_.shrink_to_fit();
+    }
+
+    static constexpr bool handle_next_event() {
+        return PropensitiesTraits<Policy>::handle_next_event;
+    }
+
+    /**
+     * \brief reset the group data structure
+     */
+    template <typename RNG>
+    void reset(const MolState<NumMolecules>& /*mol_state*/,
+               RNG& /*rng*/,
+               const osh::Real /*state_time*/) {
+        // do nothing
+    }
+
+    void updateMaxTime(const osh::Real /*max_time*/) {
+        // do nothing
+    }
+
+    /**
+     * \brief Update the propensities of all kprocs and rebuild the sum tree.
+     *
+     * \param mol_state molecular state
+     */
+    template <typename RNG>
+    void update(const MolState<NumMolecules>& mol_state,
+                RNG& /*rng*/,
+                const osh::Real /*state_time*/) {
+        size_t k{};
+        for (auto it = ids_.begin(); it != ids_.end(); it++, k++) {
+            const auto propensity = propensities_.fun_(KProcID(static_cast<unsigned>(*it)),
+                                                       mol_state);
+            propensities_.v_[idx_[k]] = propensity;
+            if constexpr (handle_next_event()) {
+                sums_.set(k, propensity);
+            }
+        }
+        if constexpr (handle_next_event()) {
+            sums_.rebuild();
+        }
+    }
+
+    /**
+     * \brief Update the state of propensities of a selected number of kprocs.
+     *
+     * \param mol_state molecular state
+     * \param selection of kprocs that need update in the current group
+     */
+    template <typename T, typename RNG>
+    void update(const MolState<NumMolecules>& mol_state,
+                RNG& /*rng*/,
+                const Event& /*event*/,
+                const T& selection) {
+        using cast_type =
+            typename std::conditional<std::is_same<T, KProcDeps>::value, unsigned, KProcID>::type;
+        for (auto k: selection) {
+            KProcID kp(static_cast<cast_type>(k));
+            auto idx = propensities_.ab(kp);
+            const auto propensity = propensities_.fun_(kp, mol_state);
+            propensities_.v_[idx] = propensity;
+            if constexpr (handle_next_event()) {
+                sums_.update(propensities_.local_indices_[idx], propensity);
+            }
+        }
+    }
+
+    /**
+     * \brief Draw a kproc id from a discrete distribution of probabilities
+     * given by scaled propensities.
+     *
+     * Random numbers are drawn in the same order as in the \a Direct group.
+     *
+     * \param rng a random number generator
+     * \return a kproc sample
+     */
+    template <class RNG>
+    Event drawEvent(RNG& rng, osh::Real sim_time) {
+        // when the propensities are 0 or there we assume that the next event is at infinity
+        if (sums_.size() == 0) {
+            return {std::numeric_limits<osh::Real>::infinity(), KProcID(0)};
+        }
+        const osh::Real total = sums_.total();
+        if (total < std::numeric_limits<osh::Real>::epsilon()) {
+            return {std::numeric_limits<osh::Real>::infinity(), KProcID(0)};
+        }
+        osh::Real next_arrival;
+        if constexpr (std::is_same_v<RNG, steps::rng::RNG>) {
+            next_arrival = static_cast<osh::Real>(rng.getExp(total));
+        } else {
+            next_arrival = std::exponential_distribution<osh::Real>(total)(rng);
+        }
+        const auto k = sums_.search(total * propensities_.uniform_(rng));
+        return {sim_time + next_arrival, propensities_.kProcId(idx_[k])};
+    }
+
+    /// pretty printer
+    template <typename NumMoleculesF, unsigned int PolicyF>
+    friend std::ostream& operator<<(
+        std::ostream& ostr,
+        const PropensitiesGroup<NumMoleculesF,
+                                PolicyF,
+                                std::enable_if_t<PropensitiesTraits<PolicyF>::is_direct_sum_tree>>&
+            pg);
+
+  private:
+    std::vector<size_t> idx_;
+    kproc::kproc_group_t ids_;
+    SumTree<osh::Real> sums_;
+    Propensities<NumMolecules, Policy>& propensities_;
+};
+
 /**
  * \a PropensitiesGroup pretty printer
  */
@@ -610,6 +769,12 @@ extern template class Propensities<osh::I32, PropensitiesPolicy::direct_with_nex
 extern template class Propensities<osh::I64, PropensitiesPolicy::direct_with_next_event>;
 extern template class Propensities<osh::I32, PropensitiesPolicy::gibson_bruck_with_next_event>;
 extern template class Propensities<osh::I64, PropensitiesPolicy::gibson_bruck_with_next_event>;
+extern template class Propensities<osh::I32,
+                                   PropensitiesPolicy::direct_sum_tree_without_next_event>;
+extern template class Propensities<osh::I64,
+                                   PropensitiesPolicy::direct_sum_tree_without_next_event>;
+extern template class Propensities<osh::I32, PropensitiesPolicy::direct_sum_tree_with_next_event>;
+extern template class Propensities<osh::I64, PropensitiesPolicy::direct_sum_tree_with_next_event>;
 
 extern template struct PropensitiesGroup<osh::I32, PropensitiesPolicy::direct_without_next_event>;
 extern template struct PropensitiesGroup<osh::I64, PropensitiesPolicy::direct_without_next_event>;
@@ -623,6 +788,14 @@ extern template struct PropensitiesGroup<osh::I32,
                                          PropensitiesPolicy::gibson_bruck_with_next_event>;
 extern template struct PropensitiesGroup<osh::I64,
                                          PropensitiesPolicy::gibson_bruck_with_next_event>;
+extern template struct PropensitiesGroup<osh::I32,
+                                         PropensitiesPolicy::direct_sum_tree_without_next_event>;
+extern template struct PropensitiesGroup<osh::I64,
+                                         PropensitiesPolicy::direct_sum_tree_without_next_event>;
+extern template struct PropensitiesGroup<osh::I32,
+                                         PropensitiesPolicy::direct_sum_tree_with_next_event>;
+extern template struct PropensitiesGroup<osh::I64,
+                                         PropensitiesPolicy::direct_sum_tree_with_next_event>;
 
 } // namespace kproc
 } // namespace dist
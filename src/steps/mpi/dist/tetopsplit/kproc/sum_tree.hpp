@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace steps {
+namespace dist {
+namespace kproc {
+
+/**
+ * \brief A complete binary tree of partial sums over a fixed number of
+ * non-negative values.
+ *
+ * Leaves hold the values, every inner node holds the sum of its two children.
+ * Updating a single value and searching the value that a cumulative weight
+ * falls into are both O(log N).
+ *
+ * Inner nodes are recomputed from their children rather than incremented by
+ * a delta, so the sums never drift away from the values they cover no matter
+ * how many updates occurred.
+ *
+ * \tparam T value type
+ */
+template <typename T>
+class SumTree {
+  public:
+    SumTree() = default;
+
+    explicit SumTree(size_t size) {
+        resize(size);
+    }
+
+    /**
+     * \brief Resize the tree and set all values to zero.
+     */
+    void resize(size_t size) {
+        size_ = size;
+        capacity_ = 1;
+        while (capacity_ < size) {
+            capacity_ *= 2;
+        }
+        tree_.assign(2 * capacity_, T{});
+    }
+
+    /// \return the number of values
+    inline size_t size() const noexcept {
+        return size_;
+    }
+
+    /// \return the sum of all values
+    inline T total() const noexcept {
+        return tree_[1];
+    }
+
+    /// \return the value at index \a idx
+    inline T operator[](size_t idx) const noexcept {
+        assert(idx < size_);
+        return tree_[capacity_ + idx];
+    }
+
+    /**
+     * \brief Set the value at index \a idx without updating the partial sums.
+     * rebuild() must be called once all values have been set.
+     */
+    inline void set(size_t idx, T value) noexcept {
+        assert(idx < size_);
+        tree_[capacity_ + idx] = value;
+    }
+
+    /**
+     * \brief Recompute all partial sums from the values, O(N).
+     */
+    void rebuild() noexcept {
+        for (size_t node = capacity_ - 1; node > 0; node--) {
+            tree_[node] = tree_[2 * node] + tree_[2 * node + 1];
+        }
+    }
+
+    /**
+     * \brief Set the value at index \a idx and update the partial sums
+     * along the path to the root, O(log N).
+     */
+    void update(size_t idx, T value) noexcept {
+        assert(idx < size_);
+        size_t node = capacity_ + idx;
+        tree_[node] = value;
+        for (node /= 2; node > 0; node /= 2) {
+            tree_[node] = tree_[2 * node] + tree_[2 * node + 1];
+        }
+    }
+
+    /**
+     * \brief Search the index of the value that the cumulative weight
+     * \a weight falls into, i.e. the first index whose inclusive prefix sum
+     * is strictly greater than \a weight.
+     *
+     * Subtrees summing to zero are never selected, so rounding errors on
+     * \a weight close to total() cannot select a zero value. The total must
+     * be strictly positive.
+     */
+    size_t search(T weight) const noexcept {
+        assert(total() > T{});
+        size_t node = 1;
+        while (node < capacity_) {
+            const size_t left = 2 * node;
+            if (weight < tree_[left] || !(tree_[left + 1] > T{})) {
+                node = left;
+            } else {
+                weight -= tree_[left];
+                node = left + 1;
+            }
+        }
+        assert(node - capacity_ < size_);
+        return node - capacity_;
+    }
+
+  private:
+    size_t size_{};
+    size_t capacity_{1};
+    /// 1-based heap layout: node i has children 2i and 2i+1, leaves start at capacity_
+    std::vector<T> tree_ = std::vector<T>(2);
+};
+
+}  // namespace kproc
+}  // namespace dist
+}  // namespace steps
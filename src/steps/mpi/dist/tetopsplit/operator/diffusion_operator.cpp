@@ -1,5 +1,6 @@
 #include "diffusion_operator.hpp"
 
+#include <cstdint>
 #include <random>
 
 #include <Omega_h_for.hpp>
@@ -18,8 +19,34 @@ template <typename RNG, typename NumMolecules>
 DiffusionOperator<RNG, NumMolecules>::DiffusionOperator(
     DistMesh &t_mesh, RNG &t_rng, MolState<NumMolecules> &t_pools,
     kproc::Diffusions<RNG, NumMolecules> &t_diffusions)
-    : mesh(t_mesh), rng(t_rng), pools(t_pools), diffusions_(t_diffusions),
-      ur_distribution(0, 1) {}
+    : mesh(t_mesh), rng(t_rng), pools(t_pools), diffusions_(t_diffusions) {
+    const auto& neighbors = mesh.tet_neighbors_int_data();
+    const auto is_halo = [&](mesh::tetrahedron_id_t element) {
+        for (auto face = 0; face < neighbors.size(element.get()); face++) {
+            const auto neighbor = mesh::tetrahedron_id_t(neighbors(element.get(), face)[0]);
+            if (!mesh.isOwned(neighbor)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    osh::LO num_halo_elems{};
+    for (auto element: mesh.owned_elems()) {
+        num_halo_elems += is_halo(element) ? 1 : 0;
+    }
+    osh::Write<osh::LO> halo_elems(num_halo_elems);
+    osh::Write<osh::LO> interior_elems(mesh.owned_elems().size() - num_halo_elems);
+    osh::LO halo_idx{}, interior_idx{};
+    for (auto element: mesh.owned_elems()) {
+        if (is_halo(element)) {
+            halo_elems[halo_idx++] = element.get();
+        } else {
+            interior_elems[interior_idx++] = element.get();
+        }
+    }
+    halo_elems_ = mesh::tetrahedron_ids(halo_elems);
+    interior_elems_ = mesh::tetrahedron_ids(interior_elems);
+}
 
 template <typename RNG, typename NumMolecules>
 void DiffusionOperator<RNG, NumMolecules>::operator()(const osh::Real opsplit_period,
@@ -27,53 +54,100 @@ void DiffusionOperator<RNG, NumMolecules>::operator()(const osh::Real opsplit_pe
     Instrumentor::phase p("DiffusionOperator::operator()");
 
     diffusions_.reset();
-    species_leaving_elements(opsplit_period, state_time);
-
-    num_diffusions_ += diffusions_.leaving_molecules().num_diffusions();
-
-    Instrumentor::phase_begin("sync_delta_pools()");
-    diffusions_.leaving_molecules().sync_delta_pools();
-    Instrumentor::phase_end("sync_delta_pools()");
-
-    species_entering_elements();
+    ++step_;
+    auto& leaving_molecules = diffusions_.leaving_molecules();
+    if (overlap_halo_exchange_) {
+        // the ghosts of the other processes only need the increments of the halo elements:
+        // send them first, then work on the interior while the messages are in flight
+        species_leaving_elements(halo_elems_, opsplit_period, state_time);
+        leaving_molecules.start_sync_delta_pools();
+        species_leaving_elements(interior_elems_, opsplit_period, state_time);
+        // interior elements only read the increments of owned elements
+        species_entering_elements(interior_elems_);
+
+        num_diffusions_ += leaving_molecules.num_diffusions();
+
+        Instrumentor::phase_begin("sync_delta_pools()");
+        leaving_molecules.finish_sync_delta_pools();
+        Instrumentor::phase_end("sync_delta_pools()");
+
+        species_entering_elements(halo_elems_);
+    } else {
+        species_leaving_elements(mesh.owned_elems(), opsplit_period, state_time);
+
+        num_diffusions_ += leaving_molecules.num_diffusions();
+
+        Instrumentor::phase_begin("sync_delta_pools()");
+        leaving_molecules.sync_delta_pools();
+        Instrumentor::phase_end("sync_delta_pools()");
+
+        species_entering_elements(mesh.owned_elems());
+    }
 }
 
 template <typename RNG, typename NumMolecules>
-void DiffusionOperator<RNG, NumMolecules>::species_leaving_elements(const osh::Real opsplit_period,
-                                                                    const osh::Real state_time) {
+void DiffusionOperator<RNG, NumMolecules>::species_leaving_elements(
+    const mesh::tetrahedron_ids& elements,
+    const osh::Real opsplit_period,
+    const osh::Real state_time) {
     Instrumentor::phase p("DiffusionOperator::species_leaving_elements()");
 
-    const auto lambda = [this, opsplit_period, state_time](osh::LO elemIdx)
-        __attribute__((always_inline, flatten)) {
-        const auto element = mesh.owned_elems()[elemIdx];
-        for (auto species: pools.species(element)) {
-            const auto num_molecules = pools(element, species);
-            if (num_molecules > 0) {
-                species_leaving_element(
-                    element, species, num_molecules, opsplit_period, state_time);
+    if (counter_rng_) {
+        // each (element, species, step) draws from its own generator: no state is shared
+        // between the iterations, and the numbers do not depend on the owner of the element
+        const auto lambda = [this, &elements, opsplit_period, state_time](osh::LO elemIdx)
+            __attribute__((always_inline, flatten)) {
+            const auto element = elements[elemIdx];
+            const auto global_index = static_cast<std::uint32_t>(mesh.getGlobalIndex(element));
+            for (auto species: pools.species(element)) {
+                const auto num_molecules = pools(element, species);
+                if (num_molecules > 0) {
+                    steps::rng::CounterRNG gen(counter_rng_seed_,
+                                               steps::rng::CounterRNG::DIFFUSION,
+                                               global_index,
+                                               static_cast<std::uint32_t>(species.get()),
+                                               step_);
+                    species_leaving_element(
+                        element, species, num_molecules, opsplit_period, state_time, gen);
+                }
             }
-        }
-    };
-    osh::parallel_for(mesh.owned_elems().size(), lambda);
+        };
+        osh::parallel_for(elements.size(), lambda);
+    } else {
+        const auto lambda = [this, &elements, opsplit_period, state_time](osh::LO elemIdx)
+            __attribute__((always_inline, flatten)) {
+            const auto element = elements[elemIdx];
+            for (auto species: pools.species(element)) {
+                const auto num_molecules = pools(element, species);
+                if (num_molecules > 0) {
+                    species_leaving_element(
+                        element, species, num_molecules, opsplit_period, state_time, rng);
+                }
+            }
+        };
+        osh::parallel_for(elements.size(), lambda);
+    }
 }
 
 template <typename RNG, typename NumMolecules>
+template <typename Generator>
 void DiffusionOperator<RNG, NumMolecules>::species_leaving_element(mesh::tetrahedron_id_t element,
                                                                    container::species_id species,
                                                                    NumMolecules num_molecules,
                                                                    const osh::Real opsplit_period,
-                                                                   const osh::Real state_time) {
+                                                                   const osh::Real state_time,
+                                                                   Generator& gen) {
     const osh::Real rates_sum = diffusions_.rates_sum(element, species);
     const auto delta_pool_total = this->get_leaving_molecules(
-        element, species, num_molecules, rates_sum, opsplit_period, state_time);
+        element, species, num_molecules, rates_sum, opsplit_period, state_time, gen);
     if (delta_pool_total > 0) {
         // no need to update occupancy here because channels cannot diffuse and rd occupancy should
         // not track diffusion changes
         pools.add(element, species, -delta_pool_total);
         if (delta_pool_total <= diffusion_threshold_) {
-            species_leaving_element_standard(element, species, delta_pool_total, rates_sum);
+            species_leaving_element_standard(element, species, delta_pool_total, rates_sum, gen);
         } else {
-            species_leaving_element_binomial(element, species, delta_pool_total, rates_sum);
+            species_leaving_element_binomial(element, species, delta_pool_total, rates_sum, gen);
         }
     }
 }
@@ -85,11 +159,13 @@ void DiffusionOperator<RNG, NumMolecules>::species_leaving_element(mesh::tetrahe
 // For a small vector the current implementation is slightly faster.
 
 template <typename RNG, typename NumMolecules>
+template <typename Generator>
 void DiffusionOperator<RNG, NumMolecules>::species_leaving_element_standard(
     mesh::tetrahedron_id_t element, container::species_id species,
-    NumMolecules delta_pool_total, osh::Real scaled_dcst) {
+    NumMolecules delta_pool_total, osh::Real scaled_dcst, Generator& gen) {
+  std::uniform_real_distribution<double> ur_distribution(0, 1);
   while (delta_pool_total > 0) {
-    const auto selector = ur_distribution(rng) * scaled_dcst;
+    const auto selector = ur_distribution(gen) * scaled_dcst;
     osh::Real partial_sum_scaled_dcst{0};
     const auto &rates = diffusions_.rates().rates(element, species);
     for (auto direction = 0; direction < static_cast<osh::LO>(rates.size());
@@ -107,23 +183,24 @@ void DiffusionOperator<RNG, NumMolecules>::species_leaving_element_standard(
 }
 
 template <typename RNG, typename NumMolecules>
+template <typename Generator>
 void DiffusionOperator<RNG, NumMolecules>::species_leaving_element_binomial(
     mesh::tetrahedron_id_t element, container::species_id species,
-    NumMolecules delta_pool_total, osh::Real scaled_dcst) {
+    NumMolecules delta_pool_total, osh::Real scaled_dcst, Generator& gen) {
   const auto &rates = diffusions_.rates().rates(element, species);
   for (auto e = 0; e < static_cast<osh::LO>(rates.size());
        ++e) { // loop over boundary/faces
       const auto probability_e = rates[static_cast<size_t>(e)] / scaled_dcst;
       auto delta_pool_e = delta_pool_total;
       if (probability_e < 1) {
-          if constexpr (std::is_same_v<RNG, steps::rng::RNG>) {
+          if constexpr (std::is_same_v<Generator, steps::rng::RNG>) {
               delta_pool_e = static_cast<NumMolecules>(
-                  this->rng.getBinom(static_cast<uint>(delta_pool_total),
-                                     static_cast<double>(probability_e)));
+                  gen.getBinom(static_cast<uint>(delta_pool_total),
+                               static_cast<double>(probability_e)));
           } else {
               std::binomial_distribution<NumMolecules> leaving_through_e(delta_pool_total,
                                                                          probability_e);
-              delta_pool_e = leaving_through_e(this->rng);
+              delta_pool_e = leaving_through_e(gen);
           }
           delta_pool_total -= delta_pool_e;
           scaled_dcst -= rates[static_cast<size_t>(e)];
@@ -190,7 +267,8 @@ private:
 };
 
 template <typename RNG, typename NumMolecules>
-void DiffusionOperator<RNG, NumMolecules>::species_entering_elements() {
+void DiffusionOperator<RNG, NumMolecules>::species_entering_elements(
+    const mesh::tetrahedron_ids& elements) {
 
   Instrumentor::phase p("DiffusionOperator::species_entering_elements()");
 
@@ -198,23 +276,25 @@ void DiffusionOperator<RNG, NumMolecules>::species_entering_elements() {
                                                               pools,
                                                               diffusions_.leaving_molecules());
 
-  const auto lambda = [this, &func_per_element](osh::LO ownedElemIdx)
+  const auto lambda = [&elements, &func_per_element](osh::LO elemIdx)
       __attribute__((always_inline, flatten)) {
-      const auto elem = mesh.owned_elems()[ownedElemIdx];
+      const auto elem = elements[elemIdx];
       func_per_element(mesh::tetrahedron_id_t(elem));
   };
 
-  osh::parallel_for(mesh.owned_elems().size(), lambda);
+  osh::parallel_for(elements.size(), lambda);
 }
 
 template <typename RNG, typename NumMolecules>
+template <typename Generator>
 NumMolecules DiffusionOperator<RNG, NumMolecules>::get_leaving_molecules(
     mesh::tetrahedron_id_t elem,
     container::species_id species,
     NumMolecules num_molecules,
     osh::Real sum_rates,
     const osh::Real opsplit_period,
-    const osh::Real state_time) {
+    const osh::Real state_time,
+    Generator& gen) {
     // if probability is 0 we do not diffuse
     if (sum_rates == 0)
         return 0;
@@ -223,8 +303,8 @@ NumMolecules DiffusionOperator<RNG, NumMolecules>::get_leaving_molecules(
     const auto occupancy = pools.get_occupancy_rd(elem, species, state_time + opsplit_period);
 
     const auto mean_population =
-        math::stochastic_round<NumMolecules>(occupancy, this->rng, num_molecules);
-    return diffusions_.total_leaving()(mean_population, sum_rates, opsplit_period);
+        math::stochastic_round<NumMolecules>(occupancy, gen, num_molecules);
+    return diffusions_.total_leaving()(mean_population, sum_rates, opsplit_period, gen);
 }
 
 // explicit template instantiation definitions
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 #include <Omega_h_array.hpp>
@@ -7,6 +8,7 @@
 
 #include "../kproc/diffusions.hpp"
 #include "geom/dist/fwd.hpp"
+#include "rng/counter_rng.hpp"
 #include "rng/rng.hpp"
 
 namespace steps {
@@ -24,20 +26,56 @@ public:
     diffusion_threshold_ = threshold;
   }
 
+  /**
+   * Draw the random numbers of each (element, species, step) from its own
+   * counter-based generator instead of the generator of the simulation.
+   * The number of molecules leaving the owned elements can then be computed
+   * in parallel, and trajectories no longer depend on the partitioning of
+   * the mesh or on the number of threads.
+   *
+   * \param seed Seed of the generators, must be the same on all ranks
+   */
+  inline void setCounterBasedRNG(std::uint64_t seed) noexcept {
+    counter_rng_ = true;
+    counter_rng_seed_ = seed;
+  }
+
+  inline bool isCounterBasedRNG() const noexcept { return counter_rng_; }
+
+  /**
+   * Restart the counter of the counter-based generators, so that a reset
+   * simulation draws the same numbers as a new one.
+   */
+  inline void reset() noexcept { step_ = 0; }
+
+  /**
+   * Overlap the synchronization of the delta pools with computations: the
+   * leaving molecules of the elements that are ghosts on other processes are
+   * computed first, then the exchange is started while the other elements
+   * are processed, as well as the entering molecules of the elements without
+   * ghost neighbors. Enabled by default.
+   */
+  inline void setHaloExchangeOverlap(bool overlap) noexcept {
+    overlap_halo_exchange_ = overlap;
+  }
+
 private:
-  /** Compute leaving species on all owned elements
+  /** Compute leaving species on the given owned elements
    *
+   * @param elements
    * @param opsplit_period
    * @param state_time
    */
-  void species_leaving_elements(osh::Real opsplit_period, osh::Real state_time);
+  void species_leaving_elements(const mesh::tetrahedron_ids& elements,
+                                osh::Real opsplit_period,
+                                osh::Real state_time);
 
   /**
-   * Update state of owned elements to take into account entering species
+   * Update state of the given owned elements to take into account entering species
    *
    * no need for opsplit_period apparently
    */
-  void species_entering_elements();
+  void species_entering_elements(const mesh::tetrahedron_ids& elements);
 
   /** Compute species leaving a given element (triangle/tetrahedron)
    *
@@ -46,22 +84,29 @@ private:
    * @param num_molecules
    * @param opsplit_period
    * @param state_time
+   * @param gen random number generator to draw from
    */
+  template <typename Generator>
   void species_leaving_element(mesh::tetrahedron_id_t element,
                                container::species_id species,
                                NumMolecules num_molecules,
                                osh::Real opsplit_period,
-                               osh::Real state_time);
+                               osh::Real state_time,
+                               Generator& gen);
 
+  template <typename Generator>
   void species_leaving_element_standard(mesh::tetrahedron_id_t element,
                                         container::species_id species,
                                         NumMolecules delta_pool_total,
-                                        osh::Real scaled_dcst);
+                                        osh::Real scaled_dcst,
+                                        Generator& gen);
 
+  template <typename Generator>
   void species_leaving_element_binomial(mesh::tetrahedron_id_t element,
                                         container::species_id species,
                                         NumMolecules delta_pool_total,
-                                        osh::Real scaled_dcst);
+                                        osh::Real scaled_dcst,
+                                        Generator& gen);
 
   /** Compute number of molecules leaving an element (triangle/tetrahedron)
    *
@@ -71,14 +116,17 @@ private:
    * @param sum_rates
    * @param opsplit_period
    * @param state_time
+   * @param gen random number generator to draw from
    * \return number of molecules leaving
    */
+  template <typename Generator>
   NumMolecules get_leaving_molecules(mesh::tetrahedron_id_t elem,
                                      container::species_id species,
                                      NumMolecules num_molecules,
                                      osh::Real sum_rates,
                                      osh::Real opsplit_period,
-                                     osh::Real state_time);
+                                     osh::Real state_time,
+                                     Generator& gen);
 
   const DistMesh& mesh;
   RNG& rng;
@@ -87,7 +135,17 @@ private:
   osh::I64 num_diffusions_{};
 
   osh::I64 diffusion_threshold_{10};
-  std::uniform_real_distribution<double> ur_distribution;
+
+  /// owned elements with at least one neighbor owned by another process
+  mesh::tetrahedron_ids halo_elems_;
+  /// owned elements whose neighbors are all owned by this process
+  mesh::tetrahedron_ids interior_elems_;
+  bool overlap_halo_exchange_{true};
+
+  bool counter_rng_{false};
+  std::uint64_t counter_rng_seed_{};
+  /// number of calls to operator(), counter of the counter-based generators
+  std::uint32_t step_{};
 };
 
 // explicit template instantiation declarations
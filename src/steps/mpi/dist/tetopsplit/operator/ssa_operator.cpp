@@ -1,7 +1,12 @@
 #include "ssa_operator.hpp"
 
+#include <exception>
+#include <numeric>
+#include <unordered_map>
+
 #include "../kproc/diffusions.hpp"
 #include "../kproc/kproc_state.hpp"
+#include "rng/counter_rng.hpp"
 #include "util/profile/profiler_interface.h"
 
 #undef MPI_Allreduce
@@ -26,38 +31,137 @@ osh::Real SSAOperator<RNG, NumMolecules, SearchMethod>::run(const osh::Real peri
                                                             const osh::Real state_time) {
     Instrumentor::phase p("SSAOperator::run()");
     osh::Real slack{-period};
-    for (auto& group: pPropensities.groups()) {
-        if(need_reset) {
-            group.template reset<RNG>(pMolState, rng_, state_time);
+    auto& groups = pPropensities.groups();
+    if (counter_rng_) {
+        ++step_;
+        if (subdomains_.empty()) {
+            setupSubdomains();
         }
-        group.updateMaxTime(max_time_);
-        group.template update<RNG>(pMolState, rng_, state_time);
-        osh::Real cumulative_dt{};
-        while (true) {
-            const kproc::Event& event = group.drawEvent(rng_, state_time + cumulative_dt);
-            if (event.first > (state_time + period)) {
-                break;
-            }
-            cumulative_dt = (event.first - state_time);
-            slack = std::max(slack, cumulative_dt - period);
-            pKProcState.updateMolStateAndOccupancy(pMolState,
-                                                   event.first,
-                                                   event.second);
-            if (event.second.type() == kproc::KProcType::GHKSReac) {
-                pKProcState.updateGHKChargeFlow(event.second.id());
+        const auto& group_ids = pKProcState.groupGlobalIds();
+        osh::I64 num_events{};
+        std::exception_ptr error;
+        // sub-domains update disjoint parts of the molecular state: no synchronization is
+        // needed until the end of the operator-split period
+#pragma omp parallel for schedule(dynamic, 16) reduction(max : slack) reduction(+ : num_events)
+        for (long s = 0; s < static_cast<long>(subdomains_.size()); s++) {
+            try {
+                for (auto g: subdomains_[static_cast<size_t>(s)]) {
+                    // keyed on the group contents, not on its rank-local index
+                    const auto& id = group_ids[g];
+                    steps::rng::CounterRNG gen(counter_rng_seed_,
+                                               steps::rng::CounterRNG::SSA,
+                                               id.first,
+                                               id.second,
+                                               step_);
+                    slack = std::max(slack,
+                                     runGroup(groups[g], gen, period, state_time, num_events));
+                }
+            } catch (...) {
+#pragma omp critical(steps_dist_ssa_operator)
+                if (!error) {
+                    error = std::current_exception();
+                }
             }
-            const kproc::KProcDeps& dependencies = pKProcState.dependenciesFromEvent(event.second);
-            group.template update<kproc::KProcDeps, RNG>(pMolState, rng_, event, dependencies);
-            extent += 1;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        extent += num_events;
+    } else {
+        for (auto& group: groups) {
+            slack = std::max(slack, runGroup(group, rng_, period, state_time, extent));
         }
     }
     need_reset = false;
     return slack;
 }
 
+template <typename RNG, typename NumMolecules, NextEventSearchMethod SearchMethod>
+template <class Generator>
+osh::Real SSAOperator<RNG, NumMolecules, SearchMethod>::runGroup(group_type& group,
+                                                                 Generator& rng,
+                                                                 const osh::Real period,
+                                                                 const osh::Real state_time,
+                                                                 osh::I64& num_events) {
+    osh::Real slack{-period};
+    if(need_reset) {
+        group.template reset<Generator>(pMolState, rng, state_time);
+    }
+    group.updateMaxTime(max_time_);
+    group.template update<Generator>(pMolState, rng, state_time);
+    osh::Real cumulative_dt{};
+    while (true) {
+        const kproc::Event& event = group.drawEvent(rng, state_time + cumulative_dt);
+        if (event.first > (state_time + period)) {
+            break;
+        }
+        cumulative_dt = (event.first - state_time);
+        slack = std::max(slack, cumulative_dt - period);
+        pKProcState.updateMolStateAndOccupancy(pMolState,
+                                               event.first,
+                                               event.second);
+        if (event.second.type() == kproc::KProcType::GHKSReac) {
+            pKProcState.updateGHKChargeFlow(event.second.id());
+        }
+        const kproc::KProcDeps& dependencies = pKProcState.dependenciesFromEvent(event.second);
+        group.template update<kproc::KProcDeps, Generator>(pMolState, rng, event, dependencies);
+        num_events += 1;
+    }
+    return slack;
+}
+
+template <typename RNG, typename NumMolecules, NextEventSearchMethod SearchMethod>
+void SSAOperator<RNG, NumMolecules, SearchMethod>::setCounterBasedRNG(std::uint64_t seed) {
+    counter_rng_ = true;
+    counter_rng_seed_ = seed;
+}
+
+template <typename RNG, typename NumMolecules, NextEventSearchMethod SearchMethod>
+void SSAOperator<RNG, NumMolecules, SearchMethod>::setupSubdomains() {
+    // union-find over the groups: two groups updating the same molecular state element, e.g.
+    // a product that is not a reactant of any kproc, must run on the same thread
+    const auto& kproc_groups = pKProcState.groups();
+    const auto num_groups = static_cast<size_t>(kproc_groups.size());
+    std::vector<size_t> parent(num_groups);
+    std::iota(parent.begin(), parent.end(), 0);
+    const auto find = [&parent](size_t g) {
+        while (parent[g] != g) {
+            parent[g] = parent[parent[g]];
+            g = parent[g];
+        }
+        return g;
+    };
+    std::unordered_map<MolStateElementID, size_t, boost::hash<MolStateElementID>> writers;
+    for (size_t g = 0; g < num_groups; g++) {
+        for (auto kp: kproc_groups[static_cast<osh::LO>(g)]) {
+            const kproc::KProcID kid(static_cast<unsigned>(kp));
+            for (const auto& elmt: pKProcState.molStateElementsUpdates(kid)) {
+                const auto it = writers.emplace(elmt, g).first;
+                const auto root = find(it->second);
+                const auto this_root = find(g);
+                if (root != this_root) {
+                    parent[std::max(root, this_root)] = std::min(root, this_root);
+                }
+            }
+        }
+    }
+    // sub-domains are ordered by their first group
+    std::vector<size_t> root2subdomain(num_groups, num_groups);
+    subdomains_.clear();
+    for (size_t g = 0; g < num_groups; g++) {
+        auto& subdomain = root2subdomain[find(g)];
+        if (subdomain == num_groups) {
+            subdomain = subdomains_.size();
+            subdomains_.emplace_back();
+        }
+        subdomains_[subdomain].push_back(g);
+    }
+}
+
 template <typename RNG, typename NumMolecules, NextEventSearchMethod SearchMethod>
 void SSAOperator<RNG, NumMolecules, SearchMethod>::reset() {
     need_reset = true;
+    step_ = 0;
 }
 
 template <typename RNG, typename NumMolecules, NextEventSearchMethod SearchMethod>
@@ -74,6 +178,10 @@ template class SSAOperator<std::mt19937, osh::I32,
                            NextEventSearchMethod::GibsonBruck>;
 template class SSAOperator<std::mt19937, osh::I64,
                            NextEventSearchMethod::GibsonBruck>;
+template class SSAOperator<std::mt19937, osh::I32,
+                           NextEventSearchMethod::DirectSumTree>;
+template class SSAOperator<std::mt19937, osh::I64,
+                           NextEventSearchMethod::DirectSumTree>;
 
 template class SSAOperator<steps::rng::RNG, osh::I32,
                            NextEventSearchMethod::Direct>;
@@ -83,6 +191,10 @@ template class SSAOperator<steps::rng::RNG, osh::I32,
                            NextEventSearchMethod::GibsonBruck>;
 template class SSAOperator<steps::rng::RNG, osh::I64,
                            NextEventSearchMethod::GibsonBruck>;
+template class SSAOperator<steps::rng::RNG, osh::I32,
+                           NextEventSearchMethod::DirectSumTree>;
+template class SSAOperator<steps::rng::RNG, osh::I64,
+                           NextEventSearchMethod::DirectSumTree>;
 
 } // namespace dist
 } // namespace steps
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "../kproc/fwd.hpp"
 #include "geom/dist/fwd.hpp"
@@ -58,6 +62,7 @@ public:
    * This delay reset is needed as the call of simulation reset is before
    * molecule/propensity changes, but the reset of this operator should be 
    * performed after the molecule/propensity changes. 
+   * The counter of the counter-based generators restarts immediately.
    */
   void reset();
 
@@ -68,7 +73,45 @@ public:
    */
   void updateMaxTime(const osh::Real max_time);
 
+  /**
+   * \brief Run the independent groups of kprocs on the OpenMP threads.
+   *
+   * Each group draws from its own counter-based generator instead of the
+   * generator of the simulation, keyed on KProcState::groupGlobalIds(). Groups that update the same molecular state
+   * elements are gathered in sub-domains, which are dispatched over the
+   * threads during the operator-split period. Results do not depend on the
+   * number of threads. Groups are independent only if the kprocs were split
+   * with independent_kprocs (see KProcState), otherwise there is a single
+   * group and no parallelism.
+   *
+   * \param seed seed of the counter-based generators
+   */
+  void setCounterBasedRNG(std::uint64_t seed);
+
 private:
+  using propensities_type =
+      kproc::Propensities<NumMolecules,
+                          kproc::PropensitiesPolicy::get<SearchMethod>() |
+                              kproc::PropensitiesPolicy::with_next_event>;
+  using group_type = typename std::decay_t<
+      decltype(std::declval<propensities_type&>().groups())>::value_type;
+
+  /**
+   * \brief Execute the operator on one group of kprocs
+   *
+   * \param num_events incremented by the number of kinetic events
+   * \return the slack between the time of the last event and the period
+   */
+  template <class Generator>
+  osh::Real runGroup(group_type& group,
+                     Generator& rng,
+                     const osh::Real period,
+                     const osh::Real state_time,
+                     osh::I64& num_events);
+
+  /// gather the groups that update the same molecular state elements
+  void setupSubdomains();
+
   void resetOccupancy(const MolState<NumMolecules>& molState) const;
   
   MolState<NumMolecules> &pMolState;
@@ -77,13 +120,17 @@ private:
   osh::Reals potential_on_vertices_;
 
   osh::I64 extent{};
-  kproc::Propensities<NumMolecules,
-                      kproc::PropensitiesPolicy::get<SearchMethod>() |
-                          kproc::PropensitiesPolicy::with_next_event>
-      pPropensities;
+  propensities_type pPropensities;
 
   bool  need_reset {true};
   osh::Real max_time_ {};
+
+  bool counter_rng_{false};
+  std::uint64_t counter_rng_seed_{};
+  /// number of calls to run(), counter of the counter-based generators
+  std::uint32_t step_{};
+  /// indices of the groups of each sub-domain
+  std::vector<std::vector<size_t>> subdomains_;
 };
 
 // explicit template instantiation declarations
@@ -95,6 +142,10 @@ extern template class SSAOperator<std::mt19937, osh::I32,
                                   NextEventSearchMethod::GibsonBruck>;
 extern template class SSAOperator<std::mt19937, osh::I64,
                                   NextEventSearchMethod::GibsonBruck>;
+extern template class SSAOperator<std::mt19937, osh::I32,
+                                  NextEventSearchMethod::DirectSumTree>;
+extern template class SSAOperator<std::mt19937, osh::I64,
+                                  NextEventSearchMethod::DirectSumTree>;
 
 extern template class SSAOperator<steps::rng::RNG, osh::I32,
                                   NextEventSearchMethod::Direct>;
@@ -104,6 +155,10 @@ extern template class SSAOperator<steps::rng::RNG, osh::I32,
                                   NextEventSearchMethod::GibsonBruck>;
 extern template class SSAOperator<steps::rng::RNG, osh::I64,
                                   NextEventSearchMethod::GibsonBruck>;
+extern template class SSAOperator<steps::rng::RNG, osh::I32,
+                                  NextEventSearchMethod::DirectSumTree>;
+extern template class SSAOperator<steps::rng::RNG, osh::I64,
+                                  NextEventSearchMethod::DirectSumTree>;
 
 } // namespace dist
 } // namespace steps
@@ -828,6 +828,23 @@ void OmegaHSimulation<SSA, RNG, NumMolecules, SearchMethod>::
   data->diffOp.setBinomialThreshold(static_cast<osh::GO>(threshold));
 }
 
+template <SSAMethod SSA, typename RNG, typename NumMolecules,
+          NextEventSearchMethod SearchMethod>
+void OmegaHSimulation<SSA, RNG, NumMolecules, SearchMethod>::
+    setCounterBasedRNG(std::uint64_t seed) {
+  data->diffOp.setCounterBasedRNG(seed);
+  if constexpr (SSA == SSAMethod::SSA) {
+    data->ssaOp.setCounterBasedRNG(seed);
+  }
+}
+
+template <SSAMethod SSA, typename RNG, typename NumMolecules,
+          NextEventSearchMethod SearchMethod>
+void OmegaHSimulation<SSA, RNG, NumMolecules, SearchMethod>::
+    setDiffOpHaloExchangeOverlap(bool overlap) {
+  data->diffOp.setHaloExchangeOverlap(overlap);
+}
+
 template <SSAMethod SSA, typename RNG, typename NumMolecules,
           NextEventSearchMethod SearchMethod>
 osh::Real
@@ -1236,6 +1253,10 @@ template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I32,
                                 NextEventSearchMethod::GibsonBruck>;
 template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I64,
                                 NextEventSearchMethod::GibsonBruck>;
+template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I32,
+                                NextEventSearchMethod::DirectSumTree>;
+template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I64,
+                                NextEventSearchMethod::DirectSumTree>;
 template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I32,
                                 NextEventSearchMethod::Direct>;
 template class OmegaHSimulation<SSAMethod::RSSA, std::mt19937, osh::I32,
@@ -1250,6 +1271,10 @@ template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I32,
                                 NextEventSearchMethod::GibsonBruck>;
 template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I64,
                                 NextEventSearchMethod::GibsonBruck>;
+template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I32,
+                                NextEventSearchMethod::DirectSumTree>;
+template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I64,
+                                NextEventSearchMethod::DirectSumTree>;
 template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I32,
                                 NextEventSearchMethod::Direct>;
 template class OmegaHSimulation<SSAMethod::RSSA, steps::rng::RNG, osh::I32,
@@ -150,6 +150,8 @@ public:
                           osh::Real* currents) const;
 
   void setDiffOpBinomialThreshold(osh::Real threshold) override;
+  void setCounterBasedRNG(std::uint64_t seed) override;
+  void setDiffOpHaloExchangeOverlap(bool overlap) override;
   osh::Real getIterationTimeStep() const noexcept override;
 
   void exportMolStateToVTK(const std::string &filename) override;
@@ -409,6 +411,8 @@ extern template class OmegaHSimulation<SSAMethod::RSSA, std::mt19937, osh::I32,
                                        NextEventSearchMethod::Direct>;
 extern template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I32,
                                        NextEventSearchMethod::GibsonBruck>;
+extern template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I32,
+                                       NextEventSearchMethod::DirectSumTree>;
 
 extern template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I64,
                                        NextEventSearchMethod::Direct>;
@@ -416,6 +420,8 @@ extern template class OmegaHSimulation<SSAMethod::RSSA, std::mt19937, osh::I64,
                                        NextEventSearchMethod::Direct>;
 extern template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I64,
                                        NextEventSearchMethod::GibsonBruck>;
+extern template class OmegaHSimulation<SSAMethod::SSA, std::mt19937, osh::I64,
+                                       NextEventSearchMethod::DirectSumTree>;
 
 extern template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I32,
                                        NextEventSearchMethod::Direct>;
@@ -423,6 +429,8 @@ extern template class OmegaHSimulation<SSAMethod::RSSA, steps::rng::RNG, osh::I3
                                        NextEventSearchMethod::Direct>;
 extern template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I32,
                                        NextEventSearchMethod::GibsonBruck>;
+extern template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I32,
+                                       NextEventSearchMethod::DirectSumTree>;
 
 extern template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I64,
                                        NextEventSearchMethod::Direct>;
@@ -430,6 +438,8 @@ extern template class OmegaHSimulation<SSAMethod::RSSA, steps::rng::RNG, osh::I6
                                        NextEventSearchMethod::Direct>;
 extern template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I64,
                                        NextEventSearchMethod::GibsonBruck>;
+extern template class OmegaHSimulation<SSAMethod::SSA, steps::rng::RNG, osh::I64,
+                                       NextEventSearchMethod::DirectSumTree>;
 
 extern template class Simulation<steps::rng::RNG>;
 
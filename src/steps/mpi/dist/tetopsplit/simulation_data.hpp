@@ -117,6 +117,7 @@ public:
       diffusions.reset();
       pools.reset(state_time);
       ssaOp.reset();
+      diffOp.reset();
   }
 
   osh::Real updateIterationTimeStep() {
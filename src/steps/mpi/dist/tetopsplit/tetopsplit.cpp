@@ -441,6 +441,18 @@ void TetOpSplit<SSA, SearchMethod>::setDiffApplyThreshold(int threshold) {
     sim->setDiffOpBinomialThreshold(threshold);
 }
 
+template <steps::dist::SSAMethod SSA,
+          steps::dist::NextEventSearchMethod SearchMethod>
+void TetOpSplit<SSA, SearchMethod>::setCounterBasedRNG(unsigned long seed) {
+    sim->setCounterBasedRNG(seed);
+}
+
+template <steps::dist::SSAMethod SSA,
+          steps::dist::NextEventSearchMethod SearchMethod>
+void TetOpSplit<SSA, SearchMethod>::setDiffHaloExchangeOverlap(bool overlap) {
+    sim->setDiffOpHaloExchangeOverlap(overlap);
+}
+
 template <steps::dist::SSAMethod SSA,
           steps::dist::NextEventSearchMethod SearchMethod>
 void TetOpSplit<SSA, SearchMethod>::setMembIClamp(const std::string &memb,
@@ -478,6 +490,8 @@ template class TetOpSplit<steps::dist::SSAMethod::SSA,
                           steps::dist::NextEventSearchMethod::Direct>;
 template class TetOpSplit<steps::dist::SSAMethod::SSA,
                           steps::dist::NextEventSearchMethod::GibsonBruck>;
+template class TetOpSplit<steps::dist::SSAMethod::SSA,
+                          steps::dist::NextEventSearchMethod::DirectSumTree>;
 template class TetOpSplit<steps::dist::SSAMethod::RSSA,
                           steps::dist::NextEventSearchMethod::Direct>;
 
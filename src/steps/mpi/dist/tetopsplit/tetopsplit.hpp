@@ -136,6 +136,8 @@ class TetOpSplitBase {
     virtual bool getDiffBoundaryDiffusionActive(const std::string &name,
                                                 const std::string &spec) = 0;
     virtual void setDiffApplyThreshold(int threshold) = 0;
+    virtual void setCounterBasedRNG(unsigned long seed) = 0;
+    virtual void setDiffHaloExchangeOverlap(bool overlap) = 0;
     virtual void setMembIClamp(const std::string &memb, double stim) = 0;
 
 
@@ -387,6 +389,14 @@ class TetOpSplit : public TetOpSplitBase {
 
     void setDiffApplyThreshold(int threshold) override;
 
+    /// Draw the random numbers of diffusion and reactions from counter-based
+    /// generators, see OmegaHSimulation::setCounterBasedRNG
+    void setCounterBasedRNG(unsigned long seed) override;
+
+    /// Overlap the halo exchange of diffusion with the computations on the
+    /// interior elements, enabled by default
+    void setDiffHaloExchangeOverlap(bool overlap) override;
+
     /**
      * \}
      */
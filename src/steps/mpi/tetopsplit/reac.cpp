@@ -218,57 +218,14 @@ bool smtos::Reac::depSpecTri(uint /*gidx*/, smtos::Tri * /*tri*/)
 
 double smtos::Reac::rate(smtos::TetOpSplitP * /*solver*/)
 {
-
     if (inactive()) return 0.0;
 
-    // Prefetch some variables.
+    // Compute combinatorial part over the reactants only.
     ssolver::Compdef * cdef = pTet->compdef();
-    uint nspecs = cdef->countSpecs();
-    uint * lhs_vec = cdef->reac_lhs_bgn(cdef->reacG2L(pReacdef->gidx()));
-    uint * cnt_vec = pTet->pools();
-
-    // Compute combinatorial part.
-    double h_mu = 1.0;
-    for (uint pool = 0; pool < nspecs; ++pool)
-    {
-        uint lhs = lhs_vec[pool];
-        if (lhs == 0) { continue;
-        }
-        uint cnt = cnt_vec[pool];
-        if (lhs > cnt)
-        {
-            h_mu = 0.0;
-            break;
-        }
-        switch (lhs)
-        {
-            case 4:
-            {
-                h_mu *= static_cast<double>(cnt - 3);
-            }
-            STEPS_FALLTHROUGH;
-            case 3:
-            {
-                h_mu *= static_cast<double>(cnt - 2);
-            }
-            STEPS_FALLTHROUGH;
-            case 2:
-            {
-                h_mu *= static_cast<double>(cnt - 1);
-            }
-            STEPS_FALLTHROUGH;
-            case 1:
-            {
-                h_mu *= static_cast<double>(cnt);
-                break;
-            }
-            default:
-            {
-                AssertLog(0);
-                return 0.0;
-            }
-        }
-    }
+    uint lidx = cdef->reacG2L(pReacdef->gidx());
+    double h_mu = ssolver::reac_comb(cdef->reac_reactants_bgn(lidx),
+                                     cdef->reac_reactants_end(lidx),
+                                     pTet->pools());
 
     // Multiply with scaled reaction constant.
     return h_mu * pCcst;
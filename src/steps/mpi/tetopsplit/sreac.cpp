@@ -390,151 +390,36 @@ bool smtos::SReac::depSpecTri(uint gidx, smtos::Tri * triangle)
 ////////////////////////////////////////////////////////////////////////////////
 double smtos::SReac::rate(steps::mpi::tetopsplit::TetOpSplitP * /*solver*/)
 {
-       if (inactive()) return 0.0;
+    if (inactive()) return 0.0;
 
-        // First we compute the combinatorial part.
-        //   1/ for the surface part of the stoichiometry
-        //   2/ for the inner or outer volume part of the stoichiometry,
-        //      depending on whether the sreac is inner() or outer()
-        // Then we multiply with mesoscopic constant.
+    // First we compute the combinatorial part.
+    //   1/ for the surface part of the stoichiometry
+    //   2/ for the inner or outer volume part of the stoichiometry,
+    //      depending on whether the sreac is inner() or outer()
+    // Then we multiply with mesoscopic constant.
 
-        ssolver::Patchdef * pdef = pTri->patchdef();
-        uint lidx = pdef->sreacG2L(pSReacdef->gidx());
-
-        double h_mu = 1.0;
+    ssolver::Patchdef * pdef = pTri->patchdef();
+    uint lidx = pdef->sreacG2L(pSReacdef->gidx());
 
-        uint * lhs_s_vec = pdef->sreac_lhs_S_bgn(lidx);
-        uint * cnt_s_vec = pTri->pools();
-        uint nspecs_s = pdef->countSpecs();
-        for (uint s = 0; s < nspecs_s; ++s)
-        {
-            uint lhs = lhs_s_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_s_vec[s];
-            if (lhs > cnt)
-            {
-                return 0.0;
-            }
-            switch (lhs)
-            {
-                case 4:
-                {
-                    h_mu *= static_cast<double>(cnt - 3);
-                }
-                STEPS_FALLTHROUGH;
-                case 3:
-                {
-                    h_mu *= static_cast<double>(cnt - 2);
-                }
-                STEPS_FALLTHROUGH;
-                case 2:
-                {
-                    h_mu *= static_cast<double>(cnt - 1);
-                }
-                STEPS_FALLTHROUGH;
-                case 1:
-                {
-                    h_mu *= static_cast<double>(cnt);
-                    break;
-                }
-                default:
-                {
-                    AssertLog(false);
-                }
-            }
-        }
+    double h_mu = ssolver::reac_comb(pdef->sreac_reactants_S_bgn(lidx),
+                                     pdef->sreac_reactants_S_end(lidx),
+                                     pTri->pools());
+    if (h_mu == 0.0) return 0.0;
 
-        if (pSReacdef->inside())
-        {
-            uint * lhs_i_vec = pdef->sreac_lhs_I_bgn(lidx);
-            uint * cnt_i_vec = pTri->iTet()->pools();
-            uint nspecs_i = pdef->countSpecs_I();
-            for (uint s = 0; s < nspecs_i; ++s)
-            {
-                uint lhs = lhs_i_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_i_vec[s];
-                if (lhs > cnt)
-                {
-                    return 0.0;
-                }
-                switch (lhs)
-                {
-                    case 4:
-                    {
-                        h_mu *= static_cast<double>(cnt - 3);
-                    }
-                    STEPS_FALLTHROUGH;
-                    case 3:
-                    {
-                        h_mu *= static_cast<double>(cnt - 2);
-                    }
-                    STEPS_FALLTHROUGH;
-                    case 2:
-                    {
-                        h_mu *= static_cast<double>(cnt - 1);
-                    }
-                    STEPS_FALLTHROUGH;
-                    case 1:
-                    {
-                        h_mu *= static_cast<double>(cnt);
-                        break;
-                    }
-                    default:
-                    {
-                        AssertLog(false);
-                    }
-                }
-            }
-        }
-        else if (pSReacdef->outside())
-        {
-            uint * lhs_o_vec = pdef->sreac_lhs_O_bgn(lidx);
-            uint * cnt_o_vec = pTri->oTet()->pools();
-            uint nspecs_o = pdef->countSpecs_O();
-            for (uint s = 0; s < nspecs_o; ++s)
-            {
-                uint lhs = lhs_o_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_o_vec[s];
-                if (lhs > cnt)
-                {
-                    return 0.0;
-                }
-                switch (lhs)
-                {
-                    case 4:
-                    {
-                        h_mu *= static_cast<double>(cnt - 3);
-                    }
-                    STEPS_FALLTHROUGH;
-                    case 3:
-                    {
-                        h_mu *= static_cast<double>(cnt - 2);
-                    }
-                    STEPS_FALLTHROUGH;
-                    case 2:
-                    {
-                        h_mu *= static_cast<double>(cnt - 1);
-                    }
-                    STEPS_FALLTHROUGH;
-                    case 1:
-                    {
-                        h_mu *= static_cast<double>(cnt);
-                        break;
-                    }
-                    default:
-                    {
-                        AssertLog(false);
-                    }
-                }
-            }
-        }
+    if (pSReacdef->inside())
+    {
+        h_mu = ssolver::reac_comb(pdef->sreac_reactants_I_bgn(lidx),
+                                  pdef->sreac_reactants_I_end(lidx),
+                                  pTri->iTet()->pools(), h_mu);
+    }
+    else if (pSReacdef->outside())
+    {
+        h_mu = ssolver::reac_comb(pdef->sreac_reactants_O_bgn(lidx),
+                                  pdef->sreac_reactants_O_end(lidx),
+                                  pTri->oTet()->pools(), h_mu);
+    }
 
-        return h_mu * pCcst;
+    return h_mu * pCcst;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,8 @@
 #include <cassert>
 #include <climits>
 #include <cmath>
+#include <cstdint>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -162,20 +164,360 @@ TetOpSplitP::~TetOpSplitP()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::checkpoint(std::string const & /*file_name*/)
+namespace {
+
+// The per-object checkpoint methods write to a std::fstream. Pointing its
+// stream buffer to memory lets each rank serialize its data before a single
+// collective MPI-IO write.
+
+template <typename F>
+std::string cp_serialize(F && checkpoint_fn)
 {
-    std::ostringstream os;
-    os << "This function has not been implemented!";
-    NotImplErrLog(os.str());
+    std::stringbuf buffer(std::ios::out | std::ios::binary);
+    std::fstream cp_file;
+    cp_file.std::ios::rdbuf(&buffer);
+    checkpoint_fn(cp_file);
+    return buffer.str();
+}
+
+template <typename F>
+void cp_deserialize(std::string const & data, F && restore_fn)
+{
+    std::stringbuf buffer(data, std::ios::in | std::ios::binary);
+    std::fstream cp_file;
+    cp_file.std::ios::rdbuf(&buffer);
+    restore_fn(cp_file);
+    if (cp_file.fail() || buffer.in_avail() != 0) {
+        std::ostringstream os;
+        os << "checkpoint data mismatch with simulator parameters: size of the checkpoint block.";
+        ArgErrLog(os.str());
+    }
+}
+
+// An error found on some ranks must be raised on all of them, or the others
+// would wait forever in the next collective call. True if any rank failed.
+bool cp_failed_on_any_rank(bool local_failed)
+{
+    int failed = local_failed ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    return failed != 0;
+}
+
+// Multi-rate diffusion buckets go from 0 to floor(log2(max_multiplier))
+uint diff_bucket_count(uint max_multiplier)
+{
+    uint n_buckets = 1;
+    for (uint m = max_multiplier; m > 1; m >>= 1) n_buckets++;
+    return n_buckets;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::checkpoint(std::string const & file_name)
+{
+    // File layout:
+    //   header   number of ranks, size of the shared block,
+    //            offset and size of the block of each rank
+    //   shared   data replicated on all ranks, written by rank 0
+    //   blocks   data hosted by each rank, in rank order
+    if (myRank == 0) {
+        CLOG(INFO, "general_log") << "Checkpoint to " << file_name  << "...";
+    }
+
+    std::string shared_block;
+    if (myRank == 0) {
+        shared_block = cp_serialize([this](std::fstream & cp_file) { _checkpointShared(cp_file); });
+    }
+    std::string local_block = cp_serialize([this](std::fstream & cp_file) { _checkpointLocal(cp_file); });
+
+    const bool too_large = local_block.size() > static_cast<std::size_t>(INT_MAX) ||
+                           shared_block.size() > static_cast<std::size_t>(INT_MAX);
+    if (cp_failed_on_any_rank(too_large)) {
+        std::ostringstream os;
+        if (too_large) {
+            os << "Checkpoint data of rank " << myRank << " exceeds the 2GB MPI-IO limit.";
+        } else {
+            os << "Checkpoint data of another rank exceeds the 2GB MPI-IO limit.";
+        }
+        SysErrLog(os.str());
+    }
+
+    uint64_t shared_size = shared_block.size();
+    MPI_Bcast(&shared_size, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    uint64_t local_size = local_block.size();
+    uint64_t local_offset = 0;
+    MPI_Exscan(&local_size, &local_offset, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if (myRank == 0) local_offset = 0;
+    const uint64_t header_size = sizeof(uint64_t) * (2 + 2 * static_cast<uint64_t>(nHosts));
+    local_offset += header_size + shared_size;
+
+    std::vector<uint64_t> header;
+    if (myRank == 0) header.resize(2 + 2 * nHosts);
+    uint64_t * offsets = myRank == 0 ? &header[2] : nullptr;
+    uint64_t * sizes = myRank == 0 ? &header[2 + nHosts] : nullptr;
+    MPI_Gather(&local_offset, 1, MPI_UINT64_T, offsets, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    MPI_Gather(&local_size, 1, MPI_UINT64_T, sizes, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    MPI_File fh;
+    if (MPI_File_open(MPI_COMM_WORLD, file_name.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        std::ostringstream os;
+        os << "Unable to open checkpoint file " << file_name << ".";
+        IOErrLog(os.str());
+    }
+    MPI_File_set_size(fh, 0);
+
+    if (myRank == 0) {
+        header[0] = nHosts;
+        header[1] = shared_size;
+        MPI_File_write_at(fh, 0, header.data(), static_cast<int>(header.size()), MPI_UINT64_T,
+                          MPI_STATUS_IGNORE);
+        MPI_File_write_at(fh, header_size, &shared_block[0], static_cast<int>(shared_size), MPI_BYTE,
+                          MPI_STATUS_IGNORE);
+    }
+    MPI_File_write_at_all(fh, local_offset, &local_block[0], static_cast<int>(local_size), MPI_BYTE,
+                          MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+
+    if (myRank == 0) {
+        CLOG(INFO, "general_log") << "complete.\n";
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::restore(std::string const & /*file_name*/)
+void TetOpSplitP::restore(std::string const & file_name)
 {
-    std::ostringstream os;
-    os << "This function has not been implemented!";
-    NotImplErrLog(os.str());
+    MPI_File fh;
+    if (MPI_File_open(MPI_COMM_WORLD, file_name.c_str(), MPI_MODE_RDONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        std::ostringstream os;
+        os << "Unable to open checkpoint file " << file_name << ".";
+        IOErrLog(os.str());
+    }
+
+    // each rank only reads the part of the index it needs
+    uint64_t header[2];
+    MPI_File_read_at_all(fh, 0, header, 2, MPI_UINT64_T, MPI_STATUS_IGNORE);
+    if (header[0] != static_cast<uint64_t>(nHosts)) {
+        MPI_File_close(&fh);
+        std::ostringstream os;
+        os << "Checkpoint file " << file_name << " was written by " << header[0];
+        os << " ranks, it can only be restored on the same partition (";
+        os << nHosts << " ranks).";
+        ArgErrLog(os.str());
+    }
+    const uint64_t shared_size = header[1];
+    const uint64_t header_size = sizeof(uint64_t) * (2 + 2 * static_cast<uint64_t>(nHosts));
+
+    uint64_t local_offset;
+    uint64_t local_size;
+    MPI_File_read_at_all(fh, sizeof(uint64_t) * (2 + myRank), &local_offset, 1, MPI_UINT64_T,
+                         MPI_STATUS_IGNORE);
+    MPI_File_read_at_all(fh, sizeof(uint64_t) * (2 + nHosts + myRank), &local_size, 1, MPI_UINT64_T,
+                         MPI_STATUS_IGNORE);
+
+    std::string shared_block(shared_size, '\0');
+    std::string local_block(local_size, '\0');
+    MPI_File_read_at_all(fh, header_size, &shared_block[0], static_cast<int>(shared_size), MPI_BYTE,
+                         MPI_STATUS_IGNORE);
+    MPI_File_read_at_all(fh, local_offset, &local_block[0], static_cast<int>(local_size), MPI_BYTE,
+                         MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+
+    // the local block, and so the errors, differ between ranks
+    std::exception_ptr error;
+    try {
+        cp_deserialize(shared_block, [this](std::fstream & cp_file) { _restoreShared(cp_file); });
+        cp_deserialize(local_block, [this](std::fstream & cp_file) { _restoreLocal(cp_file); });
+    } catch (steps::Err const &) {
+        error = std::current_exception();
+    }
+    if (cp_failed_on_any_rank(error != nullptr)) {
+        if (error) std::rethrow_exception(error);
+        std::ostringstream os;
+        os << "checkpoint data mismatch with simulator parameters on another rank.";
+        ArgErrLog(os.str());
+    }
+
+    recomputeUpdPeriod = true;
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_checkpointShared(std::fstream & cp_file)
+{
+    statedef().checkpoint(cp_file);
+
+    cp_file.write(reinterpret_cast<char*>(&nIteration), sizeof(double));
+
+    if (efflag()) {
+        cp_file.write(reinterpret_cast<char*>(&pTemp), sizeof(double));
+        cp_file.write(reinterpret_cast<char*>(&pEFDT), sizeof(double));
+        pEField->checkpoint(cp_file);
+        // potentials are gathered on all ranks after each EField step
+        pEField->checkpointState(cp_file);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_restoreShared(std::fstream & cp_file)
+{
+    statedef().restore(cp_file);
+
+    cp_file.read(reinterpret_cast<char*>(&nIteration), sizeof(double));
+
+    if (efflag()) {
+        cp_file.read(reinterpret_cast<char*>(&pTemp), sizeof(double));
+        cp_file.read(reinterpret_cast<char*>(&pEFDT), sizeof(double));
+        pEField->restore(cp_file);
+        pEField->restoreState(cp_file);
+        _refreshEFTrisV();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_checkpointLocal(std::fstream & cp_file)
+{
+    for (auto const& c: pComps) c->checkpoint(cp_file);
+    for (auto const& p: pPatches) p->checkpoint(cp_file);
+    for (auto const& db: pDiffBoundaries) db->checkpoint(cp_file);
+    for (auto const& sdb: pSDiffBoundaries) sdb->checkpoint(cp_file);
+
+    for (auto const& wmv: pWmVols) {
+        if (wmv != nullptr && wmv->getInHost()) wmv->checkpoint(cp_file);
+    }
+    for (auto const& t: pTets) {
+        if (t != nullptr && t->getInHost()) t->checkpoint(cp_file);
+    }
+    for (auto const& t: pTris) {
+        if (t != nullptr && t->getInHost()) t->checkpoint(cp_file);
+    }
+
+    std::size_t n_entries = nEntries;
+    cp_file.write(reinterpret_cast<char*>(&n_entries), sizeof(std::size_t));
+    for (auto const& kp: pKProcs) kp->checkpoint(cp_file);
+
+    cp_file.write(reinterpret_cast<char*>(&reacExtent), sizeof(unsigned long long));
+    cp_file.write(reinterpret_cast<char*>(&diffExtent), sizeof(unsigned long long));
+
+    // checkpoint CR SSA
+
+    cp_file.write(reinterpret_cast<char*>(&pSum), sizeof(double));
+    cp_file.write(reinterpret_cast<char*>(&nSum), sizeof(double));
+    cp_file.write(reinterpret_cast<char*>(&pA0), sizeof(double));
+
+    auto n_ngroups = nGroups.size();
+    auto n_pgroups = pGroups.size();
+
+    cp_file.write(reinterpret_cast<char*>(&n_ngroups), sizeof(std::size_t));
+    cp_file.write(reinterpret_cast<char*>(&n_pgroups), sizeof(std::size_t));
+
+    auto checkpoint_group = [&cp_file](CRGroup* group) {
+        cp_file.write(reinterpret_cast<char*>(&group->capacity), sizeof(unsigned));
+        cp_file.write(reinterpret_cast<char*>(&group->size), sizeof(unsigned));
+        cp_file.write(reinterpret_cast<char*>(&group->max), sizeof(double));
+        cp_file.write(reinterpret_cast<char*>(&group->sum), sizeof(double));
+
+        for (uint j = 0; j < group->size; j++) {
+            uint idx = group->indices[j]->schedIDX();
+            cp_file.write(reinterpret_cast<char*>(&idx), sizeof(uint));
+        }
+    };
+    for (auto const& group: nGroups) checkpoint_group(group);
+    for (auto const& group: pGroups) checkpoint_group(group);
+
+    rng()->checkpoint(cp_file);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_restoreLocal(std::fstream & cp_file)
+{
+    for (auto const& c: pComps) c->restore(cp_file);
+    for (auto const& p: pPatches) p->restore(cp_file);
+    for (auto const& db: pDiffBoundaries) db->restore(cp_file);
+    for (auto const& sdb: pSDiffBoundaries) sdb->restore(cp_file);
+
+    for (auto const& wmv: pWmVols) {
+        if (wmv != nullptr && wmv->getInHost()) wmv->restore(cp_file);
+    }
+    for (auto const& t: pTets) {
+        if (t != nullptr && t->getInHost()) t->restore(cp_file);
+    }
+    for (auto const& t: pTris) {
+        if (t != nullptr && t->getInHost()) t->restore(cp_file);
+    }
+
+    std::size_t stored_entries;
+    cp_file.read(reinterpret_cast<char*>(&stored_entries), sizeof(std::size_t));
+    if (stored_entries != nEntries) {
+        std::ostringstream os;
+        os << "checkpoint data mismatch with simulator parameters: number of kinetic processes on rank ";
+        os << myRank << ", " << stored_entries << ":" << nEntries;
+        ArgErrLog(os.str());
+    }
+    for (auto const& kp: pKProcs) kp->restore(cp_file);
+
+    cp_file.read(reinterpret_cast<char*>(&reacExtent), sizeof(unsigned long long));
+    cp_file.read(reinterpret_cast<char*>(&diffExtent), sizeof(unsigned long long));
+
+    // restore CR SSA
+    cp_file.read(reinterpret_cast<char*>(&pSum), sizeof(double));
+    cp_file.read(reinterpret_cast<char*>(&nSum), sizeof(double));
+    cp_file.read(reinterpret_cast<char*>(&pA0), sizeof(double));
+
+    for (auto& g: nGroups) {
+        g->free_indices();
+        delete g;
+    }
+    for (auto& g: pGroups) {
+        g->free_indices();
+        delete g;
+    }
+
+    std::size_t n_ngroups;
+    std::size_t n_pgroups;
+
+    cp_file.read(reinterpret_cast<char*>(&n_ngroups), sizeof(std::size_t));
+    cp_file.read(reinterpret_cast<char*>(&n_pgroups), sizeof(std::size_t));
+
+    auto restore_group = [this, &cp_file]() {
+        unsigned capacity;
+        unsigned size;
+        double max;
+        double sum;
+
+        cp_file.read(reinterpret_cast<char*>(&capacity), sizeof(unsigned));
+        cp_file.read(reinterpret_cast<char*>(&size), sizeof(unsigned));
+        cp_file.read(reinterpret_cast<char*>(&max), sizeof(double));
+        cp_file.read(reinterpret_cast<char*>(&sum), sizeof(double));
+
+        auto group = new CRGroup(0, capacity);
+        group->size = size;
+        group->max = max;
+        group->sum = sum;
+
+        for (uint j = 0; j < size; j++) {
+            uint idx;
+            cp_file.read(reinterpret_cast<char*>(&idx), sizeof(uint));
+            group->indices[j] = pKProcs[idx];
+        }
+        return group;
+    };
+
+    nGroups.resize(n_ngroups);
+    pGroups.resize(n_pgroups);
+    for (auto& group: nGroups) group = restore_group();
+    for (auto& group: pGroups) group = restore_group();
+
+    rng()->restore(cp_file);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -812,6 +1154,9 @@ void TetOpSplitP::_setupEField()
     case EF_DV_BDSYS:
         pEField = make_EField<dVSolverBanded>();
         break;
+    case EF_DV_PCG:
+        pEField = make_EField<dVSolverCSR>();
+        break;
 #ifdef USE_PETSC
     case EF_DV_PETSC:
         pEField = make_EField<dVSolverPETSC>();
@@ -969,6 +1314,15 @@ void TetOpSplitP::_setupEField()
     MPI_Allgatherv(local_eftri_indices.data(), static_cast<int>(local_eftri_indices.size()), MPI_STEPS_INDEX,
             EFTrisI_idx.data(), EFTrisI_count.data(), EFTrisI_offset.data(), MPI_STEPS_INDEX, MPI_COMM_WORLD);
 
+    int i_begin = EFTrisI_offset[myRank];
+    int i_end = i_begin + EFTrisI_count[myRank];
+    for (int i = i_begin; i < i_end; ++i) {
+        auto tlidx = EFTrisI_idx[i];
+        Tri *tri_p = pEFTris_vec[tlidx.get()];
+        tri_p->setupOhmicCurrents(EFOhmicCurrs, i, tlidx.get());
+        if (tri_p->patchdef()->countGHKcurrs() != 0) EFGHKTrisI.push_back(i);
+    }
+
     pEField->initMesh(pEFNVerts, &(pEFVerts.front()), pEFNTris, &(pEFTris.front()), pEFNTets, &(pEFTets.front()), memb->_getOpt_method(), memb->_getOpt_file_name(), memb->_getSearch_percent());
 
     // Triangles need to be set to some initial voltage, which they can read from the Efield pointer.
@@ -1207,6 +1561,14 @@ void TetOpSplitP::_runWithoutEField(double endtime)
 
     double update_period = updPeriod;
 
+    // Multi-rate diffusion: processes in bucket b are applied every 2^b
+    // iterations, and all of them at the last iteration so that the state
+    // is complete at endtime.
+    const uint n_buckets = diff_bucket_count(diffMaxMultiplier);
+    std::vector<double> bucket_upd_time(n_buckets, statedef().time());
+    std::vector<double> bucket_period(n_buckets, 0.0);
+    std::vector<bool> bucket_due(n_buckets, true);
+    unsigned long long n_sub_steps = 0;
 
     MPI_Request* requests = nullptr;
 
@@ -1288,6 +1650,16 @@ void TetOpSplitP::_runWithoutEField(double endtime)
         // Track how many diffusion 'steps' we do, simply for bookkeeping
         uint nsteps=0;
 
+        n_sub_steps++;
+        if (diffMaxMultiplier > 1) {
+            double post_ssa_time = aligned ? endtime : pre_ssa_time + update_period;
+            for (uint b = 0; b < n_buckets; b++) {
+                bucket_due[b] = aligned || n_sub_steps % (1ull << b) == 0;
+                bucket_period[b] = post_ssa_time - bucket_upd_time[b];
+                if (bucket_due[b]) bucket_upd_time[b] = post_ssa_time;
+            }
+        }
+
 
         // to reduce memory cost we use directions to retrieve the update list in upd process
         std::vector<KProc*> applied_diffs;
@@ -1301,13 +1673,23 @@ void TetOpSplitP::_runWithoutEField(double endtime)
             // rate is the rate (scaled_dcst * population)
             double scaleddcst = d->getScaledDcst();
 
+            // Slower processes of the multi-rate mode jump over their own,
+            // longer period. The mean population is still taken over the
+            // last update period since occupancies are reset every iteration.
+            double diff_period = update_period;
+            if (diffMaxMultiplier > 1) {
+                uint bucket = pDiffBuckets[pos];
+                if (not bucket_due[bucket]) continue;
+                if (bucket > 0) diff_period = bucket_period[bucket];
+            }
+
             // The number of molecules available for diffusion for this diffusion rule
             double population = rate/scaleddcst;
 
             // t1, AKA 'X', is a fractional number between 0 and 1: the update period divided
             // by the local mean single-molecule dwellperiod. This fraction gives the mean
             // proportion of molecules to diffuse.
-            double t1 = update_period * scaleddcst;
+            double t1 = diff_period * scaleddcst;
 
 
             if (t1>=1.0) {
@@ -1378,13 +1760,23 @@ void TetOpSplitP::_runWithoutEField(double endtime)
             // rate is the rate (scaled_dcst * population)
             double scaleddcst = d->getScaledDcst();
 
+            // Slower processes of the multi-rate mode jump over their own,
+            // longer period. The mean population is still taken over the
+            // last update period since occupancies are reset every iteration.
+            double diff_period = update_period;
+            if (diffMaxMultiplier > 1) {
+                uint bucket = pSDiffBuckets[pos];
+                if (not bucket_due[bucket]) continue;
+                if (bucket > 0) diff_period = bucket_period[bucket];
+            }
+
             // The number of molecules available for diffusion for this diffusion rule
             double population = rate/scaleddcst;
 
             // t1, AKA 'X', is a fractional number between 0 and 1: the update period divided
             // by the local mean single-molecule dwellperiod. This fraction gives the mean
             // proportion of molecules to diffuse.
-            double t1 = update_period * scaleddcst;
+            double t1 = diff_period * scaleddcst;
 
             if (t1>=1.0)
             {
@@ -1491,7 +1883,7 @@ void TetOpSplitP::_runWithoutEField(double endtime)
 ////////////////////////////////////////////////////////////////////////////////
 
 void TetOpSplitP::_refreshEFTrisV() {
-    for (uint tlidx = 0; tlidx < pEFNTris; tlidx++) EFTrisV[tlidx] = pEField->getTriV(tlidx);
+    pEField->getTrisV(EFTrisV.data());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1538,9 +1930,11 @@ void TetOpSplitP::_runWithEField(double endtime)
 
         double sttime = statedef().time();
         double real_ef_dt = sttime - t0;
-        for (int i = i_begin; i < i_end; ++i) {
+        std::fill(EFTrisI_permuted.begin() + i_begin, EFTrisI_permuted.begin() + i_end, 0.0);
+        EFOhmicCurrs.compute(EFTrisV.data(), sttime, real_ef_dt, EFTrisI_permuted.data());
+        for (int i : EFGHKTrisI) {
             auto tlidx = EFTrisI_idx[i];
-            EFTrisI_permuted[i] = pEFTris_vec[tlidx.get()]->computeI(EFTrisV[tlidx.get()], real_ef_dt, sttime, efdt());
+            EFTrisI_permuted[i] += pEFTris_vec[tlidx.get()]->computeGHKI(real_ef_dt, efdt(), sttime);
         }
 
         Instrumentor::phase_end("runWithEField -> efield");
@@ -5300,6 +5694,33 @@ void TetOpSplitP::_computeUpdPeriod()
         ArgErrLog(os.str());
     }
     updPeriod = 1.0 / global_max_rate;
+
+    // Multi-rate diffusion: a process can be applied every 2^b update periods
+    // as long as it stays below one expected jump per molecule in that time
+    const uint max_bucket = diff_bucket_count(diffMaxMultiplier) - 1;
+    auto compute_bucket = [this, max_bucket](double scaleddcst) {
+        uint bucket = 0;
+        if (scaleddcst <= 0.0) return bucket;
+        while (bucket < max_bucket &&
+               (2u << bucket) * updPeriod * scaleddcst <= 1.0) {
+            bucket++;
+        }
+        return bucket;
+    };
+
+    pDiffBuckets.clear();
+    pSDiffBuckets.clear();
+    if (diffMaxMultiplier > 1) {
+        pDiffBuckets.resize(diffSep);
+        for (uint pos = 0; pos < diffSep; pos++) {
+            pDiffBuckets[pos] = compute_bucket(pDiffs[pos]->getScaledDcst());
+        }
+        pSDiffBuckets.resize(sdiffSep);
+        for (uint pos = 0; pos < sdiffSep; pos++) {
+            pSDiffBuckets[pos] = compute_bucket(pSDiffs[pos]->getScaledDcst());
+        }
+    }
+
     recomputeUpdPeriod = false;
 }
 
@@ -5633,6 +6054,7 @@ void TetOpSplitP::getBatchTetCountsNP(const index_t *indices,
     std::ostringstream tet_not_assign;
     std::ostringstream spec_undefined;
     std::vector<double> local_counts(input_size, 0.0);
+    std::vector<int> hosts(input_size, -1);
 
     uint sgidx = statedef().getSpecIdx(s);
 
@@ -5662,6 +6084,7 @@ void TetOpSplitP::getBatchTetCountsNP(const index_t *indices,
             continue;
         }
 
+        hosts[t] = tet->getHost();
         if (tet->getInHost()) {
             local_counts[t] = tet->pools()[slidx];
         }
@@ -5677,7 +6100,7 @@ void TetOpSplitP::getBatchTetCountsNP(const index_t *indices,
         CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following tetrahedrons, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
     }
-    MPI_Allreduce(local_counts.data(), counts, input_size, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    _allgatherByHost(hosts, local_counts, counts);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -5703,6 +6126,7 @@ void TetOpSplitP::getBatchTriCountsNP(const index_t *indices,
 
     uint sgidx = statedef().getSpecIdx(s);
     std::vector<double> local_counts(input_size, 0.0);
+    std::vector<int> hosts(input_size, -1);
     for (uint t = 0; t < input_size; t++) {
         uint tidx = indices[t];
 
@@ -5728,6 +6152,7 @@ void TetOpSplitP::getBatchTriCountsNP(const index_t *indices,
             has_spec_warning = true;
             continue;
         }
+        hosts[t] = tri->getHost();
         if (tri->getInHost()) {
             local_counts[t] = tri->pools()[slidx];
         }
@@ -5743,7 +6168,7 @@ void TetOpSplitP::getBatchTriCountsNP(const index_t *indices,
         CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following triangles, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
     }
-    MPI_Allreduce(local_counts.data(), counts, input_size, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    _allgatherByHost(hosts, local_counts, counts);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -5832,6 +6257,7 @@ void TetOpSplitP::getBatchTetConcsNP(const index_t *indices,
 
     uint sgidx = statedef().getSpecIdx(s);
     std::vector<double> local_concs(ntets, 0.0);
+    std::vector<int> hosts(ntets, -1);
 
     for (uint t = 0; t < ntets; t++) {
         uint tidx = indices[t];
@@ -5858,6 +6284,7 @@ void TetOpSplitP::getBatchTetConcsNP(const index_t *indices,
             has_spec_warning = true;
             continue;
         }
+        hosts[t] = tet->getHost();
         if (tet->getInHost()) {
             double count = tet->pools()[slidx];
             double vol = tet->vol();
@@ -5875,7 +6302,207 @@ void TetOpSplitP::getBatchTetConcsNP(const index_t *indices,
         CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following tetrahedrons, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
     }
-    MPI_Allreduce(local_concs.data(), global_concs, ntets, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    _allgatherByHost(hosts, local_concs, global_concs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_allgatherByHost(std::vector<int> const & hosts,
+                                   std::vector<double> const & local_values,
+                                   double * values) const
+{
+    // The host of every element is known on all ranks, so each rank only
+    // sends the values of the elements it hosts, in request order, and the
+    // received values are put back in place without exchanging indices.
+    AssertLog(hosts.size() == local_values.size());
+
+    std::vector<int> recv_counts(nHosts, 0);
+    for (auto host: hosts) {
+        if (host >= 0) recv_counts[host]++;
+    }
+    std::vector<int> displs(nHosts, 0);
+    for (int r = 1; r < nHosts; r++) displs[r] = displs[r - 1] + recv_counts[r - 1];
+
+    std::vector<double> send_values;
+    send_values.reserve(recv_counts[myRank]);
+    for (size_t t = 0; t < hosts.size(); t++) {
+        if (hosts[t] == myRank) send_values.push_back(local_values[t]);
+    }
+
+    std::vector<double> recv_values(displs[nHosts - 1] + recv_counts[nHosts - 1]);
+    MPI_Allgatherv(send_values.data(), send_values.size(), MPI_DOUBLE,
+                   recv_values.data(), recv_counts.data(), displs.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+
+    for (size_t t = 0; t < hosts.size(); t++) {
+        values[t] = hosts[t] >= 0 ? recv_values[displs[hosts[t]]++] : 0.0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::setBatchTetCountsNP(const index_t *indices,
+                                      size_t ntets,
+                                      std::string const &s,
+                                      const double *counts,
+                                      size_t input_size)
+{
+    if (ntets != input_size)
+    {
+        std::ostringstream os;
+        os << "Error: input array (counts) size should be the same as input array (indices) size.\n";
+        ArgErrLog(os.str());
+    }
+
+    bool has_tet_warning = false;
+    bool has_spec_warning = false;
+    std::ostringstream tet_not_assign;
+    std::ostringstream spec_undefined;
+
+    uint sgidx = statedef().getSpecIdx(s);
+
+    for (size_t t = 0; t < ntets; t++) {
+        const auto tidx = indices[t];
+
+        if (tidx >= pTets.size())
+        {
+            std::ostringstream os;
+            os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
+            ArgErrLog(os.str());
+        }
+
+        if (pTets[tidx] == nullptr)
+        {
+            tet_not_assign << tidx << " ";
+            has_tet_warning = true;
+            continue;
+        }
+
+        Tet * tet = pTets[tidx];
+        uint slidx = tet->compdef()->specG2L(sgidx);
+        if (slidx == ssolver::LIDX_UNDEFINED)
+        {
+            spec_undefined << tidx << " ";
+            has_spec_warning = true;
+            continue;
+        }
+        if (counts[t] < 0.0 || counts[t] > UINT_MAX)
+        {
+            std::ostringstream os;
+            os << "Count of tetrahedron " << tidx << " should be between 0 and the maximum unsigned integer (";
+            os << UINT_MAX << ").\n";
+            ArgErrLog(os.str());
+        }
+        if (tet->getInHost()) {
+            double n_int = std::floor(counts[t]);
+            double n_frc = counts[t] - n_int;
+            uint count = static_cast<uint>(n_int);
+            if (n_frc > 0.0)
+            {
+                double rand01 = rng()->getUnfIE();
+                if (rand01 < n_frc) count++;
+            }
+
+            // don't need sync
+            tet->setCount(slidx, count);
+            _updateSpec(tet, sgidx);
+        }
+    }
+
+    // the sums are only updated once for the whole batch
+    _updateSum();
+
+    if (has_tet_warning) {
+        CLOG(WARNING, "general_log") << "The following tetrahedrons have not been assigned to a compartment, ignore them:\n";
+        CLOG(WARNING, "general_log") << tet_not_assign.str() << "\n";
+    }
+
+    if (has_spec_warning) {
+        CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following tetrahedrons, ignore them:\n";
+        CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::setBatchTriCountsNP(const index_t *indices,
+                                      size_t ntris,
+                                      std::string const &s,
+                                      const double *counts,
+                                      size_t input_size)
+{
+    if (ntris != input_size)
+    {
+        std::ostringstream os;
+        os << "Error: input array (counts) size should be the same as input array (indices) size.\n";
+        ArgErrLog(os.str());
+    }
+
+    bool has_tri_warning = false;
+    bool has_spec_warning = false;
+    std::ostringstream tri_not_assign;
+    std::ostringstream spec_undefined;
+
+    uint sgidx = statedef().getSpecIdx(s);
+
+    for (size_t t = 0; t < ntris; t++) {
+        const auto tidx = indices[t];
+
+        if (tidx >= pTris.size())
+        {
+            std::ostringstream os;
+            os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
+            ArgErrLog(os.str());
+        }
+
+        if (pTris[tidx] == nullptr)
+        {
+            tri_not_assign << tidx << " ";
+            has_tri_warning = true;
+            continue;
+        }
+
+        Tri * tri = pTris[tidx];
+        uint slidx = tri->patchdef()->specG2L(sgidx);
+        if (slidx == ssolver::LIDX_UNDEFINED)
+        {
+            spec_undefined << tidx << " ";
+            has_spec_warning = true;
+            continue;
+        }
+        if (counts[t] < 0.0 || counts[t] > UINT_MAX)
+        {
+            std::ostringstream os;
+            os << "Count of triangle " << tidx << " should be between 0 and the maximum unsigned integer (";
+            os << UINT_MAX << ").\n";
+            ArgErrLog(os.str());
+        }
+        if (tri->getInHost()) {
+            double n_int = std::floor(counts[t]);
+            double n_frc = counts[t] - n_int;
+            uint count = static_cast<uint>(n_int);
+            if (n_frc > 0.0)
+            {
+                double rand01 = rng()->getUnfIE();
+                if (rand01 < n_frc) count++;
+            }
+
+            tri->setCount(slidx, count);
+            _updateSpec(tri, sgidx);
+        }
+    }
+
+    // the sums are only updated once for the whole batch
+    _updateSum();
+
+    if (has_tri_warning) {
+        CLOG(WARNING, "general_log") << "The following triangles have not been assigned to a patch, ignore them:\n";
+        CLOG(WARNING, "general_log") << tri_not_assign.str() << "\n";
+    }
+
+    if (has_spec_warning) {
+        CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following triangles, ignore them:\n";
+        CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -6105,6 +6732,7 @@ void TetOpSplitP::getBatchTriOhmicIsNP(const index_t *indices,
 
     uint ocidx = statedef().getOhmicCurrIdx(oc);
     std::vector<double> local_counts(input_size, 0.0);
+    std::vector<int> hosts(input_size, -1);
     for (uint t = 0; t < input_size; t++) {
         uint tidx = indices[t];
 
@@ -6130,6 +6758,7 @@ void TetOpSplitP::getBatchTriOhmicIsNP(const index_t *indices,
             has_spec_warning = true;
             continue;
         }
+        hosts[t] = tri->getHost();
         if (tri->getInHost()) {
             auto loctidx = pEFTri_GtoL[tidx];
             local_counts[t] = tri->getOhmicI(locidx, EFTrisV[loctidx.get()], efdt());
@@ -6145,7 +6774,7 @@ void TetOpSplitP::getBatchTriOhmicIsNP(const index_t *indices,
         CLOG(WARNING, "general_log") << "Ohmic Current " << oc << " has not been defined in the following triangles, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << '\n';
     }
-    MPI_Allreduce(local_counts.data(), counts, input_size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    _allgatherByHost(hosts, local_counts, counts);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -6171,6 +6800,7 @@ void TetOpSplitP::getBatchTriGHKIsNP(const index_t *indices,
 
     uint ghkidx = statedef().getGHKcurrIdx(ghk);
     std::vector<double> local_counts(input_size, 0.0);
+    std::vector<int> hosts(input_size, -1);
     for (uint t = 0; t < input_size; t++) {
         uint tidx = indices[t];
 
@@ -6196,6 +6826,7 @@ void TetOpSplitP::getBatchTriGHKIsNP(const index_t *indices,
             has_spec_warning = true;
             continue;
         }
+        hosts[t] = tri->getHost();
         if (tri->getInHost()) {
             local_counts[t] = tri->getGHKI(locidx);
         }
@@ -6210,7 +6841,7 @@ void TetOpSplitP::getBatchTriGHKIsNP(const index_t *indices,
         CLOG(WARNING, "general_log") << "GHk Current " << ghk << " has not been defined in the following triangles, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
     }
-    MPI_Allreduce(local_counts.data(), counts, input_size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    _allgatherByHost(hosts, local_counts, counts);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -6519,6 +7150,28 @@ void TetOpSplitP::getROITriCountsNP(const std::string& ROI_id, std::string const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void TetOpSplitP::setROITetCountsNP(const std::string& ROI_id, std::string const & s, const double* counts, size_t input_size)
+{
+  auto const& roi = mesh()->rois.get<tetmesh::ROI_TET>(ROI_id);
+  if (roi == mesh()->rois.end<tetmesh::ROI_TET>()) {
+    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+  }
+  setBatchTetCountsNP(reinterpret_cast<const index_t*>(roi->second.data()), roi->second.size(), s, counts, input_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::setROITriCountsNP(const std::string& ROI_id, std::string const & s, const double* counts, size_t input_size)
+{
+  auto const& roi = mesh()->rois.get<tetmesh::ROI_TRI>(ROI_id);
+  if (roi == mesh()->rois.end<tetmesh::ROI_TRI>()) {
+    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+  }
+  setBatchTriCountsNP(reinterpret_cast<const index_t *>(roi->second.data()), roi->second.size(), s, counts, input_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 double TetOpSplitP::getROIVol(const std::string& ROI_id) const
 {
   auto const& roi = mesh()->rois.get<tetmesh::ROI_TET>(ROI_id);
@@ -8250,6 +8903,21 @@ void TetOpSplitP::setDiffApplyThreshold(int threshold)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void TetOpSplitP::setMultiRateDiffusion(uint max_multiplier)
+{
+    if (max_multiplier == 0 || max_multiplier > MAX_DIFF_MULTIPLIER)
+    {
+        std::ostringstream os;
+        os << "Maximum diffusion period multiplier must be between 1 and "
+           << MAX_DIFF_MULTIPLIER << ".";
+        ArgErrLog(os.str());
+    }
+    diffMaxMultiplier = max_multiplier;
+    recomputeUpdPeriod = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 unsigned long long TetOpSplitP::getReacExtent(bool local)
 {
     if (local) {
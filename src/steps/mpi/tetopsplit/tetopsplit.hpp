@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <fstream>
 #include <map>
 #include <random>
 #include <set>
@@ -48,6 +49,7 @@
 #include "solver/api.hpp"
 #include "solver/statedef.hpp"
 #include "solver/efield/efield.hpp"
+#include "solver/efield/ohmiccurrents.hpp"
 #include "util/common.h"
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -484,6 +486,21 @@ public:
     //void _build();
     void _refreshEFTrisV();
 
+    // Collect the values of a batch of elements from their host ranks with a
+    // single MPI_Allgatherv. hosts holds the host rank of each element, or -1
+    // for elements without value, which are set to zero.
+    void _allgatherByHost(std::vector<int> const & hosts,
+                          std::vector<double> const & local_values,
+                          double * values) const;
+
+    // Checkpoint data replicated on all ranks, only serialized by rank 0
+    void _checkpointShared(std::fstream & cp_file);
+    void _restoreShared(std::fstream & cp_file);
+
+    // Checkpoint data of the elements and kinetic processes hosted by this rank
+    void _checkpointLocal(std::fstream & cp_file);
+    void _restoreLocal(std::fstream & cp_file);
+
     double _getRate(uint i) const
     { return pKProcs[i]->rate(); }
 
@@ -557,6 +574,18 @@ public:
                             double *concs,
                             size_t output_size) const;
 
+    void setBatchTetCountsNP(const index_t *indices,
+                             size_t ntets,
+                             std::string const &s,
+                             const double *counts,
+                             size_t input_size);
+
+    void setBatchTriCountsNP(const index_t *indices,
+                             size_t ntris,
+                             std::string const &s,
+                             const double *counts,
+                             size_t input_size);
+
     double sumBatchTetCountsNP(const index_t *indices, size_t input_size, std::string const & s);
 
     double sumBatchTriCountsNP(const index_t *indices, size_t input_size, std::string const & s);
@@ -615,6 +644,12 @@ public:
     /// Get species counts of a list of triangles
     void getROITriCountsNP(const std::string& ROI_id, std::string const & s, double* counts, size_t output_size) const override;
 
+    /// Set species counts of the tetrahedrons of a ROI, see setBatchTetCountsNP
+    void setROITetCountsNP(const std::string& ROI_id, std::string const & s, const double* counts, size_t input_size);
+
+    /// Set species counts of the triangles of a ROI, see setBatchTriCountsNP
+    void setROITriCountsNP(const std::string& ROI_id, std::string const & s, const double* counts, size_t input_size);
+
     double getROIVol(const std::string& ROI_id) const override;
     double getROIArea(const std::string& ROI_id) const override;
 
@@ -656,6 +691,14 @@ public:
 
     void setDiffApplyThreshold(int threshold);
 
+    // Multi-rate diffusion: diffusion processes whose scaled diffusion
+    // constant allows it are only applied every 2, 4, ... up to
+    // max_multiplier update periods. 1 (default) disables it, values above
+    // MAX_DIFF_MULTIPLIER are rejected.
+    static constexpr uint MAX_DIFF_MULTIPLIER = 1u << 30;
+    void setMultiRateDiffusion(uint max_multiplier);
+    uint getMultiRateDiffusion() const noexcept { return diffMaxMultiplier; }
+
     unsigned long long getReacExtent(bool local = false);
     unsigned long long getDiffExtent(bool local = false);
     double getNIteration();
@@ -814,6 +857,14 @@ private:
     // Translate from permuted vector of triangle currents to local EFTri indices.
     std::vector<triangle_id_t >                 EFTrisI_idx;
 
+    // Ohmic currents of the host-local membrane triangles, evaluated in one
+    // batch: slots are indices in EFTrisI_permuted, potentials are read from
+    // EFTrisV by local EFTri index.
+    steps::solver::efield::OhmicCurrents        EFOhmicCurrs;
+
+    // Indices in EFTrisI_permuted of the host-local triangles with GHK currents.
+    std::vector<int>                            EFGHKTrisI;
+
     // Per-rank counts of EFTris.
     std::vector<int>                            EFTrisI_count;
 
@@ -854,6 +905,12 @@ private:
     //bool                                        requireSync;
     uint                                        diffApplyThreshold{10};
 
+    // Multi-rate diffusion: largest period multiplier, and for each local
+    // (surface) diffusion process the log2 of its own multiplier
+    uint                                        diffMaxMultiplier{1};
+    std::vector<uint>                           pDiffBuckets;
+    std::vector<uint>                           pSDiffBuckets;
+
     std::set<int>                               neighbHosts;
     uint                                        nNeighbHosts;
 
@@ -800,6 +800,31 @@ double smtos::Tri::computeI(double v, double dt, double simtime, double efdt)
         current += (n*ocdef->getG())*(v-ocdef->getERev());
     }
 
+    current += computeGHKI(dt, efdt, simtime);
+    resetOCintegrals();
+
+    return current;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::Tri::setupOhmicCurrents(ssolver::efield::OhmicCurrents & ocs,
+                                 index_t slot, index_t vidx)
+{
+    uint nocs = patchdef()->countOhmicCurrs();
+    for (uint i = 0; i < nocs; ++i)
+    {
+        ssolver::OhmicCurrdef * ocdef = patchdef()->ohmiccurrdef(i);
+        ocs.add(slot, vidx, ocdef->getG(), ocdef->getERev(),
+                &pPoolCount[patchdef()->ohmiccurr_chanstate(i)],
+                &pOCchan_timeintg[i], &pOCtime_upd[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double smtos::Tri::computeGHKI(double dt, double efdt, double simtime)
+{
     uint nghkcurrs = pPatchdef->countGHKcurrs();
     int efcharge=0;
     for (uint i =0; i < nghkcurrs; ++i)
@@ -809,13 +834,10 @@ double smtos::Tri::computeI(double v, double dt, double simtime, double efdt)
 
     // The contribution from GHK charge movement.
     auto efcharged = static_cast<double>(efcharge);
-
-    // Convert charge to coulombs and find mean current
-    current += ((efcharged*steps::math::E_CHARGE)/dt);
     resetECharge(dt, efdt, simtime);
-    resetOCintegrals();
 
-    return current;
+    // Convert charge to coulombs and find mean current
+    return ((efcharged*steps::math::E_CHARGE)/dt);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -33,6 +33,7 @@
 #include "kproc.hpp"
 
 #include "solver/patchdef.hpp"
+#include "solver/efield/ohmiccurrents.hpp"
 #include "solver/types.hpp"
 #include "util/common.h"
 ////////////////////////////////////////////////////////////////////////////////
@@ -202,6 +203,15 @@ public:
 
     double computeI(double v, double dt, double simtime, double efdt);
 
+    // Register the ohmic currents of this triangle in a batch, see
+    // steps::solver::efield::OhmicCurrents::add
+    void setupOhmicCurrents(steps::solver::efield::OhmicCurrents & ocs,
+                            index_t slot, index_t vidx);
+
+    // The GHK part of computeI: mean current of the GHK charge movements
+    // over dt, then reset the charges
+    double computeGHKI(double dt, double efdt, double simtime);
+
     double getOhmicI(double v, double dt) const;
     double getOhmicI(uint lidx, double v,double dt) const;
 
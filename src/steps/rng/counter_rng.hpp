@@ -0,0 +1,114 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_RNG_COUNTER_RNG_HPP
+#define STEPS_RNG_COUNTER_RNG_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Random123/philox.h"
+
+namespace steps {
+namespace rng {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Counter-based random number generator.
+///
+/// Numbers are the Philox 4x32 function of a key, derived from the seed and
+/// a stream tag, and of a counter made of an element index, a species index,
+/// a step index and a draw index. Two generators built with the same
+/// arguments produce the same sequence, and generators built with different
+/// arguments are independent, without any state shared between them: a
+/// generator can be created on the fly by whichever thread or process owns
+/// the element, and the numbers drawn do not depend on the partitioning of
+/// the mesh or on the number of threads.
+///
+/// Satisfies the UniformRandomBitGenerator requirements of the standard
+/// library, so that it can be used with the std distributions.
+class CounterRNG {
+  public:
+    typedef r123::Philox4x32_R<8> philox_type;
+    typedef std::uint32_t result_type;
+
+    /// Purpose of the numbers drawn, so that two solver operations on the
+    /// same element during the same step use different streams
+    enum Stream : std::uint32_t { DIFFUSION = 1, SSA = 2 };
+
+    /// Constructor
+    ///
+    /// \param seed Seed shared by all the processes, only its first 32 bits are used
+    /// \param stream Purpose of the numbers drawn
+    /// \param element Global index of the element
+    /// \param species Index of the species in the element
+    /// \param step Index of the step
+    CounterRNG(std::uint64_t seed,
+               std::uint32_t stream,
+               std::uint32_t element,
+               std::uint32_t species,
+               std::uint32_t step) noexcept
+        : pKey{{static_cast<std::uint32_t>(seed), stream}}
+        , pCtr{{element, species, step, 0}} {}
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+
+    static constexpr result_type max() noexcept {
+        return 0xffffffffu;
+    }
+
+    result_type operator()() noexcept {
+        if (pNext == pBlock.size()) {
+            pBlock = philox_type()(pCtr, pKey);
+            ++pCtr[3];
+            pNext = 0;
+        }
+        return pBlock[pNext++];
+    }
+
+    /// Uniform number on the [0, 1) interval
+    double getUnfIE() noexcept {
+        return (*this)() * (1.0 / 4294967296.0);
+    }
+
+  private:
+    philox_type::key_type pKey;
+    philox_type::ctr_type pCtr;
+    philox_type::ctr_type pBlock{};
+    std::size_t pNext{4};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}  // namespace rng
+}  // namespace steps
+
+#endif
+// STEPS_RNG_COUNTER_RNG_HPP
+
+// END
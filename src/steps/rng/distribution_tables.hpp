@@ -0,0 +1,132 @@
+/*
+   #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_RNG_DISTRIBUTION_TABLES_HPP
+#define STEPS_RNG_DISTRIBUTION_TABLES_HPP
+
+namespace steps {
+namespace rng {
+
+// Constants of the samplers of RNG, to full double precision. The values are
+// rounded from their closed forms; test_rng checks them against those.
+
+/// 1 / sqrt(2 pi)
+inline constexpr double INV_SQRT_2PI = 0.39894228040143268;
+
+/// q[k] = sum_{i=1}^{k+1} ln(2)^i / i!, for getStdExp
+inline constexpr double STD_EXP_Q[8] = {
+    0.69314718055994529, 0.93337368751904604, 0.98887779618386762,
+    0.99849592529149611, 0.99982928110613889, 0.99998331641007276,
+    0.99999856914387675, 0.99999989069255579
+};
+
+/// a[k] = Phi^-1(1/2 + k/64), bounds of the center intervals of getStdNrm
+inline constexpr double STD_NRM_A[32] = {
+    0.0, 0.039176085503097632, 0.078412412733112197,
+    0.1177698745790953, 0.1573106846101707, 0.19709908429431233,
+    0.23720210932878769, 0.27769043982157676, 0.31863936396437514,
+    0.36012989178956939, 0.4022500653217253, 0.44509652498551633,
+    0.48877641111466952, 0.53340970624128059, 0.57913216225555597,
+    0.62609901234642118, 0.67448975019608171, 0.7245143834923653,
+    0.7764217611479276, 0.83051087820539915, 0.88714655901887607,
+    0.94678175630104566, 1.0099901692495821, 1.0775155670402803,
+    1.1503493803760081, 1.229858759216589, 1.3180108973035367,
+    1.4177971379962673, 1.5341205443525463, 1.6759397227734438,
+    1.8627318674216515, 2.1538746940614564
+};
+
+/// d[k] = Phi^-1(1 - 2^-(k+2)) - Phi^-1(1 - 2^-(k+1)) for k >= 5, steps in
+/// the tail of getStdNrm
+inline constexpr double STD_NRM_D[31] = {
+    0.0, 0.0, 0.0,
+    0.0, 0.0, 0.26368432217504884,
+    0.24250845238095459, 0.2255674438092975, 0.21163416577202732,
+    0.19992426749317888, 0.18991075842246777, 0.18122518100689192,
+    0.17360140038058786, 0.16684190866667409, 0.16079672918052079,
+    0.15534971747694051, 0.15040938382815711, 0.14590257684504379,
+    0.14177003276856681, 0.13796317369537905, 0.13444176150073414,
+    0.13117215026482595, 0.12812596512584495, 0.12527909006226992,
+    0.12261088288607178, 0.1201035596564989, 0.11774170701949556,
+    0.1155118922606357, 0.11340234879117397, 0.11140272044119692,
+    0.10950385201710235
+};
+
+/// t[k] = (a[k+1]^2 - a[k]^2) / 2
+inline constexpr double STD_NRM_T[31] = {
+    0.00076738283767300815, 0.00230687039764096, 0.0038606184438739503,
+    0.0054384540670723795, 0.0070506987685679187, 0.0087083958201848582,
+    0.010423569849137294, 0.012209531949660405, 0.014081247346372715,
+    0.016055788045482643, 0.018152900751425054, 0.02039573175397702,
+    0.022811767325136404, 0.025434073323193168, 0.028302955951184258,
+    0.031468224929204341, 0.034992334383874751, 0.038954829648363658,
+    0.043458783816726861, 0.048640349180764424, 0.054683338442730232,
+    0.061842223958153447, 0.070479827616668517, 0.081131949858664704,
+    0.094624435345151081, 0.11230007889455293, 0.13649799954976638,
+    0.17168856004707314, 0.2276240548826875, 0.33049802776911241,
+    0.58470309390508934
+};
+
+/// h[k] = (a[k+1] - a[k]) / (1 - t[k])
+inline constexpr double STD_NRM_H[31] = {
+    0.039206171646349902, 0.039327049636647911, 0.039509994860860299,
+    0.03975702679514416, 0.040070927724907002, 0.040455326026549186,
+    0.040914808860813848, 0.0414550711585846, 0.042083110513438722,
+    0.042807481379953355, 0.043638627334726766, 0.04458931789605388,
+    0.045675227795607051, 0.046915713716962529, 0.048334869781188471,
+    0.049962984277024253, 0.051838586447232569, 0.054011381833977586,
+    0.056546561865148143, 0.059531304238840461, 0.06308488965372662,
+    0.067375034949043608, 0.072645435566567565, 0.079264714149681337,
+    0.08781922325338197, 0.099303983239259833, 0.11555994154119117,
+    0.14043438342815798, 0.18361418337459665, 0.27900163464162214,
+    0.70104742502769302
+};
+
+/// (log(1 + v) - v) / v^2 = sum_k a[k] v^k with a[k] = (-1)^(k+1) / (k + 2);
+/// for |v| <= 0.25 the first omitted term is below 2^-54, see getPsn
+inline constexpr double PSN_LOG_A[25] = {
+    -0.5, 0.33333333333333331, -0.25,
+    0.20000000000000001, -0.16666666666666666, 0.14285714285714285,
+    -0.125, 0.1111111111111111, -0.10000000000000001,
+    0.090909090909090912, -0.083333333333333329, 0.076923076923076927,
+    -0.071428571428571425, 0.066666666666666666, -0.0625,
+    0.058823529411764705, -0.055555555555555552, 0.052631578947368418,
+    -0.050000000000000003, 0.047619047619047616, -0.045454545454545456,
+    0.043478260869565216, -0.041666666666666664, 0.040000000000000001,
+    -0.038461538461538464
+};
+
+/// Coefficients of 1/k, 1/k^3... in log(k!) - log(sqrt(2 pi k) (k/e)^k); for
+/// k >= 10 the first omitted term is below 3e-17, see getPsn
+inline constexpr double PSN_STIRLING[7] = {
+    0.083333333333333329, -0.0027777777777777779, 0.00079365079365079365,
+    -0.00059523809523809529, 0.00084175084175084171, -0.0019175269175269176,
+    0.00641025641025641
+};
+
+}  // namespace rng
+}  // namespace steps
+
+#endif  // STEPS_RNG_DISTRIBUTION_TABLES_HPP
@@ -108,6 +108,22 @@ void MT19937::concreteFillBuffer()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MT19937::concreteCheckpoint(std::fstream & cp_file)
+{
+    cp_file.write(reinterpret_cast<char*>(pState), sizeof(unsigned long) * MT_N);
+    cp_file.write(reinterpret_cast<char*>(&pStateInit), sizeof(int));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MT19937::concreteRestore(std::fstream & cp_file)
+{
+    cp_file.read(reinterpret_cast<char*>(pState), sizeof(unsigned long) * MT_N);
+    cp_file.read(reinterpret_cast<char*>(&pStateInit), sizeof(int));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 MT19937::MT19937(uint bufsize)
 : RNG(bufsize)
 {
@@ -118,6 +118,12 @@ protected:
     ///
     virtual void concreteFillBuffer();
 
+    /// checkpoint the state of the generator
+    virtual void concreteCheckpoint(std::fstream & cp_file);
+
+    /// restore the state of the generator
+    virtual void concreteRestore(std::fstream & cp_file);
+
 private:
 
     unsigned long               pState[MT_N];
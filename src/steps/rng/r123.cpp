@@ -90,4 +90,20 @@ void R123::concreteFillBuffer()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void R123::concreteCheckpoint(std::fstream & cp_file)
+{
+    cp_file.write(reinterpret_cast<char*>(key.data()), sizeof(key));
+    cp_file.write(reinterpret_cast<char*>(ctr.data()), sizeof(ctr));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void R123::concreteRestore(std::fstream & cp_file)
+{
+    cp_file.read(reinterpret_cast<char*>(key.data()), sizeof(key));
+    cp_file.read(reinterpret_cast<char*>(ctr.data()), sizeof(ctr));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // END
@@ -105,6 +105,12 @@ protected:
     ///
     virtual void concreteFillBuffer();
 
+    /// checkpoint the state of the generator
+    virtual void concreteCheckpoint(std::fstream & cp_file);
+
+    /// restore the state of the generator
+    virtual void concreteRestore(std::fstream & cp_file);
+
 private:
 
     r123_type::key_type key;
@@ -26,14 +26,17 @@
 
 
 // Standard library & STL headers.
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
 #include <random>
+#include <sstream>
 #include <string>
 
 // STEPS headers.
 #include "rng.hpp"
+#include "distribution_tables.hpp"
 #include "small_binomial.hpp"
 // util
 #include "util/error.hpp"
@@ -47,6 +50,28 @@ using std::string;
 // STEPS library.
 namespace smath = steps::math;
 using steps::rng::RNG;
+using steps::rng::INV_SQRT_2PI;
+using steps::rng::PSN_LOG_A;
+using steps::rng::PSN_STIRLING;
+using steps::rng::STD_EXP_Q;
+using steps::rng::STD_NRM_A;
+using steps::rng::STD_NRM_D;
+using steps::rng::STD_NRM_H;
+using steps::rng::STD_NRM_T;
+
+namespace {
+
+// Polynomial with coefficients c[0], c[1]... evaluated at x.
+template <std::size_t N>
+inline double horner(const double (&c)[N], double x) {
+    double r = c[N - 1];
+    for (std::size_t k = N - 1; k > 0; k--) {
+        r = r * x + c[k - 1];
+    }
+    return r;
+}
+
+}  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
 RNG::RNG(uint bufsize)
@@ -81,21 +106,49 @@ void RNG::initialize(ulong const & seed)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-float RNG::getStdExp()
+void RNG::checkpoint(std::fstream & cp_file)
 {
-    static float q[8] =
-    {
-        0.6931472, 0.9333737, 0.9888778, 0.9984959,
-        0.9998293, 0.9999833, 0.9999986, 0.9999999
-    };
-    static long i;
-    static float sexpo, a, u, ustar, umin;
-    static float *q1 = q;
-    a = 0.0;
-    u = getUnfEE();
+    AssertLog(pInitialized);
+    uint next = static_cast<uint>(rNext - rBuffer);
+    cp_file.write(reinterpret_cast<char*>(&rSize), sizeof(uint));
+    cp_file.write(reinterpret_cast<char*>(&next), sizeof(uint));
+    cp_file.write(reinterpret_cast<char*>(rBuffer), sizeof(uint) * rSize);
+    concreteCheckpoint(cp_file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::restore(std::fstream & cp_file)
+{
+    uint size;
+    uint next;
+    cp_file.read(reinterpret_cast<char*>(&size), sizeof(uint));
+    cp_file.read(reinterpret_cast<char*>(&next), sizeof(uint));
+    if (size != rSize) {
+        std::ostringstream os;
+        os << "checkpoint data mismatch with simulator parameters: rng::RNG::rSize, ";
+        os << size << ":" << rSize;
+        ArgErrLog(os.str());
+    }
+    cp_file.read(reinterpret_cast<char*>(rBuffer), sizeof(uint) * rSize);
+    rNext = rBuffer + next;
+    concreteRestore(cp_file);
+    pInitialized = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double RNG::getStdExp()
+{
+    const double* q = STD_EXP_Q;
+    const double q1 = q[0];
+    long i;
+    double sexpo, ustar, umin;
+    double a = 0.0;
+    double u = getUnfEE();
     goto S30;
 S20:
-    a += *q1;
+    a += q1;
 S30:
     u += u;
     /*
@@ -103,10 +156,10 @@ S30:
      * JJV unpredictable behavior if U is initially 0.5.
      *  if(u <= 1.0) goto S20;
      */
-    if(u < 1.0f) { goto S20;
+    if(u < 1.0) { goto S20;
 }
-    u -= 1.0f;
-    if(u > *q1) { goto S60;
+    u -= 1.0;
+    if(u > q1) { goto S60;
 }
     sexpo = a + u;
     return sexpo;
@@ -121,27 +174,15 @@ S70:
     i += 1;
     if(u > *(q + i - 1)) { goto S70;
 }
-    sexpo = a + umin * *q1;
+    sexpo = a + umin * q1;
     return sexpo;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-long RNG::getPsn(float lambda)
+long RNG::getPsn(double lambda)
 {
-    static float a0 = -0.5;
-    static float a1 = 0.3333333;
-    static float a2 = -0.2500068;
-    static float a3 = 0.2000118;
-    static float a4 = -0.1661269;
-    static float a5 = 0.1421878;
-    static float a6 = -0.1384794;
-    static float a7 = 0.125006;
-
-    // JJV changed the initial values of MUPREV and MUOLD.
-    static float muold = -1.0E37;
-    static float muprev = -1.0E37;
-    static float fact[10] =
+    static const double fact[10] =
     {
         1.0, 1.0,
         2.0, 6.0,
@@ -150,39 +191,59 @@ long RNG::getPsn(float lambda)
         40320.0, 362880.0
     };
 
-    // JJV added ll to the list, for Case A.
-    static long ignpoi, j, k, kflag, l, ll, m;
-    static float b1, b2, c, c0, c1, c2, c3, d, del, difmuk, e, fk, fx, fy, g;
-    static float omega, p, p0, px, py, q, s, t, u, v, x, xx, pp[35];
-    float mu = 1.0f / lambda;
+    // The values that only depend on mu are kept in pPsn from one call to
+    // the next, so that each generator can be used from its own thread.
+    double & muold = pPsn.muold;
+    double & muprev = pPsn.muprev;
+    long & l = pPsn.l;
+    long & ll = pPsn.ll;
+    long & m = pPsn.m;
+    double & b1 = pPsn.b1;
+    double & b2 = pPsn.b2;
+    double & c = pPsn.c;
+    double & c0 = pPsn.c0;
+    double & c1 = pPsn.c1;
+    double & c2 = pPsn.c2;
+    double & c3 = pPsn.c3;
+    double & d = pPsn.d;
+    double & omega = pPsn.omega;
+    double & p = pPsn.p;
+    double & p0 = pPsn.p0;
+    double & q = pPsn.q;
+    double & s = pPsn.s;
+    double * pp = pPsn.pp;
+
+    long ignpoi, j, k, kflag;
+    double del, difmuk, e, fk, fx, fy, g, px, py, t, u, v, x, xx;
+    double mu = 1.0 / lambda;
 
     if(mu == muprev) { goto S10;
 }
-    if(mu < 10.0f) { goto S120;
+    if(mu < 10.0) { goto S120;
 }
 
     // CASE A. RECALCULATION OF S,D,LL IF MU HAS CHANGED.
     // JJV changed l in Case A to ll
     muprev = mu;
     s = std::sqrt(mu);
-    d = 6.0f * mu * mu;
+    d = 6.0 * mu * mu;
 
     // THE POISSON PROBABILITIES PK EXCEED THE DISCRETE NORMAL
     // PROBABILITIES FK WHENEVER K >= M(MU). LL=IFIX(MU-1.1484)
     // IS AN UPPER BOUND TO M(MU) FOR ALL MU >= 10 .
-    ll = static_cast<long>(mu - 1.1484f);
+    ll = static_cast<long>(mu - 1.1484);
 
 S10:
     // STEP N. NORMAL SAMPLE - SNORM(IR) FOR STANDARD NORMAL DEVIATE.
     g = mu + s * getStdNrm();
-    if(g < 0.0f) { goto S20;
+    if(g < 0.0) { goto S20;
 }
     ignpoi = static_cast<long>(g);
     // STEP I. IMMEDIATE ACCEPTANCE IF IGNPOI IS LARGE ENOUGH.
     if(ignpoi >= ll) { return ignpoi;
 }
     // STEP S. SQUEEZE ACCEPTANCE - SUNIF(IR) FOR (0,1)-SAMPLE U.
-    fk = static_cast<float>(ignpoi);
+    fk = static_cast<double>(ignpoi);
     difmuk = mu - fk;
     u = getUnfEE();
     if(d * u >= difmuk * difmuk * difmuk) { return ignpoi;
@@ -191,24 +252,23 @@ S10:
 S20:
     // STEP P. PREPARATIONS FOR STEPS Q AND H.
     // (RECALCULATIONS OF PARAMETERS IF NECESSARY)
-    // .3989423=(2*PI)**(-.5)  .416667E-1=1./24.  .1428571=1./7.
     // THE QUANTITIES B1, B2, C3, C2, C1, C0 ARE FOR THE HERMITE
     // APPROXIMATIONS TO THE DISCRETE NORMAL PROBABILITIES FK.
     // C=.1069/MU GUARANTEES MAJORIZATION BY THE 'HAT'-FUNCTION.
     if(mu == muold) { goto S30;
 }
     muold = mu;
-    omega = 0.3989423f / s;
-    b1 = 4.166667e-2f / mu;
-    b2 = 0.3f * b1 * b1;
-    c3 = 0.1428571f * b1 * b2;
-    c2 = b2 - 15.0f * c3;
-    c1 = b1 - 6.0f * b2 + 45.0f * c3;
-    c0 = 1.0f - b1 + 3.0f * b2 - 15.0f * c3;
-    c = 0.1069f / mu;
+    omega = INV_SQRT_2PI / s;
+    b1 = 1.0 / (24.0 * mu);
+    b2 = 0.3 * b1 * b1;
+    c3 = b1 * b2 / 7.0;
+    c2 = b2 - 15.0 * c3;
+    c1 = b1 - 6.0 * b2 + 45.0 * c3;
+    c0 = 1.0 - b1 + 3.0 * b2 - 15.0 * c3;
+    c = 0.1069 / mu;
 
 S30:
-    if(g < 0.0f) { goto S50;
+    if(g < 0.0) { goto S50;
 }
     // 'SUBROUTINE' F IS CALLED (KFLAG=0 FOR CORRECT RETURN).
     kflag = 0;
@@ -226,12 +286,12 @@ S50:
     // (IF T <= -.6744 THEN PK < FK FOR ALL MU >= 10.)
     e = getStdExp();
     u = getUnfEE();
-    u += (u - 1.0f);
-    t = 1.8f + smath::sign(e, u);
-    if(t <= -0.6744f) { goto S50;
+    u += (u - 1.0);
+    t = 1.8 + smath::sign(e, u);
+    if(t <= -0.6744) { goto S50;
 }
     ignpoi = static_cast<long>(mu + s * t);
-    fk = static_cast<float>(ignpoi);
+    fk = static_cast<double>(ignpoi);
     difmuk = mu - fk;
     // 'SUBROUTINE' F IS CALLED (KFLAG=1 FOR CORRECT RETURN).
     kflag = 1;
@@ -248,31 +308,30 @@ S70:
     if(ignpoi >= 10) { goto S80;
 }
     px = -mu;
-    py = std::pow(mu, static_cast<float>(ignpoi)) / *(fact + ignpoi);
+    py = std::pow(mu, static_cast<double>(ignpoi)) / *(fact + ignpoi);
     goto S110;
 
 S80:
-    // CASE IGNPOI .GE. 10 USES POLYNOMIAL APPROXIMATION
-    // A0-A7 FOR ACCURACY WHEN ADVISABLE
-    // .8333333E - 1 = 1. / 12.
-    // .3989423 = (2 * PI) ** (-.5) */
-    del = 8.333333e-2f / fk;
-    del -= (4.8f * del * del * del);
+    // CASE IGNPOI .GE. 10 USES THE STIRLING SERIES FOR THE CORRECTION DEL
+    // AND, WHEN ADVISABLE, THE TAYLOR SERIES OF (LOG(1+V)-V)/V**2 FOR
+    // ACCURACY, BOTH TRUNCATED BELOW DOUBLE PRECISION (SEE
+    // distribution_tables.hpp)
+    del = horner(PSN_STIRLING, 1.0 / (fk * fk)) / fk;
     v = difmuk / fk;
-    if(std::fabs(v) <= 0.25f) goto S90;
-    px = fk * std::log(1.0f + v) - difmuk - del;
+    if(std::fabs(v) <= 0.25) goto S90;
+    px = fk * std::log(1.0 + v) - difmuk - del;
     goto S100;
 
 S90:
-    px = fk*v*v*(((((((a7*v+a6)*v+a5)*v+a4)*v+a3)*v+a2)*v+a1)*v+a0)-del;
+    px = fk * v * v * horner(PSN_LOG_A, v) - del;
 
 S100:
-    py = 0.3989423f / std::sqrt(fk);
+    py = INV_SQRT_2PI / std::sqrt(fk);
 
 S110:
-    x = (0.5f - difmuk) / s;
+    x = (0.5 - difmuk) / s;
     xx = x * x;
-    fx = -0.5f * xx;
+    fx = -0.5 * xx;
     fy = omega * (((c3 * xx + c2) * xx + c1) * xx + c0);
     if(kflag <= 0) { goto S40;
 }
@@ -285,7 +344,7 @@ S120:
     if(mu == muold) { goto S130;
 }
     // JJV added argument checker here.
-    if(mu >= 0.0f) { goto S125;
+    if(mu >= 0.0) { goto S125;
 }
     // NO EXIT!
     CLOG(WARNING, "general_log") << "MU < 0 in IGNPOI: MU:" << mu << std::endl;
@@ -311,7 +370,7 @@ S130:
     if(l == 0) { goto S150;
 }
     j = 1;
-    if(u > 0.458f) j = smath::min(l,m);
+    if(u > 0.458) j = smath::min(l,m);
     for(k=j; k<=l; ++k)
     {
         if(u <= *(pp + k - 1)) { goto S180;
@@ -326,7 +385,7 @@ S150:
     l += 1;
     for(k = l; k <= 35; ++k)
     {
-        p = p * mu / static_cast<float>(k);
+        p = p * mu / static_cast<double>(k);
         q += p;
         *(pp + k - 1) = q;
         if(u <= q) { goto S170;
@@ -359,57 +418,20 @@ S180:
 //
 // THE DEFINITIONS OF THE CONSTANTS A(K), D(K), T(K) AND
 // H(K) ARE ACCORDING TO THE ABOVEMENTIONED ARTICLE
-float RNG::getStdNrm()
+double RNG::getStdNrm()
 {
-    static float a[32] =
-    {
-        0.0000000,      3.917609E-2,    7.841241E-2,    0.11777,
-        0.1573107,      0.1970991,      0.2372021,      0.2776904,
-        0.3186394,      0.36013,        0.4022501,      0.4450965,
-        0.4887764,      0.5334097,      0.5791322,      0.626099,
-        0.6744898,      0.7245144,      0.7764218,      0.8305109,
-        0.8871466,      0.9467818,      1.00999,        1.077516,
-        1.150349,       1.229859,       1.318011,       1.417797,
-        1.534121,       1.67594,        1.862732,       2.153875
-    };
-    static float d[31] = {
-        0.0,            0.0,            0.0,            0.0,
-        0.0,            0.2636843,      0.2425085,      0.2255674,
-        0.2116342,      0.1999243,      0.1899108,      0.1812252,
-        0.1736014,      0.1668419,      0.1607967,      0.1553497,
-        0.1504094,      0.1459026,      0.14177,        0.1379632,
-        0.1344418,      0.1311722,      0.128126,       0.1252791,
-        0.1226109,      0.1201036,      0.1177417,      0.1155119,
-        0.1134023,      0.1114027,      0.1095039
-    };
-    static float t[31] = {
-        7.673828E-4,    2.30687E-3,     3.860618E-3,    5.438454E-3,
-        7.0507E-3,      8.708396E-3,    1.042357E-2,    1.220953E-2,
-        1.408125E-2,    1.605579E-2,    1.81529E-2,     2.039573E-2,
-        2.281177E-2,    2.543407E-2,    2.830296E-2,    3.146822E-2,
-        3.499233E-2,    3.895483E-2,    4.345878E-2,    4.864035E-2,
-        5.468334E-2,    6.184222E-2,    7.047983E-2,    8.113195E-2,
-        9.462444E-2,    0.1123001,      0.136498,       0.1716886,
-        0.2276241,      0.330498,       0.5847031
-    };
-    static float h[31] = {
-        3.920617E-2,    3.932705E-2,    3.951E-2,        3.975703E-2,
-        4.007093E-2,    4.045533E-2,    4.091481E-2,     4.145507E-2,
-        4.208311E-2,    4.280748E-2,    4.363863E-2,     4.458932E-2,
-        4.567523E-2,    4.691571E-2,    4.833487E-2,     4.996298E-2,
-        5.183859E-2,    5.401138E-2,    5.654656E-2,     5.95313E-2,
-        6.308489E-2,    6.737503E-2,    7.264544E-2,     7.926471E-2,
-        8.781922E-2,    9.930398E-2,    0.11556,         0.1404344,
-        0.1836142,      0.2790016,      0.7010474
-    };
-    static long i;
-    static float snorm, u, s, ustar, aa, w, y, tt;
-    u = getUnfEE();
-    s = 0.0;
-    if(u > 0.5f) { s = 1.0;
+    const double* a = STD_NRM_A;
+    const double* d = STD_NRM_D;
+    const double* t = STD_NRM_T;
+    const double* h = STD_NRM_H;
+    long i;
+    double snorm, ustar, aa, w, y, tt;
+    double u = getUnfEE();
+    double s = 0.0;
+    if(u > 0.5) { s = 1.0;
 }
     u += (u - s);
-    u = 32.0f * u;
+    u = 32.0 * u;
     i = static_cast<long>(u);
     if(i == 32) { i = 31;
 }
@@ -417,7 +439,7 @@ float RNG::getStdNrm()
 }
 
     // START CENTER
-    ustar = u - static_cast<float>(i);
+    ustar = u - static_cast<double>(i);
     aa = *(a + i - 1);
 
 S40:
@@ -429,7 +451,7 @@ S50:
     // EXIT   (BOTH CASES)
     y = aa + w;
     snorm = y;
-    if(s == 1.0f) { snorm = -y;
+    if(s == 1.0) { snorm = -y;
 }
     return snorm;
 
@@ -437,7 +459,7 @@ S60:
     // CENTER CONTINUED
     u = getUnfEE();
     w = u * (*(a + i) - aa);
-    tt = (0.5f * w + aa) * w;
+    tt = (0.5 * w + aa) * w;
     goto S80;
 
 S70:
@@ -465,13 +487,13 @@ S110:
 
 S120:
     u += u;
-    if(u < 1.0f) { goto S110;
+    if(u < 1.0) { goto S110;
 }
-    u -= 1.0f;
+    u -= 1.0;
 
 S140:
     w = u * *(d + i - 1);
-    tt = (0.5f * w + aa) * w;
+    tt = (0.5 * w + aa) * w;
     goto S160;
 
 S150:
@@ -490,9 +512,10 @@ S160:
 
 double RNG::getExp(double lambda)
 {
-     return (1.0 / lambda) * static_cast<double>(getStdExp());
+     return (1.0 / lambda) * getStdExp();
 }
 
+////////////////////////////////////////////////////////////////////////////////
 
 uint RNG::getBinom(uint t, double p)
 {
@@ -503,8 +526,81 @@ uint RNG::getBinom(uint t, double p)
         return d(*this);
     }
 
-    std::binomial_distribution<uint> distribution(t, p);
-    return distribution(*this);
+    // Setting up the distribution is more expensive than drawing from it,
+    // keep it while the parameters don't change. Resetting it discards any
+    // value cached by the distribution, so that the numbers drawn, and the
+    // checkpoints, are the same as with a new distribution at each call.
+    if (pBinom.t() != t || pBinom.p() != p) {
+        pBinom.param(std::binomial_distribution<uint>::param_type(t, p));
+    }
+    pBinom.reset();
+    return pBinom(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillUnf(double * out, std::size_t n)
+{
+    while (n != 0)
+    {
+        if (rNext == rEnd) { concreteFillBuffer(); rNext = rBuffer; }
+        const auto m = std::min(n, static_cast<std::size_t>(rEnd - rNext));
+        const uint * b = rNext;
+
+        // Divided by 2^32.
+        #pragma omp simd
+        for (std::size_t i = 0; i < m; ++i) {
+            out[i] = b[i] * (1.0/4294967296.0);
+        }
+
+        rNext += m;
+        out += m;
+        n -= m;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillExp(double const * lambda, double * out, std::size_t n)
+{
+    while (n != 0)
+    {
+        if (rNext == rEnd) { concreteFillBuffer(); rNext = rBuffer; }
+        const auto m = std::min(n, static_cast<std::size_t>(rEnd - rNext));
+        const uint * b = rNext;
+
+        // Inversion of uniform numbers on (0,1), see getUnfEE().
+        #pragma omp simd
+        for (std::size_t i = 0; i < m; ++i) {
+            const double u = (static_cast<double>(b[i]) + 0.5) * (1.0/4294967296.0);
+            out[i] = -std::log(u) / lambda[i];
+        }
+
+        rNext += m;
+        lambda += m;
+        out += m;
+        n -= m;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillBinom(uint * out, std::size_t n, uint t, double p)
+{
+    uint t_small = 20;
+
+    if (t<=t_small) {
+        small_binomial_distribution<uint> d(t,p);
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = d(*this);
+        }
+        return;
+    }
+
+    std::binomial_distribution<uint> d(t, p);
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = d(*this);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
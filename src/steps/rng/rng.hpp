@@ -30,7 +30,10 @@
 
 
 // STL headers.
+#include <cstddef>
+#include <fstream>
 #include <memory>
+#include <random>
 
 // STEPS headers.
 #include "util/common.h"
@@ -43,6 +46,9 @@ namespace rng {
 /// Base class of random number generator.
 ///
 /// The RNG class can be inherited by other classes of random number generators.
+///
+/// An RNG keeps all its state in the object: separate generators can be used
+/// concurrently, e.g. one per thread.
 class RNG
 {
 
@@ -61,6 +67,12 @@ public:
     /// \param seed Seed for the generator.
     void initialize(ulong const & seed);
 
+    /// checkpoint the generator state and the unused part of the buffer
+    void checkpoint(std::fstream & cp_file);
+
+    /// restore the generator state and the unused part of the buffer
+    void restore(std::fstream & cp_file);
+
     /// Minimax inclusive range for the C++11 compatibility
     static constexpr uint min() { return 0; }
     static constexpr uint max() { return 0xffffffffu; }
@@ -109,24 +121,40 @@ public:
     }
 
     /// Get a standard exponentially distributed number.
-    float getStdExp();
+    double getStdExp();
 
-    /// Get an exponentially distributed number with mean lambda.
+    /// Get an exponentially distributed number with rate lambda, i.e. with
+    /// mean 1/lambda.
     ///
     double getExp(double lambda);
 
-    /// Get a Poisson-distributed number with mean lambda.
+    /// Get a Poisson-distributed number with mean 1/lambda.
     ///
-    long getPsn(float lambda);
+    long getPsn(double lambda);
 
     /// Get a standard normally distributed random number.
     ///
-    float getStdNrm();
+    double getStdNrm();
 
     /// Get a binomially distributed number with parameters t and p.
     ///
     uint getBinom(uint t, double p);
 
+    /// Fill out with n uniform random numbers on [0,1), the same numbers as
+    /// n calls to getUnfIE().
+    ///
+    void fillUnf(double * out, std::size_t n);
+
+    /// Fill out with n exponentially distributed numbers, out[i] with rate
+    /// lambda[i]. Uses the inversion method, so the numbers differ from the
+    /// ones getExp() returns.
+    ///
+    void fillExp(double const * lambda, double * out, std::size_t n);
+
+    /// Fill out with n binomially distributed numbers with parameters t and p.
+    ///
+    void fillBinom(uint * out, std::size_t n, uint t, double p);
+
 protected:
 
     uint                      * rBuffer;
@@ -141,10 +169,39 @@ protected:
     ///
     virtual void concreteFillBuffer() = 0;
 
+    /// checkpoint the state of the concrete generator
+    virtual void concreteCheckpoint(std::fstream & cp_file) = 0;
+
+    /// restore the state of the concrete generator
+    virtual void concreteRestore(std::fstream & cp_file) = 0;
+
 private:
 
     bool                        pInitialized;
 
+    /// Values of getPsn() that only depend on its argument.
+    struct PsnCache
+    {
+        // JJV changed the initial values of MUPREV and MUOLD.
+        double                  muold{-1.0E37};
+        double                  muprev{-1.0E37};
+        // JJV added ll to the list, for Case A.
+        long                    l{0};
+        long                    ll{0};
+        long                    m{0};
+        double                  b1{0.0}, b2{0.0};
+        double                  c{0.0}, c0{0.0}, c1{0.0}, c2{0.0}, c3{0.0};
+        double                  d{0.0};
+        double                  omega{0.0};
+        double                  p{0.0}, p0{0.0}, q{0.0};
+        double                  s{0.0};
+        double                  pp[35]{};
+    };
+    PsnCache                    pPsn;
+
+    /// Distribution of getBinom() for large numbers of trials.
+    std::binomial_distribution<uint> pBinom;
+
 };
 
 using RNGptr = std::shared_ptr<RNG>;
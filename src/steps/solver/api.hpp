@@ -70,6 +70,7 @@ public:
         EF_DEFAULT = 1, // must be one for API compatibility
         EF_DV_BDSYS,
         EF_DV_PETSC,
+        EF_DV_PCG,
     };
 
     /// Constructor
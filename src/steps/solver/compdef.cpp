@@ -292,6 +292,7 @@ void ssolver::Compdef::setup_indices()
                 pReac_UPD_Spec[aridx] = rdef->upd(si);
             }
         }
+        pReac_Reactants.assign(pReac_LHS_Spec, pReacsN, pSpecsN);
     }
 
     if (pDiffsN != 0)
@@ -38,6 +38,7 @@
 #include "util/common.h"
 #include "api.hpp"
 #include "diffdef.hpp"
+#include "reactants.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -217,6 +218,20 @@ public:
     /// \param rlidx Local index of the reaction.
     uint * reac_lhs_end(uint rlidx) const;
 
+    /// Return the beginning of the compact reactant list of reaction
+    /// specified by local index argument.
+    ///
+    /// \param rlidx Local index of the reaction.
+    inline const Reactant * reac_reactants_bgn(uint rlidx) const noexcept
+    { return pReac_Reactants.bgn(rlidx); }
+
+    /// Return the end of the compact reactant list of reaction
+    /// specified by local index argument.
+    ///
+    /// \param rlidx Local index of the reaction.
+    inline const Reactant * reac_reactants_end(uint rlidx) const noexcept
+    { return pReac_Reactants.end(rlidx); }
+
     /// Return the beginning of the update array of reaction specified by
     /// local index argument.
     ///
@@ -393,6 +408,9 @@ private:
     uint                              * pReac_LHS_Spec;
     int                               * pReac_UPD_Spec;
 
+    // Non-zero entries of pReac_LHS_Spec, per reaction.
+    ReactantLists                       pReac_Reactants;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA: DIFFUSION RULES
     ////////////////////////////////////////////////////////////////////////
@@ -46,7 +46,7 @@ inline void swap_row(double *u,double *v,int n) {
     for (int j=0;j<n;++j) std::swap(u[j],v[j]);
 }
 
-void BDSystem::solve()
+void BDSystem::decompose()
 {
     constexpr double TINY = 1.0e-20;
 
@@ -130,12 +130,22 @@ void BDSystem::solve()
         lk += h;
     }
 
+}
+
+void BDSystem::substitute()
+{
+    auto n = pN;
+    auto h = pHalfBW;
+    auto w = 2 * h + 1;
+    const double *a = pA.data();
+    const double *l = h > 0? pL.data(): nullptr;
+
     // 2. Forward substitution, b into x.
     std::copy(pb.begin(),pb.end(),px.begin());
     double *x = px.data();
     double *xk = x;
-    lk = l;
-    ak = a;
+    const double *lk = l;
+    const double *ak = a;
     for (auto k = 0u; k < n; ++k)
     {
         auto i = pp[k];
@@ -99,7 +99,15 @@ public:
 
     const vector_type &x() const { return px_view; }
 
-    void solve(); // destructive: overwrites pA
+    void solve() {
+        decompose();
+        substitute();
+    }
+
+    void decompose(); // destructive: overwrites pA
+
+    // solve for the current b with the factors of the last decompose()
+    void substitute();
 
 private:
     size_t pN,pHalfBW;
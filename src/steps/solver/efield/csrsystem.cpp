@@ -0,0 +1,286 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/common.h"
+#include "csrsystem.hpp"
+
+#include <easylogging++.h>
+#include "util/error.hpp"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+CSRMatrix::CSRMatrix(std::vector<std::vector<size_t>> const & pattern)
+: pN(pattern.size())
+, pRowPtr(1, 0)
+{
+    pRowPtr.reserve(pN + 1);
+    for (auto const& row: pattern) {
+        std::vector<size_t> cols(row);
+        std::sort(cols.begin(), cols.end());
+        cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+        AssertLog(cols.empty() || cols.back() < pN);
+
+        pCol.insert(pCol.end(), cols.begin(), cols.end());
+        pRowPtr.push_back(pCol.size());
+    }
+    pValues.assign(pCol.size(), 0.0);
+}
+
+size_t CSRMatrix::find(size_t row,size_t col) const {
+    auto b = pCol.begin() + pRowPtr[row];
+    auto e = pCol.begin() + pRowPtr[row + 1];
+    auto it = std::lower_bound(b, e, col);
+    if (it == e || *it != col) {
+        return pValues.size();
+    }
+    return static_cast<size_t>(it - pCol.begin());
+}
+
+double CSRMatrix::get(size_t row,size_t col) const {
+    auto k = find(row, col);
+    return k < pValues.size() ? pValues[k] : 0.0;
+}
+
+void CSRMatrix::set(size_t row,size_t col,double value) {
+    auto k = find(row, col);
+    AssertLog(k < pValues.size());
+    pValues[k] = value;
+}
+
+void CSRMatrix::zero() {
+    std::fill(pValues.begin(), pValues.end(), 0.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CSRSystem::CSRSystem(std::vector<std::vector<size_t>> const & pattern, double rtol):
+    pN(pattern.size()),
+    pRTol(rtol),
+    pA(pattern),
+    pTransPos(pA.nnz()),
+    pDiagPos(pN),
+    pL(pA.nnz(), 0.0),
+    pInvDiag(pN, 0.0),
+    pb(pN, 0.0),
+    px(pN, 0.0),
+    pr(pN, 0.0),
+    pz(pN, 0.0),
+    pp(pN, 0.0),
+    pq(pN, 0.0),
+    pb_view(pN, pb.data()),
+    px_view(pN, px.data())
+{
+    const size_t *rowptr = pA.rowptr();
+    const size_t *col = pA.col();
+    for (auto i = 0u; i < pN; ++i) {
+        for (auto k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+            pTransPos[k] = pA.find(col[k], i);
+        }
+        pDiagPos[i] = pA.find(i, i);
+        if (pDiagPos[i] == pA.nnz()) {
+            ArgErrLog("Sparsity pattern is missing a diagonal entry.");
+        }
+    }
+}
+
+void CSRSystem::decompose()
+{
+    const auto nnz = pA.nnz();
+    const size_t *rowptr = pA.rowptr();
+    const size_t *col = pA.col();
+    double *a = pA.values();
+
+    // 1. Symmetrise: drop entries whose transpose is zero.
+    for (auto k = 0u; k < nnz; ++k) {
+        if (pTransPos[k] == nnz || a[pTransPos[k]] == 0.0) {
+            a[k] = 0.0;
+        }
+    }
+
+    for (auto i = 0u; i < pN; ++i) {
+        pInvDiag[i] = 1.0 / a[pDiagPos[i]];
+    }
+
+    // 2. IC(0), row by row: for k < i in the pattern of row i,
+    // L_ik = (A_ik - sum_{j<k} L_ij L_kj) / L_kk, and
+    // L_ii = sqrt(A_ii - sum_{j<i} L_ij^2).
+    pUseIC = true;
+    for (auto i = 0u; i < pN && pUseIC; ++i) {
+        const auto ib = rowptr[i];
+        const auto id = pDiagPos[i];
+        for (auto ik = ib; ik < id; ++ik) {
+            const auto k = col[ik];
+            double s = a[ik];
+            // merge the lower parts of rows i and k
+            auto ij = ib;
+            auto kj = rowptr[k];
+            const auto kd = pDiagPos[k];
+            while (ij < ik && kj < kd) {
+                if (col[ij] < col[kj]) ++ij;
+                else if (col[kj] < col[ij]) ++kj;
+                else s -= pL[ij++] * pL[kj++];
+            }
+            pL[ik] = s / pL[kd];
+        }
+        double d = a[id];
+        for (auto ij = ib; ij < id; ++ij) {
+            d -= pL[ij] * pL[ij];
+        }
+        if (!(d > 0.0)) {
+            pUseIC = false;
+        } else {
+            pL[id] = std::sqrt(d);
+        }
+    }
+}
+
+void CSRSystem::precondition(const double *r, double *z) const
+{
+    if (!pUseIC) {
+        #pragma omp parallel for
+        for (size_t i = 0; i < pN; ++i) {
+            z[i] = r[i] * pInvDiag[i];
+        }
+        return;
+    }
+
+    const size_t *rowptr = pA.rowptr();
+    const size_t *col = pA.col();
+
+    // L y = r
+    for (auto i = 0u; i < pN; ++i) {
+        double s = r[i];
+        for (auto k = rowptr[i]; k < pDiagPos[i]; ++k) {
+            s -= pL[k] * z[col[k]];
+        }
+        z[i] = s / pL[pDiagPos[i]];
+    }
+
+    // L^T z = y
+    for (auto i = pN; i-- > 0;) {
+        z[i] /= pL[pDiagPos[i]];
+        const double zi = z[i];
+        for (auto k = rowptr[i]; k < pDiagPos[i]; ++k) {
+            z[col[k]] -= pL[k] * zi;
+        }
+    }
+}
+
+void CSRSystem::iterate()
+{
+    const size_t *rowptr = pA.rowptr();
+    const size_t *col = pA.col();
+    const double *a = pA.values();
+
+    const double *b = pb.data();
+    double *x = px.data();
+    double *r = pr.data();
+    double *z = pz.data();
+    double *p = pp.data();
+    double *q = pq.data();
+
+    auto spmv = [&](const double *v, double *w) {
+        #pragma omp parallel for
+        for (size_t i = 0; i < pN; ++i) {
+            double s = 0.0;
+            for (auto k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+                s += a[k] * v[col[k]];
+            }
+            w[i] = s;
+        }
+    };
+
+    auto dot = [&](const double *u, const double *v) {
+        double s = 0.0;
+        #pragma omp parallel for reduction(+:s)
+        for (size_t i = 0; i < pN; ++i) {
+            s += u[i] * v[i];
+        }
+        return s;
+    };
+
+    pIterations = 0;
+
+    const double bnorm = std::sqrt(dot(b, b));
+    if (bnorm == 0.0) {
+        std::fill(px.begin(), px.end(), 0.0);
+        return;
+    }
+    const double threshold = pRTol * bnorm;
+
+    // warm start from the previous solution
+    spmv(x, q);
+    #pragma omp parallel for
+    for (size_t i = 0; i < pN; ++i) {
+        r[i] = b[i] - q[i];
+    }
+    if (std::sqrt(dot(r, r)) <= threshold) {
+        return;
+    }
+
+    precondition(r, z);
+    std::copy(z, z + pN, p);
+    double rz = dot(r, z);
+
+    const auto max_iterations = std::max<size_t>(pN, 100);
+    while (pIterations < max_iterations) {
+        ++pIterations;
+
+        spmv(p, q);
+        const double alpha = rz / dot(p, q);
+        #pragma omp parallel for
+        for (size_t i = 0; i < pN; ++i) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+
+        if (std::sqrt(dot(r, r)) <= threshold) {
+            return;
+        }
+
+        precondition(r, z);
+        const double rz_next = dot(r, z);
+        const double beta = rz_next / rz;
+        rz = rz_next;
+        #pragma omp parallel for
+        for (size_t i = 0; i < pN; ++i) {
+            p[i] = z[i] + beta * p[i];
+        }
+    }
+
+    CLOG(WARNING, "general_log") << "E-Field conjugate gradient did not converge in "
+                                 << pIterations << " iterations.";
+}
+
+}  // namespace efield
+}  // namespace solver
+}  // namespace steps
@@ -0,0 +1,158 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_SOLVER_EFIELD_CSRSYSTEM_HPP
+#define STEPS_SOLVER_EFIELD_CSRSYSTEM_HPP 1
+
+#include <cstddef>
+#include <vector>
+
+#include "util/common.h"
+#include "linsystem.hpp"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+/// Square sparse matrix in compressed sparse row format, with a sparsity
+/// pattern fixed at construction.
+
+class CSRMatrix: public AMatrix {
+public:
+    /// \param pattern Column indices of the non-zero entries of each row.
+    explicit CSRMatrix(std::vector<std::vector<size_t>> const & pattern);
+
+    size_t nRow() const override final { return pN; }
+    size_t nCol() const override final { return pN; }
+
+    double get(size_t row,size_t col) const override final;
+
+    /// (row, col) must be in the sparsity pattern.
+    void set(size_t row,size_t col,double value) override final;
+
+    void zero() override final;
+
+    // direct access to compact representation
+
+    inline size_t nnz() const noexcept { return pValues.size(); }
+    inline const size_t *rowptr() const noexcept { return pRowPtr.data(); }
+    inline const size_t *col() const noexcept { return pCol.data(); }
+    inline const double *values() const noexcept { return pValues.data(); }
+    inline double *values() noexcept { return pValues.data(); }
+
+    /// Position of the entry (row, col) in the compact representation, or
+    /// nnz() if it is not in the sparsity pattern.
+    size_t find(size_t row,size_t col) const;
+
+private:
+    size_t pN;
+    std::vector<size_t> pRowPtr;
+    std::vector<size_t> pCol;
+    std::vector<double> pValues;
+};
+
+/// Linear system solved by the preconditioned conjugate gradient method.
+///
+/// The matrix is expected to be symmetric positive definite except for
+/// identity rows, as produced by clamped vertices. Entries (i, j) whose
+/// transpose (j, i) is zero are dropped before solving, which leaves the
+/// solution unchanged as x_j = b_j = 0 for an identity row j with zero right
+/// hand side, and makes the system symmetric.
+///
+/// The preconditioner is the incomplete Cholesky factorisation IC(0), with
+/// Jacobi as fallback if it breaks down. The solution of the previous solve
+/// is used as initial guess.
+
+class CSRSystem
+{
+public:
+    typedef CSRMatrix matrix_type;
+    typedef VVector vector_type;
+
+    /// \param pattern Column indices of the non-zero entries of each row.
+    /// \param rtol Convergence threshold on the residual norm, relative to
+    ///        the norm of b.
+    explicit CSRSystem(std::vector<std::vector<size_t>> const & pattern, double rtol = 1.0e-12);
+
+    const matrix_type &A() const { return pA; }
+    matrix_type &A() { return pA; }
+
+    const vector_type &b() const { return pb_view; }
+    vector_type &b() { return pb_view; }
+
+    const vector_type &x() const { return px_view; }
+
+    void solve() {
+        decompose();
+        iterate();
+    }
+
+    /// Symmetrise A and compute the preconditioner.
+    void decompose(); // destructive: overwrites pA
+
+    /// Solve for the current b with the preconditioner of the last decompose().
+    void iterate();
+
+    /// Number of iterations of the last solve.
+    inline unsigned int iterations() const noexcept { return pIterations; }
+
+    /// True if the preconditioner is IC(0), false if Jacobi.
+    inline bool incompleteCholesky() const noexcept { return pUseIC; }
+
+private:
+    void precondition(const double *r, double *z) const;
+
+    size_t pN;
+    double pRTol;
+
+    CSRMatrix pA;
+    // position of the transposed entry of each entry
+    std::vector<size_t> pTransPos;
+    // position of the diagonal entry of each row
+    std::vector<size_t> pDiagPos;
+
+    // IC(0) factor L, lower triangular part in the pattern of pA
+    std::vector<double> pL;
+    // inverse of the diagonal, for the Jacobi preconditioner
+    std::vector<double> pInvDiag;
+    bool pUseIC{true};
+
+    std::vector<double> pb;
+    std::vector<double> px;
+    // work vectors
+    std::vector<double> pr, pz, pp, pq;
+
+    unsigned int pIterations{0};
+
+    vector_type pb_view;
+    vector_type px_view;
+};
+
+
+}}} // namespace steps::solver::efield
+
+#endif // ndef STEPS_SOLVER_EFIELD_CSRSYSTEM_HPP
@@ -28,6 +28,7 @@
 // STL headers.
 #include <algorithm>
 #include <cmath>
+#include <fstream>
 #include <utility>
 
 // STEPS headers.
@@ -52,10 +53,13 @@ void dVSolverBase::initMesh(TetMesh *mesh) {
 
     pTriCur.assign(pNTris, 0.0);
     pTriCurClamp.assign(pNTris, 0.0);
+
+    pOperatorChanged = true;
 }
 
 void dVSolverBase::setSurfaceConductance(double g_surface, double v_rev) {
     pVExt = v_rev;
+    pOperatorChanged = true;
     if (pMesh == nullptr) { return;
 }
 
@@ -65,6 +69,28 @@ void dVSolverBase::setSurfaceConductance(double g_surface, double v_rev) {
     }
 }
 
+void dVSolverBase::checkpoint(std::fstream & cp_file) {
+    steps::checkpoint(cp_file, pV, false);
+    steps::checkpoint(cp_file, pGExt, false);
+    cp_file.write(reinterpret_cast<char*>(&pVExt), sizeof(double));
+    steps::checkpoint(cp_file, pVertexClamp, false);
+    steps::checkpoint(cp_file, pTriCur, false);
+    steps::checkpoint(cp_file, pTriCurClamp, false);
+    steps::checkpoint(cp_file, pVertCurClamp, false);
+}
+
+void dVSolverBase::restore(std::fstream & cp_file) {
+    steps::restore(cp_file, pNVerts, pV);
+    steps::restore(cp_file, pNVerts, pGExt);
+    cp_file.read(reinterpret_cast<char*>(&pVExt), sizeof(double));
+    steps::restore(cp_file, pNVerts, pVertexClamp);
+    steps::restore(cp_file, pNTris, pTriCur);
+    steps::restore(cp_file, pNTris, pTriCurClamp);
+    steps::restore(cp_file, pNVerts, pVertCurClamp);
+
+    pOperatorChanged = true;
+}
+
 int dVSolverBase::meshHalfBW(TetMesh *mesh) {
     int halfbw = 0;
     auto nVerts = mesh->countVertices();
@@ -36,6 +36,7 @@
 // STEPS headers.
 #include "util/common.h"
 #include "bdsystem.hpp"
+#include "csrsystem.hpp"
 #include "efieldsolver.hpp"
 #include "tetmesh.hpp"
 #include "vertexconnection.hpp"
@@ -70,7 +71,15 @@ public:
     bool getClamped(vertex_id_t i) const noexcept override { return pVertexClamp[i.get()]; }
 
     /** Set voltage clamped status for vertex i */
-    void setClamped(vertex_id_t i, bool clamped) noexcept override { pVertexClamp[i.get()] = clamped; }
+    void setClamped(vertex_id_t i, bool clamped) noexcept override {
+        if (static_cast<bool>(pVertexClamp[i.get()]) != clamped) {
+            pVertexClamp[i.get()] = clamped;
+            pOperatorChanged = true;
+        }
+    }
+
+    /** Vertex capacitances have changed */
+    void capacitanceChanged() noexcept override { pOperatorChanged = true; }
 
     /** Get current through triangle i */
     double getTriI(triangle_id_t i) const noexcept override { return -pTriCur[i.get()]; }
@@ -78,6 +87,14 @@ public:
     /** Set current through triangle i to d (pA) */
     void setTriI(triangle_id_t i, double d) noexcept override { pTriCur[i.get()] = -d; }
 
+    /** Set current through triangles 0..n-1 to cur[i]*scale (pA) */
+    void setTrisI(const double *cur, size_t n, double scale) noexcept override {
+#pragma omp simd
+        for (size_t i = 0; i < n; ++i) {
+            pTriCur[i] = -(cur[i] * scale);
+        }
+    }
+
     /** Set additional current injection for triangle i to c (pA) */
     void setTriIClamp(triangle_id_t i, double c) noexcept override { pTriCurClamp[i.get()] = -c; }
 
@@ -90,10 +107,24 @@ public:
     /** Get additional current injection for area associated with vertex i (pA) */
     double getVertIClamp(vertex_id_t i) const noexcept override { return pVertCurClamp[i.get()]; }
 
+    /** Checkpoint potentials, leak and clamp state */
+    void checkpoint(std::fstream & cp_file) override;
+
+    /** Restore potentials, leak and clamp state */
+    void restore(std::fstream & cp_file) override;
+
 protected:
     /// Generic populate and solve
     template <typename LinSysImpl>
     void _advance(LinSysImpl *L, double dt) {
+        _assemble(L, dt, true);
+        L->solve();
+        _update(L);
+    }
+
+    /// Populate the right hand side, and the matrix if with_matrix is true
+    template <typename LinSysImpl>
+    void _assemble(LinSysImpl *L, double dt, bool with_matrix) {
         // Add up current clamp contributions
         std::copy(pVertCurClamp.begin(), pVertCurClamp.end(), pVertCur.begin());
         for (uint i = 0; i < pNTris; ++i) {
@@ -110,14 +141,14 @@ protected:
 
         double oodt = 1.0/dt;
 
-        A.zero();
+        if (with_matrix) A.zero();
         for (uint i = 0; i < pNVerts; ++i) {
             VertexElement * ve = pMesh->getVertex(i);
             int ind = ve->getIDX();
 
             if (pVertexClamp[ind]) {
                 b.set(ind,0);
-                A.set(ind,ind,1.0);
+                if (with_matrix) A.set(ind,ind,1.0);
             }
             else {
                 double rhs = pVertCur[ind] + pGExt[ind] * (pVExt - pV[ind]);
@@ -129,15 +160,17 @@ protected:
 
                     rhs += cc * (pV[k] - pV[ind]);
                     Aii += cc;
-                    A.set(ind,k,-cc);
+                    if (with_matrix) A.set(ind,k,-cc);
                 }
                 b.set(ind,rhs);
-                A.set(ind,ind,Aii);
+                if (with_matrix) A.set(ind,ind,Aii);
             }
         }
+    }
 
-        L->solve();
-
+    /// Apply the solution of the linear system to the potentials
+    template <typename LinSysImpl>
+    void _update(LinSysImpl *L) {
         const typename LinSysImpl::vector_type DV=L->x();
         for (uint i = 0; i < pNVerts; ++i)
             if (pVertexClamp[i] == false) pV[i] += DV.get(i);
@@ -181,6 +214,10 @@ protected:
 
     /// Current clamp through each vertex (adds to any triangle clamps.)
     std::vector<double>         pVertCurClamp;
+
+    /// Set when clamps, leak conductance or capacitances have changed since
+    /// the matrix was last assembled.
+    bool                        pOperatorChanged{true};
 };
 
 class dVSolverBanded: public dVSolverBase {
@@ -191,11 +228,68 @@ public:
     }
 
     void advance(double dt) override {
-        _advance(pBDSys.get(), dt);
+        // The matrix only depends on dt, clamps, leak conductance and
+        // capacitances: keep its LU factors as long as they don't change.
+        if (pOperatorChanged || dt != pFactorDT) {
+            _assemble(pBDSys.get(), dt, true);
+            pBDSys->solve();
+            pFactorDT = dt;
+            pOperatorChanged = false;
+        }
+        else {
+            _assemble(pBDSys.get(), dt, false);
+            pBDSys->substitute();
+        }
+        _update(pBDSys.get());
     }
 
 private:
     std::unique_ptr<BDSystem>  pBDSys;
+
+    /// dt of the factorised matrix
+    double                     pFactorDT{0.0};
+};
+
+class dVSolverCSR: public dVSolverBase {
+public:
+    void initMesh(TetMesh *mesh) override {
+        dVSolverBase::initMesh(mesh);
+
+        std::vector<std::vector<size_t>> pattern(pNVerts);
+        for (auto i = 0u; i < pNVerts; ++i) {
+            VertexElement *ve = mesh->getVertex(i);
+
+            auto &row = pattern[ve->getIDX()];
+            row.push_back(ve->getIDX());
+            for (auto j = 0u; j < ve->getNCon(); ++j) {
+                row.push_back(ve->nbrIdx(j));
+            }
+        }
+
+        pCSRSys.reset(new CSRSystem(pattern));
+    }
+
+    void advance(double dt) override {
+        // As for dVSolverBanded, keep the preconditioner while the matrix
+        // does not change. The previous solution is the initial guess.
+        if (pOperatorChanged || dt != pFactorDT) {
+            _assemble(pCSRSys.get(), dt, true);
+            pCSRSys->solve();
+            pFactorDT = dt;
+            pOperatorChanged = false;
+        }
+        else {
+            _assemble(pCSRSys.get(), dt, false);
+            pCSRSys->iterate();
+        }
+        _update(pCSRSys.get());
+    }
+
+private:
+    std::unique_ptr<CSRSystem> pCSRSys;
+
+    /// dt of the assembled matrix
+    double                     pFactorDT{0.0};
 };
 
 
@@ -161,6 +161,20 @@ void sefield::EField::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void sefield::EField::checkpointState(std::fstream & cp_file)
+{
+    pVProp->checkpoint(cp_file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void sefield::EField::restoreState(std::fstream & cp_file)
+{
+    pVProp->restore(cp_file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void sefield::EField::setMembCapac(uint midx, double cm)
 {
     // Currently midx should be zero until multiple membranes are supported
@@ -171,6 +185,7 @@ void sefield::EField::setMembCapac(uint midx, double cm)
     // specific capacitance in pF/um2.
     // Argument is in F/m^2: 1 F/m^2 = 1 pF / um^2 so no conversion needed!
     pMesh->applySurfaceCapacitance(cm);
+    pVProp->capacitanceChanged();
 }
 
 void sefield::EField::setTriCapac(triangle_id_t tidx, double cm)
@@ -185,7 +200,7 @@ void sefield::EField::setTriCapac(triangle_id_t tidx, double cm)
     // Argument is in F/m^2: 1 F/m^2 = 1 pF / um^2 so no conversion needed!
 
     pMesh->applyTriCapacitance(tidx, cm);
-
+    pVProp->capacitanceChanged();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -415,16 +430,29 @@ void sefield::EField::setTriIClamp(triangle_id_t tidx, double cur)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/*
-void    sefield::EField::setTriI(double * cur)
+
+void    sefield::EField::setTrisI(const double * cur)
+{
+    // convert to picoamp
+    pVProp->setTrisI(cur, pNTris, 1.0e12);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void    sefield::EField::getTrisV(double * v)
 {
     for (uint i = 0; i < pNTris; ++i)
     {
-        // convert to picoamp
-        pVProp->setTriI(i, cur[i]*1.0e12);
+        double pot = 0.0;
+        pot += pVProp->getV(pTritoVert[i * 3]);
+        pot += pVProp->getV(pTritoVert[(i * 3) + 1]);
+        pot += pVProp->getV(pTritoVert[(i * 3) + 2]);
+
+        // getV returns in milliVolts
+        v[i] = (pot*1.0e-3)/3.0;
     }
 }
-*/
+
 ////////////////////////////////////////////////////////////////////////////////
 
 double    sefield::EField::getTetV(tetrahedron_id_t tidx)
@@ -108,6 +108,14 @@ public:
     /// restore data
     void restore(std::fstream & cp_file);
 
+    /// checkpoint potentials, leak and clamps held by the solver
+    /// implementation, which checkpoint() does not cover
+    void checkpointState(std::fstream & cp_file);
+
+    /// restore potentials, leak and clamps held by the solver
+    /// implementation
+    void restoreState(std::fstream & cp_file);
+
     // Save optimal vertex configuration
     void saveOptimal(std::string const & opt_file_name);
 
@@ -206,8 +214,13 @@ public:
 
     /// Auxiliary function for setting current in all triangles at once.
     /// \param cur A 1D array, size = number of surface triangles,
-    ///     of current across triangles
-    // void    setTriI(double * cur);
+    ///     of current across triangles (amps)
+    void    setTrisI(const double * cur);
+
+    /// Auxiliary function for getting the potential of all triangles at once.
+    /// \param v A 1D array, size = number of surface triangles, filled
+    ///     with the electric potential of the triangles (volts)
+    void    getTrisV(double * v);
 
     /// Set the specific capacitance of a triangle surface element.
     /// \param tidx Index of the triangle surface element
@@ -31,6 +31,8 @@
 /** \file Abstract interface for solver implementations
  * used by EField objects. */
 
+#include <fstream>
+
 #include "tetmesh.hpp"
 
 namespace steps {
@@ -66,6 +68,13 @@ struct EFieldSolver {
     /** Set current through triangle i to d (pA) */
     virtual void setTriI(triangle_id_t i, double d) =0;
 
+    /** Set current through triangles 0..n-1 to cur[i]*scale (pA) */
+    virtual void setTrisI(const double *cur, size_t n, double scale) {
+        for (size_t i = 0; i < n; ++i) {
+            setTriI(triangle_id_t(static_cast<index_t>(i)), cur[i] * scale);
+        }
+    }
+
     /** Set additional current injection for triangle i to c (pA) */
     virtual void setTriIClamp(triangle_id_t i, double c) =0;
 
@@ -78,8 +87,17 @@ struct EFieldSolver {
     /** Get additional current injection for area associated with vertex i (pA) */
     virtual double getVertIClamp(vertex_id_t i) const =0;
 
+    /** Notify the solver that vertex capacitances have changed */
+    virtual void capacitanceChanged() =0;
+
     /** Solve for voltage with given dt */
     virtual void advance(double dt) =0;
+
+    /** Checkpoint potentials, leak and clamp state */
+    virtual void checkpoint(std::fstream & cp_file) =0;
+
+    /** Restore potentials, leak and clamp state */
+    virtual void restore(std::fstream & cp_file) =0;
 };
 
 }}} // namespace steps::efield::solver
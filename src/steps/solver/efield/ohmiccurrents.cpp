@@ -0,0 +1,85 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#include "ohmiccurrents.hpp"
+
+#include <easylogging++.h>
+#include "util/error.hpp"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+void OhmicCurrents::add(index_t slot, index_t vidx, double g, double erev,
+                        const uint *count, double *timeintg, double *time_upd)
+{
+    AssertLog(pSlot.empty() || pSlot.back() <= slot);
+    pSlot.push_back(slot);
+    pVIdx.push_back(vidx);
+    pG.push_back(g);
+    pERev.push_back(erev);
+    pCount.push_back(count);
+    pTimeIntg.push_back(timeintg);
+    pTimeUpd.push_back(time_upd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OhmicCurrents::compute(const double *v, double simtime, double dt, double *cur)
+{
+    const size_t n = size();
+    pN.resize(n);
+    pI.resize(n);
+
+    // Gather the mean number of conducting channels over dt, adding the last
+    // bit of the time integral up to simtime.
+    for (size_t k = 0; k < n; ++k) {
+        double integral = *pCount[k] * (simtime - *pTimeUpd[k]);
+        AssertLog(integral >= 0.0);
+        pN[k] = (*pTimeIntg[k] + integral) / dt;
+        *pTimeIntg[k] = 0.0;
+        *pTimeUpd[k] = simtime;
+    }
+
+    const double *n_open = pN.data();
+    const double *g = pG.data();
+    const double *erev = pERev.data();
+    const index_t *vidx = pVIdx.data();
+    double *i = pI.data();
+    #pragma omp simd
+    for (size_t k = 0; k < n; ++k) {
+        i[k] = (n_open[k] * g[k]) * (v[vidx[k]] - erev[k]);
+    }
+
+    // Entries are sorted by slot, so the currents of a triangle are summed in
+    // the order of their local index.
+    for (size_t k = 0; k < n; ++k) {
+        cur[pSlot[k]] += pI[k];
+    }
+}
+
+}}} // namespace steps::solver::efield
@@ -0,0 +1,92 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_SOLVER_EFIELD_OHMICCURRENTS_HPP
+#define STEPS_SOLVER_EFIELD_OHMICCURRENTS_HPP 1
+
+#include <cstddef>
+#include <vector>
+
+#include "util/common.h"
+#include "util/vocabulary.hpp"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+/// Ohmic currents of all the membrane triangles of a solver, stored as a
+/// structure of arrays so that the currents of all triangles are computed in
+/// one pass rather than triangle by triangle through their patch definitions.
+///
+/// The count of conducting channels and its time integral stay in the
+/// triangles, which update them when the channel state changes; only
+/// pointers to them are stored here.
+
+class OhmicCurrents {
+public:
+    /// Add an ohmic current of a triangle. The currents of a triangle must be
+    /// added in a row, in the order of their local index.
+    ///
+    /// \param slot Index of the triangle in the current array.
+    /// \param vidx Index of the triangle in the potential array.
+    /// \param g Conductance of a single channel.
+    /// \param erev Reversal potential.
+    /// \param count Number of channels in the conducting state.
+    /// \param timeintg Time integral of \a count since the last computation.
+    /// \param time_upd Time at which \a timeintg was last updated.
+    void add(index_t slot, index_t vidx, double g, double erev,
+             const uint *count, double *timeintg, double *time_upd);
+
+    inline size_t size() const noexcept { return pG.size(); }
+
+    /// Add the mean ohmic current of each triangle over the last dt to
+    /// cur[slot], and reset the time integrals of the channel counts.
+    ///
+    /// \param v Potential of the triangles, by vidx.
+    /// \param simtime Current time.
+    /// \param dt Time since the last computation.
+    /// \param cur Currents of the triangles, by slot.
+    void compute(const double *v, double simtime, double dt, double *cur);
+
+private:
+    std::vector<index_t> pSlot;
+    std::vector<index_t> pVIdx;
+    std::vector<double> pG;
+    std::vector<double> pERev;
+
+    std::vector<const uint *> pCount;
+    std::vector<double *> pTimeIntg;
+    std::vector<double *> pTimeUpd;
+
+    // mean number of conducting channels, then current of each entry
+    std::vector<double> pN;
+    std::vector<double> pI;
+};
+
+}}} // namespace steps::solver::efield
+
+#endif // ndef STEPS_SOLVER_EFIELD_OHMICCURRENTS_HPP
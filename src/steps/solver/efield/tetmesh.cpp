@@ -29,6 +29,7 @@
 // STL headers.
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <climits>
 #include <cmath>
 #include <cstring>
@@ -489,7 +490,13 @@ void sefield::TetMesh::axisOrderElements(uint opt_method, std::string const & op
     }
 
 
-    if (opt_method == 2)
+    const auto start_time = std::chrono::steady_clock::now();
+
+    if (opt_method == 3)
+    {
+        rcmOrderElements();
+    }
+    else if (opt_method == 2)
     {
         // The breadth first search with Cuthill-McKee improvement
 
@@ -690,6 +697,214 @@ void sefield::TetMesh::axisOrderElements(uint opt_method, std::string const & op
     reindexElements();
     reordered();
 
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    CLOG(INFO, "general_log") << "Vertex ordering method " << opt_method << ": bandwidth "
+                              << bandwidth() << " in " << elapsed.count() << "s" << endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void sefield::TetMesh::rcmOrderElements()
+{
+    const auto nverts = static_cast<uint>(pElements.size());
+
+    // adjacency by original index
+    std::vector<uint> adj_start(nverts + 1, 0);
+    std::vector<uint> adj;
+    for (uint v = 0; v < nverts; ++v)
+    {
+        VertexElement * ve = pElements[v];
+        AssertLog(ve->getIDX() == v);
+        for (uint i = 0; i < ve->getNCon(); ++i) {
+            adj.push_back(ve->nbrIdx(i));
+        }
+        adj_start[v + 1] = static_cast<uint>(adj.size());
+    }
+    auto degree = [&](uint v) { return adj_start[v + 1] - adj_start[v]; };
+
+    // Breadth first search from start, visiting the neighbours of each vertex
+    // by increasing degree (Cuthill-McKee). Ties are broken by increasing or
+    // decreasing index: the order of the connections depends on the vertex
+    // addresses, so it can't be relied upon, and which of both directions
+    // gives the narrowest ordering depends on the mesh.
+    // Appends to order the vertices of the component of start; visited must
+    // be false for all of them. Returns the depth of the search, and the
+    // index in order where the last level starts.
+    std::vector<uint> nbrs;
+    auto cuthill_mckee = [&](uint start, bool descending, std::vector<char> & visited,
+                             std::vector<uint> & order, std::vector<uint> & nbrs_buf) {
+        auto by_degree = [&](uint a, uint b) {
+            if (degree(a) != degree(b)) return degree(a) < degree(b);
+            return descending ? a > b : a < b;
+        };
+        auto level_begin = order.size();
+        auto level_end = level_begin + 1;
+        auto last_level = level_begin;
+        uint depth = 0;
+        order.push_back(start);
+        visited[start] = true;
+        for (auto k = level_begin; k < order.size(); ++k)
+        {
+            if (k == level_end) {
+                last_level = k;
+                level_end = order.size();
+                ++depth;
+            }
+            const uint v = order[k];
+            nbrs_buf.clear();
+            for (uint i = adj_start[v]; i < adj_start[v + 1]; ++i) {
+                if (!visited[adj[i]]) {
+                    visited[adj[i]] = true;
+                    nbrs_buf.push_back(adj[i]);
+                }
+            }
+            std::sort(nbrs_buf.begin(), nbrs_buf.end(), by_degree);
+            order.insert(order.end(), nbrs_buf.begin(), nbrs_buf.end());
+        }
+        return std::make_pair(depth, last_level);
+    };
+    auto by_degree = [&](uint a, uint b) {
+        return degree(a) < degree(b) || (degree(a) == degree(b) && a < b);
+    };
+
+    auto component_bandwidth = [&](std::vector<uint> const & order, std::vector<uint> & pos) {
+        for (uint k = 0; k < order.size(); ++k) pos[order[k]] = k;
+        uint bw = 0;
+        for (auto v: order) {
+            for (uint i = adj_start[v]; i < adj_start[v + 1]; ++i) {
+                const auto p = pos[v], q = pos[adj[i]];
+                bw = std::max(bw, p > q ? p - q : q - p);
+            }
+        }
+        return bw;
+    };
+
+    // Bounds on the number of candidate start vertices per component, which
+    // keeps the cost to O(N log N) per candidate:
+    // - vertices of lowest degree in the last level of the pseudo-peripheral
+    //   vertex search,
+    // - the same from the searches of the first few of those,
+    // - vertices of lowest degree in the whole component.
+    constexpr uint max_peripheral_candidates = 16;
+    constexpr uint n_peripheral_searches = 4;
+    constexpr uint max_low_degree_candidates = 128;
+
+    std::vector<char> done(nverts, false);
+    std::vector<char> visited(nverts);
+    std::vector<uint> order;
+    std::vector<uint> result;
+    result.reserve(nverts);
+
+    for (uint seed = 0; seed < nverts; ++seed)
+    {
+        if (done[seed]) continue;
+
+        // Pseudo-peripheral vertex (George and Liu): restart from a vertex of
+        // lowest degree in the last level as long as the depth increases.
+        uint start = seed;
+        std::vector<uint> last_level;
+        uint depth = 0;
+        while (true)
+        {
+            order.clear();
+            std::copy(done.begin(), done.end(), visited.begin());
+            const auto search = cuthill_mckee(start, false, visited, order, nbrs);
+
+            if (start != seed && search.first <= depth) break;
+            depth = search.first;
+            last_level.assign(order.begin() + search.second, order.end());
+            std::sort(last_level.begin(), last_level.end(), by_degree);
+            if (last_level.front() == start) break;
+            start = last_level.front();
+        }
+
+        // Candidate start vertices: the pseudo-peripheral vertex, some of its
+        // farthest vertices and theirs, and the vertices of lowest degree.
+        std::vector<uint> candidates{start};
+        auto add_peripheral = [&](std::vector<uint> const & level) {
+            uint n = 0;
+            for (auto v: level) {
+                if (n == max_peripheral_candidates) break;
+                if (v != start) {
+                    candidates.push_back(v);
+                    ++n;
+                }
+            }
+        };
+        add_peripheral(last_level);
+        const auto nsearches = std::min<size_t>(n_peripheral_searches, candidates.size());
+        std::vector<uint> level_order;
+        for (size_t c = 1; c < nsearches; ++c)
+        {
+            level_order.clear();
+            std::copy(done.begin(), done.end(), visited.begin());
+            const auto search = cuthill_mckee(candidates[c], false, visited, level_order, nbrs);
+            std::vector<uint> level(level_order.begin() + search.second, level_order.end());
+            std::sort(level.begin(), level.end(), by_degree);
+            add_peripheral(level);
+        }
+        const auto nlow = std::min<size_t>(max_low_degree_candidates, order.size());
+        std::partial_sort(order.begin(), order.begin() + nlow, order.end(), by_degree);
+        candidates.insert(candidates.end(), order.begin(), order.begin() + nlow);
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        // Evaluate every candidate with both tie breaking directions, keep the
+        // narrowest ordering (first one on equal bandwidth, for
+        // reproducibility).
+        const auto ntrials = static_cast<int>(2 * candidates.size());
+        std::vector<uint> widths(ntrials);
+        #pragma omp parallel
+        {
+            std::vector<char> visited_c(nverts);
+            std::vector<uint> order_c, nbrs_c, pos_c(nverts);
+            #pragma omp for schedule(dynamic)
+            for (int t = 0; t < ntrials; ++t)
+            {
+                order_c.clear();
+                std::copy(done.begin(), done.end(), visited_c.begin());
+                cuthill_mckee(candidates[t / 2], t % 2 == 1, visited_c, order_c, nbrs_c);
+                widths[t] = component_bandwidth(order_c, pos_c);
+            }
+        }
+        const auto best = std::min_element(widths.begin(), widths.end()) - widths.begin();
+
+        order.clear();
+        std::copy(done.begin(), done.end(), visited.begin());
+        cuthill_mckee(candidates[best / 2], best % 2 == 1, visited, order, nbrs);
+        for (auto v: order) done[v] = true;
+        result.insert(result.end(), order.begin(), order.end());
+    }
+    AssertLog(result.size() == nverts);
+
+    // reversed Cuthill-McKee
+    std::reverse(result.begin(), result.end());
+
+    std::vector<VertexElement*> orig_indices = pElements;
+    pElements.clear();
+    uint ielt = 0;
+    for (auto v: result) {
+        pElements.push_back(orig_indices[v]);
+        pVertexPerm[v] = ielt;
+        ielt++;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint sefield::TetMesh::bandwidth() const
+{
+    uint bw = 0;
+    for (auto const& ve: pElements)
+    {
+        const uint ind = ve->getIDX();
+        for (uint i = 0; i < ve->getNCon(); ++i)
+        {
+            const uint inbr = ve->nbrIdx(i);
+            bw = std::max(bw, ind > inbr ? ind - inbr : inbr - ind);
+        }
+    }
+    return bw;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
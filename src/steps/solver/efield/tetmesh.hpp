@@ -309,6 +309,15 @@ public:
 
     void saveOptimal(std::string const & opt_file_name);
 
+    /// Reverse Cuthill-McKee ordering (opt_method 3). For each connected
+    /// component, a bounded set of start vertices around a pseudo-peripheral
+    /// vertex is tried (in parallel) and the narrowest ordering is kept.
+    /// Sets pElements and pVertexPerm.
+    void rcmOrderElements();
+
+    /// Maximal index difference between connected vertices.
+    uint bandwidth() const;
+
     void fill_ve_vec(set<VertexElement*> & veset, vector<VertexElement*> & vevec, queue<VertexElement*> & vequeue, uint ncons, VertexElement ** nbrs);
 
     /// Originally from Mesh.
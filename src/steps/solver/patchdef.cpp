@@ -702,6 +702,12 @@ void ssolver::Patchdef::setup_indices() {
         }
       }
     }
+
+    pSReac_Reactants_S.assign(pSReac_LHS_S_Spec, pSReacsN, pSpecsN_S);
+    pSReac_Reactants_I.assign(pSReac_LHS_I_Spec, pSReacsN, pSpecsN_I);
+    if (pOuter != nullptr) {
+      pSReac_Reactants_O.assign(pSReac_LHS_O_Spec, pSReacsN, pSpecsN_O);
+    }
   }
 
   // 3.5 -- DEAL WITH PATCH SURFACE-DIFFUSION
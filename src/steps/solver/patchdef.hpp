@@ -43,6 +43,7 @@
 #include "util/common.h"
 #include "statedef.hpp"
 #include "api.hpp"
+#include "reactants.hpp"
 #include "geom/patch.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -265,6 +266,23 @@ public:
     uint * sreac_lhs_O_bgn(uint lidx) const;
     uint * sreac_lhs_O_end(uint lidx) const;
 
+    /// Warning: these methods perform no error checking!
+    ///
+    // Return the beginning and end of the compact reactant lists of surface
+    // reaction specified by local index argument.
+    inline const Reactant * sreac_reactants_I_bgn(uint lidx) const noexcept
+    { return pSReac_Reactants_I.bgn(lidx); }
+    inline const Reactant * sreac_reactants_I_end(uint lidx) const noexcept
+    { return pSReac_Reactants_I.end(lidx); }
+    inline const Reactant * sreac_reactants_S_bgn(uint lidx) const noexcept
+    { return pSReac_Reactants_S.bgn(lidx); }
+    inline const Reactant * sreac_reactants_S_end(uint lidx) const noexcept
+    { return pSReac_Reactants_S.end(lidx); }
+    inline const Reactant * sreac_reactants_O_bgn(uint lidx) const noexcept
+    { return pSReac_Reactants_O.bgn(lidx); }
+    inline const Reactant * sreac_reactants_O_end(uint lidx) const noexcept
+    { return pSReac_Reactants_O.end(lidx); }
+
     /// Warning: these methods perform no error checking!
     ///
     // Return the beginning and end of the update arrays of surface reaction
@@ -589,6 +607,11 @@ private:
     int                               * pSReac_UPD_S_Spec;
     int                               * pSReac_UPD_O_Spec;
 
+    // Non-zero entries of the pSReac_LHS tables, per surface reaction.
+    ReactantLists                       pSReac_Reactants_I;
+    ReactantLists                       pSReac_Reactants_S;
+    ReactantLists                       pSReac_Reactants_O;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA: SURFACE DIFFUSION RULES
     ////////////////////////////////////////////////////////////////////////
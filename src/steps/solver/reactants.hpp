@@ -0,0 +1,190 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_SOLVER_REACTANTS_HPP
+#define STEPS_SOLVER_REACTANTS_HPP 1
+
+// STL headers.
+#include <vector>
+
+// STEPS headers.
+#include "util/common.h"
+#include "util/error.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace solver {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// A species on the left hand side of a reaction rule, given by its local
+/// pool index and its stoichiometric order.
+struct Reactant
+{
+    uint                                pool;
+    uint                                order;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Compact reactant lists of a set of reaction rules.
+///
+/// Built from a dense (rules x species) lhs table such as the ones kept by
+/// Compdef and Patchdef, keeping only the species with a non-zero order.
+/// Reactants of a rule are sorted by increasing pool index.
+///
+class ReactantLists
+{
+public:
+
+    /// Fill the lists from a dense lhs table of nrules * nspecs entries.
+    void assign(const uint * lhs, uint nrules, uint nspecs)
+    {
+        pReactants.clear();
+        pOffsets.assign(1, 0);
+        pOffsets.reserve(nrules + 1);
+        for (uint r = 0; r < nrules; ++r)
+        {
+            const uint * lhs_vec = lhs + (r * nspecs);
+            for (uint s = 0; s < nspecs; ++s)
+            {
+                if (lhs_vec[s] == 0) continue;
+                pReactants.push_back({s, lhs_vec[s]});
+            }
+            pOffsets.push_back(pReactants.size());
+        }
+    }
+
+    inline const Reactant * bgn(uint ridx) const noexcept
+    { return pReactants.data() + pOffsets[ridx]; }
+
+    inline const Reactant * end(uint ridx) const noexcept
+    { return pReactants.data() + pOffsets[ridx + 1]; }
+
+    inline uint size(uint ridx) const noexcept
+    { return pOffsets[ridx + 1] - pOffsets[ridx]; }
+
+private:
+
+    std::vector<Reactant>               pReactants;
+    std::vector<uint>                   pOffsets;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Multiply h_mu with the number of distinct combinations of order molecules
+/// out of cnt, i.e. the falling factorial cnt * (cnt-1) * ... The factors
+/// are applied in the same sequence as the dense loops used to, so results
+/// are unchanged.
+inline void reac_comb_mult(double & h_mu, uint cnt, uint order)
+{
+    switch (order)
+    {
+        case 4:
+        {
+            h_mu *= static_cast<double>(cnt - 3);
+        }
+        STEPS_FALLTHROUGH;
+        case 3:
+        {
+            h_mu *= static_cast<double>(cnt - 2);
+        }
+        STEPS_FALLTHROUGH;
+        case 2:
+        {
+            h_mu *= static_cast<double>(cnt - 1);
+        }
+        STEPS_FALLTHROUGH;
+        case 1:
+        {
+            h_mu *= static_cast<double>(cnt);
+            break;
+        }
+        default:
+        {
+            AssertLog(false);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Combinatorial part of the propensity for a fixed number N of reactants,
+/// multiplied into h_mu. Pools can be any indexable container of molecule
+/// counts; real valued counts (as in the well-mixed solvers) are truncated.
+template <uint N, typename Pools>
+inline double reac_comb(const Reactant * reac, const Pools & pools, double h_mu)
+{
+    for (uint i = 0; i < N; ++i)
+    {
+        auto cnt = static_cast<uint>(pools[reac[i].pool]);
+        if (reac[i].order > cnt) return 0.0;
+        reac_comb_mult(h_mu, cnt, reac[i].order);
+    }
+    return h_mu;
+}
+
+/// Combinatorial part of the propensity of the reactants in [bgn, end),
+/// multiplied into h_mu. Returns 0.0 if any pool holds fewer molecules than
+/// its order.
+///
+/// Dispatches to a kernel specialized on the number of reactants, which
+/// covers reactions of order 0 to 4.
+template <typename Pools>
+inline double reac_comb(const Reactant * bgn, const Reactant * end, const Pools & pools,
+                        double h_mu = 1.0)
+{
+    switch (end - bgn)
+    {
+        case 0: return h_mu;
+        case 1: return reac_comb<1>(bgn, pools, h_mu);
+        case 2: return reac_comb<2>(bgn, pools, h_mu);
+        case 3: return reac_comb<3>(bgn, pools, h_mu);
+        case 4: return reac_comb<4>(bgn, pools, h_mu);
+        default:
+        {
+            for (const Reactant * r = bgn; r != end; ++r)
+            {
+                auto cnt = static_cast<uint>(pools[r->pool]);
+                if (r->order > cnt) return 0.0;
+                reac_comb_mult(h_mu, cnt, r->order);
+            }
+            return h_mu;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif
+
+// STEPS_SOLVER_REACTANTS_HPP
+
+// END
@@ -0,0 +1,309 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+// Standard library & STL headers.
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+// STEPS headers.
+#include "crflat.hpp"
+
+#include <easylogging++.h>
+#include "util/error.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stex = steps::tetexact;
+
+////////////////////////////////////////////////////////////////////////////////
+
+stex::CRFlatSchedule::Group::Group(int power)
+: max(std::pow(2, power))
+{}
+
+////////////////////////////////////////////////////////////////////////////////
+
+stex::CRFlatSchedule::CRFlatSchedule(std::vector<KProc*> const & kprocs)
+: pKProcs(kprocs)
+{}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::CRFlatSchedule::clear()
+{
+    nGroups.clear();
+    pGroups.clear();
+    nSums.clear();
+    pSums.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::CRFlatSchedule::update(KProc * kp, double new_rate)
+{
+    CRKProcData & data = kp->crData;
+    double old_rate = data.rate;
+
+    data.rate = new_rate;
+
+    if (old_rate == new_rate) return;
+
+    // new rate in either a positive or a negative group
+    if (new_rate > 1e-20) {
+        int new_pow;
+        std::frexp(new_rate, &new_pow);
+
+        if (data.pow == new_pow && data.recorded) {
+            _getSum(new_pow) += (new_rate - old_rate);
+            _getGroup(new_pow).rates[data.pos] = new_rate;
+        }
+        // pow is not the same
+        else {
+            if (data.recorded) _remove(data.pow, data.pos, old_rate);
+            data.pow = new_pow;
+            _insert(kp, new_pow, new_rate);
+        }
+        data.recorded = true;
+    }
+    else {
+        if (data.recorded) _remove(data.pow, data.pos, old_rate);
+        data.recorded = false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::CRFlatSchedule::_remove(int pow, unsigned pos, double old_rate)
+{
+    Group & group = _getGroup(pow);
+    double & sum = _getSum(pow);
+
+    uint last = group.kprocs.back();
+    double last_rate = group.rates.back();
+    group.kprocs.pop_back();
+    group.rates.pop_back();
+
+    if (group.kprocs.empty()) sum = 0.0;
+    else {
+        sum -= old_rate;
+
+        if (pos != group.kprocs.size()) {
+            group.kprocs[pos] = last;
+            group.rates[pos] = last_rate;
+            pKProcs[last]->crData.pos = pos;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::CRFlatSchedule::_insert(KProc * kp, int pow, double new_rate)
+{
+    if (pow >= 0) {
+        while (static_cast<int>(pGroups.size()) <= pow) {
+            pGroups.emplace_back(static_cast<int>(pGroups.size()));
+            pSums.push_back(0.0);
+        }
+    }
+    else {
+        while (static_cast<int>(nGroups.size()) <= -pow) {
+            nGroups.emplace_back(-static_cast<int>(nGroups.size()));
+            nSums.push_back(0.0);
+        }
+    }
+
+    Group & group = _getGroup(pow);
+    kp->crData.pos = group.kprocs.size();
+    group.kprocs.push_back(kp->schedIDX());
+    group.rates.push_back(new_rate);
+    _getSum(pow) += new_rate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double stex::CRFlatSchedule::computeA0() const
+{
+    double a0 = 0.0;
+    for (double s: nSums) a0 += s;
+    for (double s: pSums) a0 += s;
+    return a0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+stex::KProc * stex::CRFlatSchedule::_select(Group const & group, const rng::RNGptr & rng) const
+{
+    const double * rates = group.rates.data();
+    double g_max = group.max;
+    double random_rate = g_max * rng->getUnfII();
+    uint group_size = group.rates.size();
+    uint random_pos = rng->get() % group_size;
+
+    while (rates[random_pos] <= random_rate) {
+        random_rate = g_max * rng->getUnfII();
+        random_pos = rng->get() % group_size;
+    }
+
+    return pKProcs[group.kprocs[random_pos]];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+stex::KProc * stex::CRFlatSchedule::getNext(double a0, const rng::RNGptr & rng) const
+{
+    double selector = a0 * rng->getUnfII();
+
+    double partial_sum = 0.0;
+
+    const auto n_neg_groups = nGroups.size();
+    const auto n_pos_groups = pGroups.size();
+
+    for (uint i = 0; i < n_neg_groups; i++) {
+        if (nGroups[i].rates.empty()) continue;
+
+        if (selector > partial_sum + nSums[i]) {
+            partial_sum += nSums[i];
+            continue;
+        }
+        return _select(nGroups[i], rng);
+    }
+
+    for (uint i = 0; i < n_pos_groups; i++) {
+        if (pGroups[i].rates.empty()) continue;
+
+        if (selector > partial_sum + pSums[i]) {
+            partial_sum += pSums[i];
+            continue;
+        }
+        return _select(pGroups[i], rng);
+    }
+
+    // Precision rounding error force clean up
+    // Force the search in the last non-empty group
+    for (int i = n_pos_groups - 1; i >= 0; i--) {
+        if (pGroups[i].rates.empty()) continue;
+        return _select(pGroups[i], rng);
+    }
+
+    for (int i = n_neg_groups - 1; i >= 0; i--) {
+        if (nGroups[i].rates.empty()) continue;
+        return _select(nGroups[i], rng);
+    }
+
+    std::ostringstream os;
+    os << "Cannot find any suitable entry.\n";
+    os << "A0: " << std::setprecision (15) << a0 << "\n";
+    os << "Selector: " << std::setprecision (15) << selector << "\n";
+    os << "Current Partial Sum: " << std::setprecision (15) << partial_sum << "\n";
+
+    os << "Distribution of group sums\n";
+    os << "Negative groups\n";
+    for (uint i = 0; i < n_neg_groups; i++) {
+        os << i << ": " << std::setprecision (15) << nSums[i] << "\n";
+    }
+    os << "Positive groups\n";
+    for (uint i = 0; i < n_pos_groups; i++) {
+        os << i << ": " << std::setprecision (15) << pSums[i] << "\n";
+    }
+
+    ProgErrLog(os.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::CRFlatSchedule::checkpoint(std::fstream & cp_file) const
+{
+    // Same layout as the CRGroup schedule in Tetexact::checkpoint
+    auto n_ngroups = nGroups.size();
+    auto n_pgroups = pGroups.size();
+
+    cp_file.write(reinterpret_cast<char*>(&n_ngroups), sizeof(std::size_t));
+    cp_file.write(reinterpret_cast<char*>(&n_pgroups), sizeof(std::size_t));
+
+    auto write_group = [&cp_file](Group const & group, double sum) {
+        unsigned capacity = group.kprocs.capacity();
+        unsigned size = group.kprocs.size();
+        double max = group.max;
+        cp_file.write(reinterpret_cast<char*>(&capacity), sizeof(unsigned));
+        cp_file.write(reinterpret_cast<char*>(&size), sizeof(unsigned));
+        cp_file.write(reinterpret_cast<char*>(&max), sizeof(double));
+        cp_file.write(reinterpret_cast<char*>(&sum), sizeof(double));
+        cp_file.write(reinterpret_cast<const char*>(group.kprocs.data()), sizeof(uint) * size);
+    };
+
+    for (uint i = 0; i < n_ngroups; i++) write_group(nGroups[i], nSums[i]);
+    for (uint i = 0; i < n_pgroups; i++) write_group(pGroups[i], pSums[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::CRFlatSchedule::restore(std::fstream & cp_file)
+{
+    clear();
+
+    std::size_t n_ngroups;
+    std::size_t n_pgroups;
+
+    cp_file.read(reinterpret_cast<char*>(&n_ngroups), sizeof(std::size_t));
+    cp_file.read(reinterpret_cast<char*>(&n_pgroups), sizeof(std::size_t));
+
+    // Rates are taken from the kprocs, which are restored beforehand
+    auto read_group = [this, &cp_file](Group & group, double & sum) {
+        unsigned capacity;
+        unsigned size;
+
+        cp_file.read(reinterpret_cast<char*>(&capacity), sizeof(unsigned));
+        cp_file.read(reinterpret_cast<char*>(&size), sizeof(unsigned));
+        cp_file.read(reinterpret_cast<char*>(&group.max), sizeof(double));
+        cp_file.read(reinterpret_cast<char*>(&sum), sizeof(double));
+
+        group.kprocs.resize(size);
+        cp_file.read(reinterpret_cast<char*>(group.kprocs.data()), sizeof(uint) * size);
+        group.rates.resize(size);
+        for (uint j = 0; j < size; j++) {
+            group.rates[j] = pKProcs[group.kprocs[j]]->crData.rate;
+        }
+    };
+
+    nGroups.reserve(n_ngroups);
+    nSums.resize(n_ngroups);
+    for (uint i = 0; i < n_ngroups; i++) {
+        nGroups.emplace_back(0);
+        read_group(nGroups[i], nSums[i]);
+    }
+
+    pGroups.reserve(n_pgroups);
+    pSums.resize(n_pgroups);
+    for (uint i = 0; i < n_pgroups; i++) {
+        pGroups.emplace_back(0);
+        read_group(pGroups[i], pSums[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// END
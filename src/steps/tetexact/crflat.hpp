@@ -0,0 +1,127 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_TETEXACT_CRFLAT_HPP
+#define STEPS_TETEXACT_CRFLAT_HPP 1
+
+// STL headers.
+#include <fstream>
+#include <vector>
+
+// STEPS headers.
+#include "kproc.hpp"
+#include "util/common.h"
+#include "rng/rng.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace tetexact {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Composition-rejection schedule with flat, struct-of-arrays groups.
+///
+/// Each group stores the rates and schedule indices of its members in two
+/// contiguous arrays, so a rejection trial reads a single double from the
+/// group instead of dereferencing a KProc. Group sums of each sign are
+/// stored contiguously as well, which makes the A0 update a single pass over
+/// two small arrays.
+///
+/// Group membership, the swap-with-last removal, the bookkeeping of group
+/// sums and the sequence of random numbers drawn in getNext() are identical
+/// to the CRGroup based schedule in Tetexact, so both schedules produce
+/// bit-for-bit identical trajectories from the same RNG stream. The per-kproc
+/// CRKProcData is kept up to date as well, so checkpoint files can be
+/// exchanged between both schedules.
+///
+class CRFlatSchedule
+{
+public:
+
+    /// \param kprocs Table of all kinetic processes, indexed by schedule index.
+    explicit CRFlatSchedule(std::vector<KProc*> const & kprocs);
+
+    /// Remove all kinetic processes from the schedule.
+    void clear();
+
+    /// Move kp to the group matching its new rate.
+    void update(KProc * kp, double new_rate);
+
+    /// Return the sum of all group sums, negative groups first.
+    double computeA0() const;
+
+    /// Select the next kinetic process to fire.
+    ///
+    /// \param a0 Current total propensity, must be strictly positive.
+    KProc * getNext(double a0, const rng::RNGptr & rng) const;
+
+    void checkpoint(std::fstream & cp_file) const;
+    void restore(std::fstream & cp_file);
+
+private:
+
+    struct Group
+    {
+        explicit Group(int power);
+
+        double                      max;
+        std::vector<double>         rates;
+        std::vector<uint>           kprocs;
+    };
+
+    inline Group & _getGroup(int pow) {
+        return pow >= 0 ? pGroups[pow] : nGroups[-pow];
+    }
+
+    inline double & _getSum(int pow) {
+        return pow >= 0 ? pSums[pow] : nSums[-pow];
+    }
+
+    void _remove(int pow, unsigned pos, double old_rate);
+    void _insert(KProc * kp, int pow, double new_rate);
+
+    KProc * _select(Group const & group, const rng::RNGptr & rng) const;
+
+    std::vector<KProc*> const &                 pKProcs;
+
+    std::vector<Group>                          nGroups;
+    std::vector<Group>                          pGroups;
+
+    std::vector<double>                         nSums;
+    std::vector<double>                         pSums;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif
+
+// STEPS_TETEXACT_CRFLAT_HPP
+
+// END
@@ -26,6 +26,7 @@
 
 
 // Standard library & STL headers.
+#include <algorithm>
 #include <iostream>
 #include <vector>
 // STEPS headers.
@@ -47,7 +48,8 @@ namespace smath = steps::math;
 
 stex::Diff::Diff(ssolver::Diffdef * ddef, stex::Tet * tet)
 :
-pDiffdef(ddef)
+ KProc(KProcType::Diff)
+, pDiffdef(ddef)
 , pTet(tet)
 {
     AssertLog(pDiffdef != nullptr);
@@ -162,11 +164,12 @@ void stex::Diff::restore(std::fstream & cp_file)
     cp_file.read(reinterpret_cast<char*>(&crData.pow), sizeof(int));
     cp_file.read(reinterpret_cast<char*>(&crData.pos), sizeof(unsigned));
     cp_file.read(reinterpret_cast<char*>(&crData.rate), sizeof(double));
+    _updateTableRow();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Diff::setupDeps()
+void stex::Diff::setupDeps(UpdTemplatePool & pool)
 {
     // We will check all KProcs of the following simulation elements:
     //   * the 'source' tetrahedron
@@ -210,10 +213,9 @@ void stex::Diff::setupDeps()
     {
         // Fetch next tetrahedron, if it exists.
         stex::Tet * next = pTet->nextTet(i);
-        if (next == nullptr) {
-            continue;
-        }
-        if (pTet->nextTri(i) != nullptr) {
+        if (next == nullptr || pTet->nextTri(i) != nullptr) {
+            // never selected
+            pUpdTemplate[i] = pool.get(pTet, {});
             continue;
         }
 
@@ -245,8 +247,7 @@ void stex::Diff::setupDeps()
             }
         }
 
-        // Copy the set to the update vector.
-        pUpdVec[i].assign(local2.begin(), local2.end());
+        pUpdTemplate[i] = pool.get(pTet, local2);
     }
 }
 
@@ -376,6 +377,8 @@ void stex::Diff::setDcst(double dcst)
         pCDFSelector[1] = pCDFSelector[0] + d[1] / pScaledDcst;
         pCDFSelector[2] = pCDFSelector[1] + d[2] / pScaledDcst;
     }
+
+    _updateTableRow();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -434,6 +437,33 @@ void stex::Diff::setDirectionDcst(int direction, double dcst)
         pCDFSelector[1] = pCDFSelector[0] + d[1] / pScaledDcst;
         pCDFSelector[2] = pCDFSelector[1] + d[2] / pScaledDcst;
     }
+
+    _updateTableRow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::Diff::setupTable(stex::DiffTable & table)
+{
+    pTable = &table;
+    pTableRow = table.add(schedIDX(), pTet->pools().data() + lidxTet);
+    _updateTableRow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::Diff::_updateTableRow()
+{
+    if (pTable == nullptr) return;
+    pTable->setDcst(pTableRow, inactive() ? 0.0 : pScaledDcst);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::Diff::setActive(bool active)
+{
+    KProc::setActive(active);
+    _updateTableRow();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -452,7 +482,7 @@ double stex::Diff::rate(steps::tetexact::Tetexact * /*solver*/)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::Diff::apply(const rng::RNGptr &rng, double /*dt*/, double /*simtime*/)
+stex::UpdList stex::Diff::apply(const rng::RNGptr &rng, double /*dt*/, double /*simtime*/)
 {
     //uint lidxTet = this->lidxTet;
     // Pre-fetch some general info.
@@ -490,18 +520,16 @@ std::vector<stex::KProc*> const & stex::Diff::apply(const rng::RNGptr &rng, doub
 
     rExtent++;
 
-    return pUpdVec[iSel];
+    return UpdList{pUpdTemplate[iSel], pTet};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 uint stex::Diff::updVecSize() const
 {
-    auto maxsize = pUpdVec[0].size();
-    for (uint i=1; i <= 3; ++i)
-    {
-        if (pUpdVec[i].size() > maxsize)
-            maxsize = pUpdVec[i].size();
+    uint maxsize = 0;
+    for (auto const& t: pUpdTemplate) {
+        maxsize = std::max(maxsize, t->size());
     }
     return maxsize;
 }
@@ -39,6 +39,7 @@
 // STEPS headers.
 #include "util/common.h"
 #include "kproc.hpp"
+#include "kproctables.hpp"
 // #include "tetexact.hpp"
 #include "math/constants.hpp"
 #include "solver/diffdef.hpp"
@@ -58,7 +59,7 @@ class WmVol;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class Diff
+class Diff final
 : public steps::tetexact::KProc
 {
 
@@ -91,17 +92,24 @@ public:
     void setDcst(double d);
     void setDirectionDcst(int direction, double dcst);
 
-    void setupDeps() override;
+    void setupDeps(UpdTemplatePool & pool) override;
     bool depSpecTet(uint gidx, steps::tetexact::WmVol * tet) override;
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri) override;
     void reset() override;
+    void setActive(bool active) override;
     double rate(steps::tetexact::Tetexact * solver = nullptr) override;
-    std::vector<KProc*> const & apply(const rng::RNGptr &rng, double dt, double simtime) override;
+    UpdList apply(const rng::RNGptr &rng, double dt, double simtime) override;
 
     uint updVecSize() const override;
 
     ////////////////////////////////////////////////////////////////////////
 
+    /// Add the row of this diff to table, which is kept up to date from then
+    /// on. Called once all kprocs have been created.
+    void setupTable(DiffTable & table);
+
+    ////////////////////////////////////////////////////////////////////////
+
     void setDiffBndActive(uint i, bool active);
 
     bool getDiffBndActive(uint i) const;
@@ -115,12 +123,16 @@ public:
 
 private:
 
+    /// Copy the scaled diffusion constant to the table row, zero if
+    /// inactive.
+    void _updateTableRow();
+
     ////////////////////////////////////////////////////////////////////////
 
     uint                                lidxTet;
     steps::solver::Diffdef            * pDiffdef;
     steps::tetexact::Tet              * pTet;
-    std::vector<KProc*>                 pUpdVec[4];
+    std::array<UpdTemplate const *, 4> pUpdTemplate{};
     std::map<uint, double>              directionalDcsts;
 
     /// Properly scaled diffusivity constant.
@@ -141,6 +153,9 @@ private:
     // and therefore have different spec indices
     std::array<solver::lidxT, 4>  pNeighbCompLidx{solver::LIDX_UNDEFINED, solver::LIDX_UNDEFINED, solver::LIDX_UNDEFINED, solver::LIDX_UNDEFINED};
 
+    DiffTable                         * pTable{nullptr};
+    uint                                pTableRow{0};
+
     ////////////////////////////////////////////////////////////////////////
 
 };
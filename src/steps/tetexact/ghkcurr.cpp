@@ -52,9 +52,9 @@ namespace sm = steps::math;
 
 stex::GHKcurr::GHKcurr(ssolver::GHKcurrdef * ghkdef, stex::Tri * tri)
 :
- pGHKcurrdef(ghkdef)
+ KProc(KProcType::GHKcurr)
+, pGHKcurrdef(ghkdef)
 , pTri(tri)
-, pUpdVec()
 , pEffFlux(true)
 {
     AssertLog(pGHKcurrdef != nullptr);
@@ -108,7 +108,7 @@ void stex::GHKcurr::reset()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::GHKcurr::setupDeps()
+void stex::GHKcurr::setupDeps(UpdTemplatePool & pool)
 {
     std::set<stex::KProc*> updset;
 
@@ -155,7 +155,7 @@ void stex::GHKcurr::setupDeps()
         }
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdTemplate = pool.get(pTri, updset);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -240,7 +240,7 @@ double stex::GHKcurr::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::GHKcurr::apply(const rng::RNGptr &/*rng*/, double /*dt*/, double /*simtime*/)
+stex::UpdList stex::GHKcurr::apply(const rng::RNGptr &/*rng*/, double /*dt*/, double /*simtime*/)
 {
     stex::WmVol * itet = pTri->iTet();
     stex::WmVol * otet = pTri->oTet();
@@ -295,7 +295,7 @@ std::vector<stex::KProc*> const & stex::GHKcurr::apply(const rng::RNGptr &/*rng*
 
     rExtent++;
 
-    return pUpdVec;
+    return UpdList{pUpdTemplate, pTri};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,7 +53,7 @@ class Tetexact;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class GHKcurr
+class GHKcurr final
 : public steps::tetexact::KProc
 {
 
@@ -79,7 +79,7 @@ public:
     // VIRTUAL INTERFACE METHODS
     ////////////////////////////////////////////////////////////////////////
 
-    void setupDeps() override;
+    void setupDeps(UpdTemplatePool & pool) override;
     bool depSpecTet(uint gidx, steps::tetexact::WmVol * tet) override;
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri) override;
     void reset() override;
@@ -88,7 +88,7 @@ public:
     double rate(steps::tetexact::Tetexact * solver) override;
 
     // double rate(double v, double T);
-    std::vector<KProc*> const & apply(const rng::RNGptr &rng, double dt, double simtime) override;
+    UpdList apply(const rng::RNGptr &rng, double dt, double simtime) override;
 
     inline bool efflux() const noexcept
     { return pEffFlux; }
@@ -97,7 +97,7 @@ public:
     { pEffFlux = efx; }
 
     uint updVecSize() const noexcept override
-    { return static_cast<uint>(pUpdVec.size()); }
+    { return pUpdTemplate->size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -107,7 +107,7 @@ private:
 
     steps::solver::GHKcurrdef         * pGHKcurrdef;
     steps::tetexact::Tri              * pTri;
-    std::vector<KProc*>                 pUpdVec;
+    UpdTemplate const *                 pUpdTemplate{nullptr};
 
     // Flag if flux is outward, positive flux (true) or inward, negative flux (false)
     bool                                pEffFlux;
@@ -40,7 +40,9 @@ namespace stex = steps::tetexact;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-stex::KProc::KProc() = default;
+stex::KProc::KProc(KProcType type)
+: pType(type)
+{}
 
 ////////////////////////////////////////////////////////////////////////////////
 
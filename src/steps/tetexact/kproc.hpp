@@ -37,6 +37,7 @@
 
 // STEPS headers.
 #include "crstruct.hpp"
+#include "updtemplate.hpp"
 #include "util/common.h"
 #include "solver/types.hpp"
 #include "rng/rng.hpp"
@@ -64,6 +65,23 @@ typedef KProcPVec::const_iterator       KProcPVecCI;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Concrete kind of a kinetic process.
+///
+/// The solver uses this tag to call rate() and apply() on the final
+/// derived class directly instead of through the virtual table.
+///
+enum class KProcType : unsigned char {
+    Reac,
+    Diff,
+    SReac,
+    SDiff,
+    VDepTrans,
+    VDepSReac,
+    GHKcurr
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class KProc
 
 {
@@ -73,7 +91,7 @@ public:
     // OBJECT CONSTRUCTION & DESTRUCTION
     ////////////////////////////////////////////////////////////////////////
 
-    KProc();
+    explicit KProc(KProcType type);
     virtual ~KProc();
 
     ////////////////////////////////////////////////////////////////////////
@@ -90,13 +108,16 @@ public:
     ////////////////////////////////////////////////////////////////////////
 
 
+    inline KProcType type() const noexcept
+    { return pType; }
+
     static const int INACTIVATED = 1;
 
     inline bool active() const noexcept
     { return !(pFlags & INACTIVATED); }
     inline bool inactive() const noexcept
     { return static_cast<bool>(pFlags & INACTIVATED); }
-    void setActive(bool active);
+    virtual void setActive(bool active);
 
     inline uint flags() const
     { return pFlags; }
@@ -114,9 +135,10 @@ public:
     ////////////////////////////////////////////////////////////////////////
 
     /// This function is called when all kproc objects have been created,
-    /// allowing the kproc to pre-compute its SchedIDXVec.
+    /// allowing the kproc to pre-compute its dependency templates, which
+    /// are shared through pool.
     ///
-    virtual void setupDeps() = 0;
+    virtual void setupDeps(UpdTemplatePool & pool) = 0;
 
     virtual bool depSpecTet(uint gidx, steps::tetexact::WmVol * tet) = 0;
     virtual bool depSpecTri(uint gidx, steps::tetexact::Tri * tri) = 0;
@@ -141,12 +163,11 @@ public:
     virtual double h();
 
     /// Apply a single discrete instance of the kinetic process, returning
-    /// a vector of kproc schedule indices that need to be updated as a
-    /// result.
+    /// the kprocs that need to be updated as a result.
     ///
     // NOTE: Random number generator available to this function for use
     // by Diff
-    virtual std::vector<KProc*> const & apply(const rng::RNGptr &rng, double dt, double simtime) = 0;
+    virtual UpdList apply(const rng::RNGptr &rng, double dt, double simtime) = 0;
 
     virtual uint updVecSize() const = 0;
 
@@ -180,6 +201,8 @@ protected:
 
     uint                                pSchedIDX{};
 
+    KProcType                           pType;
+
     ////////////////////////////////////////////////////////////////////////
 };
 
@@ -0,0 +1,196 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_TETEXACT_KPROCTABLES_HPP
+#define STEPS_TETEXACT_KPROCTABLES_HPP 1
+
+// STL headers.
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// STEPS headers.
+#include "util/common.h"
+#include "solver/reactants.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace tetexact {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Rate data of the Reac kprocs of a solver, one row per Reac in
+/// struct-of-arrays layout.
+///
+/// Each Reac keeps the index of its row. A full update of the solver
+/// computes the rates of all reacs in one loop over these arrays instead of
+/// going through the compartment definition and the tetrahedron of each
+/// reac, and Reac::apply() only visits the pools the reac changes. After a
+/// single event the reacs compute their rate from their own data, which the
+/// schedule reads anyway.
+///
+/// A row holds the scaled reaction constant, zero while its reac is
+/// inactive, the pools of its element and the index of its kind: the
+/// reactants and the non-zero pool changes, which are shared by all the
+/// reacs of a reaction in a compartment. Rows are added in schedule index
+/// order.
+///
+class ReacTable
+{
+public:
+
+    /// Change of a pool when a reac fires.
+    struct PoolUpd
+    {
+        uint                            pool;
+        int                             delta;
+    };
+
+    /// Add a row for the reac of schedule index sidx on the pools of its
+    /// element, with the reactants in [bgn, end) and the dense update vector
+    /// upd of nspecs entries. Returns the index of the row.
+    uint add(uint sidx, uint * pools, const solver::Reactant * bgn,
+             const solver::Reactant * end, const int * upd, uint nspecs)
+    {
+        auto kind = pKindIDX.emplace(upd, static_cast<uint>(pKinds.size()));
+        if (kind.second)
+        {
+            Kind k{bgn, end, static_cast<uint>(pUpds.size()), 0};
+            for (uint s = 0; s < nspecs; ++s)
+            {
+                if (upd[s] == 0) continue;
+                pUpds.push_back({s, upd[s]});
+            }
+            k.upd_end = static_cast<uint>(pUpds.size());
+            pKinds.push_back(k);
+        }
+        pSchedIDX.push_back(sidx);
+        pCcst.push_back(0.0);
+        pPools.push_back(pools);
+        pKind.push_back(kind.first->second);
+        return static_cast<uint>(pCcst.size() - 1);
+    }
+
+    inline std::size_t size() const noexcept
+    { return pCcst.size(); }
+
+    inline uint schedIDX(uint row) const noexcept
+    { return pSchedIDX[row]; }
+
+    inline uint * pools(uint row) const noexcept
+    { return pPools[row]; }
+
+    inline void setCcst(uint row, double ccst) noexcept
+    { pCcst[row] = ccst; }
+
+    inline double rate(uint row) const noexcept
+    {
+        Kind const & k = pKinds[pKind[row]];
+        return solver::reac_comb(k.bgn, k.end, pPools[row]) * pCcst[row];
+    }
+
+    /// The non-zero pool changes of the reac of a row, by increasing pool
+    /// index.
+    inline const PoolUpd * upd_bgn(uint row) const noexcept
+    { return pUpds.data() + pKinds[pKind[row]].upd_bgn; }
+
+    inline const PoolUpd * upd_end(uint row) const noexcept
+    { return pUpds.data() + pKinds[pKind[row]].upd_end; }
+
+private:
+
+    /// Reactants and pool changes of the reacs of a reaction in a
+    /// compartment, the latter in pUpds[upd_bgn, upd_end).
+    struct Kind
+    {
+        const solver::Reactant *        bgn;
+        const solver::Reactant *        end;
+        uint                            upd_bgn;
+        uint                            upd_end;
+    };
+
+    std::vector<uint>                   pSchedIDX;
+    std::vector<double>                 pCcst;
+    std::vector<uint *>                 pPools;
+    std::vector<uint>                   pKind;
+
+    std::vector<Kind>                   pKinds;
+    std::vector<PoolUpd>                pUpds;
+    /// Index in pKinds by dense update vector
+    std::map<const int *, uint>         pKindIDX;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Rate data of the Diff kprocs of a solver, one row per Diff in
+/// struct-of-arrays layout: the scaled diffusion constant, zero while the
+/// diff is inactive, and the pool of the diffusing species. Used like the
+/// ReacTable in a full update of the solver.
+///
+class DiffTable
+{
+public:
+
+    /// Add a row for the diff of schedule index sidx, of the species in
+    /// pool, returning its index. Rows are added in schedule index order.
+    uint add(uint sidx, const uint * pool)
+    {
+        pSchedIDX.push_back(sidx);
+        pDcst.push_back(0.0);
+        pPool.push_back(pool);
+        return static_cast<uint>(pDcst.size() - 1);
+    }
+
+    inline std::size_t size() const noexcept
+    { return pDcst.size(); }
+
+    inline uint schedIDX(uint row) const noexcept
+    { return pSchedIDX[row]; }
+
+    inline void setDcst(uint row, double dcst) noexcept
+    { pDcst[row] = dcst; }
+
+    inline double rate(uint row) const noexcept
+    { return pDcst[row] * static_cast<double>(*pPool[row]); }
+
+private:
+
+    std::vector<uint>                   pSchedIDX;
+    std::vector<double>                 pDcst;
+    std::vector<const uint *>           pPool;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif
+
+// STEPS_TETEXACT_KPROCTABLES_HPP
+
+// END
@@ -67,9 +67,9 @@ static inline double comp_ccst(double kcst, double vol, uint order, double /*com
 
 stex::Reac::Reac(ssolver::Reacdef * rdef, stex::WmVol * tet)
 :
- pReacdef(rdef)
+ KProc(KProcType::Reac)
+, pReacdef(rdef)
 , pTet(tet)
-, pUpdVec()
 , pCcst(0.0)
 , pKcst(0.0)
 {
@@ -117,6 +117,7 @@ void stex::Reac::restore(std::fstream & cp_file)
     cp_file.read(reinterpret_cast<char*>(&crData.pow), sizeof(int));
     cp_file.read(reinterpret_cast<char*>(&crData.pos), sizeof(unsigned));
     cp_file.read(reinterpret_cast<char*>(&crData.rate), sizeof(double));
+    _updateTableRow();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,6 +144,7 @@ void stex::Reac::_resetCcst()
     pKcst = kcst;
     pCcst = comp_ccst(kcst, pTet->vol(), pReacdef->order(), pTet->compdef()->vol());
     AssertLog(pCcst >= 0.0);
+    _updateTableRow();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -153,11 +155,12 @@ void stex::Reac::setKcst(double k)
     pKcst = k;
     pCcst = comp_ccst(k, pTet->vol(), pReacdef->order(), pTet->compdef()->vol());
     AssertLog(pCcst >= 0.0);
+    _updateTableRow();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Reac::setupDeps()
+void stex::Reac::setupDeps(UpdTemplatePool & pool)
 {
     std::set<stex::KProc*> updset;
 
@@ -184,7 +187,7 @@ void stex::Reac::setupDeps()
         }
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdTemplate = pool.get(pTet, updset);
     //pUpdObjVec.assign(updset_obj.begin(), updset_obj.end());
 }
 
@@ -206,58 +209,48 @@ bool stex::Reac::depSpecTri(uint /*gidx*/, stex::Tri * /*tri*/)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void stex::Reac::setupTable(stex::ReacTable & table)
+{
+    ssolver::Compdef * cdef = pTet->compdef();
+    uint lidx = cdef->reacG2L(pReacdef->gidx());
+    pTable = &table;
+    pTableRow = table.add(schedIDX(),
+                          pTet->poolData(),
+                          cdef->reac_reactants_bgn(lidx),
+                          cdef->reac_reactants_end(lidx),
+                          cdef->reac_upd_bgn(lidx),
+                          cdef->countSpecs());
+    _updateTableRow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::Reac::_updateTableRow()
+{
+    if (pTable == nullptr) return;
+    pTable->setCcst(pTableRow, inactive() ? 0.0 : pCcst);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::Reac::setActive(bool active)
+{
+    KProc::setActive(active);
+    _updateTableRow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 double stex::Reac::rate(steps::tetexact::Tetexact * /*solver*/)
 {
     if (inactive()) return 0.0;
 
-    // Prefetch some variables.
+    // Compute combinatorial part over the reactants only.
     ssolver::Compdef * cdef = pTet->compdef();
-    uint nspecs = cdef->countSpecs();
-    uint * lhs_vec = cdef->reac_lhs_bgn(cdef->reacG2L(pReacdef->gidx()));
-    auto const& cnt_vec = pTet->pools();
-
-    // Compute combinatorial part.
-    double h_mu = 1.0;
-    for (uint pool = 0; pool < nspecs; ++pool)
-    {
-        uint lhs = lhs_vec[pool];
-        if (lhs == 0) { continue;
-}
-        uint cnt = cnt_vec[pool];
-        if (lhs > cnt)
-        {
-            h_mu = 0.0;
-            break;
-        }
-        switch (lhs)
-        {
-            case 4:
-            {
-                h_mu *= static_cast<double>(cnt - 3);
-            }
-            STEPS_FALLTHROUGH;
-            case 3:
-            {
-                h_mu *= static_cast<double>(cnt - 2);
-            }
-            STEPS_FALLTHROUGH;
-            case 2:
-            {
-                h_mu *= static_cast<double>(cnt - 1);
-            }
-            STEPS_FALLTHROUGH;
-            case 1:
-            {
-                h_mu *= static_cast<double>(cnt);
-                break;
-            }
-            default:
-            {
-                AssertLog(0);
-                return 0.0;
-            }
-        }
-    }
+    uint lidx = cdef->reacG2L(pReacdef->gidx());
+    double h_mu = ssolver::reac_comb(cdef->reac_reactants_bgn(lidx),
+                                     cdef->reac_reactants_end(lidx),
+                                     pTet->pools());
 
     // Multiply with scaled reaction constant.
     return h_mu * pCcst;
@@ -265,23 +258,18 @@ double stex::Reac::rate(steps::tetexact::Tetexact * /*solver*/)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::Reac::apply(const rng::RNGptr &/*rng*/, double /*dt*/, double /*simtime*/)
+stex::UpdList stex::Reac::apply(const rng::RNGptr &/*rng*/, double /*dt*/, double /*simtime*/)
 {
-    auto const& local = pTet->pools();
-    ssolver::Compdef * cdef = pTet->compdef();
-    uint l_ridx = cdef->reacG2L(pReacdef->gidx());
-    int * upd_vec = cdef->reac_upd_bgn(l_ridx);
-    uint nspecs = cdef->countSpecs();
-    for (uint i = 0; i < nspecs; ++i)
+    uint * pools = pTable->pools(pTableRow);
+    const auto * upd_end = pTable->upd_end(pTableRow);
+    for (auto * u = pTable->upd_bgn(pTableRow); u != upd_end; ++u)
     {
-        if (pTet->clamped(i)) continue;
-        int j = upd_vec[i];
-        if (j == 0) continue;
-        int nc = static_cast<int>(local[i]) + j;
-        pTet->setCount(i, static_cast<uint>(nc));
+        if (pTet->clamped(u->pool)) continue;
+        int nc = static_cast<int>(pools[u->pool]) + u->delta;
+        pools[u->pool] = static_cast<uint>(nc);
     }
     rExtent++;
-    return pUpdVec;
+    return UpdList{pUpdTemplate, pTet};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
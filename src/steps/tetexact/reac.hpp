@@ -38,6 +38,7 @@
 // STEPS headers.
 #include "util/common.h"
 #include "kproc.hpp"
+#include "kproctables.hpp"
 #include "solver/reacdef.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -54,7 +55,7 @@ class Tetexact;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class Reac
+class Reac final
 : public steps::tetexact::KProc
 {
 
@@ -95,30 +96,43 @@ public:
     // VIRTUAL INTERFACE METHODS
     ////////////////////////////////////////////////////////////////////////
 
-    void setupDeps() override;
+    void setupDeps(UpdTemplatePool & pool) override;
     bool depSpecTet(uint gidx, steps::tetexact::WmVol * tet) override;
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri) override;
     void reset() override;
+    void setActive(bool active) override;
     double rate(steps::tetexact::Tetexact * solver = nullptr) override;
-    std::vector<KProc*> const & apply(const rng::RNGptr &rng, double dt, double simtime) override;
+    UpdList apply(const rng::RNGptr &rng, double dt, double simtime) override;
 
     uint updVecSize() const override
-    { return static_cast<uint>(pUpdVec.size()); }
+    { return pUpdTemplate->size(); }
+
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Add the row of this reac to table, which apply() uses from then on.
+    /// Called once all kprocs have been created.
+    void setupTable(ReacTable & table);
 
     ////////////////////////////////////////////////////////////////////////
 
 private:
 
+    /// Copy the rate constant to the table row, zero if inactive.
+    void _updateTableRow();
+
     ////////////////////////////////////////////////////////////////////////
 
     steps::solver::Reacdef                              * pReacdef;
     steps::tetexact::WmVol                              * pTet;
-    std::vector<KProc*>                                   pUpdVec;
+    UpdTemplate const *                                   pUpdTemplate{nullptr};
     /// Properly scaled reaction constant.
     double                                                pCcst;
     // Also store the K constant for convenience
     double                                                pKcst;
 
+    ReacTable                                           * pTable{nullptr};
+    uint                                                  pTableRow{0};
+
     ////////////////////////////////////////////////////////////////////////
 
 };
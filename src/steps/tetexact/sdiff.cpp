@@ -27,6 +27,7 @@
 
 
 // Standard library & STL headers.
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <vector>
@@ -52,7 +53,8 @@ namespace smath = steps::math;
 
 stex::SDiff::SDiff(ssolver::Diffdef * sdef, stex::Tri * tri)
 :
- pSDiffdef(sdef)
+ KProc(KProcType::SDiff)
+, pSDiffdef(sdef)
 , pTri(tri)
 {
     AssertLog(pSDiffdef != nullptr);
@@ -170,7 +172,7 @@ void stex::SDiff::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::SDiff::setupDeps()
+void stex::SDiff::setupDeps(UpdTemplatePool & pool)
 {
     // We will check all KProcs of the following simulation elements:
     //   * the 'source' triangle
@@ -215,6 +217,8 @@ void stex::SDiff::setupDeps()
         // Fetch next triangle, if it exists.
         stex::Tri * next = pTri->nextTri(i);
         if (next == nullptr) {
+          // never selected
+          pUpdTemplate[i] = pool.get(pTri, {});
           continue;
         }
 
@@ -243,8 +247,7 @@ void stex::SDiff::setupDeps()
             }
         }
 
-        // Copy the set to the update vector.
-        pUpdVec[i].assign(local2.begin(), local2.end());
+        pUpdTemplate[i] = pool.get(pTri, local2);
     }
 
 }
@@ -423,7 +426,7 @@ double stex::SDiff::rate(steps::tetexact::Tetexact * /*solver*/)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::SDiff::apply(const rng::RNGptr &rng, double /*dt*/, double /*simtime*/)
+stex::UpdList stex::SDiff::apply(const rng::RNGptr &rng, double /*dt*/, double /*simtime*/)
 {
     //uint lidxTet = this->lidxTet;
     // Pre-fetch some general info.
@@ -461,18 +464,16 @@ std::vector<stex::KProc*> const & stex::SDiff::apply(const rng::RNGptr &rng, dou
 
     rExtent++;
 
-    return pUpdVec[iSel];
+    return UpdList{pUpdTemplate[iSel], pTri};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 uint stex::SDiff::updVecSize() const
 {
-    auto maxsize = pUpdVec[0].size();
-    for (uint i=1; i <= 2; ++i)
-    {
-        if (pUpdVec[i].size() > maxsize)
-            maxsize = pUpdVec[i].size();
+    uint maxsize = 0;
+    for (auto const& t: pUpdTemplate) {
+        maxsize = std::max(maxsize, t->size());
     }
     return maxsize;
 }
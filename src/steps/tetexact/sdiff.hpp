@@ -56,7 +56,7 @@ class Tri;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class SDiff
+class SDiff final
 : public steps::tetexact::KProc
 {
 
@@ -89,7 +89,7 @@ public:
     void setDcst(double d);
     void setDirectionDcst(int direction, double dcst);
 
-    void setupDeps() override;
+    void setupDeps(UpdTemplatePool & pool) override;
 
     bool depSpecTet(uint gidx, steps::tetexact::WmVol * tet) override;
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri) override;
@@ -97,7 +97,7 @@ public:
     void reset() override;
     double rate(steps::tetexact::Tetexact * solver = nullptr) override;
 
-    std::vector<KProc*> const & apply(const rng::RNGptr &rng, double dt, double simtime) override;
+    UpdList apply(const rng::RNGptr &rng, double dt, double simtime) override;
 
     uint updVecSize() const override;
 
@@ -116,7 +116,7 @@ private:
     uint                                lidxTri;
     steps::solver::Diffdef              * pSDiffdef;
     steps::tetexact::Tri                * pTri;
-    std::vector<KProc*>                 pUpdVec[3];
+    std::array<UpdTemplate const *, 3> pUpdTemplate{};
 
     // Storing the species local index for each neighbouring tri: Needed
     // because neighbours may belong to different patches for
@@ -57,7 +57,7 @@ class Tetexact;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class SReac
+class SReac final
 : public steps::tetexact::KProc
 {
 
@@ -100,15 +100,15 @@ public:
     // VIRTUAL INTERFACE METHODS
     ////////////////////////////////////////////////////////////////////////
 
-    void setupDeps() override;
+    void setupDeps(UpdTemplatePool & pool) override;
     bool depSpecTet(uint gidx, steps::tetexact::WmVol * tet) override;
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri) override;
     void reset() override;
     double rate(steps::tetexact::Tetexact * solver = nullptr) override;
-    std::vector<KProc*> const & apply(const rng::RNGptr &rng, double dt, double simtime) override;
+    UpdList apply(const rng::RNGptr &rng, double dt, double simtime) override;
 
     inline uint updVecSize() const noexcept override
-    { return pUpdVec.size(); }
+    { return pUpdTemplate->size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -123,7 +123,7 @@ private:
 
     steps::solver::SReacdef           * pSReacdef;
     steps::tetexact::Tri              * pTri;
-    std::vector<KProc*>                 pUpdVec;
+    UpdTemplate const *                 pUpdTemplate{nullptr};
     /// Properly scaled reaction constant.
     double                              pCcst;
     // Store the kcst for convenience
@@ -160,7 +160,7 @@ void Tet::setNextTri(uint i, Tri * t)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Tet::setupKProcs(Tetexact * tex)
+void Tet::setupKProcs(Tetexact * tex, uint first)
 {
     uint j = 0;
 
@@ -170,8 +170,9 @@ void Tet::setupKProcs(Tetexact * tex)
     {
         auto * rdef = compdef()->reacdef(i);
         auto * r = new Reac(rdef, this);
-        kprocs()[j++] = r;
-        tex->addKProc(r);
+        kprocs()[j] = r;
+        tex->addKProc(r, first + j);
+        ++j;
     }
 
     // Create diffusion kproc's.
@@ -183,8 +184,9 @@ void Tet::setupKProcs(Tetexact * tex)
     {
         auto * ddef = compdef()->diffdef(i);
         auto * d = new Diff(ddef, this);
-        kprocs()[j++] = d;
-        tex->addKProc(d);
+        kprocs()[j] = d;
+        tex->addKProc(d, first + j);
+        ++j;
     }
 }
 
@@ -108,9 +108,10 @@ public:
 
 
     /// Create the kinetic processes -- to be called when all tetrahedrons
-    /// and triangles have been fully declared and connected.
+    /// and triangles have been fully declared and connected. They get the
+    /// schedule indices starting at first.
     ///
-    void setupKProcs(Tetexact * tex) override;
+    void setupKProcs(Tetexact * tex, uint first) override;
 
 
     ////////////////////////////////////////////////////////////////////////
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -81,9 +82,40 @@ void schedIDXSet_To_Vec(SchedIDXSet const & s, SchedIDXVec & v)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// Call f(i) for all i in [0, n) from the OpenMP threads. f must not depend
+// on the order of the calls. An exception thrown by f is rethrown once all
+// threads are done, as exceptions cannot leave a parallel region.
+template <typename F>
+void parallelFor(std::size_t n, F f)
+{
+    std::exception_ptr error;
+    const auto ni = static_cast<long>(n);
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (long i = 0; i < ni; ++i)
+    {
+        try {
+            f(static_cast<std::size_t>(i));
+        }
+        catch (...) {
+            #pragma omp critical(steps_tetexact_parallel_for)
+            if (!error) error = std::current_exception();
+        }
+    }
+
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
 Tetexact::Tetexact(steps::model::Model *m, steps::wm::Geom *g, const rng::RNGptr &r,
-                   int calcMembPot)
+                   int calcMembPot, int crSchedule)
 : API(m, g, r)
+, pCRSchedule(static_cast<CR_schedule>(crSchedule))
 , pEFoption(static_cast<EF_solver>(calcMembPot))
 {
     if (rng() == nullptr)
@@ -93,6 +125,13 @@ Tetexact::Tetexact(steps::model::Model *m, steps::wm::Geom *g, const rng::RNGptr
         ArgErrLog(os.str());
     }
 
+    if (crSchedule != CR_SCHEDULE_DEFAULT && crSchedule != CR_SCHEDULE_FLAT)
+    {
+        std::ostringstream os;
+        os << "Unknown CR schedule option: " << crSchedule;
+        ArgErrLog(os.str());
+    }
+
     // All initialization code now in _setup() to allow EField solver to be
     // derived and create EField local objects within the constructor
     _setup();
@@ -199,6 +238,13 @@ void Tetexact::checkpoint(std::string const & file_name)
     cp_file.write(reinterpret_cast<char*>(&nSum), sizeof(double));
     cp_file.write(reinterpret_cast<char*>(&pA0), sizeof(double));
 
+    if (pCRSchedule == CR_SCHEDULE_FLAT) {
+        pFlatCR.checkpoint(cp_file);
+        cp_file.close();
+        CLOG(INFO, "general_log") << "complete.\n";
+        return;
+    }
+
     auto n_ngroups = nGroups.size();
     auto n_pgroups = pGroups.size();
 
@@ -296,6 +342,11 @@ void Tetexact::restore(std::string const & file_name)
         cp_file.read(reinterpret_cast<char*>(&pTemp), sizeof(double));
         cp_file.read(reinterpret_cast<char*>(&pEFDT), sizeof(double));
         pEField->restore(cp_file);
+
+        // The restored voltage-dependent rates match the restored potentials
+        for (uint tlidx = 0; tlidx < pEFTriV.size(); ++tlidx) {
+            pEFTriV[tlidx] = pEField->getTriV(tlidx);
+        }
     }
 
     std::size_t stored_entries;
@@ -312,6 +363,12 @@ void Tetexact::restore(std::string const & file_name)
     cp_file.read(reinterpret_cast<char*>(&nSum), sizeof(double));
     cp_file.read(reinterpret_cast<char*>(&pA0), sizeof(double));
 
+    if (pCRSchedule == CR_SCHEDULE_FLAT) {
+        pFlatCR.restore(cp_file);
+        cp_file.close();
+        return;
+    }
+
     std::size_t n_ngroups;
     std::size_t n_pgroups;
 
@@ -933,36 +990,89 @@ void Tetexact::_setup()
             _tri(tris[t])->setSDiffBndDirection(tris_direction[t]);
     }
 
-    for (auto const& t: pTets)
-        if (t) t->setupKProcs(this);
-
-    for (auto const& wmv: pWmVols)
-        if (wmv) wmv->setupKProcs(this);
-
+    // Lay out the schedule before creating any kproc: each element gets a
+    // contiguous block of schedule indices, tets first, then well-mixed
+    // volumes, then triangles. The kprocs can then be created, and their
+    // dependencies resolved, concurrently with the same result as a serial
+    // setup whatever the number of threads.
     for (auto const& t: pTris)
-        if (t) t->setupKProcs(this, efflag());
+        if (t) t->resizeKProcs(efflag());
+
+    AssertLog(pKProcs.empty());
+    uint nkprocs = 0;
+    std::vector<uint> tet_first(pTets.size());
+    for (uint i = 0; i < pTets.size(); ++i) {
+        if (!pTets[i]) continue;
+        tet_first[i] = nkprocs;
+        nkprocs += pTets[i]->countKProcs();
+    }
+    std::vector<uint> wmv_first(pWmVols.size());
+    for (uint i = 0; i < pWmVols.size(); ++i) {
+        if (!pWmVols[i]) continue;
+        wmv_first[i] = nkprocs;
+        nkprocs += pWmVols[i]->countKProcs();
+    }
+    std::vector<uint> tri_first(pTris.size());
+    for (uint i = 0; i < pTris.size(); ++i) {
+        if (!pTris[i]) continue;
+        tri_first[i] = nkprocs;
+        nkprocs += pTris[i]->countKProcs();
+    }
+    pKProcs.resize(nkprocs, nullptr);
+
+    parallelFor(pTets.size(), [&](std::size_t i) {
+        if (pTets[i]) pTets[i]->setupKProcs(this, tet_first[i]);
+    });
+    parallelFor(pWmVols.size(), [&](std::size_t i) {
+        if (pWmVols[i]) pWmVols[i]->setupKProcs(this, wmv_first[i]);
+    });
+    parallelFor(pTris.size(), [&](std::size_t i) {
+        if (pTris[i]) pTris[i]->setupKProcs(this, tri_first[i], efflag());
+    });
 
     // Resolve all dependencies
-    for (auto const& t: pTets) {
-        // DEBUG: vector holds all possible tetrahedrons,
-        // but they have not necessarily been added to a compartment.
-        if (!t) continue;
-        for (auto const& k: t->kprocs()) k->setupDeps();
-    }
+    for (auto const& t: pTets)
+        if (t) pUpdTemplates.addElement(static_cast<WmVol*>(t));
 
-    for (auto const& wmv: pWmVols) {
-        // Vector allows for all compartments to be well-mixed, so
-        // hold null-pointer for mesh compartments
-        if (!wmv) continue;
-        for (auto const& k: wmv->kprocs()) k->setupDeps();
-    }
+    for (auto const& wmv: pWmVols)
+        if (wmv) pUpdTemplates.addElement(wmv);
 
-    for (auto const& t: pTris) {
-        // DEBUG: vector holds all possible triangles, but
-        // only patch triangles are filled
-        if (!t) continue;
-        for (auto const& k: t->kprocs()) k->setupDeps();
+    for (auto const& t: pTris)
+        if (t) pUpdTemplates.addElement(t);
+
+    // DEBUG: vectors hold all possible tetrahedrons and triangles, but they
+    // have not necessarily been added to a compartment or patch. The vector
+    // of well-mixed volumes holds null-pointers for mesh compartments.
+    parallelFor(pTets.size(), [&](std::size_t i) {
+        if (!pTets[i]) return;
+        for (auto const& k: pTets[i]->kprocs()) k->setupDeps(pUpdTemplates);
+    });
+    parallelFor(pWmVols.size(), [&](std::size_t i) {
+        if (!pWmVols[i]) return;
+        for (auto const& k: pWmVols[i]->kprocs()) k->setupDeps(pUpdTemplates);
+    });
+    parallelFor(pTris.size(), [&](std::size_t i) {
+        if (!pTris[i]) return;
+        for (auto const& k: pTris[i]->kprocs()) k->setupDeps(pUpdTemplates);
+    });
+
+    pUpdTemplates.finishSetup();
+
+    // Rate tables, filled in schedule index order
+    for (auto const& kp: pKProcs) {
+        if (kp->type() == KProcType::Reac) {
+            static_cast<Reac*>(kp)->setupTable(pReacTable);
+        } else if (kp->type() == KProcType::Diff) {
+            static_cast<Diff*>(kp)->setupTable(pDiffTable);
+        } else {
+            pUntabledKProcs.push_back(kp);
+        }
     }
+    CLOG(INFO, "general_log") << "Dependencies: " << pUpdTemplates.countLists()
+                              << " update lists sharing " << pUpdTemplates.countTemplates()
+                              << " templates, " << pUpdTemplates.memory()
+                              << " bytes (" << pUpdTemplates.vectorMemory()
+                              << " bytes as per-kproc vectors)" << std::endl;
 
     // Create EField structures if EField is to be calculated
     if (efflag()) _setupEField();
@@ -992,6 +1102,9 @@ void Tetexact::_setupEField()
     case EF_DV_BDSYS:
         pEField = make_EField<dVSolverBanded>();
         break;
+    case EF_DV_PCG:
+        pEField = make_EField<dVSolverCSR>();
+        break;
     default:
         ArgErrLog("Unsupported E-Field solver.");
     }
@@ -1096,6 +1209,7 @@ void Tetexact::_setupEField()
     AssertLog(membtris.size() == neftris());
 
     pEFTris_vec.resize(neftris());
+    pEFTriVDepKProcs.resize(neftris());
 
     for (uint eft = 0; eft < neftris(); ++eft)
     {
@@ -1124,7 +1238,27 @@ void Tetexact::_setupEField()
         // This is added now for quicker iteration during run()
         // Extremely important for larger meshes, orders of magnitude times faster
         pEFTris_vec[eft] = pTris[triidx.get()];
+
+        for (auto const& kp: pEFTris_vec[eft]->kprocs()) {
+            switch (kp->type()) {
+            case KProcType::VDepTrans:
+            case KProcType::VDepSReac:
+            case KProcType::GHKcurr:
+                pEFTriVDepKProcs[eft].push_back(kp);
+                break;
+            default:
+                break;
+            }
+        }
+
+        pEFTris_vec[eft]->setupOhmicCurrents(pEFOhmicCurrs, eft, eft);
+        if (pEFTris_vec[eft]->patchdef()->countGHKcurrs() != 0) {
+            pEFGHKTris.push_back(eft);
+        }
     }
+    pEFTriV.assign(neftris(), std::numeric_limits<double>::quiet_NaN());
+    pEFTriVBuffer.resize(neftris());
+    pEFTriIBuffer.resize(neftris());
 
     CLOG(INFO, "general_log") << "Initting mesh with:" << std::endl;
     CLOG(INFO, "general_log") << "Number of EF verts:" << nefverts() << std::endl
@@ -1137,6 +1271,25 @@ void Tetexact::_setupEField()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Tetexact::setEfieldVTolerance(double tol)
+{
+    if (!efflag())
+    {
+        std::ostringstream os;
+        os << "Method not available: EField calculation not included in simulation.";
+        ArgErrLog(os.str());
+    }
+    if (tol < 0.0)
+    {
+        std::ostringstream os;
+        os << "EField potential tolerance cannot be negative.";
+        ArgErrLog(os.str());
+    }
+    pEFVTolerance = tol;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Tetexact::saveMembOpt(std::string const & opt_file_name)
 {
     if  (!efflag())
@@ -1376,6 +1529,8 @@ void Tetexact::reset()
     }
     pGroups.clear();
 
+    pFlatCR.clear();
+
     pSum = 0.0;
     nSum = 0.0;
     pA0 = 0.0;
@@ -1472,20 +1627,22 @@ void Tetexact::run(double endtime)
             // currents from triangles during the ef_dt and applying these to the EField
             // object.
 
-            uint tlidx = 0;
             double sttime = statedef().time();
 
-            for (auto const& eft : pEFTris_vec) {
-                double v = pEField->getTriV(tlidx);
-                double cur = eft->computeI(v, maxDt, sttime, efdt());
-                pEField->setTriI(tlidx, cur);
-                tlidx++;
+            std::fill(pEFTriIBuffer.begin(), pEFTriIBuffer.end(), 0.0);
+            pEField->getTrisV(pEFTriVBuffer.data());
+            pEFOhmicCurrs.compute(pEFTriVBuffer.data(), sttime, maxDt,
+                                  pEFTriIBuffer.data());
+            for (auto tlidx : pEFGHKTris) {
+                pEFTriIBuffer[tlidx] +=
+                    pEFTris_vec[tlidx]->computeGHKI(maxDt, efdt(), sttime);
             }
+            pEField->setTrisI(pEFTriIBuffer.data());
 
             pEField->advance(maxDt);
 
-            // TODO: Replace this with something that only resets voltage-dependent things
-            _update();
+            // Only the rates of voltage-dependent kprocs depend on the potential
+            _updateVDep();
         }
     }
 
@@ -1567,6 +1724,11 @@ void Tetexact::setTemp(double t)
     }
     AssertLog(t >= 0.0);
     pTemp = t;
+
+    // GHK rates depend on the temperature: refresh them now, the
+    // voltage-dependent update after EField steps would miss them if the
+    // potential doesn't change
+    if (efflag()) _update();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2244,13 +2406,14 @@ void Tetexact::_setPatchVDepSReacActive(uint pidx, uint vsridx, bool a)
 }
 ////////////////////////////////////////////////////////////////////////////////
 
-void Tetexact::addKProc(steps::tetexact::KProc * kp)
+void Tetexact::addKProc(steps::tetexact::KProc * kp, uint sidx)
 {
     AssertLog(kp != nullptr);
+    AssertLog(sidx < pKProcs.size());
+    AssertLog(pKProcs[sidx] == nullptr);
 
-    const auto nidx = pKProcs.size();
-    pKProcs.push_back(kp);
-    kp->setSchedIDX(nidx);
+    pKProcs[sidx] = kp;
+    kp->setSchedIDX(sidx);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2271,6 +2434,8 @@ steps::tetexact::KProc * Tetexact::_getNext() const
     // Quick check to see whether nothing is there.
     if (pA0 == 0.0) return nullptr;
 
+    if (pCRSchedule == CR_SCHEDULE_FLAT) return pFlatCR.getNext(pA0, rng());
+
     double selector = pA0 * rng()->getUnfII();
 
     double partial_sum = 0.0;
@@ -2405,10 +2570,61 @@ void Tetexact::_reset()
 */
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// Type-dispatched KProc::rate and KProc::apply. All kproc classes are final,
+// so each case below is a direct call rather than a virtual one.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type"
+inline double kprocRate(KProc * kp, Tetexact * solver)
+{
+    switch (kp->type()) {
+    case KProcType::Reac:
+        return static_cast<Reac*>(kp)->rate(solver);
+    case KProcType::Diff:
+        return static_cast<Diff*>(kp)->rate(solver);
+    case KProcType::SReac:
+        return static_cast<SReac*>(kp)->rate(solver);
+    case KProcType::SDiff:
+        return static_cast<SDiff*>(kp)->rate(solver);
+    case KProcType::VDepTrans:
+        return static_cast<VDepTrans*>(kp)->rate(solver);
+    case KProcType::VDepSReac:
+        return static_cast<VDepSReac*>(kp)->rate(solver);
+    case KProcType::GHKcurr:
+        return static_cast<GHKcurr*>(kp)->rate(solver);
+    }
+}
+
+inline UpdList kprocApply(KProc * kp, const rng::RNGptr &rng, double dt, double simtime)
+{
+    switch (kp->type()) {
+    case KProcType::Reac:
+        return static_cast<Reac*>(kp)->apply(rng, dt, simtime);
+    case KProcType::Diff:
+        return static_cast<Diff*>(kp)->apply(rng, dt, simtime);
+    case KProcType::SReac:
+        return static_cast<SReac*>(kp)->apply(rng, dt, simtime);
+    case KProcType::SDiff:
+        return static_cast<SDiff*>(kp)->apply(rng, dt, simtime);
+    case KProcType::VDepTrans:
+        return static_cast<VDepTrans*>(kp)->apply(rng, dt, simtime);
+    case KProcType::VDepSReac:
+        return static_cast<VDepSReac*>(kp)->apply(rng, dt, simtime);
+    case KProcType::GHKcurr:
+        return static_cast<GHKcurr*>(kp)->apply(rng, dt, simtime);
+    }
+}
+#pragma GCC diagnostic pop
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Tetexact::_executeStep(steps::tetexact::KProc * kp, double dt)
 {
-    std::vector<KProc*> const & upd = kp->apply(rng(), dt, statedef().time());
-    _update(upd.begin(), upd.end());
+    _update(kprocApply(kp, rng(), dt, statedef().time()));
     statedef().incTime(dt);
     statedef().incNSteps(1);
 }
@@ -2417,22 +2633,22 @@ void Tetexact::_executeStep(steps::tetexact::KProc * kp, double dt)
 
 void Tetexact::_updateSpec(steps::tetexact::WmVol * tet)
 {
-    std::set<KProc*> updset;
-
-    // Loop over tet.
-    for (auto const& kproc: tet->kprocs()) updset.insert(kproc);
+    pUpdBuffer.assign(tet->kprocBegin(), tet->kprocEnd());
 
     for (auto const&tri: tet->nexttris()) {
         if (!tri) {
             continue;
         }
-        for (auto const &kproc: tri->kprocs()) {
-            updset.insert(kproc);
-        }
+        pUpdBuffer.insert(pUpdBuffer.end(), tri->kprocBegin(), tri->kprocEnd());
     }
 
-    // Send the list of kprocs that need to be updated to the schedule.
-    _update(updset.begin(), updset.end());
+    // In schedule index order rather than pointer order, so that the group
+    // sums do not depend on where the kprocs were allocated.
+    std::sort(pUpdBuffer.begin(), pUpdBuffer.end(), [](KProc* a, KProc* b) {
+        return a->schedIDX() < b->schedIDX();
+    });
+    pUpdBuffer.erase(std::unique(pUpdBuffer.begin(), pUpdBuffer.end()), pUpdBuffer.end());
+    _updateBuffer();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4244,10 +4460,120 @@ void Tetexact::_setMembVolRes(uint midx, double ro)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Tetexact::_update()
+{
+    const auto nkprocs = pKProcs.size();
+    pRateBuffer.resize(nkprocs);
+    parallelFor(pReacTable.size(), [&](std::size_t r) {
+        const auto row = static_cast<uint>(r);
+        pRateBuffer[pReacTable.schedIDX(row)] = pReacTable.rate(row);
+    });
+    parallelFor(pDiffTable.size(), [&](std::size_t r) {
+        const auto row = static_cast<uint>(r);
+        pRateBuffer[pDiffTable.schedIDX(row)] = pDiffTable.rate(row);
+    });
+    parallelFor(pUntabledKProcs.size(), [&](std::size_t i) {
+        KProc* kp = pUntabledKProcs[i];
+        pRateBuffer[kp->schedIDX()] = kprocRate(kp, this);
+    });
+
+    for (std::size_t i = 0; i < nkprocs; ++i) {
+        _updateElement(pKProcs[i], pRateBuffer[i]);
+    }
+    _updateSum();
+
+    // The voltage-dependent rates now match the current potentials
+    for (uint tlidx = 0; tlidx < pEFTriV.size(); ++tlidx) {
+        pEFTriV[tlidx] = pEField->getTriV(tlidx);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_updateVDep()
+{
+    pUpdBuffer.clear();
+    for (uint tlidx = 0; tlidx < pEFTriV.size(); ++tlidx) {
+        if (pEFTriVDepKProcs[tlidx].empty()) continue;
+        double v = pEField->getTriV(tlidx);
+        if (std::abs(v - pEFTriV[tlidx]) <= pEFVTolerance) continue;
+        pEFTriV[tlidx] = v;
+        pUpdBuffer.insert(pUpdBuffer.end(), pEFTriVDepKProcs[tlidx].begin(),
+                          pEFTriVDepKProcs[tlidx].end());
+    }
+
+    // same order as a full update, so that the group sums are identical
+    std::sort(pUpdBuffer.begin(), pUpdBuffer.end(), [](KProc* a, KProc* b) {
+        return a->schedIDX() < b->schedIDX();
+    });
+    _updateBuffer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_updateBuffer()
+{
+    // Resolved dependency templates list the kprocs of each type one after
+    // another, so this is one loop per type.
+    const auto end = pUpdBuffer.cend();
+    for (auto b = pUpdBuffer.cbegin(); b != end;) {
+        const auto type = (*b)->type();
+        const auto e = std::find_if(b + 1, end, [type](KProc* kp) {
+            return kp->type() != type;
+        });
+        switch (type) {
+        case KProcType::Reac:
+            _updateElements<Reac>(b, e);
+            break;
+        case KProcType::Diff:
+            _updateElements<Diff>(b, e);
+            break;
+        case KProcType::SReac:
+            _updateElements<SReac>(b, e);
+            break;
+        case KProcType::SDiff:
+            _updateElements<SDiff>(b, e);
+            break;
+        case KProcType::VDepTrans:
+            _updateElements<VDepTrans>(b, e);
+            break;
+        case KProcType::VDepSReac:
+            _updateElements<VDepSReac>(b, e);
+            break;
+        case KProcType::GHKcurr:
+            _updateElements<GHKcurr>(b, e);
+            break;
+        }
+        b = e;
+    }
+    _updateSum();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename K>
+void Tetexact::_updateElements(KProcPVecCI b, KProcPVecCI e)
+{
+    for (; b != e; ++b) {
+        _updateElement(*b, static_cast<K*>(*b)->rate(this));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Tetexact::_updateElement(KProc* kp)
 {
+    _updateElement(kp, kprocRate(kp, this));
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-    double new_rate = kp->rate(this);
+void Tetexact::_updateElement(KProc* kp, double new_rate)
+{
+    if (pCRSchedule == CR_SCHEDULE_FLAT) {
+        pFlatCR.update(kp, new_rate);
+        return;
+    }
 
     CRKProcData & data = kp->crData;
     double old_rate = data.rate;
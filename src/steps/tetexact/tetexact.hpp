@@ -43,11 +43,15 @@
 #include "diffboundary.hpp"
 #include "sdiffboundary.hpp"
 #include "crstruct.hpp"
+#include "crflat.hpp"
+#include "kproctables.hpp"
+#include "updtemplate.hpp"
 
 #include "geom/tetmesh.hpp"
 #include "solver/api.hpp"
 #include "solver/statedef.hpp"
 #include "solver/efield/efield.hpp"
+#include "solver/efield/ohmiccurrents.hpp"
 #include "util/common.h"
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -82,8 +86,14 @@ class Tetexact: public steps::solver::API
 
 public:
 
+    // Constants for describing the composition-rejection schedule layout
+    enum CR_schedule {
+        CR_SCHEDULE_DEFAULT = 0, // groups of KProc pointers
+        CR_SCHEDULE_FLAT = 1,    // contiguous (rate, kproc index) groups
+    };
+
     Tetexact(steps::model::Model *m, steps::wm::Geom *g, const rng::RNGptr &r,
-             int calcMembPot = EF_NONE);
+             int calcMembPot = EF_NONE, int crSchedule = CR_SCHEDULE_DEFAULT);
     ~Tetexact() override;
 
 
@@ -126,6 +136,14 @@ public:
     // save the optimal vertex indexing
     void saveMembOpt(std::string const & opt_file_name);
 
+    // Potential change (in volts) of a membrane triangle below which its
+    // voltage-dependent rates are not recomputed after an EField step.
+    // The default of zero recomputes them whenever the potential changes.
+    void setEfieldVTolerance(double tol);
+
+    inline double getEfieldVTolerance() const noexcept
+    { return pEFVTolerance; }
+
     ////////////////////////////////////////////////////////////////////////
 
     ////////////////////////////////////////////////////////////////////////
@@ -440,8 +458,9 @@ public:
 
     ////////////////////////////////////////////////////////////////////////
 
-    // Called from local Comp or Patch objects. Add KProc to this object
-    void addKProc(steps::tetexact::KProc * kp);
+    // Called from local Comp or Patch objects. Add KProc to this object at
+    // schedule index sidx, laid out by _setup().
+    void addKProc(steps::tetexact::KProc * kp, uint sidx);
 
     inline uint countKProcs() const
     { return pKProcs.size(); }
@@ -662,18 +681,63 @@ private:
     std::vector<CRGroup*>                       nGroups;
     std::vector<CRGroup*>                       pGroups;
 
+    // Layout of the CR schedule; pFlatCR is only used with CR_SCHEDULE_FLAT
+    CR_schedule                                 pCRSchedule;
+    CRFlatSchedule                              pFlatCR{pKProcs};
+
+    // Shared dependency templates of all kprocs, and the buffer their
+    // update lists are resolved into
+    UpdTemplatePool                             pUpdTemplates;
+    std::vector<KProc*>                         pUpdBuffer;
+
+    // Rates of all kprocs during a full update, by schedule index
+    std::vector<double>                         pRateBuffer;
+
+    // Rate data of the reacs and diffs, with one row per kproc in schedule
+    // index order
+    ReacTable                                   pReacTable;
+    DiffTable                                   pDiffTable;
+
+    // The kprocs of the other types, in schedule index order
+    std::vector<KProc*>                         pUntabledKProcs;
+
     ////////////////////////////////////////////////////////////////////////////////
 
     template <typename KProcPIter>
     inline void _update(KProcPIter b, KProcPIter e) {
-        while (b!=e) _updateElement(*b++);
-        _updateSum();
+        pUpdBuffer.assign(b, e);
+        _updateBuffer();
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline void _update() {
-        _update(pKProcs.begin(), pKProcs.end());
+    // Update the kprocs in pUpdBuffer, in order. The rates of each run of
+    // kprocs of the same type are computed in one loop, with direct calls.
+    void _updateBuffer();
+
+    // Update the kprocs in [b, e), which are all of concrete type K.
+    template <typename K>
+    void _updateElements(KProcPVecCI b, KProcPVecCI e);
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // Update all kprocs. Rates are computed concurrently, those of the reacs
+    // and diffs in one pass over their table, then inserted in the schedule
+    // in schedule index order.
+    void _update();
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // Update the voltage-dependent kprocs of the membrane triangles whose
+    // potential changed by more than pEFVTolerance since their last update.
+    void _updateVDep();
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    inline void _update(UpdList const & upd) {
+        pUpdBuffer.clear();
+        upd.tmpl->resolve(upd.home, pUpdBuffer);
+        _updateBuffer();
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -759,19 +823,25 @@ private:
     ////////////////////////////////////////////////////////////////////////////////
 
     void _updateElement(KProc* kp);
+    void _updateElement(KProc* kp, double new_rate);
 
     inline void _updateSum() {
         #ifdef SSA_DEBUG
         CLOG(INFO, "general_log") << "update A0 from " << pA0 << " to ";
         #endif
 
-        pA0 = 0.0;
-
-        for (const auto& neg_grp: nGroups) {
-          pA0 += neg_grp->sum;
+        if (pCRSchedule == CR_SCHEDULE_FLAT) {
+            pA0 = pFlatCR.computeA0();
         }
-        for (const auto& pos_grp: pGroups) {
-          pA0 += pos_grp->sum;
+        else {
+            pA0 = 0.0;
+
+            for (const auto& neg_grp: nGroups) {
+              pA0 += neg_grp->sum;
+            }
+            for (const auto& pos_grp: pGroups) {
+              pA0 += pos_grp->sum;
+            }
         }
 
         #ifdef SSA_DEBUG
@@ -810,6 +880,27 @@ private:
 
     std::vector<steps::tetexact::Tri *>        pEFTris_vec;
 
+    // Voltage-dependent kprocs (VDepTrans, VDepSReac, GHKcurr) of each
+    // membrane triangle, by EField local triangle index
+    std::vector<std::vector<KProc *>>           pEFTriVDepKProcs;
+
+    // Potential of each membrane triangle at the last update of its
+    // voltage-dependent kprocs
+    std::vector<double>                         pEFTriV;
+
+    double                                      pEFVTolerance{0.0};
+
+    // Ohmic currents of all membrane triangles, evaluated in one batch with
+    // the EField local triangle index as both slot and potential index
+    steps::solver::efield::OhmicCurrents        pEFOhmicCurrs;
+
+    // EField local indices of the membrane triangles with GHK currents
+    std::vector<uint>                           pEFGHKTris;
+
+    // Potential and current of each membrane triangle during an EField step
+    std::vector<double>                         pEFTriVBuffer;
+    std::vector<double>                         pEFTriIBuffer;
+
     // The number of tetrahedrons
     uint                                        pEFNTets{0};
     // Array of tetrahedrons
@@ -227,14 +227,19 @@ void stex::Tri::setNextTri(uint i, stex::Tri * t)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
+void stex::Tri::resizeKProcs(bool efield)
 {
     uint kprocvecsize = pPatchdef->countSReacs()+pPatchdef->countSurfDiffs();
     if (efield) {
         kprocvecsize += (pPatchdef->countVDepTrans() + pPatchdef->countVDepSReacs() + pPatchdef->countGHKcurrs());
 }
     pKProcs.resize(kprocvecsize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
+void stex::Tri::setupKProcs(stex::Tetexact * tex, uint first, bool efield)
+{
     uint j = 0;
     // Create surface reaction kprocs
     uint nsreacs = patchdef()->countSReacs();
@@ -243,8 +248,9 @@ void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
         ssolver::SReacdef * srdef = patchdef()->sreacdef(i);
         auto * sr = new SReac(srdef, this);
         AssertLog(sr != nullptr);
-        pKProcs[j++] = sr;
-        tex->addKProc(sr);
+        pKProcs[j] = sr;
+        tex->addKProc(sr, first + j);
+        ++j;
     }
 
     uint nsdiffs = patchdef()->countSurfDiffs();
@@ -253,8 +259,9 @@ void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
         ssolver::Diffdef * sddef = patchdef()->surfdiffdef(i);
         auto * sd = new SDiff(sddef, this);
         AssertLog(sd != nullptr);
-        pKProcs[j++] = sd;
-        tex->addKProc(sd);
+        pKProcs[j] = sd;
+        tex->addKProc(sd, first + j);
+        ++j;
     }
 
 
@@ -266,8 +273,9 @@ void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
             ssolver::VDepTransdef * vdtdef = patchdef()->vdeptransdef(i);
             auto * vdt = new VDepTrans(vdtdef, this);
             AssertLog(vdt != nullptr);
-            pKProcs[j++] = vdt;
-            tex->addKProc(vdt);
+            pKProcs[j] = vdt;
+            tex->addKProc(vdt, first + j);
+            ++j;
         }
 
         uint nvdsreacs = patchdef()->countVDepSReacs();
@@ -276,8 +284,9 @@ void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
             ssolver::VDepSReacdef * vdsrdef = patchdef()->vdepsreacdef(i);
             auto * vdsr = new VDepSReac(vdsrdef, this);
             AssertLog(vdsr != nullptr);
-            pKProcs[j++] = vdsr;
-            tex->addKProc(vdsr);
+            pKProcs[j] = vdsr;
+            tex->addKProc(vdsr, first + j);
+            ++j;
         }
 
         uint nghkcurrs = patchdef()->countGHKcurrs();
@@ -286,10 +295,12 @@ void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
             ssolver::GHKcurrdef * ghkdef = patchdef()->ghkcurrdef(i);
             auto * ghk = new GHKcurr(ghkdef, this);
             AssertLog(ghk != nullptr);
-            pKProcs[j++] = ghk;
-            tex->addKProc(ghk);
+            pKProcs[j] = ghk;
+            tex->addKProc(ghk, first + j);
+            ++j;
         }
     }
+    AssertLog(j == pKProcs.size());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -518,6 +529,31 @@ double stex::Tri::computeI(double v, double dt, double simtime, double efdt)
         double n = pOCchan_timeintg[i]/dt;
         current += (n*ocdef->getG())*(v-ocdef->getERev());
     }
+    current += computeGHKI(dt, efdt, simtime);
+    resetOCintegrals();
+
+    return current;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::Tri::setupOhmicCurrents(ssolver::efield::OhmicCurrents & ocs,
+                                 index_t slot, index_t vidx)
+{
+    uint nocs = patchdef()->countOhmicCurrs();
+    for (uint i = 0; i < nocs; ++i)
+    {
+        ssolver::OhmicCurrdef * ocdef = patchdef()->ohmiccurrdef(i);
+        ocs.add(slot, vidx, ocdef->getG(), ocdef->getERev(),
+                &pPoolCount[patchdef()->ohmiccurr_chanstate(i)],
+                &pOCchan_timeintg[i], &pOCtime_upd[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double stex::Tri::computeGHKI(double dt, double efdt, double simtime)
+{
     uint nghkcurrs = pPatchdef->countGHKcurrs();
     int efcharge=0;
     for (uint i =0; i < nghkcurrs; ++i)
@@ -527,13 +563,10 @@ double stex::Tri::computeI(double v, double dt, double simtime, double efdt)
 
     // The contribution from GHK charge movement.
     auto efcharged = static_cast<double>(efcharge);
-
-    // Convert charge to coulombs and find mean current
-    current += ((efcharged*steps::math::E_CHARGE)/dt);
     resetECharge(dt, efdt, simtime);
-    resetOCintegrals();
 
-    return current;
+    // Convert charge to coulombs and find mean current
+    return ((efcharged*steps::math::E_CHARGE)/dt);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
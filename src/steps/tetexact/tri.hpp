@@ -39,6 +39,7 @@
 #include "util/common.h"
 #include "kproc.hpp"
 #include "solver/patchdef.hpp"
+#include "solver/efield/ohmiccurrents.hpp"
 #include "solver/types.hpp"
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -113,10 +114,15 @@ public:
     void setNextTri(uint i, stex::Tri * t);
 
 
+    /// Size the kproc list, before setupKProcs().
+    ///
+    void resizeKProcs(bool efield = false);
+
     /// Create the kinetic processes -- to be called when all tetrahedrons
-    /// and triangles have been fully declared and connected.
+    /// and triangles have been fully declared and connected. They get the
+    /// schedule indices starting at first.
     ///
-    void setupKProcs(stex::Tetexact * tex, bool efield = false);
+    void setupKProcs(stex::Tetexact * tex, uint first, bool efield = false);
 
     /// Set all pool flags and molecular populations to zero.
     void reset();
@@ -195,6 +201,15 @@ public:
 
     double computeI(double v, double dt, double simtime, double efdt);
 
+    // Register the ohmic currents of this triangle in a batch, see
+    // steps::solver::efield::OhmicCurrents::add
+    void setupOhmicCurrents(steps::solver::efield::OhmicCurrents & ocs,
+                            index_t slot, index_t vidx);
+
+    // The GHK part of computeI: mean current of the GHK charge movements
+    // over dt, then reset the charges
+    double computeGHKI(double dt, double efdt, double simtime);
+
     double getOhmicI(double v, double dt) const;
     double getOhmicI(uint lidx, double v,double dt) const;
 
@@ -0,0 +1,295 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+// STL headers.
+#include <algorithm>
+
+// STEPS headers.
+#include "updtemplate.hpp"
+#include "kproc.hpp"
+#include "tet.hpp"
+#include "tri.hpp"
+#include "wmvol.hpp"
+
+// logging
+#include "util/error.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stex = steps::tetexact;
+
+////////////////////////////////////////////////////////////////////////////////
+
+stex::UpdTemplate::UpdTemplate(std::vector<Group> groups)
+: pGroups(std::move(groups))
+{
+    for (auto const& g: pGroups) {
+        pSize += static_cast<uint>(g.kprocs.size());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+stex::UpdHome stex::UpdTemplate::follow(UpdHome home, Path const & path)
+{
+    for (auto const& hop: path)
+    {
+        switch (hop.kind)
+        {
+            case Hop::VolTri:
+                home = home.vol->nexttris()[hop.index];
+                break;
+            case Hop::TetTet:
+                // only followed from the tetrahedron it was recorded from
+                home = UpdHome(static_cast<WmVol*>(static_cast<Tet*>(home.vol)->nextTet(hop.index)));
+                break;
+            case Hop::TriITet:
+                home = home.tri->iTet();
+                break;
+            case Hop::TriOTet:
+                home = home.tri->oTet();
+                break;
+            case Hop::TriTri:
+                home = home.tri->nextTri(hop.index);
+                break;
+        }
+        if (home.vol == nullptr && home.tri == nullptr) {
+            break;
+        }
+    }
+    return home;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::UpdTemplate::resolve(UpdHome home, std::vector<KProc*> & out) const
+{
+    for (auto const& g: pGroups)
+    {
+        const UpdHome elem = follow(home, g.path);
+        AssertLog(elem.vol != nullptr || elem.tri != nullptr);
+        KProc * const * kprocs = elem.vol != nullptr ? elem.vol->kprocs().data()
+                                                     : elem.tri->kprocs().data();
+        for (auto k: g.kprocs) {
+            out.push_back(kprocs[k]);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t stex::UpdTemplate::memory() const
+{
+    std::size_t mem = sizeof(UpdTemplate) + pGroups.capacity() * sizeof(Group);
+    for (auto const& g: pGroups) {
+        mem += g.path.capacity() * sizeof(Hop) + g.kprocs.capacity() * sizeof(uint);
+    }
+    return mem;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+stex::UpdTemplatePool::UpdTemplatePool()
+{
+#ifdef _OPENMP
+    pNbh.resize(omp_get_max_threads());
+#else
+    pNbh.resize(1);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::UpdTemplatePool::addElement(UpdHome elem)
+{
+    auto const& kprocs = elem.vol != nullptr ? elem.vol->kprocs() : elem.tri->kprocs();
+    for (uint k = 0; k < kprocs.size(); ++k)
+    {
+        const auto idx = kprocs[k]->schedIDX();
+        if (idx >= pLocations.size()) {
+            pLocations.resize(idx + 1);
+        }
+        pLocations[idx] = Location{elem, k};
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::UpdTemplatePool::_setupNeighbourhood(Neighbourhood & nbh, UpdHome home)
+{
+    typedef UpdTemplate::Hop Hop;
+
+    nbh.home = home;
+    nbh.elems.clear();
+    nbh.index.clear();
+    nbh.elems.emplace_back(home, UpdTemplate::Path());
+    nbh.index.emplace(_key(home), 0);
+
+    auto visit = [&](UpdHome elem, UpdTemplate::Path const & path, Hop hop) {
+        if (elem.vol == nullptr && elem.tri == nullptr) return;
+        if (!nbh.index.emplace(_key(elem), nbh.elems.size()).second) return;
+        UpdTemplate::Path p(path);
+        p.push_back(hop);
+        nbh.elems.emplace_back(elem, std::move(p));
+    };
+
+    // breadth first, two levels
+    std::size_t level_begin = 0;
+    for (uint level = 0; level < 2; ++level)
+    {
+        const auto level_end = nbh.elems.size();
+        for (auto e = level_begin; e < level_end; ++e)
+        {
+            // copies: nbh.elems grows while visiting
+            const UpdHome elem = nbh.elems[e].first;
+            const UpdTemplate::Path path = nbh.elems[e].second;
+            if (elem.vol != nullptr)
+            {
+                auto const& tris = elem.vol->nexttris();
+                for (uint i = 0; i < tris.size(); ++i) {
+                    visit(tris[i], path, Hop{Hop::VolTri, i});
+                }
+                auto tet = dynamic_cast<Tet*>(elem.vol);
+                if (tet != nullptr)
+                {
+                    for (uint i = 0; i < 4; ++i) {
+                        visit(static_cast<WmVol*>(tet->nextTet(i)), path, Hop{Hop::TetTet, i});
+                    }
+                }
+            }
+            else
+            {
+                visit(elem.tri->iTet(), path, Hop{Hop::TriITet, 0});
+                visit(elem.tri->oTet(), path, Hop{Hop::TriOTet, 0});
+                for (uint i = 0; i < 3; ++i) {
+                    visit(elem.tri->nextTri(i), path, Hop{Hop::TriTri, i});
+                }
+            }
+        }
+        level_begin = level_end;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t stex::UpdTemplatePool::_find(Neighbourhood const & nbh, UpdHome elem)
+{
+    auto it = nbh.index.find(_key(elem));
+    return it != nbh.index.end() ? it->second : nbh.elems.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+stex::UpdTemplate const * stex::UpdTemplatePool::get(UpdHome home, std::set<KProc*> const & deps)
+{
+    AssertLog(home.vol != nullptr || home.tri != nullptr);
+
+#ifdef _OPENMP
+    const auto tid = static_cast<std::size_t>(omp_get_thread_num());
+#else
+    const std::size_t tid = 0;
+#endif
+    AssertLog(tid < pNbh.size());
+    Neighbourhood & nbh = pNbh[tid];
+
+    // Kinetic processes of the same element are set up one after another.
+    if (!(home == nbh.home)) {
+        _setupNeighbourhood(nbh, home);
+    }
+
+    // Group the dependencies by type, then by element in breadth first
+    // order, then by index in the kproc list of the element.
+    auto & deps_by_type = nbh.deps;
+    deps_by_type.clear();
+    for (auto k: deps)
+    {
+        AssertLog(k->schedIDX() < pLocations.size());
+        Location const & loc = pLocations[k->schedIDX()];
+        const auto e = _find(nbh, loc.elem);
+        if (e == nbh.elems.size()) {
+            ProgErrLog("Dependent kinetic process is more than two elements away.");
+        }
+        deps_by_type.emplace_back(k->type(), e, loc.idx);
+    }
+    std::sort(deps_by_type.begin(), deps_by_type.end());
+
+    std::vector<UpdTemplate::Group> groups;
+    for (std::size_t d = 0; d < deps_by_type.size(); ++d)
+    {
+        const auto type = std::get<0>(deps_by_type[d]);
+        const auto e = std::get<1>(deps_by_type[d]);
+        if (d == 0 || type != std::get<0>(deps_by_type[d - 1]) ||
+            e != std::get<1>(deps_by_type[d - 1])) {
+            groups.push_back(UpdTemplate::Group{type, nbh.elems[e].second, {}});
+        }
+        groups.back().kprocs.push_back(std::get<2>(deps_by_type[d]));
+    }
+
+    UpdTemplate candidate(std::move(groups));
+    UpdTemplate const * tmpl;
+    #pragma omp critical(steps_tetexact_updtemplatepool)
+    {
+        ++pNLists;
+        pVectorMemory += sizeof(std::vector<KProc*>) + deps.size() * sizeof(KProc*);
+        // most templates are already there, don't allocate a node for them
+        auto it = pTemplates.find(candidate);
+        if (it == pTemplates.end()) {
+            it = pTemplates.insert(std::move(candidate)).first;
+        }
+        tmpl = &*it;
+    }
+    return tmpl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::UpdTemplatePool::finishSetup()
+{
+    std::vector<Location>().swap(pLocations);
+    for (auto & nbh: pNbh) {
+        nbh = Neighbourhood();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t stex::UpdTemplatePool::memory() const
+{
+    // one pointer per update list, plus the node overhead of the set
+    std::size_t mem = pNLists * sizeof(UpdTemplate const *);
+    for (auto const& t: pTemplates) {
+        mem += t.memory() + 4 * sizeof(void*);
+    }
+    return mem;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// END
@@ -0,0 +1,255 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_TETEXACT_UPDTEMPLATE_HPP
+#define STEPS_TETEXACT_UPDTEMPLATE_HPP 1
+
+// STL headers.
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+// STEPS headers.
+#include "util/common.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace tetexact {
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Forward declarations.
+class KProc;
+enum class KProcType : unsigned char;
+class Tri;
+class WmVol;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Element owning a kinetic process: a volume (WmVol or Tet) or a triangle.
+struct UpdHome
+{
+    UpdHome() = default;
+    UpdHome(WmVol * v) : vol(v) {}
+    UpdHome(Tri * t) : tri(t) {}
+
+    bool operator==(UpdHome const & h) const noexcept
+    { return vol == h.vol && tri == h.tri; }
+
+    WmVol *                             vol{nullptr};
+    Tri *                               tri{nullptr};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Dependency template of a kinetic process.
+///
+/// Lists the kinetic processes to update after a kinetic process fired, not
+/// by address but relative to the element owning it: a path of at most two
+/// hops through the mesh connectivity, and the index of the kinetic process
+/// in the kproc list of the element at the end of that path. All kinetic
+/// processes of a given type in elements with the same neighbourhood (e.g.
+/// the tetrahedrons inside a compartment) then have the same dependency
+/// template, which is stored only once in the UpdTemplatePool.
+///
+class UpdTemplate
+{
+public:
+
+    /// One hop through the mesh connectivity.
+    struct Hop
+    {
+        enum Kind : unsigned char {
+            VolTri,     ///< WmVol::nexttris()[index]
+            TetTet,     ///< Tet::nextTet(index)
+            TriITet,    ///< Tri::iTet()
+            TriOTet,    ///< Tri::oTet()
+            TriTri      ///< Tri::nextTri(index)
+        };
+
+        Kind                            kind;
+        uint                            index;
+
+        bool operator<(Hop const & h) const noexcept
+        { return kind < h.kind || (kind == h.kind && index < h.index); }
+        bool operator==(Hop const & h) const noexcept
+        { return kind == h.kind && index == h.index; }
+    };
+
+    /// Path from the owning element, empty for the owning element itself.
+    typedef std::vector<Hop>            Path;
+
+    /// Kinetic processes of one type of the element at the end of a path,
+    /// by index in its kproc list.
+    struct Group
+    {
+        KProcType                       type;
+        Path                            path;
+        std::vector<uint>               kprocs;
+
+        bool operator<(Group const & g) const noexcept
+        { return type < g.type || (type == g.type && (path < g.path ||
+                 (path == g.path && kprocs < g.kprocs))); }
+    };
+
+    explicit UpdTemplate(std::vector<Group> groups);
+
+    bool operator<(UpdTemplate const & t) const noexcept
+    { return pGroups < t.pGroups; }
+
+    /// Append to out the kinetic processes this template refers to, relative
+    /// to home. Kinetic processes of the same type are appended one after
+    /// another.
+    void resolve(UpdHome home, std::vector<KProc*> & out) const;
+
+    /// Number of kinetic processes this template refers to.
+    inline uint size() const noexcept
+    { return pSize; }
+
+    inline std::vector<Group> const & groups() const noexcept
+    { return pGroups; }
+
+    /// Memory used by this template in bytes.
+    std::size_t memory() const;
+
+    /// Follow path from home, return an empty UpdHome if one of the
+    /// elements along the way doesn't exist.
+    static UpdHome follow(UpdHome home, Path const & path);
+
+private:
+
+    std::vector<Group>                  pGroups;
+    uint                                pSize{0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// The kinetic processes to update after a kinetic process fired.
+struct UpdList
+{
+    UpdTemplate const *                 tmpl;
+    UpdHome                             home;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Owner of the dependency templates of all kinetic processes of a solver.
+///
+/// Templates are interned: kinetic processes with identical dependencies
+/// relative to their owning element share a single template.
+///
+/// get() can be called concurrently from OpenMP threads, for different
+/// elements. Each thread caches the neighbourhood of the element it is
+/// setting up.
+///
+class UpdTemplatePool
+{
+public:
+
+    UpdTemplatePool();
+
+    /// Record the kproc list of an element. Must be called for all elements
+    /// before any call to get().
+    void addElement(UpdHome elem);
+
+    /// Return the template listing deps relative to home. All deps must be
+    /// owned by home or by an element at most two hops away from it.
+    UpdTemplate const * get(UpdHome home, std::set<KProc*> const & deps);
+
+    /// Release the data only needed while the templates are being built.
+    void finishSetup();
+
+    /// Number of distinct templates.
+    inline std::size_t countTemplates() const noexcept
+    { return pTemplates.size(); }
+
+    /// Number of update lists, i.e. calls to get().
+    inline std::size_t countLists() const noexcept
+    { return pNLists; }
+
+    /// Memory used by the templates and the references to them, in bytes.
+    std::size_t memory() const;
+
+    /// Memory the same update lists use when stored as one vector of
+    /// kinetic process pointers each, in bytes.
+    inline std::size_t vectorMemory() const noexcept
+    { return pVectorMemory; }
+
+private:
+
+    /// Elements at most two hops away from an element, with their first
+    /// path in breadth first order.
+    struct Neighbourhood
+    {
+        UpdHome                         home;
+        std::vector<std::pair<UpdHome, UpdTemplate::Path>> elems;
+        /// Index in elems of each element of the neighbourhood
+        std::map<void const *, std::size_t> index;
+        /// Scratch space of get(): type, index in elems and index in the
+        /// kproc list of each dependency
+        std::vector<std::tuple<KProcType, std::size_t, uint>> deps;
+    };
+
+    static void _setupNeighbourhood(Neighbourhood & nbh, UpdHome home);
+
+    static inline void const * _key(UpdHome elem) noexcept
+    { return elem.vol != nullptr ? static_cast<void const *>(elem.vol)
+                                 : static_cast<void const *>(elem.tri); }
+
+    /// Index of elem in nbh.elems, nbh.elems.size() if it is not part of
+    /// the neighbourhood.
+    static std::size_t _find(Neighbourhood const & nbh, UpdHome elem);
+
+    struct Location
+    {
+        UpdHome                         elem;
+        uint                            idx;
+    };
+
+    std::set<UpdTemplate>               pTemplates;
+
+    /// Location of each kinetic process, by schedule index.
+    std::vector<Location>               pLocations;
+
+    /// Neighbourhood cache, by OpenMP thread number.
+    std::vector<Neighbourhood>          pNbh;
+
+    std::size_t                         pNLists{0};
+    std::size_t                         pVectorMemory{0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif
+
+// STEPS_TETEXACT_UPDTEMPLATE_HPP
+
+// END
@@ -48,9 +48,9 @@ namespace smath = steps::math;
 
 stex::VDepSReac::VDepSReac(ssolver::VDepSReacdef * vdsrdef, stex::Tri * tri)
 :
- pVDepSReacdef(vdsrdef)
+ KProc(KProcType::VDepSReac)
+, pVDepSReacdef(vdsrdef)
 , pTri(tri)
-, pUpdVec()
 , pScaleFactor(0.0)
 {
     AssertLog(pVDepSReacdef != nullptr);
@@ -138,7 +138,7 @@ void stex::VDepSReac::reset()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::VDepSReac::setupDeps()
+void stex::VDepSReac::setupDeps(UpdTemplatePool & pool)
 {
     // For all non-zero entries gidx in SReacDef's UPD_S:
     //   Perform depSpecTri(gidx,tri()) for:
@@ -216,7 +216,7 @@ void stex::VDepSReac::setupDeps()
         }
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdTemplate = pool.get(pTri, updset);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -407,7 +407,7 @@ double stex::VDepSReac::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::VDepSReac::apply(const rng::RNGptr &/*rng*/, double dt, double simtime)
+stex::UpdList stex::VDepSReac::apply(const rng::RNGptr &/*rng*/, double dt, double simtime)
 {
     // NOTE: simtime is BEFORE the update has taken place
 
@@ -485,7 +485,7 @@ std::vector<stex::KProc*> const & stex::VDepSReac::apply(const rng::RNGptr &/*rn
 
     rExtent++;
 
-    return pUpdVec;
+    return UpdList{pUpdTemplate, pTri};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
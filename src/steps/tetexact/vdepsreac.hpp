@@ -54,7 +54,7 @@ class Tetexact;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class VDepSReac
+class VDepSReac final
 : public steps::tetexact::KProc
 {
 
@@ -80,16 +80,16 @@ public:
     // VIRTUAL INTERFACE METHODS
     ////////////////////////////////////////////////////////////////////////
 
-    void setupDeps() override;
+    void setupDeps(UpdTemplatePool & pool) override;
     bool depSpecTet(uint gidx, steps::tetexact::WmVol * tet) override;
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri) override;
     void reset() override;
 
     double rate(steps::tetexact::Tetexact * solver = nullptr) override;
-    std::vector<KProc*> const & apply(const rng::RNGptr &rng, double dt, double simtime) override;
+    UpdList apply(const rng::RNGptr &rng, double dt, double simtime) override;
 
     uint updVecSize() const noexcept override
-    { return static_cast<uint>(pUpdVec.size()); }
+    { return pUpdTemplate->size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -99,7 +99,7 @@ private:
 
     steps::solver::VDepSReacdef       * pVDepSReacdef;
     steps::tetexact::Tri              * pTri;
-    std::vector<KProc*>                   pUpdVec;
+    UpdTemplate const *                   pUpdTemplate{nullptr};
 
     // The information about the size of the comaprtment or patch, and the
     // dimensions. Important for scaling the constant.
@@ -46,9 +46,9 @@ namespace ssolver = steps::solver;
 
 stex::VDepTrans::VDepTrans(ssolver::VDepTransdef * vdtdef, stex::Tri * tri)
 :
- pVDepTransdef(vdtdef)
+ KProc(KProcType::VDepTrans)
+, pVDepTransdef(vdtdef)
 , pTri(tri)
-, pUpdVec()
 {
     AssertLog(pVDepTransdef != nullptr);
     AssertLog(pTri != nullptr);
@@ -99,7 +99,7 @@ void stex::VDepTrans::reset()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::VDepTrans::setupDeps()
+void stex::VDepTrans::setupDeps(UpdTemplatePool & pool)
 {
     std::set<stex::KProc*> updset;
 
@@ -111,7 +111,7 @@ void stex::VDepTrans::setupDeps()
         }
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdTemplate = pool.get(pTri, updset);
 
 }
 
@@ -149,7 +149,7 @@ double stex::VDepTrans::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::VDepTrans::apply(const rng::RNGptr &/*rng*/, double dt, double simtime)
+stex::UpdList stex::VDepTrans::apply(const rng::RNGptr &/*rng*/, double dt, double simtime)
 {
     ssolver::Patchdef * pdef = pTri->patchdef();
     uint lidx = pdef->vdeptransG2L(pVDepTransdef->gidx());
@@ -188,7 +188,7 @@ std::vector<stex::KProc*> const & stex::VDepTrans::apply(const rng::RNGptr &/*rn
 
     rExtent++;
 
-    return pUpdVec;
+    return UpdList{pUpdTemplate, pTri};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,7 +53,7 @@ class Tetexact;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class VDepTrans
+class VDepTrans final
 : public steps::tetexact::KProc
 {
 
@@ -79,17 +79,17 @@ public:
     // VIRTUAL INTERFACE METHODS
     ////////////////////////////////////////////////////////////////////////
 
-    void setupDeps() override;
+    void setupDeps(UpdTemplatePool & pool) override;
     bool depSpecTet(uint gidx, steps::tetexact::WmVol * tet) override;
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri) override;
     void reset() override;
 
     double rate(steps::tetexact::Tetexact * solver) override;
 
-    std::vector<KProc*> const & apply(const rng::RNGptr &rng, double dt, double simtime) override;
+    UpdList apply(const rng::RNGptr &rng, double dt, double simtime) override;
 
     inline uint updVecSize() const override
-    { return static_cast<uint>(pUpdVec.size()); }
+    { return pUpdTemplate->size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -99,7 +99,7 @@ private:
 
     steps::solver::VDepTransdef       * pVDepTransdef;
     steps::tetexact::Tri              * pTri;
-    std::vector<KProc*>                 pUpdVec;
+    UpdTemplate const *                 pUpdTemplate{nullptr};
 
     ////////////////////////////////////////////////////////////////////////
 
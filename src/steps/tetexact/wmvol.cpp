@@ -109,7 +109,7 @@ void stex::WmVol::setNextTri(stex::Tri * t)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::WmVol::setupKProcs(stex::Tetexact * tex)
+void stex::WmVol::setupKProcs(stex::Tetexact * tex, uint first)
 {
 
     uint j = 0;
@@ -122,8 +122,9 @@ void stex::WmVol::setupKProcs(stex::Tetexact * tex)
     {
         ssolver::Reacdef * rdef = compdef()->reacdef(i);
         auto * r = new stex::Reac(rdef, this);
-        pKProcs[j++] = r;
-        tex->addKProc(r);
+        pKProcs[j] = r;
+        tex->addKProc(r, first + j);
+        ++j;
     }
 
 }
@@ -100,9 +100,10 @@ public:
     ////////////////////////////////////////////////////////////////////////
 
     /// Create the kinetic processes -- to be called when all tetrahedrons
-    /// and triangles have been fully declared and connected.
+    /// and triangles have been fully declared and connected. They get the
+    /// schedule indices starting at first.
     ///
-    virtual void setupKProcs(stex::Tetexact * tex);
+    virtual void setupKProcs(stex::Tetexact * tex, uint first);
 
     virtual void setNextTri(stex::Tri *t);
 
@@ -133,6 +134,10 @@ public:
 
     inline const std::vector<uint>& pools() const noexcept
     { return pPoolCount; }
+    /// The pools as an array, for the rate tables of the solver which apply
+    /// the reacs of this element in place.
+    inline uint * poolData() noexcept
+    { return pPoolCount.data(); }
     void setCount(uint lidx, uint count);
     void incCount(uint lidx, int inc);
 
@@ -0,0 +1,142 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+// Standard library & STL headers.
+#include <algorithm>
+#include <cmath>
+
+// STEPS headers.
+#include "blockjacobi.hpp"
+#include "util/error.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace stode = steps::tetode;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stode::BlockJacobi::init(std::vector<uint> block_start)
+{
+    AssertLog(!block_start.empty() && block_start.front() == 0);
+
+    pBlockStart = std::move(block_start);
+    const auto nblocks = pBlockStart.size() - 1;
+    pBlockOffset.assign(nblocks + 1, 0);
+    for (uint b = 0; b < nblocks; ++b) {
+        const uint n = pBlockStart[b + 1] - pBlockStart[b];
+        pBlockOffset[b + 1] = pBlockOffset[b] + n * n;
+    }
+    pJac.assign(pBlockOffset.back(), 0.0);
+    pLU.assign(pBlockOffset.back(), 0.0);
+    pPivots.assign(pBlockStart.back(), 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stode::BlockJacobi::setJacobian(std::vector<uint> const & rowptr,
+                                     std::vector<uint> const & col,
+                                     std::vector<double> const & val)
+{
+    AssertLog(rowptr.size() == pBlockStart.back() + 1);
+
+    std::fill(pJac.begin(), pJac.end(), 0.0);
+    const auto nblocks = pBlockStart.size() - 1;
+    for (uint b = 0; b < nblocks; ++b) {
+        const uint first = pBlockStart[b];
+        const uint n = pBlockStart[b + 1] - first;
+        double *J = pJac.data() + pBlockOffset[b];
+        for (uint i = first; i < first + n; ++i) {
+            for (uint k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+                const uint j = col[k];
+                if (j >= first && j < first + n) J[(i - first) * n + (j - first)] = val[k];
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool stode::BlockJacobi::factor(double gamma)
+{
+    const auto nblocks = pBlockStart.size() - 1;
+    for (uint b = 0; b < nblocks; ++b) {
+        const uint first = pBlockStart[b];
+        const uint n = pBlockStart[b + 1] - first;
+        const double *J = pJac.data() + pBlockOffset[b];
+        double *P = pLU.data() + pBlockOffset[b];
+        uint *piv = pPivots.data() + first;
+
+        for (uint k = 0; k < n * n; ++k) P[k] = -gamma * J[k];
+        for (uint i = 0; i < n; ++i) P[i * n + i] += 1.0;
+
+        for (uint k = 0; k < n; ++k) {
+            uint pk = k;
+            for (uint i = k + 1; i < n; ++i) {
+                if (std::abs(P[i * n + k]) > std::abs(P[pk * n + k])) pk = i;
+            }
+            if (P[pk * n + k] == 0.0) return false;
+            piv[k] = pk;
+            if (pk != k) {
+                std::swap_ranges(P + k * n, P + (k + 1) * n, P + pk * n);
+            }
+            for (uint i = k + 1; i < n; ++i) {
+                const double l = P[i * n + k] /= P[k * n + k];
+                for (uint j = k + 1; j < n; ++j) P[i * n + j] -= l * P[k * n + j];
+            }
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stode::BlockJacobi::solve(double * x) const
+{
+    const auto nblocks = pBlockStart.size() - 1;
+    for (uint b = 0; b < nblocks; ++b) {
+        const uint first = pBlockStart[b];
+        const uint n = pBlockStart[b + 1] - first;
+        const double *P = pLU.data() + pBlockOffset[b];
+        const uint *piv = pPivots.data() + first;
+        double *xb = x + first;
+
+        for (uint k = 0; k < n; ++k) {
+            if (piv[k] != k) std::swap(xb[k], xb[piv[k]]);
+        }
+        for (uint i = 1; i < n; ++i) {
+            for (uint j = 0; j < i; ++j) xb[i] -= P[i * n + j] * xb[j];
+        }
+        for (uint i = n; i-- > 0;) {
+            for (uint j = i + 1; j < n; ++j) xb[i] -= P[i * n + j] * xb[j];
+            xb[i] /= P[i * n + i];
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// END
@@ -0,0 +1,103 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_TETODE_BLOCKJACOBI_HPP
+#define STEPS_TETODE_BLOCKJACOBI_HPP 1
+
+// STL headers.
+#include <vector>
+
+// STEPS headers.
+#include "util/common.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace tetode {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Block-Jacobi preconditioner of the stiff TetODE solver.
+///
+/// Approximates I - gamma*J by its diagonal blocks, one per tetrahedron and
+/// per triangle, each stored densely and LU-factorised with partial pivoting.
+///
+class BlockJacobi
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Set the blocks.
+    ///
+    /// \param block_start First row of each block, followed by the number of
+    ///        rows.
+    void init(std::vector<uint> block_start);
+
+    /// Copy the diagonal blocks of the jacobian J, given in CSR format.
+    void setJacobian(std::vector<uint> const & rowptr,
+                     std::vector<uint> const & col,
+                     std::vector<double> const & val);
+
+    /// LU-factorise the blocks of I - gamma*J.
+    ///
+    /// Return false on a zero pivot, in which case solve() must not be
+    /// called before the next successful factorisation.
+    bool factor(double gamma);
+
+    /// Solve (I - gamma*J) x = b with the factorised blocks, in place.
+    void solve(double * x) const;
+
+    inline std::vector<uint> const & blockStart() const noexcept
+    { return pBlockStart; }
+
+    ////////////////////////////////////////////////////////////////////////
+
+private:
+
+    std::vector<uint>                   pBlockStart;
+    // position of each block in pJac and pLU
+    std::vector<uint>                   pBlockOffset;
+    // diagonal blocks of J, and LU factors of I - gamma*J
+    std::vector<double>                 pJac;
+    std::vector<double>                 pLU;
+    std::vector<uint>                   pPivots;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
+
+// STEPS_TETODE_BLOCKJACOBI_HPP
+
+// END
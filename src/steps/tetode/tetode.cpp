@@ -25,7 +25,9 @@
  */
 
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -35,8 +37,15 @@
 #include <sundials/sundials_dense.h>     /* definitions DlsMat DENSE_ELEM */
 #include <sundials/sundials_nvector.h>
 #include <sundials/sundials_types.h>     /* definition of type realtype */
+#if STEPS_SUNDIALS_VERSION_MAJOR >= 4
+#include <cvode/cvode_ls.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
+#else
+#include <cvode/cvode_spgmr.h>           /* CVSpgmr, CVSpils* */
+#endif
 
 #include "tetode.hpp"
+#include "blockjacobi.hpp"
 
 #include "math/constants.hpp"
 #include "math/point.hpp"
@@ -120,11 +129,30 @@ namespace tetode {
    // Memory block for CVODE
    void     * cvode_mem_cvode;
 
+   // BDF and Newton iteration instead of Adams and functional iteration
+   bool stiff{false};
+#if STEPS_SUNDIALS_VERSION_MAJOR >= 4
+   SUNLinearSolver linsol_cvode{nullptr};
+#endif
+
+   // Preconditioner, with one block per tetrahedron and per triangle
+   BlockJacobi prec;
+
+   // Jacobian of f_cvode in CSR format, evaluated at jac_y
+   std::vector<uint> jac_rowptr;
+   std::vector<uint> jac_col;
+   std::vector<realtype> jac_val;
+   std::vector<realtype> jac_y;
+   // Position in jac_val of each derivative term, in the order of
+   // pSpec_matrixsub traversal
+   std::vector<uint> jac_pos;
+
    CVodeState(uint N_, uint maxn, double atol, double rtol);
    ~CVodeState();
 
    void setTolerances(double atol, double rtol);
    void setMaxNumSteps(uint maxn);
+   void setStiff(bool s);
    int  initialise();
    int  reinit(realtype starttime);
 
@@ -132,6 +160,13 @@ namespace tetode {
 
    void checkpoint(std::fstream &);
    void restore(std::fstream &);
+
+   void create();
+   void buildJacobian();
+   void evalJacobian(N_Vector y);
+   int  precSetup(N_Vector y, bool jok, booleantype *jcurPtr, realtype gamma);
+   int  precSolve(N_Vector r, N_Vector z);
+   int  jacTimes(N_Vector v, N_Vector Jv, N_Vector y);
  };
 
 void check_flag(void *flagvalue, const char *funcname, int opt)
@@ -181,27 +216,34 @@ CVodeState::CVodeState(uint N_, uint maxn, realtype atol, realtype rtol) {
         Ith(abstol_cvode, i) = atol;
     }
 
+    // Initialise y:
+    for (uint i=0; i<N; ++i)
+    {
+        Ith(y_cvode, i) = 0.0;
+    }
+
+    create();
+}
+
+void CVodeState::create() {
     // Call CVodeCreate to create the solver memory and specify the
     // Backward Differentiation Formula and the use of a Newton iteration
     //cvode_mem_cvode = CVodeCreate(CV_BDF, CV_NEWTON);
     // NO- the above choice eats up memory like you wouldn't believe
     // and causes segmentation faults
+    // (with the dense solver; the stiff option below uses a Krylov solver
+    // which only stores a few vectors)
 
     // ADAMS and FUNCTIONAL are a much much better choice
     #if STEPS_SUNDIALS_VERSION_MAJOR >= 4
-        cvode_mem_cvode = CVodeCreate(CV_ADAMS);
+        cvode_mem_cvode = CVodeCreate(stiff ? CV_BDF : CV_ADAMS);
     #else
-        cvode_mem_cvode = CVodeCreate(CV_ADAMS, CV_FUNCTIONAL);
+        cvode_mem_cvode = stiff ? CVodeCreate(CV_BDF, CV_NEWTON)
+                                : CVodeCreate(CV_ADAMS, CV_FUNCTIONAL);
     #endif
 
     check_flag(cvode_mem_cvode, "CVodeCreate", 0);
 
-    // Initialise y:
-    for (uint i=0; i<N; ++i)
-    {
-        Ith(y_cvode, i) = 0.0;
-    }
-
     // Call CVodeInit to initialize the integrator memory and specify the
     // user's right hand side function in y'=f(t,y), the initial time T0, and
     // the initial dependent variable vector y.
@@ -219,6 +261,9 @@ CVodeState::~CVodeState() {
 
     /* Free integrator memory */
     CVodeFree(&cvode_mem_cvode);
+#if STEPS_SUNDIALS_VERSION_MAJOR >= 4
+    if (linsol_cvode != nullptr) SUNLinSolFree(linsol_cvode);
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -284,6 +329,57 @@ void CVodeState::setMaxNumSteps(uint maxn) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CVodeState::setStiff(bool s) {
+    if (s == stiff) return;
+
+    // The integration method can only be chosen at creation
+    CVodeFree(&cvode_mem_cvode);
+#if STEPS_SUNDIALS_VERSION_MAJOR >= 4
+    if (linsol_cvode != nullptr) SUNLinSolFree(linsol_cvode);
+    linsol_cvode = nullptr;
+#endif
+    stiff = s;
+    create();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if STEPS_SUNDIALS_VERSION_MAJOR >= 4
+static int psetup_cvode(realtype /*t*/, N_Vector y, N_Vector /*fy*/,
+                        booleantype jok, booleantype *jcurPtr, realtype gamma,
+                        void *user_data)
+#else
+static int psetup_cvode(realtype /*t*/, N_Vector y, N_Vector /*fy*/,
+                        booleantype jok, booleantype *jcurPtr, realtype gamma,
+                        void *user_data, N_Vector /*tmp1*/, N_Vector /*tmp2*/,
+                        N_Vector /*tmp3*/)
+#endif
+{
+    return static_cast<CVodeState *>(user_data)->precSetup(y, jok, jcurPtr, gamma);
+}
+
+#if STEPS_SUNDIALS_VERSION_MAJOR >= 4
+static int psolve_cvode(realtype /*t*/, N_Vector /*y*/, N_Vector /*fy*/,
+                        N_Vector r, N_Vector z, realtype /*gamma*/,
+                        realtype /*delta*/, int /*lr*/, void *user_data)
+#else
+static int psolve_cvode(realtype /*t*/, N_Vector /*y*/, N_Vector /*fy*/,
+                        N_Vector r, N_Vector z, realtype /*gamma*/,
+                        realtype /*delta*/, int /*lr*/, void *user_data,
+                        N_Vector /*tmp*/)
+#endif
+{
+    return static_cast<CVodeState *>(user_data)->precSolve(r, z);
+}
+
+static int jtimes_cvode(N_Vector v, N_Vector Jv, realtype /*t*/, N_Vector y,
+                        N_Vector /*fy*/, void *user_data, N_Vector /*tmp*/)
+{
+    return static_cast<CVodeState *>(user_data)->jacTimes(v, Jv, y);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 int CVodeState::initialise() {
     int flag;
 
@@ -299,6 +395,40 @@ int CVodeState::initialise() {
     //flag = CVDense(cvode_mem_cvode, pSpecs_tot);
     //check_flag(&flag, "CVDense", 1);
 
+    if (stiff) {
+        // Newton iterations are solved with preconditioned GMRES, using the
+        // analytical jacobian for the products J*v
+        if (jac_rowptr.empty()) buildJacobian();
+        jac_y.clear();
+
+        flag = CVodeSetUserData(cvode_mem_cvode, this);
+        check_flag(&flag, "CVodeSetUserData", 1);
+
+#if STEPS_SUNDIALS_VERSION_MAJOR >= 4
+        if (linsol_cvode == nullptr) {
+            linsol_cvode = SUNLinSol_SPGMR(y_cvode, PREC_LEFT, 0);
+            check_flag(linsol_cvode, "SUNLinSol_SPGMR", 0);
+        }
+        flag = CVodeSetLinearSolver(cvode_mem_cvode, linsol_cvode, nullptr);
+        check_flag(&flag, "CVodeSetLinearSolver", 1);
+
+        flag = CVodeSetPreconditioner(cvode_mem_cvode, psetup_cvode, psolve_cvode);
+        check_flag(&flag, "CVodeSetPreconditioner", 1);
+
+        flag = CVodeSetJacTimes(cvode_mem_cvode, nullptr, jtimes_cvode);
+        check_flag(&flag, "CVodeSetJacTimes", 1);
+#else
+        flag = CVSpgmr(cvode_mem_cvode, PREC_LEFT, 0);
+        check_flag(&flag, "CVSpgmr", 1);
+
+        flag = CVSpilsSetPreconditioner(cvode_mem_cvode, psetup_cvode, psolve_cvode);
+        check_flag(&flag, "CVSpilsSetPreconditioner", 1);
+
+        flag = CVSpilsSetJacTimesVecFn(cvode_mem_cvode, jtimes_cvode);
+        check_flag(&flag, "CVSpilsSetJacTimesVecFn", 1);
+#endif
+    }
+
     return flag;
 }
 
@@ -306,9 +436,131 @@ int CVodeState::reinit(realtype starttime) {
     int flag = CVodeReInit(cvode_mem_cvode, starttime, y_cvode);
     check_flag(&flag, "CVodeInit", 1);
 
+    // reaction constants may have changed since the last evaluation
+    jac_y.clear();
+
     return flag;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+void CVodeState::buildJacobian() {
+    AssertLog(pSpec_matrixsub.size() == N);
+    AssertLog(!prec.blockStart().empty() && prec.blockStart().back() == N);
+
+    // Every factor of every reaction term contributes to the derivative with
+    // respect to its species
+    jac_rowptr.assign(1, 0);
+    jac_col.clear();
+    jac_pos.clear();
+    std::vector<uint> cols;
+    for (auto const& sp: pSpec_matrixsub) {
+        cols.clear();
+        for (auto const& r: sp) {
+            for (auto const& p: r.players) {
+                for (auto const& q: p.info) {
+                    cols.push_back(q.spec_idx);
+                }
+            }
+        }
+        auto terms = cols;
+        std::sort(cols.begin(), cols.end());
+        cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+
+        const uint row_begin = jac_rowptr.back();
+        for (auto c: terms) {
+            jac_pos.push_back(row_begin + static_cast<uint>(std::lower_bound(cols.begin(), cols.end(), c) - cols.begin()));
+        }
+        jac_col.insert(jac_col.end(), cols.begin(), cols.end());
+        jac_rowptr.push_back(static_cast<uint>(jac_col.size()));
+    }
+    jac_val.assign(jac_col.size(), 0.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CVodeState::evalJacobian(N_Vector y) {
+    std::fill(jac_val.begin(), jac_val.end(), 0.0);
+
+    auto pos = jac_pos.cbegin();
+    for (auto const& sp: pSpec_matrixsub) {
+        for (auto const& r: sp) {
+            const double c = r.upd * r.ccst;
+            for (auto const& pk: r.players) {
+                for (auto const& qk: pk.info) {
+                    double d = c;
+                    for (auto const& p: r.players) {
+                        for (auto const& q: p.info) {
+                            double val = Ith(y, q.spec_idx);
+                            if (&q == &qk) {
+                                if (q.order != 1) d *= q.order * pow(val, q.order - 1);
+                            }
+                            else {
+                                if (q.order == 1) d *= val;
+                                else d *= pow(val, q.order);
+                            }
+                        }
+                    }
+                    jac_val[*pos++] += d;
+                }
+            }
+        }
+    }
+    AssertLog(pos == jac_pos.cend());
+
+    jac_y.assign(NV_DATA_S(y), NV_DATA_S(y) + N);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int CVodeState::precSetup(N_Vector y, bool jok, booleantype *jcurPtr, realtype gamma) {
+    if (jok) {
+        *jcurPtr = false;
+    }
+    else {
+        evalJacobian(y);
+        prec.setJacobian(jac_rowptr, jac_col, jac_val);
+        *jcurPtr = true;
+    }
+
+    // a zero pivot is a recoverable failure, CVODE will retry with a
+    // smaller step
+    return prec.factor(gamma) ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int CVodeState::precSolve(N_Vector r, N_Vector z) {
+    const realtype *rd = NV_DATA_S(r);
+    realtype *zd = NV_DATA_S(z);
+    std::copy(rd, rd + N, zd);
+    prec.solve(zd);
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int CVodeState::jacTimes(N_Vector v, N_Vector Jv, N_Vector y) {
+    // The Krylov iterations of a Newton iteration all use the same y
+    const realtype *yd = NV_DATA_S(y);
+    if (jac_y.size() != N || std::memcmp(jac_y.data(), yd, N * sizeof(realtype)) != 0) {
+        evalJacobian(y);
+    }
+
+    const realtype *vd = NV_DATA_S(v);
+    realtype *Jvd = NV_DATA_S(Jv);
+    for (uint i = 0; i < N; ++i) {
+        realtype sum = 0.0;
+        for (uint k = jac_rowptr[i]; k < jac_rowptr[i + 1]; ++k) {
+            sum += jac_val[k] * vd[jac_col[k]];
+        }
+        Jvd[i] = sum;
+    }
+
+    return 0;
+}
+
 int CVodeState::run(realtype endtime) {
     realtype t;
     return CVode(cvode_mem_cvode, endtime, y_cvode, &t, CV_NORMAL);
@@ -1395,6 +1647,22 @@ void TetODE::_setup()
 
     pCVodeState = new CVodeState(pSpecs_tot, 10000, 1.0e-3, 1.0e-3);
 
+    // One block of the stiff solver preconditioner per tetrahedron and per
+    // triangle, following the species layout set up above
+    std::vector<uint> block_start(1, 0);
+    for (auto const& comp: pComps) {
+        uint nspecs = comp->def()->countSpecs();
+        if (nspecs == 0) continue;
+        for (uint t = 0; t < comp->countTets(); ++t) block_start.push_back(block_start.back() + nspecs);
+    }
+    for (auto const& patch: pPatches) {
+        uint nspecs = patch->def()->countSpecs();
+        if (nspecs == 0) continue;
+        for (uint t = 0; t < patch->countTris(); ++t) block_start.push_back(block_start.back() + nspecs);
+    }
+    AssertLog(block_start.back() == pSpecs_tot);
+    pCVodeState->prec.init(std::move(block_start));
+
     if (efflag()) _setupEField();
 
 }
@@ -1431,6 +1699,9 @@ void TetODE::_setupEField()
     case EF_DV_BDSYS:
         pEField = make_EField<dVSolverBanded>();
         break;
+    case EF_DV_PCG:
+        pEField = make_EField<dVSolverCSR>();
+        break;
     default:
         ArgErrLog("Unsupported E-Field solver.");
     }
@@ -1580,6 +1851,25 @@ void TetODE::setTolerances(double atol, double rtol)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void TetODE::setStiff(bool stiff)
+{
+    if (stiff == pCVodeState->stiff) return;
+
+    pCVodeState->setStiff(stiff);
+    // new CVODE memory, options and start time have to be set again
+    pInitialised = false;
+    pReinit = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool TetODE::getStiff() const
+{
+    return pCVodeState->stiff;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void TetODE::_addTet(tetrahedron_id_t tetidx,
                      steps::tetode::Comp *comp, double vol,
                      double a1, double a2, double a3, double a4,
@@ -404,6 +404,17 @@ public:
 
     void setMaxNumSteps(uint maxn);
 
+    /// Choose the CVODE integration method.
+    ///
+    /// By default the Adams-Moulton method with functional iteration is used,
+    /// which needs very small steps for stiff systems. If stiff is true, the
+    /// BDF method with Newton iteration is used instead, the linear systems
+    /// being solved by GMRES with the analytical jacobian of the system and a
+    /// block-Jacobi preconditioner (one block per tetrahedron and triangle).
+    void setStiff(bool stiff);
+
+    bool getStiff() const;
+
     ////////////////////////// ADDED FOR EFIELD ////////////////////////////
 
     /// Check the EField flag
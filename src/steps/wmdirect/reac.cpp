@@ -173,60 +173,17 @@ bool swmd::Reac::depSpecPatch(uint /*gidx*/, swmd::Patch * /*patch*/)
 
 double swmd::Reac::rate() const
 {
-    if (inactive()) { return 0.0;
-}
+    if (inactive()) return 0.0;
 
-    // Prefetch some variables.
+    // Compute combinatorial part over the reactants only.
     ssolver::Compdef * cdef = pComp->def();
-    uint nspecs = cdef->countSpecs();
-    uint * lhs_vec = cdef->reac_lhs_bgn(cdef->reacG2L(defr()->gidx()));
-    double * cnt_vec = cdef->pools();
-
-    // Compute combinatorial part.
-        double h_mu = 1.0;
-        for (uint pool = 0; pool < nspecs; ++pool)
-        {
-            uint lhs = lhs_vec[pool];
-            if (lhs == 0) { continue;
-}
-            auto cnt = static_cast<uint>(cnt_vec[pool]);
-            if (lhs > cnt)
-            {
-                h_mu = 0.0;
-                break;
-            }
-            switch (lhs)
-            {
-                case 4:
-                {
-                    h_mu *= static_cast<double>(cnt - 3);
-                }
-                STEPS_FALLTHROUGH;
-                case 3:
-                {
-                    h_mu *= static_cast<double>(cnt - 2);
-                }
-                STEPS_FALLTHROUGH;
-                case 2:
-                {
-                    h_mu *= static_cast<double>(cnt - 1);
-                }
-                STEPS_FALLTHROUGH;
-                case 1:
-                {
-                    h_mu *= static_cast<double>(cnt);
-                    break;
-                }
-                default:
-                {
-                    AssertLog(false);
-                }
-            }
-        }
-
-        // Multiply with scaled reaction constant.
-        return h_mu * pCcst;
+    uint lidx = cdef->reacG2L(defr()->gidx());
+    double h_mu = ssolver::reac_comb(cdef->reac_reactants_bgn(lidx),
+                                     cdef->reac_reactants_end(lidx),
+                                     cdef->pools());
 
+    // Multiply with scaled reaction constant.
+    return h_mu * pCcst;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -275,150 +275,33 @@ void swmd::SReac::resetCcst()
 
 double swmd::SReac::rate() const
 {
-    if (inactive()) { return 0.0;
-}
+    if (inactive()) return 0.0;
 
     // First we compute the combinatorial part.
     //   1/ for the surface part of the stoichiometry
-    //   2/ for the inner or outer volume part of the stoichiometry, pool
+    //   2/ for the inner or outer volume part of the stoichiometry,
     //      depending on whether the sreac is inner() or outer()
     // Then we multiply with mesoscopic constant.
 
     ssolver::Patchdef * pdef = pPatch->def();
     uint lidx = pdef->sreacG2L(defsr()->gidx());
 
-    double h_mu = 1.0;
-
-    uint * lhs_s_vec = pdef->sreac_lhs_S_bgn(lidx);
-    double * cnt_s_vec = pdef->pools();
-    uint nspecs_s = pdef->countSpecs();
-    for (uint s = 0; s < nspecs_s; ++s)
-    {
-        uint lhs = lhs_s_vec[s];
-        if (lhs == 0) { continue;
-}
-        auto cnt = static_cast<uint>(cnt_s_vec[s]);
-        if (lhs > cnt)
-        {
-            return 0.0;
-        }
-        switch (lhs)
-        {
-            case 4:
-            {
-                h_mu *= static_cast<double>(cnt - 3);
-            }
-            STEPS_FALLTHROUGH;
-            case 3:
-            {
-                h_mu *= static_cast<double>(cnt - 2);
-            }
-            STEPS_FALLTHROUGH;
-            case 2:
-            {
-                h_mu *= static_cast<double>(cnt - 1);
-            }
-            STEPS_FALLTHROUGH;
-            case 1:
-            {
-                h_mu *= static_cast<double>(cnt);
-                break;
-            }
-            default:
-            {
-                AssertLog(0);
-                return 0.0;
-            }
-        }
-    }
+    double h_mu = ssolver::reac_comb(pdef->sreac_reactants_S_bgn(lidx),
+                                     pdef->sreac_reactants_S_end(lidx),
+                                     pdef->pools());
+    if (h_mu == 0.0) return 0.0;
 
     if (defsr()->inside())
     {
-        uint * lhs_i_vec = pdef->sreac_lhs_I_bgn(lidx);
-        double * cnt_i_vec = pPatch->iComp()->def()->pools();
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
-        {
-            uint lhs = lhs_i_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_i_vec[s];
-            if (lhs > cnt)
-            {
-                return 0.0;
-            }
-            switch (lhs)
-            {
-                case 4:
-                {
-                    h_mu *= static_cast<double>(cnt - 3);
-                }
-                STEPS_FALLTHROUGH;
-                case 3:
-                {
-                    h_mu *= static_cast<double>(cnt - 2);
-                }
-                STEPS_FALLTHROUGH;
-                case 2:
-                {
-                    h_mu *= static_cast<double>(cnt - 1);
-                }
-                STEPS_FALLTHROUGH;
-                case 1:
-                {
-                    h_mu *= static_cast<double>(cnt);
-                    break;
-                }
-                default:
-                {
-                    AssertLog(0);
-                }
-            }
-        }
+        h_mu = ssolver::reac_comb(pdef->sreac_reactants_I_bgn(lidx),
+                                  pdef->sreac_reactants_I_end(lidx),
+                                  pPatch->iComp()->def()->pools(), h_mu);
     }
     else if (defsr()->outside())
     {
-        uint * lhs_o_vec = pdef->sreac_lhs_O_bgn(lidx);
-        double * cnt_o_vec = pPatch->oComp()->def()->pools();
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
-        {
-            uint lhs = lhs_o_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_o_vec[s];
-            if (lhs > cnt)
-            {
-                return 0.0;
-            }
-            switch (lhs)
-            {
-                case 4:
-                {
-                    h_mu *= static_cast<double>(cnt - 3);
-                }
-                STEPS_FALLTHROUGH;
-                case 3:
-                {
-                    h_mu *= static_cast<double>(cnt - 2);
-                }
-                STEPS_FALLTHROUGH;
-                case 2:
-                {
-                    h_mu *= static_cast<double>(cnt - 1);
-                }
-                STEPS_FALLTHROUGH;
-                case 1:
-                {
-                    h_mu *= static_cast<double>(cnt);
-                    break;
-                }
-                default:
-                {
-                    AssertLog(false);
-                }
-            }
-        }
+        h_mu = ssolver::reac_comb(pdef->sreac_reactants_O_bgn(lidx),
+                                  pdef->sreac_reactants_O_end(lidx),
+                                  pPatch->oComp()->def()->pools(), h_mu);
     }
 
     return h_mu * pCcst;
@@ -27,6 +27,7 @@
 
 
 // Standard library & STL headers.
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <fstream>
@@ -128,6 +129,8 @@ void swmrk4::Wmrk4::reset()
     statedef().resetTime();
     // recompute flags and counts vectors in Wmrk4 object
     _refill();
+    // and copy them to the lanes
+    if (pNLanes != 0) setNLanes(pNLanes);
 
 }
 
@@ -141,7 +144,14 @@ void swmrk4::Wmrk4::run(double endtime)
         os << "Endtime is before current simulation time";
         ArgErrLog(os.str());
     }
-    _rksteps(statedef().time(), endtime);
+    if (pIntegrator == Integrator::RK45)
+    {
+        _rk45steps(statedef().time(), endtime);
+    }
+    else
+    {
+        _rksteps(statedef().time(), endtime);
+    }
     statedef().setTime(endtime);
 }
 
@@ -164,6 +174,18 @@ void swmrk4::Wmrk4::advance(double adv)
 
 void swmrk4::Wmrk4::step()
 {
+    if (pIntegrator == Integrator::RK45)
+    {
+        // complete the current step, or take a new one
+        double t = statedef().time();
+        if (!pRK45Valid || t < pRK45T || t > pRK45T + pRK45H) _rk45Init(t);
+        if (t == pRK45T + pRK45H) _rk45Step();
+        double endtime = pRK45T + pRK45H;
+        _rk45Output(endtime);
+        statedef().setTime(endtime);
+        return;
+    }
+
     AssertLog(pDT > 0.0);
     _rksteps(statedef().time(), statedef().time() + pDT);
     statedef().setTime(statedef().time() + pDT);
@@ -184,6 +206,49 @@ void swmrk4::Wmrk4::setRk4DT(double dt)
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void swmrk4::Wmrk4::setIntegrator(std::string const & name)
+{
+    if (name == "rk4")
+    {
+        pIntegrator = Integrator::RK4;
+    }
+    else if (name == "rk45")
+    {
+        pIntegrator = Integrator::RK45;
+    }
+    else
+    {
+        std::ostringstream os;
+        os << "Unknown integrator '" << name << "', expected 'rk4' or 'rk45'.";
+        ArgErrLog(os.str());
+    }
+    pRK45Valid = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string swmrk4::Wmrk4::getIntegrator() const
+{
+    return pIntegrator == Integrator::RK45 ? "rk45" : "rk4";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::setTolerances(double atol, double rtol)
+{
+    if (atol < 0.0 || rtol < 0.0 || (atol == 0.0 && rtol == 0.0))
+    {
+        std::ostringstream os;
+        os << "Tolerances cannot be negative, and cannot both be zero.";
+        ArgErrLog(os.str());
+    }
+    pATol = atol;
+    pRTol = rtol;
+    pRK45Valid = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 double swmrk4::Wmrk4::getTime() const
 {
     return statedef().time();
@@ -267,6 +332,9 @@ void swmrk4::Wmrk4::restore(std::string const & file_name)
     statedef().restore(cp_file);
 
     cp_file.close();
+
+    // the adaptive integration is not checkpointed, restart it
+    pRK45Valid = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -947,6 +1015,8 @@ void swmrk4::Wmrk4::_refill()
     AssertLog(c_marker == pVals.size());
     AssertLog(pVals.size() == pSFlags.size());
     AssertLog(pSFlags.size() == pSpecs_tot);
+
+    pRK45Valid = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1018,11 +1088,12 @@ void swmrk4::Wmrk4::_refillCcst()
         r_marker += patchReacs_N;
     }
 
+    pRK45Valid = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrk4::Wmrk4::_setderivs(dVec & vals, dVec & dydx)
+void swmrk4::Wmrk4::_setderivs(dVec const & vals, dVec & dydx)
 {
     std::fill(dydx.begin(), dydx.end(), 0);
     for(const auto &reaction: reactions)
@@ -1107,9 +1178,7 @@ void swmrk4::Wmrk4::_rksteps(double t1, double t2)
     {
         if ((t+pDT) > t2) break;
 
-        _setderivs(pVals, pDyDx);
-        _rk4(pDT);
-        _update();
+        _rkstep(pDT);
         t += pDT;
     }
 
@@ -1126,9 +1195,7 @@ void swmrk4::Wmrk4::_rksteps(double t1, double t2)
     if (tfrac != 0.0) // && tfrac/pDT >= 0.01)
     {
         AssertLog(tfrac < pDT);
-        _setderivs(pVals, pDyDx);
-        _rk4(tfrac);
-        _update();
+        _rkstep(tfrac);
     }
     ////////////////////////////////////////////////////////////////////////////
 }
@@ -1153,6 +1220,13 @@ void swmrk4::Wmrk4::_update()
         }
     }
 
+    _updatePools();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_updatePools()
+{
     /// update pools with computed values
     uint Comps_N = statedef().countComps();
     uint Patches_N = statedef().countPatches();
@@ -1181,5 +1255,611 @@ void swmrk4::Wmrk4::_update()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-// END
+void swmrk4::Wmrk4::_rkstep(double pdt)
+{
+    if (pNLanes == 0)
+    {
+        _setderivs(pVals, pDyDx);
+        _rk4(pdt);
+        _update();
+    }
+    else
+    {
+        _setderivsLanes(pLaneVals, pLaneDyDx);
+        _rk4Lanes(pdt);
+        _updateLanes();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::setNLanes(uint n)
+{
+    pNLanes = n;
+    pRK45Valid = false;
+    if (n == 0)
+    {
+        for (auto * v: {&pLaneVals, &pLaneNewVals, &pLaneDyDx, &pLaneYt, &pLaneDyt,
+                        &pLaneDym, &pLaneCcst, &pLaneRate})
+        {
+            dVec().swap(*v);
+        }
+        return;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(pSpecs_tot) * n;
+    pLaneVals.resize(size);
+    for (uint i = 0; i < pSpecs_tot; ++i)
+    {
+        std::fill_n(pLaneVals.begin() + static_cast<std::size_t>(i) * n, n, pVals[i]);
+    }
+    pLaneNewVals.assign(size, 0.0);
+    pLaneDyDx.assign(size, 0.0);
+    pLaneYt.assign(size, 0.0);
+    pLaneDyt.assign(size, 0.0);
+    pLaneDym.assign(size, 0.0);
+
+    pLaneCcst.resize(static_cast<std::size_t>(pReacs_tot) * n);
+    for (uint r = 0; r < pReacs_tot; ++r)
+    {
+        std::fill_n(pLaneCcst.begin() + static_cast<std::size_t>(r) * n, n, reactions[r].c);
+    }
+    pLaneRate.assign(n, 0.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_checkLane(uint lane) const
+{
+    if (lane >= pNLanes)
+    {
+        std::ostringstream os;
+        os << "Lane " << lane << " out of range (number of lanes: " << pNLanes << ").";
+        ArgErrLog(os.str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint swmrk4::Wmrk4::_compSpecIdx(std::string const & c, std::string const & s) const
+{
+    uint cidx = statedef().getCompIdx(c);
+    uint sidx = statedef().getSpecIdx(s);
+    Compdef * comp = statedef().compdef(cidx);
+    AssertLog(comp != nullptr);
+    uint slidx = comp->specG2L(sidx);
+    if (slidx == ssolver::LIDX_UNDEFINED)
+    {
+        std::ostringstream os;
+        os << "Species undefined in compartment.\n";
+        ArgErrLog(os.str());
+    }
+
+    uint c_marker = 0;
+    for (uint i = 0; i < cidx; ++i) c_marker += statedef().compdef(i)->countSpecs();
+    return c_marker + slidx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint swmrk4::Wmrk4::_patchSpecIdx(std::string const & p, std::string const & s) const
+{
+    uint pidx = statedef().getPatchIdx(p);
+    uint sidx = statedef().getSpecIdx(s);
+    Patchdef * patch = statedef().patchdef(pidx);
+    AssertLog(patch != nullptr);
+    uint slidx = patch->specG2L(sidx);
+    if (slidx == ssolver::LIDX_UNDEFINED)
+    {
+        std::ostringstream os;
+        os << "Species undefined in patch.\n";
+        ArgErrLog(os.str());
+    }
+
+    uint c_marker = 0;
+    for (uint i = 0; i < statedef().countComps(); ++i) c_marker += statedef().compdef(i)->countSpecs();
+    for (uint i = 0; i < pidx; ++i) c_marker += statedef().patchdef(i)->countSpecs();
+    return c_marker + slidx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double swmrk4::Wmrk4::getLaneCompCount(uint lane, std::string const & c, std::string const & s) const
+{
+    _checkLane(lane);
+    return pLaneVals[static_cast<std::size_t>(_compSpecIdx(c, s)) * pNLanes + lane];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::setLaneCompCount(uint lane, std::string const & c, std::string const & s, double n)
+{
+    _checkLane(lane);
+    ArgErrLogIf(n < 0.0, "Number of molecules cannot be negative.");
+    pLaneVals[static_cast<std::size_t>(_compSpecIdx(c, s)) * pNLanes + lane] = n;
+    pRK45Valid = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double swmrk4::Wmrk4::getLanePatchCount(uint lane, std::string const & p, std::string const & s) const
+{
+    _checkLane(lane);
+    return pLaneVals[static_cast<std::size_t>(_patchSpecIdx(p, s)) * pNLanes + lane];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::setLanePatchCount(uint lane, std::string const & p, std::string const & s, double n)
+{
+    _checkLane(lane);
+    ArgErrLogIf(n < 0.0, "Number of molecules cannot be negative.");
+    pLaneVals[static_cast<std::size_t>(_patchSpecIdx(p, s)) * pNLanes + lane] = n;
+    pRK45Valid = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::setLaneCompReacK(uint lane, std::string const & c, std::string const & r, double kf)
+{
+    _checkLane(lane);
+    ArgErrLogIf(kf < 0.0, "Reaction constant cannot be negative.");
+    uint cidx = statedef().getCompIdx(c);
+    uint ridx = statedef().getReacIdx(r);
+    Compdef * comp = statedef().compdef(cidx);
+    AssertLog(comp != nullptr);
+    uint lridx = comp->reacG2L(ridx);
+    if (lridx == ssolver::LIDX_UNDEFINED)
+    {
+        std::ostringstream os;
+        os << "Reaction undefined in compartment.\n";
+        ArgErrLog(os.str());
+    }
+
+    uint r_marker = 0;
+    for (uint i = 0; i < cidx; ++i) r_marker += statedef().compdef(i)->countReacs();
+    pLaneCcst[static_cast<std::size_t>(r_marker + lridx) * pNLanes + lane] =
+        _ccst(kf, comp->vol(), comp->reacdef(lridx)->order());
+    pRK45Valid = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::setLanePatchSReacK(uint lane, std::string const & p, std::string const & sr, double kf)
+{
+    _checkLane(lane);
+    ArgErrLogIf(kf < 0.0, "Reaction constant cannot be negative.");
+    uint pidx = statedef().getPatchIdx(p);
+    uint ridx = statedef().getSReacIdx(sr);
+    Patchdef * patch = statedef().patchdef(pidx);
+    AssertLog(patch != nullptr);
+    uint lridx = patch->sreacG2L(ridx);
+    if (lridx == ssolver::LIDX_UNDEFINED)
+    {
+        std::ostringstream os;
+        os << "Surface reaction undefined in patch.\n";
+        ArgErrLog(os.str());
+    }
+
+    uint r_marker = 0;
+    for (uint i = 0; i < statedef().countComps(); ++i) r_marker += statedef().compdef(i)->countReacs();
+    for (uint i = 0; i < pidx; ++i) r_marker += statedef().patchdef(i)->countSReacs();
+
+    // same scaling as _refillCcst
+    ssolver::SReacdef * sreacdef = patch->sreacdef(lridx);
+    double ccst;
+    if (sreacdef->surf_surf() == false)
+    {
+        Compdef * comp = sreacdef->inside() ? patch->icompdef() : patch->ocompdef();
+        AssertLog(comp != nullptr);
+        ccst = _ccst(kf, comp->vol(), sreacdef->order());
+    }
+    else
+    {
+        ccst = _ccst2D(kf, patch->area(), sreacdef->order());
+    }
+    pLaneCcst[static_cast<std::size_t>(r_marker + lridx) * pNLanes + lane] = ccst;
+    pRK45Valid = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_setderivsLanes(dVec const & vals, dVec & dydx)
+{
+    // Same arithmetic as _setderivs, with each operation applied to all
+    // lanes by a loop over the contiguous lane values.
+    const std::size_t nlanes = pNLanes;
+    double * rate = pLaneRate.data();
+
+    std::fill(dydx.begin(), dydx.end(), 0);
+    for (uint r = 0; r < pReacs_tot; ++r)
+    {
+        const auto & reaction = reactions[r];
+        if (!reaction.isActivated) continue;
+
+        const double * ccst = &pLaneCcst[r * nlanes];
+        #pragma omp simd
+        for (std::size_t l = 0; l < nlanes; ++l) rate[l] = ccst[l];
+
+        for (const auto &reactant: reaction.reactants)
+        {
+            /// allow maximum 4 molecules of one species in reaction
+            AssertLog(reactant.order <= 4);
+            const double * population = &vals[reactant.globalIndex * nlanes];
+            for (uint o = 0; o < reactant.order; ++o)
+            {
+                #pragma omp simd
+                for (std::size_t l = 0; l < nlanes; ++l) rate[l] *= population[l];
+            }
+        }
+        for (const auto &specie: reaction.affectedSpecies)
+        {
+            if (pSFlags[specie.globalIndex] & Statedef::CLAMPED_POOLFLAG)
+                continue;
+            double * d = &dydx[specie.globalIndex * nlanes];
+            const double change = specie.populationChange;
+            #pragma omp simd
+            for (std::size_t l = 0; l < nlanes; ++l) d[l] += change * rate[l];
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_rk4Lanes(double pdt)
+{
+    double dt_2 = pdt/2.0;
+    double dt_6 = pdt/6.0;
+
+    const std::size_t size = pLaneVals.size();
+    const double * vals = pLaneVals.data();
+    const double * dydx = pLaneDyDx.data();
+    double * lane_yt = pLaneYt.data();
+    double * lane_dyt = pLaneDyt.data();
+    double * lane_dym = pLaneDym.data();
+    double * newvals = pLaneNewVals.data();
+
+    #pragma omp simd
+    for (std::size_t i = 0; i < size; ++i) lane_yt[i] = vals[i] + (dt_2 * dydx[i]);
+    _setderivsLanes(pLaneYt, pLaneDyt);
+    #pragma omp simd
+    for (std::size_t i = 0; i < size; ++i) lane_yt[i] = vals[i] + (dt_2 * lane_dyt[i]);
+    _setderivsLanes(pLaneYt, pLaneDym);
+    #pragma omp simd
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        lane_yt[i] = vals[i] + (pdt * lane_dym[i]);
+        lane_dym[i] += lane_dyt[i];
+    }
+    _setderivsLanes(pLaneYt, pLaneDyt);
+    #pragma omp simd
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        newvals[i] = vals[i] + dt_6 * (dydx[i] + lane_dyt[i] + (2.0 * lane_dym[i]));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_updateLanes()
+{
+    const std::size_t nlanes = pNLanes;
+    for (uint i = 0; i < pSpecs_tot; ++i)
+    {
+        /// check clamped flag and only update if not clamped
+        if (pSFlags[i] & Statedef::CLAMPED_POOLFLAG) continue;
+
+        double * vals = &pLaneVals[i * nlanes];
+        const double * newvals = &pLaneNewVals[i * nlanes];
+        #pragma omp simd
+        for (std::size_t l = 0; l < nlanes; ++l)
+        {
+            vals[l] = newvals[l] < 0.0 ? 0.0 : newvals[l];
+        }
+        pVals[i] = vals[0];
+    }
+
+    _updatePools();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Dormand-Prince 5(4) coefficients and dense output of order 4, from
+// E. Hairer, S.P. Norsett and G. Wanner, Solving Ordinary Differential
+// Equations I, 2nd ed., Springer (1993), table 5.2 and section II.6.
+
+namespace {
+
+constexpr double dp_a21 = 1.0 / 5.0;
+constexpr double dp_a31 = 3.0 / 40.0;
+constexpr double dp_a32 = 9.0 / 40.0;
+constexpr double dp_a41 = 44.0 / 45.0;
+constexpr double dp_a42 = -56.0 / 15.0;
+constexpr double dp_a43 = 32.0 / 9.0;
+constexpr double dp_a51 = 19372.0 / 6561.0;
+constexpr double dp_a52 = -25360.0 / 2187.0;
+constexpr double dp_a53 = 64448.0 / 6561.0;
+constexpr double dp_a54 = -212.0 / 729.0;
+constexpr double dp_a61 = 9017.0 / 3168.0;
+constexpr double dp_a62 = -355.0 / 33.0;
+constexpr double dp_a63 = 46732.0 / 5247.0;
+constexpr double dp_a64 = 49.0 / 176.0;
+constexpr double dp_a65 = -5103.0 / 18656.0;
+constexpr double dp_a71 = 35.0 / 384.0;
+constexpr double dp_a73 = 500.0 / 1113.0;
+constexpr double dp_a74 = 125.0 / 192.0;
+constexpr double dp_a75 = -2187.0 / 6784.0;
+constexpr double dp_a76 = 11.0 / 84.0;
+
+// difference between the 5th and 4th order solutions
+constexpr double dp_e1 = 71.0 / 57600.0;
+constexpr double dp_e3 = -71.0 / 16695.0;
+constexpr double dp_e4 = 71.0 / 1920.0;
+constexpr double dp_e5 = -17253.0 / 339200.0;
+constexpr double dp_e6 = 22.0 / 525.0;
+constexpr double dp_e7 = -1.0 / 40.0;
+
+constexpr double dp_d1 = -12715105075.0 / 11282082432.0;
+constexpr double dp_d3 = 87487479700.0 / 32700410799.0;
+constexpr double dp_d4 = -10690763975.0 / 1880347072.0;
+constexpr double dp_d5 = 701980252875.0 / 199316789632.0;
+constexpr double dp_d6 = -1453857185.0 / 822651844.0;
+constexpr double dp_d7 = 69997945.0 / 29380423.0;
+
+// step size control
+constexpr double dp_safety = 0.9;
+constexpr double dp_min_factor = 0.2;
+constexpr double dp_max_factor = 5.0;
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_derivs(dVec const & vals, dVec & dydx)
+{
+    if (pNLanes == 0)
+    {
+        _setderivs(vals, dydx);
+    }
+    else
+    {
+        _setderivsLanes(vals, dydx);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_rk45steps(double t1, double t2)
+{
+    AssertLog(t1 <= t2);
+    if (!pRK45Valid || t1 < pRK45T || t1 > pRK45T + pRK45H) _rk45Init(t1);
+    if (t1 == t2) return;
+
+    while (pRK45T + pRK45H < t2) _rk45Step();
+    _rk45Output(t2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
+void swmrk4::Wmrk4::_rk45Init(double t)
+{
+    const dVec & vals = (pNLanes == 0) ? pVals : pLaneVals;
+    const std::size_t size = vals.size();
+
+    pRK45Y = vals;
+    pRK45YNew.assign(size, 0.0);
+    pRK45Yt.assign(size, 0.0);
+    pRK45K.resize(7);
+    for (auto & k: pRK45K) k.assign(size, 0.0);
+    pRK45Cont.assign(5 * size, 0.0);
+    pRK45Err.assign(std::max(pNLanes, 1u), 0.0);
+
+    _derivs(pRK45Y, pRK45K[0]);
+    pRK45T = t;
+    pRK45H = 0.0;
+    pRK45NextH = (pDT > 0.0) ? pDT : _rk45InitialStep();
+    pRK45Valid = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double swmrk4::Wmrk4::_rk45InitialStep()
+{
+    // Hairer, Norsett and Wanner, section II.4: make the first Euler step
+    // small compared to the values and to the change of the derivatives.
+    const std::size_t nlanes = std::max(pNLanes, 1u);
+    const std::size_t size = pRK45Y.size();
+    const double * y = pRK45Y.data();
+    const double * f0 = pRK45K[0].data();
+
+    // largest scaled RMS norm over the lanes
+    const auto norm = [&](const double * v) {
+        std::fill(pRK45Err.begin(), pRK45Err.end(), 0.0);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const double sk = pATol + pRTol * std::abs(y[i]);
+            pRK45Err[i % nlanes] += (v[i] / sk) * (v[i] / sk);
+        }
+        return std::sqrt(*std::max_element(pRK45Err.begin(), pRK45Err.end()) / pSpecs_tot);
+    };
+
+    const double d0 = norm(y);
+    const double d1 = norm(f0);
+    double h0 = (d0 < 1.0e-5 || d1 < 1.0e-5) ? 1.0e-6 : 0.01 * d0 / d1;
+
+    double * rk45_yt = pRK45Yt.data();
+    for (std::size_t i = 0; i < size; ++i) rk45_yt[i] = y[i] + h0 * f0[i];
+    _derivs(pRK45Yt, pRK45K[1]);
+    const double * f1 = pRK45K[1].data();
+    for (std::size_t i = 0; i < size; ++i) rk45_yt[i] = f1[i] - f0[i];
+    const double d2 = norm(rk45_yt) / h0;
+
+    const double dmax = std::max(d1, d2);
+    const double h1 = (dmax <= 1.0e-15) ? std::max(1.0e-6, h0 * 1.0e-3)
+                                        : std::pow(0.01 / dmax, 1.0 / 5.0);
+    return std::min(100.0 * h0, h1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_rk45Step()
+{
+    const std::size_t nlanes = std::max(pNLanes, 1u);
+    const std::size_t size = pRK45Y.size();
+    const double t = pRK45T + pRK45H;
+    double h = pRK45NextH;
+    bool rejected = false;
+
+    const double * y = pRK45Y.data();
+    double * ynew = pRK45YNew.data();
+    double * rk45_yt = pRK45Yt.data();
+    double * k1 = pRK45K[0].data();
+    double * k2 = pRK45K[1].data();
+    double * k3 = pRK45K[2].data();
+    double * k4 = pRK45K[3].data();
+    double * k5 = pRK45K[4].data();
+    double * k6 = pRK45K[5].data();
+    double * k7 = pRK45K[6].data();
+
+    while (true)
+    {
+        if (t + h <= t)
+        {
+            std::ostringstream os;
+            os << "Step size underflow at time " << t << " in the rk45 integrator; ";
+            os << "the tolerances may be too tight.";
+            ArgErrLog(os.str());
+        }
+
+        #pragma omp simd
+        for (std::size_t i = 0; i < size; ++i) rk45_yt[i] = y[i] + h * dp_a21 * k1[i];
+        _derivs(pRK45Yt, pRK45K[1]);
+        #pragma omp simd
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            rk45_yt[i] = y[i] + h * (dp_a31 * k1[i] + dp_a32 * k2[i]);
+        }
+        _derivs(pRK45Yt, pRK45K[2]);
+        #pragma omp simd
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            rk45_yt[i] = y[i] + h * (dp_a41 * k1[i] + dp_a42 * k2[i] + dp_a43 * k3[i]);
+        }
+        _derivs(pRK45Yt, pRK45K[3]);
+        #pragma omp simd
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            rk45_yt[i] = y[i] + h * (dp_a51 * k1[i] + dp_a52 * k2[i] + dp_a53 * k3[i] +
+                                     dp_a54 * k4[i]);
+        }
+        _derivs(pRK45Yt, pRK45K[4]);
+        #pragma omp simd
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            rk45_yt[i] = y[i] + h * (dp_a61 * k1[i] + dp_a62 * k2[i] + dp_a63 * k3[i] +
+                                     dp_a64 * k4[i] + dp_a65 * k5[i]);
+        }
+        _derivs(pRK45Yt, pRK45K[5]);
+        #pragma omp simd
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            ynew[i] = y[i] + h * (dp_a71 * k1[i] + dp_a73 * k3[i] + dp_a74 * k4[i] +
+                                  dp_a75 * k5[i] + dp_a76 * k6[i]);
+        }
+        _derivs(pRK45YNew, pRK45K[6]);
+
+        // scaled RMS error of each lane, values are stored as [species][lane]
+        std::fill(pRK45Err.begin(), pRK45Err.end(), 0.0);
+        for (std::size_t i = 0; i < size; i += nlanes)
+        {
+            double * err = pRK45Err.data();
+            #pragma omp simd
+            for (std::size_t l = 0; l < nlanes; ++l)
+            {
+                const std::size_t j = i + l;
+                const double sk = pATol + pRTol * std::max(std::abs(y[j]), std::abs(ynew[j]));
+                const double e = h * (dp_e1 * k1[j] + dp_e3 * k3[j] + dp_e4 * k4[j] +
+                                      dp_e5 * k5[j] + dp_e6 * k6[j] + dp_e7 * k7[j]) / sk;
+                err[l] += e * e;
+            }
+        }
+        const double err =
+            std::sqrt(*std::max_element(pRK45Err.begin(), pRK45Err.end()) / pSpecs_tot);
+
+        double factor = (err == 0.0) ? dp_max_factor : dp_safety * std::pow(err, -0.2);
+        factor = std::min(dp_max_factor, std::max(dp_min_factor, factor));
+
+        if (err <= 1.0)
+        {
+            // accepted: keep the dense output of the step, then move to its end
+            double * cont = pRK45Cont.data();
+            #pragma omp simd
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const double ydiff = ynew[i] - y[i];
+                const double bspl = h * k1[i] - ydiff;
+                cont[i] = y[i];
+                cont[size + i] = ydiff;
+                cont[2 * size + i] = bspl;
+                cont[3 * size + i] = ydiff - h * k7[i] - bspl;
+                cont[4 * size + i] = h * (dp_d1 * k1[i] + dp_d3 * k3[i] + dp_d4 * k4[i] +
+                                          dp_d5 * k5[i] + dp_d6 * k6[i] + dp_d7 * k7[i]);
+            }
+            pRK45Y.swap(pRK45YNew);
+            pRK45K[0].swap(pRK45K[6]);
+            pRK45T = t;
+            pRK45H = h;
+            // don't grow the step right after a rejection
+            pRK45NextH = h * (rejected ? std::min(factor, 1.0) : factor);
+            return;
+        }
+
+        rejected = true;
+        h *= factor;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void swmrk4::Wmrk4::_rk45Output(double t)
+{
+    dVec & newvals = (pNLanes == 0) ? pNewVals : pLaneNewVals;
+    const std::size_t size = newvals.size();
+    AssertLog(size == pRK45Y.size());
+
+    if (pRK45H == 0.0 || t == pRK45T + pRK45H)
+    {
+        std::copy(pRK45Y.begin(), pRK45Y.end(), newvals.begin());
+    }
+    else
+    {
+        AssertLog(t >= pRK45T && t < pRK45T + pRK45H);
+        const double theta = (t - pRK45T) / pRK45H;
+        const double theta1 = 1.0 - theta;
+        const double * cont = pRK45Cont.data();
+        double * out = newvals.data();
+        #pragma omp simd
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            out[i] = cont[i] +
+                     theta * (cont[size + i] +
+                              theta1 * (cont[2 * size + i] +
+                                        theta * (cont[3 * size + i] +
+                                                 theta1 * cont[4 * size + i])));
+        }
+    }
+
+    // clamps negative counts, which stay in the integrator state
+    if (pNLanes == 0)
+    {
+        _update();
+    }
+    else
+    {
+        _updateLanes();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// END
@@ -115,6 +115,60 @@ public:
 
     void setRk4DT(double dt) override;
 
+    /// Select the integrator used by run(), advance() and step():
+    ///
+    /// - "rk4" (default): the classic Runge-Kutta method, with the fixed
+    ///   time step set by setRk4DT.
+    /// - "rk45": the embedded Dormand-Prince 5(4) method, with adaptive time
+    ///   steps controlled by setTolerances. The step set by setRk4DT is only
+    ///   the first trial step; it is estimated from the derivatives if 0.
+    ///   The integration runs ahead of the solver time and the counts at the
+    ///   end of run() are interpolated with the dense output of the last
+    ///   step, so sampling times do not shorten the steps. With lanes, all
+    ///   lanes share the step size of the lane with the largest error.
+    ///
+    /// Changing counts, rate constants, flags or lanes restarts the adaptive
+    /// integration from the current solver state.
+    void setIntegrator(std::string const & name);
+    std::string getIntegrator() const;
+
+    /// Set the absolute tolerance (in number of molecules) and the relative
+    /// tolerance of the "rk45" integrator.
+    void setTolerances(double atol, double rtol);
+
+    ////////////////////////////////////////////////////////////////////////
+    // LANES
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Integrate n instances ("lanes") of the model together.
+    ///
+    /// Each lane starts as a copy of the current counts and rate constants
+    /// of the solver and can then be given its own with the setLane*
+    /// methods. Lane states are stored as [species][lane], so that the
+    /// derivatives of all lanes are computed by the same SIMD loops. run(),
+    /// advance() and step() then integrate all lanes and the solver state
+    /// follows lane 0. Volumes, areas, clamped and active flags are shared by
+    /// all lanes, as they are when this method is called; the other solver
+    /// setters do not affect the lanes. reset() copies the solver state to
+    /// all lanes again. Lanes are not checkpointed. Each lane gives exactly
+    /// the same counts as a single instance with the same state.
+    ///
+    /// \param n Number of lanes, 0 to go back to a single instance
+    void setNLanes(uint n);
+
+    /// Return the number of lanes, 0 if lanes are not used.
+    inline uint getNLanes() const noexcept
+    { return pNLanes; }
+
+    double getLaneCompCount(uint lane, std::string const & c, std::string const & s) const;
+    void setLaneCompCount(uint lane, std::string const & c, std::string const & s, double n);
+
+    double getLanePatchCount(uint lane, std::string const & p, std::string const & s) const;
+    void setLanePatchCount(uint lane, std::string const & p, std::string const & s, double n);
+
+    void setLaneCompReacK(uint lane, std::string const & c, std::string const & r, double kf);
+    void setLanePatchSReacK(uint lane, std::string const & p, std::string const & sr, double kf);
+
     ////////////////////////////////////////////////////////////////////////
     // SOLVER STATE ACCESS:
     //      GENERAL
@@ -214,13 +268,65 @@ private:
 
     /// the derivatives calculator
     ///
-    void _setderivs(dVec& vals, dVec& dydx);
+    void _setderivs(dVec const & vals, dVec& dydx);
 
     /// update local values vector,
     /// then update state with computed counts
     ///
     void _update();
 
+    /// update state with the local values vector
+    ///
+    void _updatePools();
+
+    /// one Runge-Kutta step of all lanes, or of the single instance
+    ///
+    void _rkstep(double pdt);
+
+    /// the Runge-Kutta algorithm, all lanes
+    ///
+    void _rk4Lanes(double pdt);
+
+    /// the derivatives calculator, all lanes
+    ///
+    void _setderivsLanes(dVec const & vals, dVec & dydx);
+
+    /// update lane values, then update state with lane 0
+    ///
+    void _updateLanes();
+
+    /// position of a species in the values vector
+    ///
+    uint _compSpecIdx(std::string const & c, std::string const & s) const;
+    uint _patchSpecIdx(std::string const & p, std::string const & s) const;
+
+    void _checkLane(uint lane) const;
+
+    /// the derivatives of all lanes, or of the single instance
+    ///
+    void _derivs(dVec const & vals, dVec & dydx);
+
+    /// the adaptive stepper: integrate ahead of t2 and interpolate the
+    /// values at t2
+    ///
+    void _rk45steps(double t1, double t2);
+
+    /// start the adaptive integration from the current values at time t
+    ///
+    void _rk45Init(double t);
+
+    /// estimate the first step size of the adaptive integration
+    ///
+    double _rk45InitialStep();
+
+    /// one accepted Dormand-Prince step, with step size control
+    ///
+    void _rk45Step();
+
+    /// update values and state with the dense output at time t
+    ///
+    void _rk45Output(double t);
+
     ////////////////////////////////////////////////////////////////////////
     // WMRK4 SOLVER MEMBERS
     ////////////////////////////////////////////////////////////////////////
@@ -254,6 +360,51 @@ private:
 
     std::vector<Reaction> 				reactions;
 
+    /// number of lanes, 0 if lanes are not used
+    uint                                pNLanes{0};
+
+    /// lane counterparts of the vectors above, stored as [species][lane]
+    dVec                                pLaneVals;
+    dVec                                pLaneNewVals;
+    dVec                                pLaneDyDx;
+    dVec                                pLaneYt;
+    dVec                                pLaneDyt;
+    dVec                                pLaneDym;
+
+    /// scaled reaction constants of the lanes, stored as [reaction][lane]
+    dVec                                pLaneCcst;
+
+    /// reaction rate in each lane, temporary
+    dVec                                pLaneRate;
+
+    enum class Integrator { RK4, RK45 };
+
+    /// the integrator used by run(), advance() and step()
+    Integrator                          pIntegrator{Integrator::RK4};
+
+    /// tolerances of the adaptive integrator
+    double                              pATol{1.0e-6};
+    double                              pRTol{1.0e-6};
+
+    /// adaptive integration state; the last accepted step goes from
+    /// pRK45T to pRK45T + pRK45H, with values pRK45Y at its end
+    bool                                pRK45Valid{false};
+    double                              pRK45T{0.0};
+    double                              pRK45H{0.0};
+    double                              pRK45NextH{0.0};
+    dVec                                pRK45Y;
+    dVec                                pRK45YNew;
+    dVec                                pRK45Yt;
+
+    /// stage derivatives; pRK45K[0] holds the derivatives at pRK45Y
+    std::vector<dVec>                   pRK45K;
+
+    /// dense output coefficients of the last accepted step, 5 per value
+    dVec                                pRK45Cont;
+
+    /// error of each lane, temporary
+    dVec                                pRK45Err;
+
     ////////////////////////////////////////////////////////////////////////
 
 };
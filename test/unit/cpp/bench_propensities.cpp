@@ -0,0 +1,95 @@
+/**
+ * Micro-benchmark of the next event search methods of the distributed
+ * solver: Direct, GibsonBruck and DirectSumTree.
+ *
+ * A single group of N reactions is simulated on synthetic propensities. Each
+ * event changes the propensity of the kproc that fired and of a few
+ * neighbouring kprocs, which mimics the local dependencies of a mesh.
+ *
+ * Usage: bench_propensities [max_size [num_events]]
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "mpi/dist/tetopsplit/kproc/propensities.hpp"
+#include "mpi/dist/tetopsplit/mol_state.hpp"
+
+using namespace steps::dist;
+using namespace steps::dist::kproc;
+
+constexpr size_t num_neighbours = 4;
+
+template <NextEventSearchMethod SearchMethod>
+double bench(size_t size, size_t num_events) {
+    using propensities_t =
+        Propensities<osh::I32,
+                     PropensitiesPolicy::get<SearchMethod>() | PropensitiesPolicy::with_next_event>;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<osh::Real> rate(0.1, 10.);
+    std::vector<osh::Real> rates(size);
+    for (auto& r: rates) {
+        r = rate(rng);
+    }
+
+    std::array<unsigned, num_kproc_types()> k_proc_ty{};
+    k_proc_ty[static_cast<size_t>(KProcType::Reac)] = static_cast<unsigned>(size);
+    kproc_groups_t groups;
+    groups.reshape({static_cast<osh::LO>(size)});
+    unsigned k{};
+    for (auto& kp: groups[0]) {
+        kp = static_cast<osh::LO>(KProcID(KProcType::Reac, k++).data());
+    }
+
+    propensities_t propensities;
+    propensities.init(
+        k_proc_ty,
+        [&rates](KProcID kid, const MolState<osh::I32>& /*mol_state*/) { return rates[kid.id()]; },
+        groups);
+    MolState<osh::I32> mol_state(osh::LOs(osh::Write<osh::LO>(1, 1)), false);
+
+    auto& group = propensities.groups()[0];
+    group.reset(mol_state, rng, 0.);
+    group.updateMaxTime(std::numeric_limits<osh::Real>::infinity());
+    group.update(mol_state, rng, 0.);
+
+    std::vector<KProcID> selection(num_neighbours + 1);
+    osh::Real time{};
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t e = 0; e < num_events; e++) {
+        const Event event = group.drawEvent(rng, time);
+        time = event.first;
+        const auto fired = event.second.id();
+        for (size_t n = 0; n <= num_neighbours; n++) {
+            const auto id = static_cast<unsigned>((fired + n) % size);
+            rates[id] = rate(rng);
+            selection[n] = KProcID(KProcType::Reac, id);
+        }
+        group.update(mol_state, rng, event, selection);
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() -
+                                                              start;
+    return elapsed.count() / static_cast<double>(num_events);
+}
+
+int main(int argc, char** argv) {
+    const size_t max_size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    const size_t num_events = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+    std::cout << "# time per event in microseconds, " << num_events << " events\n"
+              << std::setw(10) << "kprocs" << std::setw(14) << "Direct" << std::setw(14)
+              << "GibsonBruck" << std::setw(14) << "DirectSumTree" << '\n';
+    for (size_t size = 1000; size <= max_size; size *= 10) {
+        std::cout << std::setw(10) << size << std::setw(14)
+                  << bench<NextEventSearchMethod::Direct>(size, num_events) << std::setw(14)
+                  << bench<NextEventSearchMethod::GibsonBruck>(size, num_events) << std::setw(14)
+                  << bench<NextEventSearchMethod::DirectSumTree>(size, num_events) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * Startup time of the Tetexact solver with an increasing number of OpenMP
+ * threads.
+ *
+ * The mesh is a cube of n^3 cells of 6 tetrahedrons each, with one
+ * compartment and a patch on its surface. For each number of threads, the
+ * solver is constructed (kproc creation, dependency templates, initial rates
+ * and CR schedule), then advanced by a fixed number of steps. The results
+ * must not depend on the number of threads: the program fails if A0, the
+ * simulation time or the molecule counts differ from the single-threaded run.
+ *
+ * Usage: bench_tetexact_setup [n [max_threads]]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "geom/tetmesh.hpp"
+#include "geom/tmcomp.hpp"
+#include "geom/tmpatch.hpp"
+#include "model/diff.hpp"
+#include "model/model.hpp"
+#include "model/reac.hpp"
+#include "model/spec.hpp"
+#include "model/sreac.hpp"
+#include "model/surfsys.hpp"
+#include "model/volsys.hpp"
+#include "rng/create.hpp"
+#include "tetexact/tetexact.hpp"
+
+#include "cube_mesh.hpp"
+
+using namespace steps;
+
+constexpr double cell_size = 1e-6;
+constexpr unsigned num_steps = 10000;
+
+struct Result {
+    double setup_time;
+    double a0;
+    double time;
+    std::vector<double> counts;
+};
+
+Result run(model::Model& mdl, tetmesh::Tetmesh& mesh) {
+    auto rng = rng::create("mt19937", 512);
+    rng->initialize(23);
+
+    Result res;
+    const auto start = std::chrono::steady_clock::now();
+    tetexact::Tetexact sim(&mdl, &mesh, rng);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    res.setup_time = elapsed.count();
+
+    sim.setCompConc("comp", "A", 50e-6);
+    sim.setCompConc("comp", "B", 40e-6);
+    res.a0 = sim.getA0();
+    for (unsigned s = 0; s < num_steps; s++) {
+        sim.step();
+    }
+    res.time = sim.getTime();
+    for (index_t t = 0; t < mesh.countTets(); t++) {
+        res.counts.push_back(sim.getTetCount(tetrahedron_id_t(t), "C"));
+    }
+    for (auto t: mesh.getSurfTris()) {
+        res.counts.push_back(sim.getTriCount(t, "S"));
+    }
+    return res;
+}
+
+int main(int argc, char** argv) {
+    const unsigned n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 40;
+#ifdef _OPENMP
+    const int max_threads = argc > 2 ? std::atoi(argv[2]) : omp_get_max_threads();
+#else
+    const int max_threads = 1;
+#endif
+
+    model::Model mdl;
+    auto* A = new model::Spec("A", &mdl);
+    auto* B = new model::Spec("B", &mdl);
+    auto* C = new model::Spec("C", &mdl);
+    auto* S = new model::Spec("S", &mdl);
+    auto* vsys = new model::Volsys("vsys", &mdl);
+    auto* ssys = new model::Surfsys("ssys", &mdl);
+    new model::Reac("fwd", vsys, {A, B}, {C}, 1e8);
+    new model::Reac("bwd", vsys, {C}, {A, B}, 10.0);
+    new model::Diff("diffA", vsys, A, 1e-12);
+    new model::Diff("diffC", vsys, C, 2e-12);
+    new model::SReac("bind", ssys, {}, {C}, {}, {}, {S}, {}, 1e6);
+    new model::SReac("unbind", ssys, {}, {}, {S}, {C}, {}, {}, 3.0);
+    new model::Diff("diffS", ssys, S, 1e-13);
+
+    auto mesh = make_cube(n, cell_size);
+    std::vector<index_t> all_tets(mesh->countTets());
+    for (index_t t = 0; t < mesh->countTets(); t++) {
+        all_tets[t] = t;
+    }
+    tetmesh::TmComp comp("comp", mesh.get(), all_tets);
+    comp.addVolsys("vsys");
+    const auto patch_tris = mesh->getSurfTris();
+    tetmesh::TmPatch patch("patch", mesh.get(), patch_tris, &comp);
+    patch.addSurfsys("ssys");
+
+    std::cout << "# " << mesh->countTets() << " tetrahedrons, " << patch_tris.size()
+              << " triangles\n"
+              << std::setw(8) << "threads" << std::setw(14) << "setup (s)" << std::setw(10)
+              << "speedup" << '\n';
+
+    Result reference{};
+    bool same = true;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+#ifdef _OPENMP
+        omp_set_num_threads(threads);
+#endif
+        const Result res = run(mdl, *mesh);
+        if (threads == 1) {
+            reference = res;
+        } else if (res.a0 != reference.a0 || res.time != reference.time ||
+                   res.counts != reference.counts) {
+            std::cerr << "Results with " << threads << " threads differ from the serial run\n";
+            same = false;
+        }
+        std::cout << std::setw(8) << threads << std::setw(14) << res.setup_time << std::setw(10)
+                  << reference.setup_time / res.setup_time << std::endl;
+    }
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
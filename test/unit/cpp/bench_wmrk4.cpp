@@ -0,0 +1,156 @@
+/**
+ * Accuracy and run time of the Wmrk4 integrators on the well-mixed
+ * validation models.
+ *
+ * The model combines the reactions of the wmrk4 validation with closed-form
+ * solutions: first order irreversible and reversible, second order A+A and
+ * A+B with equal concentrations, third order A+A+A. As in the validation, the
+ * counts are sampled every 0.1 s up to 1 s. For the fixed-step "rk4"
+ * integrator at several time steps and the adaptive "rk45" integrator at
+ * several tolerances, the program prints the largest relative error over all
+ * samples and the mean run time. It fails if "rk45" with its default
+ * tolerances is not within the 0.001% tolerance of the validation.
+ *
+ * Usage: bench_wmrk4 [repeats]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "geom/comp.hpp"
+#include "geom/geom.hpp"
+#include "math/constants.hpp"
+#include "model/model.hpp"
+#include "model/reac.hpp"
+#include "model/spec.hpp"
+#include "model/volsys.hpp"
+#include "wmrk4/wmrk4.hpp"
+
+using namespace steps;
+
+constexpr double vol = 9.0e-18;
+constexpr double sample_dt = 0.1;
+constexpr unsigned num_samples = 11;
+
+constexpr double k_foi = 5.0;
+constexpr double n_foi = 50.0;
+constexpr double kf_for = 10.0;
+constexpr double kb_for = 2.0;
+constexpr double n_for = 100000.0;
+constexpr double k_soA2 = 10.0e6;
+constexpr double c_soA2 = 10.0e-6;
+constexpr double k_soAA = 50.0e6;
+constexpr double c_soAA = 20.0e-6;
+constexpr double k_toA3 = 1.0e12;
+constexpr double c_toA3 = 100.0e-6;
+
+struct Result {
+    double max_rel_error;
+    double run_time;
+};
+
+// largest relative error of the sampled concentrations
+double max_rel_error(wmrk4::Wmrk4& sim, double t) {
+    const std::vector<std::pair<std::string, double>> expected{
+        {"A_foi", n_foi * std::exp(-k_foi * t) / (1.0e3 * vol * math::AVOGADRO)},
+        {"A_for",
+         n_for * (kb_for + kf_for * std::exp(-(kf_for + kb_for) * t)) / (kf_for + kb_for) /
+             (1.0e3 * vol * math::AVOGADRO)},
+        {"A_soA2", 1.0 / (1.0 / c_soA2 + 2.0 * k_soA2 * t)},
+        {"A_soAA", 1.0 / (1.0 / c_soAA + k_soAA * t)},
+        {"A_toA3", 1.0 / std::sqrt(1.0 / (c_toA3 * c_toA3) + 6.0 * k_toA3 * t)}};
+    double err = 0.0;
+    for (const auto& e: expected) {
+        const double conc = sim.getCompConc("comp", e.first);
+        err = std::max(err, std::abs(conc - e.second) / e.second);
+    }
+    return err;
+}
+
+Result run(model::Model& mdl,
+           wm::Geom& geom,
+           const std::string& integrator,
+           double dt,
+           double tol,
+           unsigned repeats) {
+    Result res{0.0, 0.0};
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < repeats; r++) {
+        wmrk4::Wmrk4 sim(&mdl, &geom, nullptr);
+        sim.setIntegrator(integrator);
+        sim.setRk4DT(dt);
+        if (tol > 0.0) {
+            sim.setTolerances(tol, tol);
+        }
+        sim.setCompCount("comp", "A_foi", n_foi);
+        sim.setCompCount("comp", "A_for", n_for);
+        sim.setCompConc("comp", "A_soA2", c_soA2);
+        sim.setCompConc("comp", "A_soAA", c_soAA);
+        sim.setCompConc("comp", "B_soAA", c_soAA);
+        sim.setCompConc("comp", "A_toA3", c_toA3);
+        for (unsigned s = 0; s < num_samples; s++) {
+            const double t = s * sample_dt;
+            sim.run(t);
+            res.max_rel_error = std::max(res.max_rel_error, max_rel_error(sim, t));
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    res.run_time = elapsed.count() / repeats;
+    return res;
+}
+
+int main(int argc, char** argv) {
+    const unsigned repeats = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+
+    model::Model mdl;
+    auto* vsys = new model::Volsys("vsys", &mdl);
+    auto* A_foi = new model::Spec("A_foi", &mdl);
+    new model::Reac("R1_foi", vsys, {A_foi}, {}, k_foi);
+    auto* A_for = new model::Spec("A_for", &mdl);
+    auto* B_for = new model::Spec("B_for", &mdl);
+    new model::Reac("R1_for", vsys, {A_for}, {B_for}, kf_for);
+    new model::Reac("R2_for", vsys, {B_for}, {A_for}, kb_for);
+    auto* A_soA2 = new model::Spec("A_soA2", &mdl);
+    auto* C_soA2 = new model::Spec("C_soA2", &mdl);
+    new model::Reac("R1_soA2", vsys, {A_soA2, A_soA2}, {C_soA2}, k_soA2);
+    auto* A_soAA = new model::Spec("A_soAA", &mdl);
+    auto* B_soAA = new model::Spec("B_soAA", &mdl);
+    auto* C_soAA = new model::Spec("C_soAA", &mdl);
+    new model::Reac("R1_soAA", vsys, {A_soAA, B_soAA}, {C_soAA}, k_soAA);
+    auto* A_toA3 = new model::Spec("A_toA3", &mdl);
+    auto* C_toA3 = new model::Spec("C_toA3", &mdl);
+    new model::Reac("R1_toA3", vsys, {A_toA3, A_toA3, A_toA3}, {C_toA3}, k_toA3);
+
+    wm::Geom geom;
+    wm::Comp comp("comp", &geom, vol);
+    comp.addVolsys("vsys");
+
+    std::cout << std::setw(12) << "integrator" << std::setw(10) << "dt" << std::setw(10) << "tol"
+              << std::setw(16) << "max rel error" << std::setw(14) << "time (s)" << '\n';
+    const auto print = [](const std::string& name, double dt, double tol, const Result& res) {
+        std::cout << std::setw(12) << name << std::setw(10) << dt << std::setw(10) << tol
+                  << std::setw(16) << res.max_rel_error << std::setw(14) << res.run_time
+                  << std::endl;
+    };
+
+    // the third order reaction makes rk4 unstable above dt ~ 3e-5
+    for (double dt: {2.0e-5, 1.0e-5, 1.0e-6}) {
+        print("rk4", dt, 0.0, run(mdl, geom, "rk4", dt, 0.0, repeats));
+    }
+    for (double tol: {1.0e-4, 1.0e-6, 1.0e-8, 1.0e-10}) {
+        print("rk45", 0.0, tol, run(mdl, geom, "rk45", 0.0, tol, repeats));
+    }
+
+    // default tolerances
+    const Result res = run(mdl, geom, "rk45", 0.0, 0.0, 1);
+    if (res.max_rel_error >= 1.0e-5) {
+        std::cerr << "rk45 relative error " << res.max_rel_error << " with default tolerances\n";
+    }
+    return res.max_rel_error < 1.0e-5 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,48 @@
+#ifndef TEST_CUBE_MESH_HPP
+#define TEST_CUBE_MESH_HPP
+
+#include <memory>
+#include <vector>
+
+#include "geom/tetmesh.hpp"
+
+// Cube of n^3 cells of side cell_size, each cell split in 6 tetrahedrons
+// around its diagonal.
+inline std::unique_ptr<steps::tetmesh::Tetmesh> make_cube(unsigned n, double cell_size) {
+    const auto vertex = [n](unsigned i, unsigned j, unsigned k) {
+        return (i * (n + 1) + j) * (n + 1) + k;
+    };
+    std::vector<double> verts;
+    for (unsigned i = 0; i <= n; i++) {
+        for (unsigned j = 0; j <= n; j++) {
+            for (unsigned k = 0; k <= n; k++) {
+                verts.insert(verts.end(), {i * cell_size, j * cell_size, k * cell_size});
+            }
+        }
+    }
+    const unsigned cell_tets[6][4] = {
+        {0, 1, 2, 6}, {0, 2, 3, 6}, {0, 3, 7, 6}, {0, 7, 4, 6}, {0, 4, 5, 6}, {0, 5, 1, 6}};
+    std::vector<steps::index_t> tets;
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned j = 0; j < n; j++) {
+            for (unsigned k = 0; k < n; k++) {
+                const steps::index_t corners[8] = {vertex(i, j, k),
+                                                   vertex(i + 1, j, k),
+                                                   vertex(i + 1, j + 1, k),
+                                                   vertex(i, j + 1, k),
+                                                   vertex(i, j, k + 1),
+                                                   vertex(i + 1, j, k + 1),
+                                                   vertex(i + 1, j + 1, k + 1),
+                                                   vertex(i, j + 1, k + 1)};
+                for (const auto& tet: cell_tets) {
+                    for (auto c: tet) {
+                        tets.push_back(corners[c]);
+                    }
+                }
+            }
+        }
+    }
+    return std::make_unique<steps::tetmesh::Tetmesh>(verts, tets);
+}
+
+#endif  // ndef TEST_CUBE_MESH_HPP
@@ -0,0 +1,58 @@
+#ifndef TEST_EFIELD_MESH_HPP
+#define TEST_EFIELD_MESH_HPP
+
+#include <memory>
+#include <vector>
+
+#include "geom/tetmesh.hpp"
+#include "solver/efield/tetmesh.hpp"
+
+#include "gtest/gtest.h"
+
+#include "cube_mesh.hpp"
+
+// Vertices, surface triangles and tetrahedrons of the EField meshes shared by
+// the tests of the EField solver: a cube of 3^3 cells of 1 um stretched along
+// x, so that the axis and the connectivity of the mesh differ in each
+// direction.
+struct EFieldMeshTest: public ::testing::Test {
+    std::vector<double> verts;
+    std::vector<steps::vertex_id_t> tris;
+    std::vector<steps::vertex_id_t> tets;
+
+    void SetUp() override {
+        using namespace steps;
+        const auto mesh = make_cube(3, 1.0);
+        for (index_t v = 0; v < mesh->countVertices(); v++) {
+            auto pos = mesh->getVertex(vertex_id_t(v));
+            // stretch along x
+            pos[0] *= 8.0 / 3.0;
+            verts.insert(verts.end(), pos.begin(), pos.end());
+        }
+        for (auto t: mesh->getSurfTris()) {
+            for (auto v: mesh->getTri(triangle_id_t(t))) {
+                tris.emplace_back(v);
+            }
+        }
+        for (index_t t = 0; t < mesh->countTets(); t++) {
+            for (auto v: mesh->getTet(tetrahedron_id_t(t))) {
+                tets.emplace_back(v);
+            }
+        }
+    }
+
+    // EField mesh with its vertex connections
+    std::unique_ptr<steps::solver::efield::TetMesh> make_mesh() {
+        auto m = std::make_unique<steps::solver::efield::TetMesh>(
+            static_cast<uint>(verts.size() / 3),
+            verts.data(),
+            static_cast<uint>(tris.size() / 3),
+            tris.data(),
+            static_cast<uint>(tets.size() / 4),
+            tets.data());
+        m->extractConnections();
+        return m;
+    }
+};
+
+#endif  // ndef TEST_EFIELD_MESH_HPP
@@ -161,3 +161,32 @@ TYPED_TEST(LinSystemImplTest,Bw7) {
         EXPECT_NEAR(x0[i],x.get(i),std::abs(x[i])*relerr);
     }
 }
+
+TEST(LinSystem,BDSystemSubstitute) {
+    constexpr int n=8;
+    constexpr int h=2;
+
+    BDSystem B(n,h), C(n,h);
+    for (int i=0;i<n;++i) {
+        for (int j=std::max(0,i-h);j<=std::min(n-1,i+h);++j) {
+            double a=(i==j)? 0.5: 1.0/(1+i+2*j);
+            B.A().set(i,j,a);
+            C.A().set(i,j,a);
+        }
+    }
+
+    for (int i=0;i<n;++i) B.b().set(i,i+1.0);
+    B.solve();
+
+    // reuse the factors for a second right hand side
+    for (int i=0;i<n;++i) {
+        B.b().set(i,std::sin(i));
+        C.b().set(i,std::sin(i));
+    }
+    B.substitute();
+    C.solve();
+
+    for (int i=0;i<n;++i) {
+        ASSERT_EQ(B.x().get(i),C.x().get(i));
+    }
+}
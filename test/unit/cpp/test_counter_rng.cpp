@@ -0,0 +1,78 @@
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "rng/counter_rng.hpp"
+
+#include "gtest/gtest.h"
+
+using steps::rng::CounterRNG;
+
+std::vector<CounterRNG::result_type> draw(CounterRNG gen, int n) {
+    std::vector<CounterRNG::result_type> res(n);
+    for (auto& r: res) {
+        r = gen();
+    }
+    return res;
+}
+
+// The same arguments always give the same sequence, whatever the order in
+// which the generators are created and used
+TEST(CounterRNG, Reproducible) {
+    CounterRNG a(42, CounterRNG::DIFFUSION, 17, 3, 5);
+    CounterRNG b(42, CounterRNG::DIFFUSION, 16, 3, 5);
+    const auto first = draw(a, 10);
+    draw(b, 10);
+    CounterRNG c(42, CounterRNG::DIFFUSION, 17, 3, 5);
+    ASSERT_EQ(draw(c, 10), first);
+}
+
+// Changing any of the arguments gives another sequence
+TEST(CounterRNG, Streams) {
+    const auto ref = draw(CounterRNG(42, CounterRNG::DIFFUSION, 17, 3, 5), 8);
+    ASSERT_NE(draw(CounterRNG(43, CounterRNG::DIFFUSION, 17, 3, 5), 8), ref);
+    ASSERT_NE(draw(CounterRNG(42, CounterRNG::SSA, 17, 3, 5), 8), ref);
+    ASSERT_NE(draw(CounterRNG(42, CounterRNG::DIFFUSION, 18, 3, 5), 8), ref);
+    ASSERT_NE(draw(CounterRNG(42, CounterRNG::DIFFUSION, 17, 4, 5), 8), ref);
+    ASSERT_NE(draw(CounterRNG(42, CounterRNG::DIFFUSION, 17, 3, 6), 8), ref);
+}
+
+// Mean and variance of the uniform numbers pooled over many short streams,
+// as drawn by the diffusion operator
+TEST(CounterRNG, Uniform) {
+    constexpr int n_elements = 100000;
+    double sum = 0, sum2 = 0;
+    int n = 0;
+    std::uniform_real_distribution<double> uniform(0, 1);
+    for (std::uint32_t e = 0; e < n_elements; e++) {
+        CounterRNG gen(1, CounterRNG::DIFFUSION, e, 0, 1);
+        for (int i = 0; i < 3; i++) {
+            const double x = i == 0 ? gen.getUnfIE() : uniform(gen);
+            ASSERT_GE(x, 0.0);
+            ASSERT_LT(x, 1.0);
+            sum += x;
+            sum2 += x * x;
+            n++;
+        }
+    }
+    const double mean = sum / n;
+    const double var = sum2 / n - mean * mean;
+    // 5 standard deviations of the estimators
+    ASSERT_NEAR(mean, 0.5, 5 * std::sqrt(1.0 / 12 / n));
+    ASSERT_NEAR(var, 1.0 / 12, 5 * std::sqrt(1.0 / 180 / n));
+}
+
+// Binomial draws through the standard library have the expected mean
+TEST(CounterRNG, Binomial) {
+    constexpr int n_elements = 20000;
+    constexpr int t = 50;
+    constexpr double p = 0.3;
+    double sum = 0;
+    for (std::uint32_t e = 0; e < n_elements; e++) {
+        CounterRNG gen(7, CounterRNG::DIFFUSION, e, 2, 9);
+        std::binomial_distribution<int> binom(t, p);
+        sum += binom(gen);
+    }
+    ASSERT_NEAR(sum / n_elements, t * p, 5 * std::sqrt(t * p * (1 - p) / n_elements));
+}
@@ -0,0 +1,105 @@
+#include <cmath>
+#include <vector>
+
+#include <steps/solver/efield/bdsystem.hpp>
+#include <steps/solver/efield/csrsystem.hpp>
+
+#include "gtest/gtest.h"
+
+using namespace steps::solver::efield;
+
+// 2d grid laplacian plus diagonal, as assembled by dVSolverBase, with
+// identity rows for clamped vertices.
+template <typename System>
+void assemble(System &S, int nx, int ny, const std::vector<bool> &clamped, double shift) {
+    auto &A = S.A();
+    A.zero();
+    for (int j = 0; j < ny; ++j) {
+        for (int i = 0; i < nx; ++i) {
+            int r = j * nx + i;
+            if (clamped[r]) {
+                A.set(r, r, 1.0);
+                S.b().set(r, 0.0);
+                continue;
+            }
+            double diag = shift;
+            int nbrs[4] = {i > 0 ? r - 1 : -1, i < nx - 1 ? r + 1 : -1,
+                           j > 0 ? r - nx : -1, j < ny - 1 ? r + nx : -1};
+            for (int c: nbrs) {
+                if (c < 0) continue;
+                double cc = 1.0 + 0.1 * ((r + c) % 3);
+                A.set(r, c, -cc);
+                diag += cc;
+            }
+            A.set(r, r, diag);
+            S.b().set(r, std::sin(r));
+        }
+    }
+}
+
+std::vector<std::vector<size_t>> grid_pattern(int nx, int ny) {
+    std::vector<std::vector<size_t>> pattern(nx * ny);
+    for (int j = 0; j < ny; ++j) {
+        for (int i = 0; i < nx; ++i) {
+            int r = j * nx + i;
+            auto &row = pattern[r];
+            row.push_back(r);
+            if (i > 0) row.push_back(r - 1);
+            if (i < nx - 1) row.push_back(r + 1);
+            if (j > 0) row.push_back(r - nx);
+            if (j < ny - 1) row.push_back(r + nx);
+        }
+    }
+    return pattern;
+}
+
+TEST(CSRSystem, CSRMatrix) {
+    CSRMatrix m({{0, 2}, {1}, {2, 0}});
+
+    ASSERT_EQ(m.nnz(), 5);
+    m.set(0, 2, 2.0);
+    m.set(2, 0, 3.0);
+    ASSERT_EQ(m.get(0, 2), 2.0);
+    ASSERT_EQ(m.get(2, 0), 3.0);
+    ASSERT_EQ(m.get(1, 0), 0.0);
+    ASSERT_EQ(m.find(1, 2), m.nnz());
+
+    m.zero();
+    ASSERT_EQ(m.get(0, 2), 0.0);
+}
+
+TEST(CSRSystem, MatchesBanded) {
+    constexpr int nx = 12, ny = 9, n = nx * ny;
+    std::vector<bool> clamped(n, false);
+    clamped[5] = clamped[40] = clamped[n - 1] = true;
+
+    BDSystem B(n, nx);
+    CSRSystem C(grid_pattern(nx, ny));
+
+    assemble(B, nx, ny, clamped, 0.01);
+    assemble(C, nx, ny, clamped, 0.01);
+    B.solve();
+    C.solve();
+
+    ASSERT_TRUE(C.incompleteCholesky());
+    ASSERT_GT(C.iterations(), 0u);
+    for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(B.x().get(i), C.x().get(i), 1e-9);
+    }
+
+    // new right hand side, same matrix: warm start and same preconditioner
+    for (int i = 0; i < n; ++i) {
+        if (clamped[i]) continue;
+        B.b().set(i, std::cos(i));
+        C.b().set(i, std::cos(i));
+    }
+    B.substitute();
+    C.iterate();
+    for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(B.x().get(i), C.x().get(i), 1e-9);
+    }
+
+    // unchanged right hand side converges immediately
+    C.iterate();
+    ASSERT_EQ(C.iterations(), 0u);
+}
@@ -0,0 +1,101 @@
+#include "solver/efield/dVsolver.hpp"
+#include "solver/efield/tetcoupler.hpp"
+#include "solver/efield/tetmesh.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "efield_mesh.hpp"
+
+using namespace steps;
+using steps::solver::efield::dVSolverBanded;
+
+// Leak current and a current injection at vertex 0 on the surface of the
+// EField mesh.
+struct dVSolverBandedTest: public EFieldMeshTest {
+    std::unique_ptr<solver::efield::TetMesh> mesh;
+
+    void SetUp() override {
+        EFieldMeshTest::SetUp();
+        mesh = make_mesh();
+        mesh->allocateSurface();
+        solver::efield::TetCoupler tc(mesh.get());
+        tc.coupleMesh();
+        // 1 uF/cm^2 in pF/um^2
+        mesh->applySurfaceCapacitance(0.01);
+    }
+
+    void init(dVSolverBanded& s) {
+        s.initMesh(mesh.get());
+        s.setSurfaceConductance(1e-4, -0.065);
+        s.setPotential(-0.065);
+        s.setVertIClamp(vertex_id_t(0), 10.0);
+    }
+
+    std::vector<double> potentials(const dVSolverBanded& s) const {
+        std::vector<double> v(mesh->countVertices());
+        for (uint i = 0; i < v.size(); i++) {
+            v[i] = s.getV(vertex_id_t(i));
+        }
+        return v;
+    }
+
+    // Potentials after a step of a new solver, which factorises its matrix,
+    // from the potentials v.
+    std::vector<double> fresh_step(const std::vector<double>& v, double dt) {
+        dVSolverBanded s;
+        init(s);
+        for (uint i = 0; i < v.size(); i++) {
+            s.setV(vertex_id_t(i), v[i]);
+        }
+        s.advance(dt);
+        return potentials(s);
+    }
+
+    // Advance s by dt and check it against a fresh solve.
+    void expect_fresh_step(dVSolverBanded& s, double dt) {
+        const auto expected = fresh_step(potentials(s), dt);
+        s.advance(dt);
+        EXPECT_EQ(potentials(s), expected);
+    }
+};
+
+TEST_F(dVSolverBandedTest, reuse_matches_fresh_solve) {
+    dVSolverBanded s;
+    init(s);
+    for (int i = 0; i < 5; i++) {
+        expect_fresh_step(s, 1e-5);
+    }
+    EXPECT_NE(s.getV(vertex_id_t(0)), -0.065);
+}
+
+TEST_F(dVSolverBandedTest, dt_change_refactorises) {
+    dVSolverBanded s;
+    init(s);
+    expect_fresh_step(s, 1e-5);
+    expect_fresh_step(s, 1e-5);
+    expect_fresh_step(s, 2e-5);
+    expect_fresh_step(s, 1e-5);
+}
+
+TEST_F(dVSolverBandedTest, capacitance_change_refactorises) {
+    dVSolverBanded s, stale;
+    init(s);
+    init(stale);
+    s.advance(1e-5);
+    stale.advance(1e-5);
+    ASSERT_EQ(potentials(stale), potentials(s));
+
+    mesh->applySurfaceCapacitance(0.02);
+    const auto expected = fresh_step(potentials(s), 1e-5);
+    // without notification, the factors of the old matrix are reused
+    stale.advance(1e-5);
+    EXPECT_NE(potentials(stale), expected);
+
+    s.capacitanceChanged();
+    s.advance(1e-5);
+    EXPECT_EQ(potentials(s), expected);
+    expect_fresh_step(s, 1e-5);
+}
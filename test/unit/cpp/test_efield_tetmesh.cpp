@@ -0,0 +1,46 @@
+#include "solver/efield/tetmesh.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "efield_mesh.hpp"
+
+using namespace steps;
+
+struct EFieldTetMeshTest: public EFieldMeshTest {
+    std::unique_ptr<solver::efield::TetMesh> make_ordered(uint opt_method) {
+        auto m = make_mesh();
+        m->axisOrderElements(opt_method);
+        return m;
+    }
+
+    void expect_permutation(const solver::efield::TetMesh& m) {
+        const auto& perm = m.getVertexPermutation();
+        ASSERT_EQ(perm.size(), m.countVertices());
+        std::vector<bool> seen(perm.size());
+        for (auto v: perm) {
+            ASSERT_LT(v.get(), perm.size());
+            EXPECT_FALSE(seen[v.get()]) << "vertex " << v;
+            seen[v.get()] = true;
+        }
+        // the elements are stored in the new order
+        for (uint v = 0; v < m.countVertices(); v++) {
+            const auto* elem = m.getVertex(perm[v]);
+            EXPECT_EQ(elem->getIDX(), perm[v].get());
+            EXPECT_EQ(elem->getX(), verts[3 * v]) << "vertex " << v;
+            EXPECT_EQ(elem->getY(), verts[3 * v + 1]) << "vertex " << v;
+            EXPECT_EQ(elem->getZ(), verts[3 * v + 2]) << "vertex " << v;
+        }
+    }
+};
+
+TEST_F(EFieldTetMeshTest, rcm_bandwidth) {
+    auto bfs = make_ordered(2);
+    auto rcm = make_ordered(3);
+    expect_permutation(*bfs);
+    expect_permutation(*rcm);
+    EXPECT_GT(rcm->bandwidth(), 0u);
+    EXPECT_LE(rcm->bandwidth(), bfs->bandwidth());
+}
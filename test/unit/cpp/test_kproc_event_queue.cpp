@@ -1,5 +1,8 @@
 #include "mpi/dist/tetopsplit/kproc/event_queue.hpp"
 
+#include <map>
+#include <random>
+
 #include "gtest/gtest.h"
 
 using namespace steps::dist::kproc;
@@ -69,6 +72,90 @@ TEST(KProcEventQueue, TimeCollision) {
     ASSERT_EQ(first3.second.data(), 4);
 }
 
+TEST(KProcEventQueue, KProcTypes) {
+    EventQueue queue;
+    queue.updateMaxTime(1);
+    queue.update(KProcID(KProcType::SReac, 3), 0.5);
+    queue.update(KProcID(KProcType::Reac, 3), 0.6);
+    queue.update(KProcID(KProcType::GHKSReac, 0), 0.4);
+
+    ASSERT_EQ(queue.getEventTime(KProcID(KProcType::SReac, 3)), 0.5);
+    ASSERT_EQ(queue.getEventTime(KProcID(KProcType::Reac, 3)), 0.6);
+    ASSERT_THROW(queue.getEventTime(KProcID(KProcType::SReac, 2)), std::logic_error);
+
+    auto first1 = queue.getFirst();
+    ASSERT_EQ(first1.first, 0.4);
+    ASSERT_EQ(first1.second.type(), KProcType::GHKSReac);
+
+    queue.update(KProcID(KProcType::GHKSReac, 0), std::numeric_limits<double>::infinity());
+    auto first2 = queue.getFirst();
+    ASSERT_EQ(first2.first, 0.5);
+    ASSERT_EQ(first2.second.type(), KProcType::SReac);
+    ASSERT_EQ(first2.second.id(), 3u);
+}
+
+TEST(KProcEventQueue, MaxTime) {
+    EventQueue queue;
+    queue.updateMaxTime(1);
+    queue.update(KProcID(1), 0.5);
+    queue.update(KProcID(2), 1.5);
+    queue.update(KProcID(3), 2.5);
+
+    // events after the maximum time are kept aside
+    ASSERT_EQ(queue.getEventTime(KProcID(2)), 1.5);
+    ASSERT_EQ(queue.getFirst().first, 0.5);
+    queue.update(KProcID(1), std::numeric_limits<double>::infinity());
+    ASSERT_EQ(queue.getFirst().first, std::numeric_limits<double>::infinity());
+
+    queue.updateMaxTime(2);
+    auto first = queue.getFirst();
+    ASSERT_EQ(first.first, 1.5);
+    ASSERT_EQ(first.second.data(), 2);
+    queue.update(KProcID(2), std::numeric_limits<double>::infinity());
+    ASSERT_EQ(queue.getFirst().first, std::numeric_limits<double>::infinity());
+}
+
+// Compare against a multimap based queue over random updates
+TEST(KProcEventQueue, RandomUpdates) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double max_time = 0.8;
+    std::multimap<double, unsigned> ref;
+    std::map<unsigned, double> ref_times;
+
+    EventQueue queue;
+    queue.updateMaxTime(max_time);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<unsigned> kproc(0, 199);
+    std::uniform_real_distribution<double> time(0., 1.);
+    for (int i = 0; i < 20000; i++) {
+        const unsigned id = kproc(rng);
+        const double t = i % 10 == 0 ? inf : time(rng);
+
+        auto it = ref_times.find(id);
+        if (it != ref_times.end() && it->second <= max_time) {
+            auto range = ref.equal_range(it->second);
+            ref.erase(std::find_if(range.first, range.second, [id](const auto& p) {
+                return p.second == id;
+            }));
+        }
+        if (t != inf && t <= max_time) {
+            ref.emplace(t, id);
+        }
+        ref_times[id] = t;
+        queue.update(KProcID(id), t);
+
+        ASSERT_EQ(queue.getEventTime(KProcID(id)), t);
+        const auto first = queue.getFirst();
+        if (ref.empty()) {
+            ASSERT_EQ(first.first, inf);
+        } else {
+            ASSERT_EQ(first.first, ref.begin()->first);
+            ASSERT_EQ(first.second.data(), ref.begin()->second);
+        }
+    }
+}
+
 int main(int argc, char **argv) {
     int r = 0;
     ::testing::InitGoogleTest(&argc, argv);
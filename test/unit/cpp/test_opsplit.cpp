@@ -1,9 +1,13 @@
 #include "steps/mpi/dist/tetopsplit/kproc/kproc_id.hpp"
 
 #define CATCH_CONFIG_RUNNER
+#include <algorithm>
 #include <Omega_h_file.hpp>
 #include <catch2/catch.hpp>
 #include <mpi.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "test_common.hpp"
 
@@ -282,6 +286,123 @@ TEST_CASE("UnsignedCompactTypeId", "[type_id]") {
   }
 }
 
+// SSA extent and counts of the two compartments model
+template <typename Simulation>
+static std::vector<Omega_h::Real> counter_rng_state(Simulation &simulation) {
+  return {static_cast<Omega_h::Real>(simulation.getSSAOpExtent()),
+          simulation.getCompCount("Left", "A"),
+          simulation.getCompCount("Left", "C"),
+          simulation.getCompCount("Right", "C"),
+          simulation.getCompCount("Right", "E")};
+}
+
+// counts after a short run of the two compartments model with independent
+// kprocs and counter-based generators, on num_threads OpenMP threads
+static std::vector<Omega_h::Real> counter_rng_counts(int num_threads) {
+  const auto mesh_file =
+      context->source_dir() / "test" / "mesh" / "two_comp_cyl.msh";
+  steps::dist::ScenarioInput input(mesh_file.string(), 1.0);
+  input.sim_indep_k_procs = true;
+  input.counter_rng_seed = 42;
+
+  std::mt19937 rng;
+  using simulation_type = steps::dist::OmegaHSimulation<>;
+  simulation_type::mesh_type mesh(context->library(), input.mesh_file,
+                                  input.scale);
+  simulation_type simulation(input, mesh, rng, std::clog);
+  steps::dist::MultipleCompartment scenario(input);
+  scenario.initialize(simulation);
+  simulation.setCompCount("Left", "A", 2000);
+  simulation.setCompCount("Left", "B", 2000);
+  simulation.setCompCount("Right", "E", 2000);
+
+#ifdef _OPENMP
+  const int max_threads = omp_get_max_threads();
+  omp_set_num_threads(num_threads);
+#endif
+  simulation.run(1e-3);
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+
+  return counter_rng_state(simulation);
+}
+
+TEST_CASE("counter_rng_threads", "[counter_rng]") {
+  const auto serial = counter_rng_counts(1);
+  REQUIRE(serial[0] > 0);
+  REQUIRE(counter_rng_counts(4) == serial);
+}
+
+TEST_CASE("counter_rng_reset", "[counter_rng]") {
+  const auto mesh_file =
+      context->source_dir() / "test" / "mesh" / "two_comp_cyl.msh";
+  steps::dist::ScenarioInput input(mesh_file.string(), 1.0);
+  input.sim_indep_k_procs = true;
+  input.counter_rng_seed = 42;
+
+  std::mt19937 rng;
+  using simulation_type = steps::dist::OmegaHSimulation<>;
+  simulation_type::mesh_type mesh(context->library(), input.mesh_file,
+                                  input.scale);
+  simulation_type simulation(input, mesh, rng, std::clog);
+  steps::dist::MultipleCompartment scenario(input);
+  scenario.initialize(simulation);
+  const auto run = [&simulation] {
+    simulation.setCompCount("Left", "A", 2000);
+    simulation.setCompCount("Left", "B", 2000);
+    simulation.setCompCount("Right", "E", 2000);
+    simulation.run(1e-3);
+    auto state = counter_rng_state(simulation);
+    // the extent is cumulative over resets
+    state.erase(state.begin());
+    return state;
+  };
+
+  const auto first = run();
+  simulation.reset();
+  // the counters of the generators restart with the simulation
+  REQUIRE(run() == first);
+}
+
+// counts of the owned elements after a few steps of the two compartments
+// model with counter-based generators, with or without overlap of the halo
+// exchange of the diffusion operator
+static std::vector<std::vector<Omega_h::LO>> halo_exchange_counts(bool overlap) {
+  const auto mesh_file =
+      context->source_dir() / "test" / "mesh" / "two_comp_cyl.msh";
+  steps::dist::ScenarioInput input(mesh_file.string(), 1.0);
+  input.sim_indep_k_procs = true;
+  input.counter_rng_seed = 42;
+
+  std::mt19937 rng;
+  using simulation_type = steps::dist::OmegaHSimulation<>;
+  simulation_type::mesh_type mesh(context->library(), input.mesh_file,
+                                  input.scale);
+  simulation_type simulation(input, mesh, rng, std::clog);
+  steps::dist::MultipleCompartment scenario(input);
+  scenario.initialize(simulation);
+  simulation.setDiffOpHaloExchangeOverlap(overlap);
+  simulation.setCompCount("Left", "A", 2000);
+  simulation.setCompCount("Left", "B", 2000);
+  simulation.setCompCount("Right", "E", 2000);
+  simulation.run(1e-3);
+
+  std::vector<std::vector<Omega_h::LO>> counts;
+  for (const auto *species : {"A", "B", "C", "E"}) {
+    counts.push_back(simulation.getOwnedElemCount(species).second);
+  }
+  return counts;
+}
+
+TEST_CASE("halo_exchange_overlap", "[counter_rng]") {
+  const auto overlapped = halo_exchange_counts(true);
+  REQUIRE(std::any_of(overlapped[2].begin(), overlapped[2].end(),
+                      [](Omega_h::LO count) { return count > 0; }));
+  // the increments of the halo elements reach the other processes in time
+  REQUIRE(halo_exchange_counts(false) == overlapped);
+}
+
 TEST_CASE("entities", "[mesh]") {
   const auto mesh_file = context->source_dir() / "test" / "mesh" / "box.msh";
   steps::dist::DistMesh mesh(context->library(), mesh_file.string());
@@ -471,6 +592,7 @@ int main(int argc, char *argv[]) {
   failed_tests += run_caburst_catch_tests(session);
   failed_tests += run_catch_test_or_tag(session, "[type_id]");
   failed_tests += run_catch_test_or_tag(session, "[mesh]");
+  failed_tests += run_catch_test_or_tag(session, "[counter_rng]");
 
   return failed_tests;
 }
@@ -0,0 +1,74 @@
+#include <vector>
+
+#include "solver/reactants.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace steps::solver;
+
+// Reference: dense scan over all species, as the solvers used to do.
+static double dense_comb(const uint * lhs, const std::vector<uint> & pools)
+{
+    double h_mu = 1.0;
+    for (uint s = 0; s < pools.size(); ++s) {
+        if (lhs[s] > pools[s]) return 0.0;
+        for (uint k = lhs[s]; k > 0; --k) {
+            h_mu *= static_cast<double>(pools[s] - (k - 1));
+        }
+    }
+    return h_mu;
+}
+
+TEST(Reactants, CompactLists) {
+    // 3 rules over 6 species.
+    const uint lhs[] = {0, 0, 0, 0, 0, 0,
+                        0, 2, 0, 0, 1, 0,
+                        1, 0, 1, 1, 0, 1};
+    ReactantLists lists;
+    lists.assign(lhs, 3, 6);
+
+    ASSERT_EQ(lists.size(0), 0u);
+    ASSERT_EQ(lists.size(1), 2u);
+    ASSERT_EQ(lists.size(2), 4u);
+
+    ASSERT_EQ(lists.bgn(1)[0].pool, 1u);
+    ASSERT_EQ(lists.bgn(1)[0].order, 2u);
+    ASSERT_EQ(lists.bgn(1)[1].pool, 4u);
+    ASSERT_EQ(lists.bgn(1)[1].order, 1u);
+    ASSERT_EQ(lists.end(1), lists.bgn(2));
+}
+
+TEST(Reactants, MatchesDenseScan) {
+    const uint nspecs = 5;
+    const std::vector<std::vector<uint>> rules = {
+        {0, 0, 0, 0, 0},
+        {0, 0, 1, 0, 0},
+        {0, 2, 0, 0, 0},
+        {1, 0, 0, 1, 0},
+        {0, 3, 0, 0, 1},
+        {4, 0, 0, 0, 0},
+        {1, 1, 1, 1, 0},
+        {1, 1, 1, 1, 1},
+    };
+    std::vector<uint> lhs;
+    for (auto const & r: rules) lhs.insert(lhs.end(), r.begin(), r.end());
+
+    ReactantLists lists;
+    lists.assign(lhs.data(), rules.size(), nspecs);
+
+    const std::vector<std::vector<uint>> states = {
+        {0, 0, 0, 0, 0},
+        {1, 2, 3, 4, 5},
+        {10, 1, 7, 0, 3},
+        {1000000, 3, 1, 2, 100000},
+    };
+    for (auto const & pools: states) {
+        std::vector<double> dpools(pools.begin(), pools.end());
+        for (uint r = 0; r < rules.size(); ++r) {
+            double ref = dense_comb(lhs.data() + r * nspecs, pools);
+            ASSERT_EQ(reac_comb(lists.bgn(r), lists.end(r), pools), ref);
+            ASSERT_EQ(reac_comb(lists.bgn(r), lists.end(r), dpools), ref);
+            ASSERT_EQ(reac_comb(lists.bgn(r), lists.end(r), pools, 2.0), 2.0 * ref);
+        }
+    }
+}
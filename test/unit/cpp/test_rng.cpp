@@ -1,12 +1,16 @@
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <vector>
 #include <map>
 #include <utility>
 #include <iostream>
 #include <iterator>
 #include <algorithm>
+#include <thread>
 
 #include "rng/create.hpp"
+#include "rng/distribution_tables.hpp"
 #include "util/error.hpp"
 #include "math/tools.hpp"
 
@@ -53,15 +57,18 @@ inline double cdf_chi_squared_distribution(double x,
 }
 
 /// Chi-squared goodness of fit test for binomial distribution
-void binomial_check(const std::string &str, uint t, double p, uint t_test, double p_test, const uint n_sample, double level_confidence) {
+void binomial_check(const std::string &str, uint t, double p, uint t_test, double p_test, const uint n_sample, double level_confidence, bool bulk = false) {
     std::vector<uint> vec_rng(n_sample);
 
     auto rng = create(str, n_sample);
     rng->initialize(12345u);
 
     /// Generating samples from the supposed binomial
-    for (uint i = 0; i < n_sample; ++i)
-        vec_rng[i] = rng->getBinom(t, p);
+    if (bulk)
+        rng->fillBinom(vec_rng.data(), n_sample, t, p);
+    else
+        for (uint i = 0; i < n_sample; ++i)
+            vec_rng[i] = rng->getBinom(t, p);
 
     /// Calculating observed and expected counts from binomial
     std::vector<uint>   vec_observed(t + 1, 0);
@@ -184,4 +191,296 @@ TEST(rng, kendall_r123) {
     const ulong seed2 = 2;
     const double p_value = kendall_rank_correlation_check("r123", n_sample, seed1, seed2);
     assert_pvalue(p_value, level_confidence);
-}
\ No newline at end of file
+}
+/// Restoring a checkpoint resumes the exact same stream
+void checkpoint_check(const std::string &str) {
+    const uint bufsize = 64;
+    auto rng = create(str, bufsize);
+    rng->initialize(12345u);
+    // stop in the middle of a buffer
+    for (uint i = 0; i < 3 * bufsize / 2; ++i) rng->get();
+
+    const std::string cp_name = "test_rng_checkpoint_" + str + ".bin";
+    std::fstream cp_file(cp_name, std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    rng->checkpoint(cp_file);
+    cp_file.close();
+
+    std::vector<uint> expected(4 * bufsize);
+    for (auto& v: expected) v = rng->get();
+
+    auto restored = create(str, bufsize);
+    restored->initialize(1u);
+    cp_file.open(cp_name, std::fstream::in | std::fstream::binary);
+    restored->restore(cp_file);
+    cp_file.close();
+    std::remove(cp_name.c_str());
+
+    for (auto v: expected) ASSERT_EQ(restored->get(), v);
+}
+
+TEST(rng, checkpoint_mt) {
+    checkpoint_check("mt19937");
+}
+
+TEST(rng, checkpoint_r123) {
+    checkpoint_check("r123");
+}
+
+/// Kolmogorov-Smirnov test of a sample against a continuous distribution
+template <typename CDF>
+void ks_check(std::vector<double> sample, CDF cdf, const std::string& what) {
+    std::sort(sample.begin(), sample.end());
+    const double n = sample.size();
+    double dist = 0.;
+    for (size_t i = 0; i < sample.size(); ++i) {
+        const double f = cdf(sample[i]);
+        dist = std::max(dist, std::max(f - i / n, (i + 1) / n - f));
+    }
+    /// critical value for a level of confidence of 0.999
+    ASSERT_LE(dist, 1.949 / std::sqrt(n)) << "FAILED Kolmogorov-Smirnov test for " << what;
+}
+
+void std_exp_check(const std::string &str) {
+    const uint n_sample = 100000;
+    auto rng = create(str, 1000);
+    rng->initialize(12345u);
+
+    std::vector<double> sample(n_sample);
+    for (auto& v: sample) v = rng->getStdExp();
+    ks_check(sample, [](double x) { return 1. - std::exp(-x); }, "getStdExp");
+
+    for (auto& v: sample) v = rng->getExp(4.);
+    ks_check(sample, [](double x) { return 1. - std::exp(-4. * x); }, "getExp");
+
+    /// one rate per number, scaled back to the standard distribution
+    std::vector<double> lambda(n_sample);
+    for (uint i = 0; i < n_sample; ++i) lambda[i] = 0.5 + i % 7;
+    rng->fillExp(lambda.data(), sample.data(), n_sample);
+    for (uint i = 0; i < n_sample; ++i) sample[i] *= lambda[i];
+    ks_check(sample, [](double x) { return 1. - std::exp(-x); }, "fillExp");
+}
+
+TEST(rng, exp_mt) {
+    std_exp_check("mt19937");
+}
+
+TEST(rng, exp_r123) {
+    std_exp_check("r123");
+}
+
+void std_nrm_check(const std::string &str) {
+    const uint n_sample = 100000;
+    auto rng = create(str, 1000);
+    rng->initialize(12345u);
+
+    std::vector<double> sample(n_sample);
+    for (auto& v: sample) v = rng->getStdNrm();
+    ks_check(sample, [](double x) { return cdf_normal_distribution(x); }, "getStdNrm");
+}
+
+TEST(rng, normal_mt) {
+    std_nrm_check("mt19937");
+}
+
+TEST(rng, normal_r123) {
+    std_nrm_check("r123");
+}
+
+/// Chi-squared goodness of fit test for Poisson distribution, the bins with
+/// less than 5 expected counts being merged with their neighbours
+void poisson_check(const std::string &str, double mean, const uint n_sample, double level_confidence) {
+    auto rng = create(str, 1000);
+    rng->initialize(12345u);
+
+    const uint kmax = static_cast<uint>(mean + 10. * std::sqrt(mean) + 10.);
+    std::vector<double> observed(kmax + 1, 0.);
+    for (uint i = 0; i < n_sample; ++i) {
+        const long k = rng->getPsn(1. / mean);
+        ASSERT_GE(k, 0);
+        ++observed[std::min(static_cast<uint>(k), kmax)];
+    }
+
+    std::vector<double> expected(kmax + 1);
+    double pk = std::exp(-mean), cumul = 0.;
+    for (uint k = 0; k < kmax; ++k) {
+        expected[k] = n_sample * pk;
+        cumul += pk;
+        pk *= mean / (k + 1);
+    }
+    expected[kmax] = n_sample * (1. - cumul);
+
+    double chi = 0., exp_bin = 0., obs_bin = 0.;
+    uint nbins = 0;
+    for (uint k = 0; k <= kmax; ++k) {
+        exp_bin += expected[k];
+        obs_bin += observed[k];
+        if (exp_bin >= 5. || k == kmax) {
+            chi += (exp_bin - obs_bin) * (exp_bin - obs_bin) / exp_bin;
+            exp_bin = obs_bin = 0.;
+            ++nbins;
+        }
+    }
+    const double p_value = 1 - cdf_chi_squared_distribution(chi, nbins - 1);
+    ASSERT_GE(p_value, 1 - level_confidence) << "FAILED Goodness of Fit test (chi-squared) for a Poisson distribution of mean "
+                                             << mean << ": p_value is " << p_value;
+}
+
+TEST(rng, poisson_mt) {
+    /// both the table lookup (mean < 10) and the normal approximation cases
+    poisson_check("mt19937", 4., 100000, 0.999);
+    poisson_check("mt19937", 40., 100000, 0.999);
+}
+
+TEST(rng, poisson_r123) {
+    poisson_check("r123", 4., 100000, 0.999);
+    poisson_check("r123", 40., 100000, 0.999);
+}
+
+/// The constants of the samplers against their closed forms: the single
+/// precision values they replace are off by 1e-8 to 1e-7.
+TEST(rng, exp_table) {
+    long double term = 1.L, q = 0.L;
+    for (int k = 0; k < 8; ++k) {
+        term *= std::log(2.L) / (k + 1);
+        q += term;
+        EXPECT_DOUBLE_EQ(STD_EXP_Q[k], static_cast<double>(q)) << "q[" << k << "]";
+    }
+}
+
+TEST(rng, normal_tables) {
+    for (int k = 0; k < 32; ++k) {
+        EXPECT_NEAR(cdf_normal_distribution(STD_NRM_A[k]), 0.5 + k / 64., 1e-15) << "a[" << k << "]";
+    }
+    /// the tail steps add up to the quantiles of 1 - 2^-(k+2)
+    double x = STD_NRM_A[31];
+    for (int k = 0; k < 31; ++k) {
+        if (k < 5) {
+            EXPECT_EQ(STD_NRM_D[k], 0.) << "d[" << k << "]";
+            continue;
+        }
+        x += STD_NRM_D[k];
+        const double tail = 0.5 * std::erfc(x / std::sqrt(2.));
+        EXPECT_NEAR(tail * std::ldexp(1., k + 2), 1., 1e-12) << "d[" << k << "]";
+    }
+    for (int k = 0; k < 31; ++k) {
+        const double a0 = STD_NRM_A[k], a1 = STD_NRM_A[k + 1];
+        const double t = 0.5 * (a1 * a1 - a0 * a0);
+        EXPECT_NEAR(STD_NRM_T[k], t, 4e-15 * t) << "t[" << k << "]";
+        const double h = (a1 - a0) / (1. - STD_NRM_T[k]);
+        EXPECT_NEAR(STD_NRM_H[k], h, 4e-15 * h) << "h[" << k << "]";
+    }
+}
+
+TEST(rng, poisson_tables) {
+    EXPECT_DOUBLE_EQ(INV_SQRT_2PI, 1. / std::sqrt(2. * M_PI));
+    for (int k = 0; k < 25; ++k) {
+        EXPECT_EQ(PSN_LOG_A[k], (k % 2 ? 1. : -1.) / (k + 2)) << "a[" << k << "]";
+    }
+    /// B_2n / (2n (2n - 1))
+    const double num[7] = {1., -1., 1., -1., 1., -691., 1.};
+    const double den[7] = {12., 360., 1260., 1680., 1188., 360360., 156.};
+    for (int k = 0; k < 7; ++k) {
+        EXPECT_EQ(PSN_STIRLING[k], num[k] / den[k]) << "stirling[" << k << "]";
+    }
+}
+
+/// Mean and variance of a large sample from fillBinom, for numbers of trials
+/// not handled by small_binomial
+void binomial_moments_check(const std::string &str, uint t, double p) {
+    const uint n_sample = 100000;
+    auto rng = create(str, 1000);
+    rng->initialize(12345u);
+
+    std::vector<uint> sample(n_sample);
+    rng->fillBinom(sample.data(), n_sample, t, p);
+    double mean = 0., var = 0.;
+    for (auto k: sample) mean += k;
+    mean /= n_sample;
+    for (auto k: sample) var += (k - mean) * (k - mean);
+    var /= n_sample - 1;
+
+    /// within 5 standard errors
+    const double exp_var = t * p * (1. - p);
+    ASSERT_NEAR(mean, t * p, 5. * std::sqrt(exp_var / n_sample));
+    ASSERT_NEAR(var, exp_var, 5. * exp_var * std::sqrt(2. / n_sample));
+}
+
+TEST(rng, binomial_bulk_mt) {
+    binomial_check("mt19937", 10, 0.3, 10, 0.3, 10000, 0.999, true);
+    binomial_check("mt19937", 8, 0.4, 8, 0.4, 10000, 0.999, true);
+    binomial_moments_check("mt19937", 40, 0.4);
+    binomial_moments_check("mt19937", 1000, 0.02);
+}
+
+TEST(rng, binomial_bulk_r123) {
+    binomial_check("r123", 10, 0.3, 10, 0.3, 10000, 0.999, true);
+    binomial_check("r123", 8, 0.4, 8, 0.4, 10000, 0.999, true);
+    binomial_moments_check("r123", 40, 0.4);
+    binomial_moments_check("r123", 1000, 0.02);
+}
+
+/// fillUnf returns the same numbers as getUnfIE, across buffer refills
+void fill_unf_check(const std::string &str) {
+    const uint bufsize = 64;
+    auto rng1 = create(str, bufsize);
+    rng1->initialize(12345u);
+    auto rng2 = create(str, bufsize);
+    rng2->initialize(12345u);
+
+    rng1->get();
+    rng2->get();
+    std::vector<double> values(10 * bufsize + 3);
+    rng1->fillUnf(values.data(), values.size());
+    for (auto v: values) ASSERT_EQ(v, rng2->getUnfIE());
+    ASSERT_EQ(rng1->get(), rng2->get());
+}
+
+TEST(rng, fill_unf_mt) {
+    fill_unf_check("mt19937");
+}
+
+TEST(rng, fill_unf_r123) {
+    fill_unf_check("r123");
+}
+
+/// Generators used concurrently, one per thread, return the same numbers as
+/// when used one after the other
+void threads_check(const std::string &str) {
+    const uint n_threads = 4;
+    const uint n_sample = 20000;
+    auto draw = [&str](ulong seed, std::vector<double>& out) {
+        auto rng = create(str, 256);
+        rng->initialize(seed);
+        out.resize(4 * n_sample);
+        for (uint i = 0; i < n_sample; ++i) {
+            /// alternate the means to exercise the cached Poisson parameters
+            out[4 * i] = rng->getPsn(1. / (2. + seed));
+            out[4 * i + 1] = rng->getPsn(1. / (20. + seed));
+            out[4 * i + 2] = rng->getStdExp();
+            out[4 * i + 3] = rng->getStdNrm();
+        }
+    };
+
+    std::vector<std::vector<double>> serial(n_threads), concurrent(n_threads);
+    for (uint t = 0; t < n_threads; ++t) {
+        draw(t + 1, serial[t]);
+    }
+    std::vector<std::thread> threads;
+    for (uint t = 0; t < n_threads; ++t) {
+        threads.emplace_back(draw, t + 1, std::ref(concurrent[t]));
+    }
+    for (auto& t: threads) {
+        t.join();
+    }
+    for (uint t = 0; t < n_threads; ++t) {
+        ASSERT_EQ(serial[t], concurrent[t]) << "generator " << t;
+    }
+}
+
+TEST(rng, threads_mt) {
+    threads_check("mt19937");
+}
+
+TEST(rng, threads_r123) {
+    threads_check("r123");
+}
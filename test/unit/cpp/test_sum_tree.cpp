@@ -0,0 +1,82 @@
+#include "mpi/dist/tetopsplit/kproc/sum_tree.hpp"
+
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using steps::dist::kproc::SumTree;
+
+// Reference: first index whose inclusive prefix sum is greater than weight
+static size_t linear_search(const std::vector<double>& values, double weight) {
+    double sum{};
+    for (size_t k = 0; k < values.size(); k++) {
+        sum += values[k];
+        if (weight < sum) {
+            return k;
+        }
+    }
+    return values.size() - 1;
+}
+
+TEST(SumTree, UpdateAndSearch) {
+    SumTree<double> tree(5);
+    ASSERT_EQ(tree.size(), 5u);
+    ASSERT_EQ(tree.total(), 0.);
+
+    tree.update(0, 1.);
+    tree.update(2, 2.);
+    tree.update(4, 4.);
+    ASSERT_EQ(tree.total(), 7.);
+    ASSERT_EQ(tree[2], 2.);
+
+    ASSERT_EQ(tree.search(0.), 0u);
+    ASSERT_EQ(tree.search(0.5), 0u);
+    ASSERT_EQ(tree.search(1.), 2u);
+    ASSERT_EQ(tree.search(2.9), 2u);
+    ASSERT_EQ(tree.search(3.), 4u);
+    ASSERT_EQ(tree.search(6.9), 4u);
+
+    // a weight beyond the total never lands on a zero value or the padding
+    ASSERT_EQ(tree.search(7.), 4u);
+    ASSERT_EQ(tree.search(100.), 4u);
+
+    tree.update(4, 0.);
+    ASSERT_EQ(tree.total(), 3.);
+    ASSERT_EQ(tree.search(3.), 2u);
+}
+
+TEST(SumTree, SingleValue) {
+    SumTree<double> tree(1);
+    tree.update(0, 0.25);
+    ASSERT_EQ(tree.total(), 0.25);
+    ASSERT_EQ(tree.search(0.1), 0u);
+}
+
+TEST(SumTree, MatchesLinearSearch) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> integer(0, 10);
+    const size_t size = 1000;
+
+    // integer values keep all sums exact
+    std::vector<double> values(size);
+    SumTree<double> tree(size);
+    for (size_t k = 0; k < size; k++) {
+        values[k] = integer(rng);
+        tree.set(k, values[k]);
+    }
+    tree.rebuild();
+
+    std::uniform_int_distribution<size_t> index(0, size - 1);
+    for (int i = 0; i < 10000; i++) {
+        const auto k = index(rng);
+        values[k] = integer(rng);
+        tree.update(k, values[k]);
+
+        const double total = std::accumulate(values.begin(), values.end(), 0.);
+        ASSERT_EQ(tree.total(), total);
+        const double weight = std::uniform_real_distribution<double>(0., total)(rng);
+        ASSERT_EQ(tree.search(weight), linear_search(values, weight));
+    }
+}
@@ -0,0 +1,191 @@
+#include "geom/memb.hpp"
+#include "geom/tetmesh.hpp"
+#include "geom/tmcomp.hpp"
+#include "geom/tmpatch.hpp"
+#include "model/chan.hpp"
+#include "model/chanstate.hpp"
+#include "model/diff.hpp"
+#include "model/ghkcurr.hpp"
+#include "model/model.hpp"
+#include "model/ohmiccurr.hpp"
+#include "model/reac.hpp"
+#include "model/spec.hpp"
+#include "model/surfsys.hpp"
+#include "model/vdepsreac.hpp"
+#include "model/volsys.hpp"
+#include "rng/create.hpp"
+#include "solver/efield/ohmiccurrents.hpp"
+#include "tetexact/tetexact.hpp"
+#include "tetexact/tri.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cube_mesh.hpp"
+
+using namespace steps;
+
+// A membrane with voltage-dependent channels carrying an ohmic and a GHK
+// current, around a cube of 2^3 cells.
+struct TetexactEFieldTest: public ::testing::Test {
+    model::Model mdl;
+    std::unique_ptr<tetmesh::Tetmesh> mesh;
+    std::unique_ptr<tetmesh::TmComp> comp;
+    std::unique_ptr<tetmesh::TmPatch> patch;
+
+    void SetUp() override {
+        auto* vsys = new model::Volsys("vsys", &mdl);
+        auto* ssys = new model::Surfsys("ssys", &mdl);
+        auto* A = new model::Spec("A", &mdl);
+        auto* Ca = new model::Spec("Ca", &mdl, 2);
+        new model::Reac("prod", vsys, {}, {A}, 1e-13);
+        new model::Diff("diffA", vsys, A, 1e-12);
+        new model::Diff("diffCa", vsys, Ca, 1e-12);
+
+        auto* chan = new model::Chan("chan", &mdl);
+        auto* closed = new model::ChanState("closed", &mdl, chan);
+        auto* open = new model::ChanState("open", &mdl, chan);
+        const double vmin = -0.2, vmax = 0.2, dv = 1e-4;
+        const auto tablesize = static_cast<uint>(std::lround((vmax - vmin) / dv)) + 1;
+        std::vector<double> kf(tablesize), kb(tablesize);
+        for (uint i = 0; i < tablesize; i++) {
+            const double v = vmin + i * dv;
+            kf[i] = 1e3 * std::exp(v / 0.02);
+            kb[i] = 1e3 * std::exp(-v / 0.02);
+        }
+        new model::VDepSReac("opening", ssys, {}, {}, {closed}, {}, {open}, {}, kf, vmin, vmax, dv,
+                             tablesize);
+        new model::VDepSReac("closing", ssys, {}, {}, {open}, {}, {closed}, {}, kb, vmin, vmax, dv,
+                             tablesize);
+        new model::OhmicCurr("leak", ssys, open, -0.077, 20e-12);
+        auto* ghk = new model::GHKcurr("caflux", ssys, open, Ca, true, 2e-3);
+        ghk->setP(2.5e-20);
+
+        mesh = make_cube(2, 1e-6);
+        std::vector<index_t> tets(mesh->countTets());
+        for (index_t t = 0; t < mesh->countTets(); t++) {
+            tets[t] = t;
+        }
+        comp = std::make_unique<tetmesh::TmComp>("comp", mesh.get(), tets);
+        comp->addVolsys("vsys");
+        patch = std::make_unique<tetmesh::TmPatch>("patch", mesh.get(), mesh->getSurfTris(),
+                                                   comp.get());
+        patch->addSurfsys("ssys");
+        // owned by the mesh
+        new tetmesh::Memb("memb", mesh.get(), {patch.get()});
+    }
+
+    std::unique_ptr<tetexact::Tetexact> make_sim() {
+        auto r = rng::create("mt19937", 512);
+        r->initialize(7);
+        auto sim = std::make_unique<tetexact::Tetexact>(&mdl, mesh.get(), r,
+                                                        solver::API::EF_DEFAULT);
+        sim->setEfieldVTolerance(0.0);
+        sim->setPatchCount("patch", "closed", 2000);
+        sim->setCompConc("comp", "Ca", 1e-6);
+        sim->setMembPotential("memb", -0.065);
+        sim->setMembCapac("memb", 1e-2);
+        sim->setMembVolRes("memb", 1.0);
+        return sim;
+    }
+
+    // Setting a rate constant to its current value recomputes all rates.
+    static void full_update(tetexact::Tetexact& sim) {
+        sim.setCompReacK("comp", "prod", sim.getCompReacK("comp", "prod"));
+    }
+
+    // Run sim and reference in steps of dt up to endtime, with a full update
+    // of the reference after each step.
+    static void run_with_full_updates(tetexact::Tetexact& sim,
+                                      tetexact::Tetexact& reference,
+                                      double dt,
+                                      double endtime) {
+        for (double t = sim.getTime() + dt; t <= endtime + dt / 2; t += dt) {
+            sim.run(t);
+            reference.run(t);
+            full_update(reference);
+        }
+    }
+
+    void expect_same_state(tetexact::Tetexact& sim, tetexact::Tetexact& reference) {
+        EXPECT_EQ(sim.getTime(), reference.getTime());
+        EXPECT_EQ(sim.getCompCount("comp", "A"), reference.getCompCount("comp", "A"));
+        EXPECT_EQ(sim.getCompCount("comp", "Ca"), reference.getCompCount("comp", "Ca"));
+        for (auto t: mesh->getSurfTris()) {
+            EXPECT_EQ(sim.getTriCount(t, "open"), reference.getTriCount(t, "open")) << "tri " << t;
+            EXPECT_EQ(sim.getTriV(t), reference.getTriV(t)) << "tri " << t;
+        }
+    }
+};
+
+TEST_F(TetexactEFieldTest, vdep_update_matches_full_update) {
+    auto sim = make_sim();
+    auto reference = make_sim();
+    run_with_full_updates(*sim, *reference, 1e-4, 2e-3);
+    EXPECT_GT(sim->getPatchCount("patch", "open"), 0.0);
+    expect_same_state(*sim, *reference);
+}
+
+TEST_F(TetexactEFieldTest, vdep_update_after_set_temp) {
+    auto sim = make_sim();
+    auto reference = make_sim();
+    // with a clamped potential, the voltage-dependent rates are never
+    // refreshed after EField steps
+    for (index_t v = 0; v < mesh->countVertices(); v++) {
+        sim->setVertVClamped(vertex_id_t(v), true);
+        reference->setVertVClamped(vertex_id_t(v), true);
+    }
+    run_with_full_updates(*sim, *reference, 1e-4, 1e-3);
+    const double ca = sim->getCompCount("comp", "Ca");
+
+    sim->setTemp(310.0);
+    reference->setTemp(310.0);
+    full_update(*reference);
+    // all GHK rates scale with the temperature, so stale rates would show in
+    // the total propensity before they show in the trajectory
+    EXPECT_EQ(sim->getA0(), reference->getA0());
+    run_with_full_updates(*sim, *reference, 1e-4, 2e-3);
+    EXPECT_NE(sim->getCompCount("comp", "Ca"), ca);
+    expect_same_state(*sim, *reference);
+}
+
+TEST_F(TetexactEFieldTest, batched_currents_match_tri_currents) {
+    auto sim = make_sim();
+    auto reference = make_sim();
+    sim->run(1e-3);
+    reference->run(1e-3);
+    // currents over the next dt, with the channel counts of the end of the
+    // run; the GHK charges of the events are set by hand
+    const double dt = 5e-5;
+    const double simtime = sim->getTime() + dt;
+    const double efdt = sim->getEfieldDT();
+
+    const auto tris = mesh->getSurfTris();
+    std::vector<double> v(tris.size());
+    std::vector<double> cur(tris.size(), 0.0);
+    solver::efield::OhmicCurrents ocs;
+    for (index_t i = 0; i < tris.size(); i++) {
+        const triangle_id_t tri(tris[i]);
+        v[i] = sim->getTriV(tri);
+        sim->_tri(tri)->setupOhmicCurrents(ocs, i, i);
+        sim->_tri(tri)->incECharge(0, 2 * static_cast<int>(i % 3 + 1));
+        reference->_tri(tri)->incECharge(0, 2 * static_cast<int>(i % 3 + 1));
+    }
+    EXPECT_EQ(ocs.size(), tris.size());
+    ocs.compute(v.data(), simtime, dt, cur.data());
+    EXPECT_TRUE(std::any_of(cur.begin(), cur.end(), [](double c) { return c != 0.0; }));
+    for (index_t i = 0; i < tris.size(); i++) {
+        cur[i] += sim->_tri(triangle_id_t(tris[i]))->computeGHKI(dt, efdt, simtime);
+    }
+
+    for (index_t i = 0; i < tris.size(); i++) {
+        const triangle_id_t tri(tris[i]);
+        const auto expected = reference->_tri(tri)->computeI(v[i], dt, simtime, efdt);
+        EXPECT_NE(expected, 0.0) << "tri " << tri;
+        EXPECT_DOUBLE_EQ(cur[i], expected) << "tri " << tri;
+    }
+}
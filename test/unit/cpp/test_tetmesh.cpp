@@ -1,9 +1,18 @@
 #include "geom/tetmesh.hpp"
+#include "geom/tetmesh_rw.hpp"
+#include "geom/tmcomp.hpp"
+#include "geom/tmpatch.hpp"
+#include "math/tetrahedron.hpp"
+#include "util/error.hpp"
 
 #include <iostream>
 #include <memory>
 #include <limits>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -425,4 +434,154 @@ TEST_F(TetmeshTest,intersectDeterministic_notFirstNeighbor) {
     for (const auto& r: res)
         sum += r.second;
     ASSERT_DOUBLE_EQ(sum, 1.0);
-}
\ No newline at end of file
+}
+TEST_F(TetmeshTest,findTetByPoint) {
+    const auto bmin = mesh->getBoundMin();
+    const auto bmax = mesh->getBoundMax();
+    const size_t nTets = mesh->countTets();
+
+    // centers, vertices and a regular lattice over the bounding box
+    std::vector<point3d> points;
+    for (index_t t = 0u; t < nTets; ++t) {
+        points.push_back(mesh->_getTetBarycenter(t));
+    }
+    for (index_t v = 0u; v < mesh->countVertices(); ++v) {
+        points.push_back(mesh->_getVertex(v));
+    }
+    const int n = 12;
+    for (int i = -1; i <= n + 1; ++i) {
+        for (int j = -1; j <= n + 1; ++j) {
+            for (int k = -1; k <= n + 1; ++k) {
+                points.emplace_back(bmin[0] + (bmax[0] - bmin[0]) * i / n,
+                                    bmin[1] + (bmax[1] - bmin[1]) * j / n,
+                                    bmin[2] + (bmax[2] - bmin[2]) * k / n);
+            }
+        }
+    }
+
+    std::vector<double> coords;
+    for (const auto& p: points) {
+        coords.insert(coords.end(), {p[0], p[1], p[2]});
+    }
+    std::vector<index_t> tets(points.size());
+    mesh->findTetsByPointsNP(coords.data(), coords.size(), tets.data(), tets.size());
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        // first tetrahedron found by a linear scan
+        steps::tetrahedron_id_t expected(steps::tetrahedron_id_t::unknown_value());
+        for (index_t t = 0u; t < nTets; ++t) {
+            const auto* v = mesh->_getTet(t);
+            if (steps::math::tet_inside(mesh->_getVertex(v[0]), mesh->_getVertex(v[1]),
+                                        mesh->_getVertex(v[2]), mesh->_getVertex(v[3]),
+                                        points[i])) {
+                expected = t;
+                break;
+            }
+        }
+        ASSERT_EQ(mesh->findTetByPoint(points[i]), expected);
+        ASSERT_EQ(tets[i], expected.get());
+    }
+
+    ASSERT_THROW(mesh->findTetsByPointsNP(coords.data(), coords.size() - 1,
+                                          tets.data(), tets.size()),
+                 steps::ArgErr);
+}
+
+TEST_F(TetmeshTest,findTetByPoint_threads) {
+    // the first queries come from several threads at once, each of them
+    // needing the point location grid
+    const size_t nTets = mesh->countTets();
+    std::vector<double> coords;
+    for (index_t t = 0u; t < nTets; ++t) {
+        const auto p = mesh->_getTetBarycenter(t);
+        coords.insert(coords.end(), {p[0], p[1], p[2]});
+    }
+    std::vector<std::vector<index_t>> tets(4, std::vector<index_t>(nTets));
+    std::vector<std::thread> threads;
+    for (auto& r: tets) {
+        threads.emplace_back([&] {
+            mesh->findTetsByPointsNP(coords.data(), coords.size(), r.data(), r.size());
+        });
+    }
+    for (auto& th: threads) {
+        th.join();
+    }
+    for (const auto& r: tets) {
+        for (index_t t = 0u; t < nTets; ++t) {
+            ASSERT_EQ(r[t], t);
+        }
+    }
+}
+
+TEST_F(TetmeshTest, binary_round_trip) {
+    std::vector<index_t> all_tets(mesh->countTets());
+    for (index_t t = 0u; t < mesh->countTets(); ++t) {
+        all_tets[t] = t;
+    }
+    auto comp = new steps::tetmesh::TmComp("comp", mesh.get(), all_tets);
+    comp->addVolsys("vsys");
+    const auto surf_tris = mesh->getSurfTris();
+    auto patch = new steps::tetmesh::TmPatch("patch", mesh.get(), surf_tris, comp);
+    patch->addSurfsys("ssys");
+    mesh->rois.insert<steps::tetmesh::ROI_TET>("roi", {2, 0});
+    mesh->rois.insert<steps::tetmesh::ROI_VERTEX>("verts", {1, 3, 2});
+
+    const std::string path = "test_tetmesh_binary_round_trip.stm";
+    steps::tetmesh::saveBinary(path, mesh.get());
+    std::unique_ptr<Tetmesh> loaded(steps::tetmesh::loadBinary(path));
+    std::remove(path.c_str());
+
+    ASSERT_EQ(loaded->countVertices(), mesh->countVertices());
+    ASSERT_EQ(loaded->countBars(), mesh->countBars());
+    ASSERT_EQ(loaded->countTris(), mesh->countTris());
+    ASSERT_EQ(loaded->countTets(), mesh->countTets());
+    for (index_t v = 0u; v < mesh->countVertices(); ++v) {
+        ASSERT_EQ(loaded->getVertex(v), mesh->getVertex(v));
+    }
+    for (index_t b = 0u; b < mesh->countBars(); ++b) {
+        ASSERT_EQ(loaded->getBar(b), mesh->getBar(b));
+    }
+    for (index_t t = 0u; t < mesh->countTris(); ++t) {
+        ASSERT_EQ(loaded->getTri(t), mesh->getTri(t));
+        ASSERT_EQ(loaded->getTriBars(t), mesh->getTriBars(t));
+        ASSERT_EQ(loaded->getTriArea(t), mesh->getTriArea(t));
+        ASSERT_EQ(loaded->getTriNorm(t), mesh->getTriNorm(t));
+        ASSERT_EQ(loaded->getTriBarycenter(t), mesh->getTriBarycenter(t));
+        ASSERT_EQ(loaded->getTriTetNeighb(t), mesh->getTriTetNeighb(t));
+    }
+    for (index_t t = 0u; t < mesh->countTets(); ++t) {
+        ASSERT_EQ(loaded->getTet(t), mesh->getTet(t));
+        ASSERT_EQ(loaded->getTetVol(t), mesh->getTetVol(t));
+        ASSERT_EQ(loaded->getTetBarycenter(t), mesh->getTetBarycenter(t));
+        ASSERT_EQ(loaded->getTetTriNeighb(t), mesh->getTetTriNeighb(t));
+        ASSERT_EQ(loaded->getTetTetNeighb(t), mesh->getTetTetNeighb(t));
+    }
+
+    auto loaded_comp = dynamic_cast<steps::tetmesh::TmComp*>(loaded->getComp("comp"));
+    ASSERT_NE(loaded_comp, nullptr);
+    ASSERT_EQ(loaded_comp->getAllTetIndices(), all_tets);
+    ASSERT_EQ(loaded_comp->getVolsys(), comp->getVolsys());
+    ASSERT_DOUBLE_EQ(loaded_comp->getVol(), comp->getVol());
+
+    auto loaded_patch = dynamic_cast<steps::tetmesh::TmPatch*>(loaded->getPatch("patch"));
+    ASSERT_NE(loaded_patch, nullptr);
+    ASSERT_EQ(loaded_patch->getIComp(), loaded_comp);
+    ASSERT_EQ(loaded_patch->getOComp(), nullptr);
+    ASSERT_EQ(loaded_patch->getAllTriIndices(), patch->getAllTriIndices());
+    ASSERT_EQ(loaded_patch->getSurfsys(), patch->getSurfsys());
+
+    ASSERT_EQ(loaded->rois.tets_roi, mesh->rois.tets_roi);
+    ASSERT_EQ(loaded->rois.vertices_roi, mesh->rois.vertices_roi);
+    ASSERT_TRUE(loaded->rois.tris_roi.empty());
+}
+
+TEST(TetmeshBinary, rejects_other_files) {
+    const std::string path = "test_tetmesh_binary_rejects.stm";
+    {
+        std::ofstream out(path);
+        out << "not a mesh";
+    }
+    ASSERT_THROW(steps::tetmesh::loadBinary(path), steps::IOErr);
+    std::remove(path.c_str());
+    ASSERT_THROW(steps::tetmesh::loadBinary(path), steps::IOErr);
+}
@@ -0,0 +1,127 @@
+#include "geom/tetmesh.hpp"
+#include "geom/tmcomp.hpp"
+#include "geom/tmpatch.hpp"
+#include "model/diff.hpp"
+#include "model/model.hpp"
+#include "model/reac.hpp"
+#include "model/spec.hpp"
+#include "model/sreac.hpp"
+#include "model/surfsys.hpp"
+#include "model/volsys.hpp"
+#include "rng/create.hpp"
+#include "tetode/blockjacobi.hpp"
+#include "tetode/tetode.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cube_mesh.hpp"
+
+using namespace steps;
+
+// A fast reversible reaction, a dimerisation and diffusion in a cube of 2^3
+// cells, and binding of A to a receptor on its surface.
+struct TetODEStiffTest: public ::testing::Test {
+    model::Model mdl;
+    std::unique_ptr<tetmesh::Tetmesh> mesh;
+    std::unique_ptr<tetmesh::TmComp> comp;
+    std::unique_ptr<tetmesh::TmPatch> patch;
+
+    void SetUp() override {
+        auto* A = new model::Spec("A", &mdl);
+        auto* B = new model::Spec("B", &mdl);
+        auto* C = new model::Spec("C", &mdl);
+        auto* R = new model::Spec("R", &mdl);
+        auto* RA = new model::Spec("RA", &mdl);
+        auto* vsys = new model::Volsys("vsys", &mdl);
+        auto* ssys = new model::Surfsys("ssys", &mdl);
+        new model::Reac("fwd", vsys, {A}, {B}, 1e4);
+        new model::Reac("bwd", vsys, {B}, {A}, 2e4);
+        new model::Reac("dim", vsys, {A, B}, {C}, 1e8);
+        new model::Diff("diffA", vsys, A, 1e-12);
+        new model::Diff("diffC", vsys, C, 1e-13);
+        new model::SReac("bind", ssys, {}, {A}, {R}, {}, {RA}, {}, 1e8);
+        new model::SReac("unbind", ssys, {}, {}, {RA}, {A}, {R}, {}, 10.0);
+
+        mesh = make_cube(2, 1e-6);
+        std::vector<index_t> tets(mesh->countTets());
+        for (index_t t = 0; t < mesh->countTets(); t++) {
+            tets[t] = t;
+        }
+        comp = std::make_unique<tetmesh::TmComp>("comp", mesh.get(), tets);
+        comp->addVolsys("vsys");
+        patch = std::make_unique<tetmesh::TmPatch>("patch", mesh.get(), mesh->getSurfTris(),
+                                                   comp.get());
+        patch->addSurfsys("ssys");
+    }
+
+    std::unique_ptr<tetode::TetODE> make_sim(bool stiff) {
+        auto r = rng::create("mt19937", 512);
+        r->initialize(1);
+        auto sim = std::make_unique<tetode::TetODE>(&mdl, mesh.get(), r);
+        sim->setTolerances(1e-8, 1e-8);
+        sim->setMaxNumSteps(1000000);
+        sim->setStiff(stiff);
+        sim->setTetCount(tetrahedron_id_t(0), "A", 10000);
+        sim->setPatchCount("patch", "R", 1000);
+        return sim;
+    }
+};
+
+TEST_F(TetODEStiffTest, stiff_matches_adams) {
+    auto adams = make_sim(false);
+    auto stiff = make_sim(true);
+    EXPECT_FALSE(adams->getStiff());
+    EXPECT_TRUE(stiff->getStiff());
+
+    const auto last_tet = tetrahedron_id_t(static_cast<index_t>(mesh->countTets() - 1));
+    for (auto t: {0.001, 0.01, 0.1}) {
+        adams->run(t);
+        stiff->run(t);
+        for (auto s: {"A", "B", "C"}) {
+            const double expected = adams->getCompCount("comp", s);
+            EXPECT_GT(expected, 0.0) << "t " << t << ", species " << s;
+            EXPECT_NEAR(stiff->getCompCount("comp", s), expected, 1e-5 * expected)
+                << "t " << t << ", species " << s;
+            const double expected_last = adams->getTetCount(last_tet, s);
+            EXPECT_NEAR(stiff->getTetCount(last_tet, s), expected_last, 1e-5 * expected_last)
+                << "t " << t << ", species " << s;
+        }
+        const double expected = adams->getPatchCount("patch", "RA");
+        EXPECT_GT(expected, 0.0) << "t " << t;
+        EXPECT_NEAR(stiff->getPatchCount("patch", "RA"), expected, 1e-5 * expected)
+            << "t " << t;
+    }
+}
+
+// Two blocks of sizes 1 and 2 of I - gamma*J, with J = [[2, 0, 0], [0, 1, 3],
+// [0, 2, 1]]. The entry J[0][1] = 5 is outside the blocks.
+struct TetODEBlockJacobiTest: public ::testing::Test {
+    tetode::BlockJacobi prec;
+
+    void SetUp() override {
+        prec.init({0, 1, 3});
+        prec.setJacobian({0, 2, 4, 6}, {0, 1, 1, 2, 1, 2}, {2.0, 5.0, 1.0, 3.0, 2.0, 1.0});
+    }
+};
+
+TEST_F(TetODEBlockJacobiTest, solve) {
+    ASSERT_TRUE(prec.factor(0.25));
+    // I - gamma*J = [[0.5, 0, 0], [0, 0.75, -0.75], [0, -0.5, 0.75]]
+    const std::vector<double> x{2.0, 1.0, -1.0};
+    std::vector<double> b{0.5 * x[0], 0.75 * x[1] - 0.75 * x[2], -0.5 * x[1] + 0.75 * x[2]};
+    prec.solve(b.data());
+    for (size_t i = 0; i < x.size(); i++) {
+        EXPECT_NEAR(b[i], x[i], 1e-14) << "row " << i;
+    }
+}
+
+TEST_F(TetODEBlockJacobiTest, zero_pivot) {
+    // the first block is 1 - 0.5 * 2 = 0, which the preconditioner setup of
+    // the stiff solver reports to CVODE as a recoverable failure
+    EXPECT_FALSE(prec.factor(0.5));
+    // the second block is singular for gamma = 1 / (1 + sqrt(6)) only
+    EXPECT_TRUE(prec.factor(0.1));
+}
@@ -0,0 +1,133 @@
+#include "ensemble/wmensemble.hpp"
+#include "rng/create.hpp"
+#include "util/error.hpp"
+#include "wmdirect/wmdirect.hpp"
+#include "wmrk4/wmrk4.hpp"
+
+#include <memory>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "wm_model.hpp"
+
+using namespace steps;
+using steps::ensemble::WmEnsemble;
+using steps::ensemble::WmOverride;
+using steps::ensemble::WmSolverType;
+
+struct WmEnsembleTest: public WmModelTest {
+    std::vector<double> tpnts{0.0, 0.01, 0.02, 0.05, 0.1};
+
+    void setInit(solver::API& sim) {
+        sim.setCompCount("comp", "A", 500);
+        sim.setCompCount("comp", "B", 300);
+    }
+
+    void setInit(WmEnsemble& ens) {
+        ens.setCompCount("comp", "A", 500);
+        ens.setCompCount("comp", "B", 300);
+        ens.addCompCount("comp", "C");
+        ens.addPatchCount("patch", "S");
+    }
+
+    // counts of a single solver at the time points
+    std::vector<double> record(solver::API& sim) {
+        std::vector<double> counts;
+        for (auto t: tpnts) {
+            sim.run(t);
+            counts.push_back(sim.getCompCount("comp", "C"));
+            counts.push_back(sim.getPatchCount("patch", "S"));
+        }
+        return counts;
+    }
+};
+
+TEST_F(WmEnsembleTest, same_as_separate_solvers) {
+    const std::vector<uint> seeds{1, 2, 3, 4, 5, 6, 7};
+    WmEnsemble ens(&mdl, &geom, WmSolverType::Wmdirect);
+    setInit(ens);
+    ASSERT_EQ(ens.countObservables(), 2);
+
+    std::vector<double> counts(seeds.size() * tpnts.size() * 2);
+    ens.run(seeds, tpnts, counts.data(), counts.size());
+
+    const size_t stride = tpnts.size() * 2;
+    for (size_t i = 0; i < seeds.size(); i++) {
+        auto r = rng::create("mt19937", 512);
+        r->initialize(seeds[i]);
+        wmdirect::Wmdirect sim(&mdl, &geom, r);
+        setInit(sim);
+        const auto expected = record(sim);
+        const std::vector<double> actual(counts.begin() + i * stride,
+                                         counts.begin() + (i + 1) * stride);
+        EXPECT_EQ(actual, expected) << "instance " << i;
+    }
+}
+
+#ifdef _OPENMP
+TEST_F(WmEnsembleTest, independent_of_num_threads) {
+    const std::vector<uint> seeds{11, 12, 13, 14, 15, 16, 17, 18, 19};
+    WmEnsemble ens(&mdl, &geom, WmSolverType::Wmrssa);
+    setInit(ens);
+
+    std::vector<double> serial(seeds.size() * tpnts.size() * 2);
+    std::vector<double> parallel(serial.size());
+    const int max_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    ens.run(seeds, tpnts, serial.data(), serial.size());
+    omp_set_num_threads(4);
+    ens.run(seeds, tpnts, parallel.data(), parallel.size());
+    omp_set_num_threads(max_threads);
+    EXPECT_EQ(serial, parallel);
+}
+#endif
+
+TEST_F(WmEnsembleTest, overrides) {
+    const std::vector<double> kfs{1e8, 1e9, 1e10};
+    WmEnsemble ens(&mdl, &geom, WmSolverType::Wmrk4);
+    setInit(ens);
+    ens.setRk4DT(1e-5);
+
+    std::vector<std::vector<WmOverride>> overrides;
+    for (auto kf: kfs) {
+        overrides.push_back({{WmOverride::Type::CompReacK, "comp", "fwd", kf},
+                             {WmOverride::Type::CompCount, "comp", "B", 400}});
+    }
+    std::vector<double> counts(kfs.size() * tpnts.size() * 2);
+    ens.run({0, 0, 0}, tpnts, counts.data(), counts.size(), overrides);
+
+    const size_t stride = tpnts.size() * 2;
+    for (size_t i = 0; i < kfs.size(); i++) {
+        wmrk4::Wmrk4 sim(&mdl, &geom, nullptr);
+        sim.setRk4DT(1e-5);
+        setInit(sim);
+        sim.setCompReacK("comp", "fwd", kfs[i]);
+        sim.setCompCount("comp", "B", 400);
+        // Wmrk4 instances are integrated as lanes of a single solver, which
+        // give the same results
+        const auto expected = record(sim);
+        const std::vector<double> actual(counts.begin() + i * stride,
+                                         counts.begin() + (i + 1) * stride);
+        EXPECT_EQ(actual, expected) << "instance " << i;
+    }
+}
+
+TEST_F(WmEnsembleTest, invalid_arguments) {
+    WmEnsemble ens(&mdl, &geom, WmSolverType::Wmdirect);
+    setInit(ens);
+    EXPECT_THROW(ens.addCompCount("comp", "X"), steps::ArgErr);
+    EXPECT_THROW(ens.setCompReacK("comp", "unknown", 1.0), steps::ArgErr);
+    EXPECT_THROW(ens.setRk4DT(1e-5), steps::ArgErr);
+
+    std::vector<double> counts(3);
+    EXPECT_THROW(ens.run({1, 2}, tpnts, counts.data(), counts.size()), steps::ArgErr);
+    counts.resize(2 * tpnts.size() * 2);
+    EXPECT_THROW(ens.run({1, 2}, {0.1, 0.0, 0.2, 0.3, 0.4}, counts.data(), counts.size()),
+                 steps::ArgErr);
+    EXPECT_THROW(ens.run({1, 2}, tpnts, counts.data(), counts.size(), {{}}), steps::ArgErr);
+}
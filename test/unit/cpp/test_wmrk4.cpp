@@ -0,0 +1,200 @@
+#include "geom/comp.hpp"
+#include "geom/geom.hpp"
+#include "model/model.hpp"
+#include "model/reac.hpp"
+#include "model/spec.hpp"
+#include "model/volsys.hpp"
+#include "util/error.hpp"
+#include "wmrk4/wmrk4.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "wm_model.hpp"
+
+using namespace steps;
+
+struct Wmrk4LanesTest: public WmModelTest {
+    void setInit(wmrk4::Wmrk4& sim) {
+        sim.setRk4DT(1e-5);
+        sim.setCompCount("comp", "A", 500);
+        sim.setCompCount("comp", "B", 300);
+    }
+};
+
+TEST_F(Wmrk4LanesTest, lanes_match_single_instances) {
+    const std::vector<double> kfs{1e8, 5e8, 1e9, 2e9, 5e9, 1e10, 3e8};
+    const std::vector<double> kbinds{10.0, 50.0, 100.0, 200.0, 20.0, 1.0, 0.0};
+    const std::vector<double> counts_b{100, 200, 300, 400, 500, 600, 700};
+    const uint nlanes = kfs.size();
+
+    wmrk4::Wmrk4 lanes(&mdl, &geom, nullptr);
+    setInit(lanes);
+    lanes.setNLanes(nlanes);
+    ASSERT_EQ(lanes.getNLanes(), nlanes);
+    for (uint l = 0; l < nlanes; l++) {
+        lanes.setLaneCompReacK(l, "comp", "fwd", kfs[l]);
+        lanes.setLanePatchSReacK(l, "patch", "bind", kbinds[l]);
+        lanes.setLaneCompCount(l, "comp", "B", counts_b[l]);
+    }
+    lanes.run(0.1);
+
+    for (uint l = 0; l < nlanes; l++) {
+        wmrk4::Wmrk4 sim(&mdl, &geom, nullptr);
+        setInit(sim);
+        sim.setCompReacK("comp", "fwd", kfs[l]);
+        sim.setPatchSReacK("patch", "bind", kbinds[l]);
+        sim.setCompCount("comp", "B", counts_b[l]);
+        sim.run(0.1);
+        for (auto s: {"A", "B", "C"}) {
+            EXPECT_EQ(lanes.getLaneCompCount(l, "comp", s), sim.getCompCount("comp", s))
+                << "lane " << l << ", species " << s;
+        }
+        EXPECT_EQ(lanes.getLanePatchCount(l, "patch", "S"), sim.getPatchCount("patch", "S"))
+            << "lane " << l;
+    }
+
+    // the solver state follows lane 0
+    EXPECT_EQ(lanes.getCompCount("comp", "C"), lanes.getLaneCompCount(0, "comp", "C"));
+    EXPECT_EQ(lanes.getPatchCount("patch", "S"), lanes.getLanePatchCount(0, "patch", "S"));
+    EXPECT_DOUBLE_EQ(lanes.getTime(), 0.1);
+}
+
+TEST_F(Wmrk4LanesTest, reset_and_single_instance) {
+    wmrk4::Wmrk4 sim(&mdl, &geom, nullptr);
+    setInit(sim);
+    sim.setNLanes(3);
+    sim.setLaneCompCount(2, "comp", "A", 50);
+    sim.run(0.01);
+    EXPECT_NE(sim.getLaneCompCount(0, "comp", "A"), sim.getLaneCompCount(2, "comp", "A"));
+
+    sim.reset();
+    for (uint l = 0; l < 3; l++) {
+        EXPECT_EQ(sim.getLaneCompCount(l, "comp", "A"), 0.0);
+    }
+
+    sim.setNLanes(0);
+    EXPECT_EQ(sim.getNLanes(), 0);
+    setInit(sim);
+    sim.run(0.01);
+    EXPECT_GT(sim.getCompCount("comp", "C"), 0.0);
+    EXPECT_THROW(sim.getLaneCompCount(0, "comp", "A"), steps::ArgErr);
+}
+
+TEST_F(Wmrk4LanesTest, invalid_arguments) {
+    wmrk4::Wmrk4 sim(&mdl, &geom, nullptr);
+    setInit(sim);
+    sim.setNLanes(2);
+    EXPECT_THROW(sim.setLaneCompCount(2, "comp", "A", 1.0), steps::ArgErr);
+    EXPECT_THROW(sim.setLaneCompCount(0, "comp", "A", -1.0), steps::ArgErr);
+    EXPECT_THROW(sim.setLaneCompCount(0, "comp", "S", 1.0), steps::ArgErr);
+    EXPECT_THROW(sim.setLaneCompReacK(0, "comp", "bind", 1.0), steps::ArgErr);
+    EXPECT_THROW(sim.setLanePatchSReacK(1, "patch", "bind", -1.0), steps::ArgErr);
+}
+
+TEST_F(Wmrk4LanesTest, rk45_matches_rk4) {
+    wmrk4::Wmrk4 rk4(&mdl, &geom, nullptr);
+    setInit(rk4);
+    rk4.setRk4DT(1e-7);
+    wmrk4::Wmrk4 rk45(&mdl, &geom, nullptr);
+    setInit(rk45);
+    rk45.setIntegrator("rk45");
+    rk45.setTolerances(1e-9, 1e-9);
+    ASSERT_EQ(rk45.getIntegrator(), "rk45");
+
+    for (auto t: {0.001, 0.01, 0.05}) {
+        rk4.run(t);
+        rk45.run(t);
+        for (auto s: {"A", "B", "C"}) {
+            const double expected = rk4.getCompCount("comp", s);
+            EXPECT_NEAR(rk45.getCompCount("comp", s), expected, 1e-6 * expected)
+                << "t " << t << ", species " << s;
+        }
+        const double expected = rk4.getPatchCount("patch", "S");
+        EXPECT_NEAR(rk45.getPatchCount("patch", "S"), expected, 1e-6 * expected) << "t " << t;
+    }
+}
+
+TEST_F(Wmrk4LanesTest, rk45_first_order_decay) {
+    model::Model decay_mdl;
+    auto* A = new model::Spec("A", &decay_mdl);
+    auto* vsys = new model::Volsys("vsys", &decay_mdl);
+    new model::Reac("decay", vsys, {A}, {}, 5.0);
+    wm::Geom decay_geom;
+    wm::Comp decay_comp("comp", &decay_geom, 1e-18);
+    decay_comp.addVolsys("vsys");
+
+    wmrk4::Wmrk4 sim(&decay_mdl, &decay_geom, nullptr);
+    sim.setIntegrator("rk45");
+    sim.setTolerances(1e-8, 1e-8);
+    sim.setCompCount("comp", "A", 100000);
+    // sampling times are much shorter than the steps
+    for (uint i = 1; i <= 200; i++) {
+        const double t = i * 0.005;
+        sim.run(t);
+        EXPECT_NEAR(sim.getCompCount("comp", "A"), 100000 * std::exp(-5.0 * t), 1e-3) << "t " << t;
+    }
+}
+
+TEST_F(Wmrk4LanesTest, rk45_independent_of_sampling) {
+    wmrk4::Wmrk4 once(&mdl, &geom, nullptr);
+    setInit(once);
+    once.setIntegrator("rk45");
+    once.run(0.1);
+
+    wmrk4::Wmrk4 sampled(&mdl, &geom, nullptr);
+    setInit(sampled);
+    sampled.setIntegrator("rk45");
+    for (uint i = 1; i <= 100; i++) {
+        sampled.run(i * 0.001);
+    }
+    EXPECT_DOUBLE_EQ(sampled.getTime(), 0.1);
+    for (auto s: {"A", "B", "C"}) {
+        EXPECT_EQ(sampled.getCompCount("comp", s), once.getCompCount("comp", s)) << s;
+    }
+    EXPECT_EQ(sampled.getPatchCount("patch", "S"), once.getPatchCount("patch", "S"));
+
+    // changing a count restarts the integration from the new state
+    sampled.setCompCount("comp", "A", 0.0);
+    sampled.step();
+    EXPECT_GT(sampled.getTime(), 0.1);
+    EXPECT_GT(sampled.getCompCount("comp", "A"), 0.0);
+}
+
+TEST_F(Wmrk4LanesTest, rk45_lanes) {
+    const std::vector<double> kfs{1e8, 1e9, 1e10};
+    wmrk4::Wmrk4 lanes(&mdl, &geom, nullptr);
+    setInit(lanes);
+    lanes.setIntegrator("rk45");
+    lanes.setTolerances(1e-9, 1e-9);
+    lanes.setNLanes(kfs.size());
+    for (uint l = 0; l < kfs.size(); l++) {
+        lanes.setLaneCompReacK(l, "comp", "fwd", kfs[l]);
+    }
+    lanes.run(0.05);
+
+    for (uint l = 0; l < kfs.size(); l++) {
+        wmrk4::Wmrk4 sim(&mdl, &geom, nullptr);
+        setInit(sim);
+        sim.setIntegrator("rk45");
+        sim.setTolerances(1e-9, 1e-9);
+        sim.setCompReacK("comp", "fwd", kfs[l]);
+        sim.run(0.05);
+        // the lanes share their steps, so the results are only close
+        for (auto s: {"A", "B", "C"}) {
+            const double expected = sim.getCompCount("comp", s);
+            EXPECT_NEAR(lanes.getLaneCompCount(l, "comp", s), expected, 1e-6 * expected)
+                << "lane " << l << ", species " << s;
+        }
+    }
+}
+
+TEST_F(Wmrk4LanesTest, rk45_invalid_arguments) {
+    wmrk4::Wmrk4 sim(&mdl, &geom, nullptr);
+    EXPECT_THROW(sim.setIntegrator("euler"), steps::ArgErr);
+    EXPECT_EQ(sim.getIntegrator(), "rk4");
+    EXPECT_THROW(sim.setTolerances(-1.0, 1e-6), steps::ArgErr);
+    EXPECT_THROW(sim.setTolerances(0.0, 0.0), steps::ArgErr);
+}
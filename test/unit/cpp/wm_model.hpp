@@ -0,0 +1,48 @@
+#ifndef TEST_WM_MODEL_HPP
+#define TEST_WM_MODEL_HPP
+
+#include <memory>
+
+#include "geom/comp.hpp"
+#include "geom/geom.hpp"
+#include "geom/patch.hpp"
+#include "model/model.hpp"
+#include "model/reac.hpp"
+#include "model/spec.hpp"
+#include "model/sreac.hpp"
+#include "model/surfsys.hpp"
+#include "model/volsys.hpp"
+
+#include "gtest/gtest.h"
+
+// Well-mixed model shared by the tests of the well-mixed solvers:
+// A + B <-> C and A + A -> B in a compartment, binding of C to the
+// surface as S on a patch.
+struct WmModelTest: public ::testing::Test {
+    steps::model::Model mdl;
+    steps::wm::Geom geom;
+    std::unique_ptr<steps::wm::Comp> comp;
+    std::unique_ptr<steps::wm::Patch> patch;
+
+    void SetUp() override {
+        using namespace steps;
+        auto* A = new model::Spec("A", &mdl);
+        auto* B = new model::Spec("B", &mdl);
+        auto* C = new model::Spec("C", &mdl);
+        auto* S = new model::Spec("S", &mdl);
+        auto* vsys = new model::Volsys("vsys", &mdl);
+        auto* ssys = new model::Surfsys("ssys", &mdl);
+        new model::Reac("fwd", vsys, {A, B}, {C}, 1e9);
+        new model::Reac("bwd", vsys, {C}, {A, B}, 10.0);
+        new model::Reac("dim", vsys, {A, A}, {B}, 1e8);
+        new model::SReac("bind", ssys, {}, {C}, {}, {}, {S}, {}, 100.0);
+        new model::SReac("unbind", ssys, {}, {}, {S}, {C}, {}, {}, 5.0);
+
+        comp = std::make_unique<wm::Comp>("comp", &geom, 1e-18);
+        comp->addVolsys("vsys");
+        patch = std::make_unique<wm::Patch>("patch", &geom, comp.get(), nullptr, 1e-12);
+        patch->addSurfsys("ssys");
+    }
+};
+
+#endif  // ndef TEST_WM_MODEL_HPP
@@ -0,0 +1,119 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+###
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+import os
+import tempfile
+import unittest
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.solver as ssolver
+
+class CRScheduleTestCase(unittest.TestCase):
+    """
+    Test that the flat composition-rejection schedule of Tetexact is
+    interchangeable with the default one.
+    """
+    def setUp(self):
+        self.mdl = smodel.Model()
+        A = smodel.Spec('A', self.mdl)
+        B = smodel.Spec('B', self.mdl)
+        C = smodel.Spec('C', self.mdl)
+        vsys = smodel.Volsys('vsys', self.mdl)
+        smodel.Reac('fwd', vsys, lhs=[A, B], rhs=[C], kcst=1e8)
+        smodel.Reac('bkw', vsys, lhs=[C], rhs=[A, B], kcst=10.0)
+        smodel.Diff('diffA', vsys, A, 1e-12)
+        smodel.Diff('diffC', vsys, C, 2e-12)
+
+        # Unit cube split in 6 tetrahedrons, scaled to 1 um
+        h = 1e-6
+        verts = [0, 0, 0,  h, 0, 0,  h, h, 0,  0, h, 0,
+                 0, 0, h,  h, 0, h,  h, h, h,  0, h, h]
+        tets = [0, 1, 2, 6,  0, 2, 3, 6,  0, 3, 7, 6,
+                0, 7, 4, 6,  0, 4, 5, 6,  0, 5, 1, 6]
+        self.mesh = sgeom.Tetmesh(verts, tets)
+        comp = sgeom.TmComp('comp', self.mesh, range(self.mesh.countTets()))
+        comp.addVolsys('vsys')
+
+        self.rng = srng.create('mt19937', 512)
+
+    def _createSim(self, schedule):
+        self.rng.initialize(1234)
+        sim = ssolver.Tetexact(self.mdl, self.mesh, self.rng, 0, schedule)
+        sim.setCompConc('comp', 'A', 50e-6)
+        sim.setCompConc('comp', 'B', 40e-6)
+        return sim
+
+    def testA0(self):
+        sim_default = self._createSim(ssolver.Tetexact.CR_SCHEDULE_DEFAULT)
+        sim_flat = self._createSim(ssolver.Tetexact.CR_SCHEDULE_FLAT)
+        self.assertGreater(sim_flat.getA0(), 0.0)
+        self.assertAlmostEqual(sim_flat.getA0() / sim_default.getA0(), 1.0, places=10)
+
+    def testRun(self):
+        sim = self._createSim(ssolver.Tetexact.CR_SCHEDULE_FLAT)
+        nAB = sim.getCompCount('comp', 'A') + sim.getCompCount('comp', 'C')
+        sim.run(0.01)
+        self.assertGreater(sim.getNSteps(), 0)
+        self.assertEqual(sim.getCompCount('comp', 'A') + sim.getCompCount('comp', 'C'), nAB)
+
+    def testTrajectory(self):
+        sim_default = self._createSim(ssolver.Tetexact.CR_SCHEDULE_DEFAULT)
+        sim_flat = self._createSim(ssolver.Tetexact.CR_SCHEDULE_FLAT)
+        for t in [0.001, 0.01]:
+            sim_default.run(t)
+            sim_flat.run(t)
+            self.assertGreater(sim_flat.getNSteps(), 0)
+            self.assertEqual(sim_flat.getNSteps(), sim_default.getNSteps())
+            for tet in range(self.mesh.countTets()):
+                for s in ['A', 'B', 'C']:
+                    self.assertEqual(sim_flat.getTetCount(tet, s), sim_default.getTetCount(tet, s))
+
+    def testCheckpointCompatibility(self):
+        sim_flat = self._createSim(ssolver.Tetexact.CR_SCHEDULE_FLAT)
+        sim_flat.run(0.01)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            cp_path = os.path.join(tmpdir, 'flat.cp')
+            sim_flat.checkpoint(cp_path)
+            sim_default = self._createSim(ssolver.Tetexact.CR_SCHEDULE_DEFAULT)
+            sim_default.restore(cp_path)
+        self.assertEqual(sim_default.getA0(), sim_flat.getA0())
+        for tet in range(self.mesh.countTets()):
+            self.assertEqual(sim_default.getTetCount(tet, 'C'), sim_flat.getTetCount(tet, 'C'))
+
+    def testUnknownSchedule(self):
+        with self.assertRaises(Exception):
+            ssolver.Tetexact(self.mdl, self.mesh, self.rng, 0, 7)
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(CRScheduleTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
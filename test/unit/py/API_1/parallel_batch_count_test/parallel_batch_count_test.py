@@ -0,0 +1,164 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+###
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+import unittest
+
+import numpy as np
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+from steps.API_1.geom import INDEX_DTYPE
+
+class ParallelBatchCountCase(unittest.TestCase):
+    """
+    Test that the batch getters and setters of TetOpSplit, which gather the
+    values from the host of each element, agree with the per-element ones.
+    """
+    def setUp(self):
+        DCST = 0.08e-10
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+
+        self.vsys = smodel.Volsys('vsys', self.model)
+        self.ssys = smodel.Surfsys('ssys', self.model)
+        self.diff = smodel.Diff("diff", self.vsys, A, DCST)
+        self.sdiff = smodel.Diff("diff", self.ssys, A, DCST)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../parallel_diff_sel_test/meshes/test_mesh.inp', 1e-7)[0]
+        else:
+            self.mesh = meshio.importAbaqus('parallel_diff_sel_test/meshes/test_mesh.inp', 1e-7)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+        self.surf_tris = self.mesh.getSurfTris()
+        self.tmpatch = sgeom.TmPatch('patch', self.mesh, self.surf_tris, icomp = self.tmcomp)
+        self.tmpatch.addSurfsys('ssys')
+        self.roi_tets = list(range(0, self.mesh.ntets, 3))
+        self.mesh.addROI('roi', sgeom.ELEM_TET, self.roi_tets)
+        self.roi_tris = list(self.surf_tris[::2])
+        self.mesh.addROI('roi_tris', sgeom.ELEM_TRI, self.roi_tris)
+
+        self.rng = srng.create('r123', 512)
+        self.rng.initialize(1000)
+
+        tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        tri_hosts = gd.partitionTris(self.mesh, tet_hosts, self.surf_tris)
+        self.solver = solv.TetOpSplit(self.model, self.mesh, self.rng, solv.EF_NONE, tet_hosts, tri_hosts)
+        self.solver.setCompCount('comp', 'A', 10000)
+        self.solver.setPatchCount('patch', 'A', 1000)
+        self.solver.run(0.001)
+
+        # all elements in reverse order, with a repeated element
+        self.tets = np.array(list(reversed(range(self.mesh.ntets))) + [0], dtype=INDEX_DTYPE)
+        self.tris = np.array(list(reversed(self.surf_tris)) + [self.surf_tris[0]], dtype=INDEX_DTYPE)
+
+    def tearDown(self):
+        self.solver = None
+        self.model = None
+        self.mesh = None
+        self.rng = None
+
+    def testGetBatchTetCounts(self):
+        expected = [self.solver.getTetCount(tet, 'A') for tet in self.tets]
+        self.assertGreater(sum(expected), 0)
+        self.assertEqual(list(self.solver.getBatchTetCounts(list(self.tets), 'A')), expected)
+        counts = np.zeros(len(self.tets))
+        self.solver.getBatchTetCountsNP(self.tets, 'A', counts)
+        self.assertEqual(list(counts), expected)
+
+    def testGetBatchTetConcs(self):
+        expected = [self.solver.getTetConc(tet, 'A') for tet in self.tets]
+        concs = np.zeros(len(self.tets))
+        self.solver.getBatchTetConcsNP(self.tets, 'A', concs)
+        self.assertEqual(list(concs), expected)
+
+    def testGetBatchTriCounts(self):
+        expected = [self.solver.getTriCount(tri, 'A') for tri in self.tris]
+        self.assertGreater(sum(expected), 0)
+        self.assertEqual(list(self.solver.getBatchTriCounts(list(self.tris), 'A')), expected)
+        counts = np.zeros(len(self.tris))
+        self.solver.getBatchTriCountsNP(self.tris, 'A', counts)
+        self.assertEqual(list(counts), expected)
+
+    def testGetROITetCounts(self):
+        expected = [self.solver.getTetCount(tet, 'A') for tet in self.roi_tets]
+        self.assertEqual(list(self.solver.getROITetCounts('roi', 'A')), expected)
+        counts = np.zeros(len(self.roi_tets))
+        self.solver.getROITetCountsNP('roi', 'A', counts)
+        self.assertEqual(list(counts), expected)
+
+    def testGetROITriCounts(self):
+        expected = [self.solver.getTriCount(tri, 'A') for tri in self.roi_tris]
+        self.assertEqual(list(self.solver.getROITriCounts('roi_tris', 'A')), expected)
+        counts = np.zeros(len(self.roi_tris))
+        self.solver.getROITriCountsNP('roi_tris', 'A', counts)
+        self.assertEqual(list(counts), expected)
+
+    def testSetROITetCounts(self):
+        counts = np.array([float(tet % 7) for tet in self.roi_tets])
+        self.solver.setROITetCountsNP('roi', 'A', counts)
+        for tet, count in zip(self.roi_tets, counts):
+            self.assertEqual(self.solver.getTetCount(tet, 'A'), count)
+        self.assertEqual(self.solver.getROICount('roi', 'A'), sum(counts))
+
+    def testSetROITriCounts(self):
+        counts = np.array([float(tri % 5) for tri in self.roi_tris])
+        self.solver.setROITriCountsNP('roi_tris', 'A', counts)
+        for tri, count in zip(self.roi_tris, counts):
+            self.assertEqual(self.solver.getTriCount(tri, 'A'), count)
+        self.assertEqual(self.solver.getROICount('roi_tris', 'A'), sum(counts))
+
+    def testSetBatchTetCounts(self):
+        tets = self.tets[:-1]
+        counts = np.array([float(tet % 7) for tet in tets])
+        self.solver.setBatchTetCountsNP(tets, 'A', counts)
+        for tet, count in zip(tets, counts):
+            self.assertEqual(self.solver.getTetCount(tet, 'A'), count)
+        self.assertEqual(self.solver.getCompCount('comp', 'A'), sum(counts))
+
+    def testSetBatchTriCounts(self):
+        tris = self.tris[:-1]
+        counts = np.array([float(tri % 5) for tri in tris])
+        self.solver.setBatchTriCountsNP(tris, 'A', counts)
+        for tri, count in zip(tris, counts):
+            self.assertEqual(self.solver.getTriCount(tri, 'A'), count)
+        self.assertEqual(self.solver.getPatchCount('patch', 'A'), sum(counts))
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(ParallelBatchCountCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
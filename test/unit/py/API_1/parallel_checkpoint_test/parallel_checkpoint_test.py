@@ -0,0 +1,136 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+###
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+import os
+import tempfile
+import unittest
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+import steps.utilities.geom_decompose as gd
+
+class ParallelCheckpointTestCase(unittest.TestCase):
+    """
+    Test checkpoint and restore of TetOpSplit.
+    """
+    def setUp(self):
+        # Bar of 10 cubes of 1 um along x, each split in 6 tetrahedrons.
+        # comp1 is the first half, comp2 the second one.
+        h = 1e-6
+        ncubes = 10
+        verts = []
+        for i in range(ncubes + 1):
+            verts += [i * h, 0, 0,  i * h, h, 0,  i * h, h, h,  i * h, 0, h]
+        tets = []
+        for i in range(ncubes):
+            v0, v1, v2, v3 = 4 * i, 4 * i + 4, 4 * i + 5, 4 * i + 1
+            v4, v5, v6, v7 = 4 * i + 3, 4 * i + 7, 4 * i + 6, 4 * i + 2
+            tets += [v0, v1, v2, v6,  v0, v2, v3, v6,  v0, v3, v7, v6,
+                     v0, v7, v4, v6,  v0, v4, v5, v6,  v0, v5, v1, v6]
+        self.mesh = sgeom.Tetmesh(verts, tets)
+        ntets = self.mesh.countTets()
+        sgeom.TmComp('comp1', self.mesh, range(ntets // 2)).addVolsys('vsys1')
+        sgeom.TmComp('comp2', self.mesh, range(ntets // 2, ntets)).addVolsys('vsys2')
+
+        self.tet_hosts = gd.linearPartition(self.mesh, [steps.mpi.nhosts, 1, 1])
+        self.cp_path = os.path.join(tempfile.gettempdir(), 'steps_parallel_checkpoint_test.cp')
+
+    def tearDown(self):
+        if steps.mpi.rank == 0 and os.path.exists(self.cp_path):
+            os.remove(self.cp_path)
+
+    def _createModel(self, extra_reac=False):
+        model = smodel.Model()
+        A = smodel.Spec('A', model)
+        B = smodel.Spec('B', model)
+        vsys1 = smodel.Volsys('vsys1', model)
+        vsys2 = smodel.Volsys('vsys2', model)
+        smodel.Reac('fwd1', vsys1, lhs=[A], rhs=[B], kcst=20.0)
+        smodel.Reac('fwd2', vsys2, lhs=[A], rhs=[B], kcst=20.0)
+        smodel.Diff('diffA1', vsys1, A, 1e-12)
+        smodel.Diff('diffA2', vsys2, A, 1e-12)
+        if extra_reac:
+            # only changes the kinetic processes of the ranks hosting comp2
+            smodel.Reac('bkw2', vsys2, lhs=[B], rhs=[A], kcst=5.0)
+        return model
+
+    def _createSim(self, model, seed):
+        rng = srng.create('r123', 512)
+        rng.initialize(seed)
+        return solv.TetOpSplit(model, self.mesh, rng, solv.EF_NONE, self.tet_hosts)
+
+    def _counts(self, sim):
+        return [(sim.getTetCount(tet, 'A'), sim.getTetCount(tet, 'B'))
+                for tet in range(self.mesh.countTets())]
+
+    def testRoundTrip(self):
+        model = self._createModel()
+        sim = self._createSim(model, 23)
+        sim.setCompCount('comp1', 'A', 3000)
+        sim.setCompCount('comp2', 'A', 1000)
+        sim.run(0.02)
+        sim.checkpoint(self.cp_path)
+        counts = self._counts(sim)
+        extent = sim.getReacExtent()
+        sim.run(0.04)
+
+        restored = self._createSim(model, 1)
+        restored.restore(self.cp_path)
+        self.assertAlmostEqual(restored.getTime(), 0.02)
+        self.assertEqual(self._counts(restored), counts)
+        self.assertGreater(restored.getCompCount('comp1', 'B'), 0)
+        self.assertEqual(restored.getReacExtent(), extent)
+        self.assertEqual(restored.getCompCount('comp1', 'A') + restored.getCompCount('comp1', 'B') +
+                         restored.getCompCount('comp2', 'A') + restored.getCompCount('comp2', 'B'), 4000)
+
+        # the restored simulation can carry on
+        restored.run(0.04)
+        self.assertAlmostEqual(restored.getTime(), 0.04)
+        self.assertGreaterEqual(restored.getCompCount('comp1', 'B') + restored.getCompCount('comp2', 'B'),
+                                sum(b for _, b in counts))
+
+    def testMismatch(self):
+        sim = self._createSim(self._createModel(), 23)
+        sim.setCompCount('comp2', 'A', 1000)
+        sim.run(0.01)
+        sim.checkpoint(self.cp_path)
+
+        # all ranks raise, even those whose own block matches
+        other = self._createSim(self._createModel(extra_reac=True), 23)
+        with self.assertRaises(Exception):
+            other.restore(self.cp_path)
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(ParallelCheckpointTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
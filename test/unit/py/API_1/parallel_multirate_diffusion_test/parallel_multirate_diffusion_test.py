@@ -0,0 +1,153 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2022 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+###
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+import math
+import unittest
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+import steps.utilities.geom_decompose as gd
+
+class ParallelMultiRateDiffusionTestCase(unittest.TestCase):
+    """
+    Test that multi-rate diffusion of TetOpSplit reproduces the default
+    diffusion.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        F = smodel.Spec('F', self.model)
+        S = smodel.Spec('S', self.model)
+        vsys = smodel.Volsys('vsys', self.model)
+        # S is slow enough to be applied every 64 update periods
+        smodel.Diff('diffF', vsys, F, 1e-11)
+        smodel.Diff('diffS', vsys, S, 1e-13)
+
+        # Bar of 10 cubes of 1 um along x, each split in 6 tetrahedrons
+        h = 1e-6
+        ncubes = 10
+        verts = []
+        for i in range(ncubes + 1):
+            verts += [i * h, 0, 0,  i * h, h, 0,  i * h, h, h,  i * h, 0, h]
+        tets = []
+        for i in range(ncubes):
+            v0, v1, v2, v3 = 4 * i, 4 * i + 4, 4 * i + 5, 4 * i + 1
+            v4, v5, v6, v7 = 4 * i + 3, 4 * i + 7, 4 * i + 6, 4 * i + 2
+            tets += [v0, v1, v2, v6,  v0, v2, v3, v6,  v0, v3, v7, v6,
+                     v0, v7, v4, v6,  v0, v4, v5, v6,  v0, v5, v1, v6]
+        self.mesh = sgeom.Tetmesh(verts, tets)
+        comp = sgeom.TmComp('comp', self.mesh, range(self.mesh.countTets()))
+        comp.addVolsys('vsys')
+
+        self.tet_hosts = gd.linearPartition(self.mesh, [steps.mpi.nhosts, 1, 1])
+
+    def _createSim(self, seed, max_multiplier=None):
+        rng = srng.create('r123', 512)
+        rng.initialize(seed)
+        sim = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, self.tet_hosts)
+        if max_multiplier is not None:
+            sim.setMultiRateDiffusion(max_multiplier)
+        # all molecules start in the first cube
+        for tet in range(6):
+            sim.setTetCount(tet, 'F', 1000)
+            sim.setTetCount(tet, 'S', 1000)
+        return sim
+
+    def _meanX(self, sim, spec):
+        total = 0.0
+        moment = 0.0
+        for tet in range(self.mesh.countTets()):
+            n = sim.getTetCount(tet, spec)
+            total += n
+            moment += n * self.mesh.getTetBarycenter(tet)[0]
+        return moment / total
+
+    def testMultiplierOne(self):
+        sim_default = self._createSim(42)
+        sim_one = self._createSim(42, 1)
+        self.assertEqual(sim_one.getMultiRateDiffusion(), 1)
+        sim_default.run(0.5)
+        sim_one.run(0.5)
+        self.assertGreater(sim_default.getDiffExtent(), 0)
+        self.assertEqual(sim_one.getDiffExtent(), sim_default.getDiffExtent())
+        for tet in range(self.mesh.countTets()):
+            for spec in ['F', 'S']:
+                self.assertEqual(sim_one.getTetCount(tet, spec), sim_default.getTetCount(tet, spec))
+
+    def testStatistics(self):
+        nruns = 8
+        endtime = 2.0
+        results = {}
+        for max_multiplier in [1, 64]:
+            means = {'F': [], 'S': []}
+            for r in range(nruns):
+                sim = self._createSim(100 + r, max_multiplier)
+                sim.run(endtime)
+                for spec in means:
+                    self.assertEqual(sim.getCompCount('comp', spec), 6000)
+                    means[spec].append(self._meanX(sim, spec))
+            results[max_multiplier] = means
+
+        # the mean positions agree within 4 standard errors of the difference
+        for spec in ['F', 'S']:
+            stats = []
+            for max_multiplier in [1, 64]:
+                m = results[max_multiplier][spec]
+                mean = sum(m) / nruns
+                var = sum((x - mean) ** 2 for x in m) / (nruns - 1)
+                stats.append((mean, var))
+            (mean_ref, var_ref), (mean_mr, var_mr) = stats
+            stderr = math.sqrt((var_ref + var_mr) / nruns)
+            self.assertLess(abs(mean_mr - mean_ref), 4 * stderr + 1e-9)
+        # S has moved, but much less than F
+        self.assertGreater(results[1]['S'][0], 0.55e-6)
+        self.assertLess(results[1]['S'][0], results[1]['F'][0])
+
+    def testLargestMultiplier(self):
+        sim = self._createSim(7, 2 ** 30)
+        self.assertEqual(sim.getMultiRateDiffusion(), 2 ** 30)
+        sim.run(0.1)
+        self.assertEqual(sim.getCompCount('comp', 'F'), 6000)
+        self.assertEqual(sim.getCompCount('comp', 'S'), 6000)
+
+    def testInvalidMultiplier(self):
+        sim = self._createSim(7)
+        with self.assertRaises(Exception):
+            sim.setMultiRateDiffusion(0)
+        with self.assertRaises(Exception):
+            sim.setMultiRateDiffusion(2 ** 30 + 1)
+        self.assertEqual(sim.getMultiRateDiffusion(), 1)
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(ParallelMultiRateDiffusionTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())